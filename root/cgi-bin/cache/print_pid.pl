@@ -0,0 +1,9 @@
+#!/usr/bin/perl
+use strict;
+use warnings;
+
+# CGIが実行される度に変わる値(pid)を返す
+print "Content-Type: text/plain\r\n\r\n";
+print "$$\n";
+
+exit;
@@ -0,0 +1,10 @@
+#!/usr/bin/perl
+use strict;
+use warnings;
+
+# cacheさせない
+print "Cache-Control: no-store\r\n";
+print "Content-Type: text/plain\r\n\r\n";
+print "$$\n";
+
+exit;
@@ -0,0 +1,10 @@
+#!/usr/bin/perl
+use strict;
+use warnings;
+
+# 実行中に同じrequestが来るように1秒待ってからpidを返す
+sleep 1;
+print "Content-Type: text/plain\r\n\r\n";
+print "$$\n";
+
+exit;
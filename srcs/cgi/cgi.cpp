@@ -6,6 +6,7 @@
 #include <cerrno>
 #include <cstdlib>
 #include <cstring>
+#include <fcntl.h> // O_CLOEXEC
 #include <signal.h>
 #include <sys/wait.h>
 #include <unistd.h>
@@ -31,8 +32,9 @@ int Dup2(int fd1, int fd2) {
 	return status;
 }
 
+// CLOEXEC: 他のcgiの子プロセスや新しいbinaryにpipe_fdを渡さない(dup2した方は外れる)
 int Pipe(int fd[2]) {
-	int status = pipe(fd);
+	int status = pipe2(fd, O_CLOEXEC);
 	if (status == SYSTEM_ERROR) {
 		throw SystemException(std::strerror(errno));
 	}
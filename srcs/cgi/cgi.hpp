@@ -3,6 +3,7 @@
 
 #include "cgi_request.hpp"
 #include <string>
+#include <sys/types.h> // pid_t
 
 namespace cgi {
 
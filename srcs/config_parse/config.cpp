@@ -1,14 +1,71 @@
 #include "config.hpp"
+#include "directive_names.hpp"
 #include "lexer.hpp"
 #include "parser.hpp"
 #include <iostream>
 #include <sstream>
+#include <stdexcept>
 
 namespace config {
+namespace {
+
+// include先でさらにincludeできる深さ(自分自身をincludeした時に止めるため)
+const std::size_t INCLUDE_DEPTH_MAX = 8;
+
+// 相対pathのincludeはincludeを書いたfileのdirectoryから探す
+std::string GetIncludePath(const std::string &file_path, const std::string &include_path) {
+	const std::size_t slash_pos = file_path.rfind('/');
+	if (include_path[0] == '/' || slash_pos == std::string::npos) {
+		return include_path;
+	}
+	return file_path.substr(0, slash_pos + 1) + include_path;
+}
+
+void LexFile(const std::string &file_path, std::list<node::Node> &tokens) {
+	std::ifstream file(file_path.c_str());
+	if (!file) {
+		throw std::runtime_error("Cannot open included file: " + file_path);
+	}
+	std::stringstream buffer;
+	buffer << file.rdbuf();
+	lexer::Lexer lex(buffer.str(), tokens);
+}
+
+// "include file_path;"をそのfileのtokenに置き換える(nginxと同じく文字列として展開する)
+void ExpandInclude(
+	std::list<node::Node> &tokens, const std::string &file_path, std::size_t depth
+) {
+	typedef std::list<node::Node>::iterator Itr;
+	Itr it = tokens.begin();
+	while (it != tokens.end()) {
+		if ((*it).token_type != node::DIRECTIVE || (*it).token != INCLUDE) {
+			++it;
+			continue;
+		}
+		const Itr path_it  = ++Itr(it);
+		const Itr delim_it = path_it == tokens.end() ? path_it : ++Itr(path_it);
+		if (path_it == tokens.end() || (*path_it).token_type != node::WORD ||
+			delim_it == tokens.end() || (*delim_it).token_type != node::DELIM) {
+			throw std::runtime_error("invalid number of arguments in 'include' directive");
+		}
+		if (depth >= INCLUDE_DEPTH_MAX) {
+			throw std::runtime_error("'include' is nested too deeply: " + (*path_it).token);
+		}
+		const std::string     include_path = GetIncludePath(file_path, (*path_it).token);
+		std::list<node::Node> include_tokens;
+		LexFile(include_path, include_tokens);
+		ExpandInclude(include_tokens, include_path, depth + 1);
+		tokens.splice(it, include_tokens);
+		it = tokens.erase(it, ++Itr(delim_it));
+	}
+}
+
+} // namespace
 
 const Config *Config::s_cInstance = NULL;
 
-Config::Config(const std::string &file_path) : config_file_(file_path.c_str()) {
+Config::Config(const std::string &file_path)
+	: file_path_(file_path), config_file_(file_path.c_str()) {
 	if (!config_file_) {
 		throw std::runtime_error("Cannot open Configuration file");
 	}
@@ -16,7 +73,8 @@ Config::Config(const std::string &file_path) : config_file_(file_path.c_str()) {
 	buffer << config_file_.rdbuf();
 	std::list<node::Node> tokens;
 	lexer::Lexer          lex(buffer.str(), tokens);
-	parser::Parser        par(tokens);
+	ExpandInclude(tokens, file_path, 0);
+	parser::Parser par(tokens);
 	if (tokens.size() == 0) {
 		throw std::runtime_error("No file content");
 	}
@@ -36,6 +94,22 @@ void Config::Create(const std::string &file_path) {
 	}
 }
 
+// 今のinstanceと同じfileから作る。使うかどうかは呼び出し側が決める(使わなければdeleteする)
+const Config *Config::CreateReloaded() {
+	if (!s_cInstance) {
+		throw std::logic_error("CreateReloaded: instance doesn't exist");
+	}
+	return new Config(s_cInstance->file_path_);
+}
+
+void Config::Replace(const Config *new_instance) {
+	if (new_instance == s_cInstance) {
+		return;
+	}
+	delete s_cInstance;
+	s_cInstance = new_instance;
+}
+
 void Config::Destroy() {
 	delete s_cInstance;
 	s_cInstance = NULL;
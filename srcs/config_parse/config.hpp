@@ -22,6 +22,10 @@ namespace config {
  * - Get Servers:
  * @li `std::list<context::ServerCon> servers = config::ConfigInstance->servers_;`
  *
+ * - Reload the same file:
+ * @li `const config::Config *reloaded = config::Config::CreateReloaded();` (throw on error)
+ * @li `config::Config::Replace(reloaded);` (delete the current Instance)
+ *
  * - Destroy the Instance:
  * @li `config::ConfigInstance->Destroy();`
  */
@@ -32,6 +36,7 @@ class Config {
 	Config(const Config &);
 	Config              &operator=(const Config &);
 	static const Config *s_cInstance;
+	std::string          file_path_;
 	std::ifstream        config_file_;
 
   public:
@@ -39,6 +44,8 @@ class Config {
 
 	static const Config          *GetInstance();
 	static void                   Create(const std::string &);
+	static const Config          *CreateReloaded();
+	static void                   Replace(const Config *);
 	static void                   Destroy();
 	std::list<context::ServerCon> servers_;
 };
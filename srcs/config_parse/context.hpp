@@ -2,14 +2,19 @@
 #define CONTEXT_HPP_
 
 #include <list>
+#include <map>
 #include <string>
 #include <utility>
 
 namespace config {
 namespace context {
 
+typedef std::pair<std::string, unsigned int> HostPortPair;
+typedef std::map<std::string, std::string>   TypeMap; // 拡張子(小文字) -> MIME type
+
 struct LocationCon {
 	std::string                          request_uri;
+	std::string                          root; // 空ならserverのrootを使う
 	std::string                          alias;
 	std::string                          index;
 	bool                                 autoindex;
@@ -17,21 +22,67 @@ struct LocationCon {
 	std::pair<unsigned int, std::string> redirect; // cannot use return
 	std::string                          cgi_extension;
 	std::string                          upload_directory;
-	LocationCon() : autoindex(false) {}
+	unsigned int                         cgi_cache_valid; // sec (0: microcache off)
+	std::list<HostPortPair>              proxy_pass;      // upstream servers
+	std::string                          proxy_balance;   // round_robin or least_conn
+	// sec, 0ならserverの値を使う
+	unsigned int                         client_body_timeout;
+	unsigned int                         keepalive_timeout;
+	unsigned int                         send_timeout;
+	std::size_t                          keepalive_requests; // 0ならserverの値を使う
+	LocationCon()
+		: autoindex(false),
+		  cgi_cache_valid(0),
+		  proxy_balance("round_robin"),
+		  client_body_timeout(0),
+		  keepalive_timeout(0),
+		  send_timeout(0),
+		  keepalive_requests(0) {}
 };
 
-typedef std::list<LocationCon>               LocationList;
-typedef std::pair<std::string, unsigned int> HostPortPair;
-typedef std::list<HostPortPair>              HostPortList;
+typedef std::list<LocationCon>  LocationList;
+typedef std::list<HostPortPair> HostPortList;
 
 struct ServerCon {
 	HostPortList                         host_ports;
 	std::list<std::string>               server_names;
+	std::string                          root; // 空ならdefaultのrootを使う
 	LocationList                         location_con;
 	std::size_t                          client_max_body_size;
 	std::pair<unsigned int, std::string> error_page;
-	// default value for client_max_body_size is 1MB
-	ServerCon() : client_max_body_size(1024 * 1024) {}
+	std::size_t                          cgi_cache_size;
+	// number, size (request line, header行はsize以下、header fields全体はnumber * size以下)
+	std::pair<std::size_t, std::size_t>  large_client_header_buffers;
+	std::size_t                          max_header_fields;
+	TypeMap                              types; // 空ならserverの外のtypes、それも無ければ組み込み
+	// sec (default値はnginxと同じ)
+	unsigned int                         client_header_timeout;
+	unsigned int                         client_body_timeout;
+	unsigned int                         keepalive_timeout;
+	unsigned int                         send_timeout;
+	std::size_t                          keepalive_requests; // 1つの接続で受けるrequest数
+	// period秒の間にbytes未満しか受信/送信できない接続は切る(0: 無効)
+	typedef std::pair<std::size_t, unsigned int> MinRate; // bytes, period(sec)
+	MinRate                              client_min_rate;
+	MinRate                              send_min_rate;
+	std::size_t                          limit_conn_per_ip; // 同じIPからの同時接続数(0: 無制限)
+	// serverの外に書き、全serverに同じ値が入る(SIGTERM, SIGQUITで処理中のrequestを待つ時間)
+	unsigned int                         shutdown_timeout;
+	// default value for client_max_body_size, cgi_cache_size is 1MB
+	ServerCon()
+		: client_max_body_size(1024 * 1024),
+		  cgi_cache_size(1024 * 1024),
+		  large_client_header_buffers(std::make_pair(4, 8192)),
+		  max_header_fields(100),
+		  client_header_timeout(60),
+		  client_body_timeout(60),
+		  keepalive_timeout(75),
+		  send_timeout(60),
+		  keepalive_requests(1000),
+		  client_min_rate(std::make_pair(0, 0)),
+		  send_min_rate(std::make_pair(0, 0)),
+		  limit_conn_per_ip(0),
+		  shutdown_timeout(10) {}
 };
 
 } // namespace context
@@ -4,12 +4,28 @@ namespace config {
 
 const std::string SERVER   = "server";
 const std::string LOCATION = "location";
+const std::string TYPES    = "types";
 
-const std::string HOST                 = "host";
-const std::string LISTEN               = "listen";
-const std::string SERVER_NAME          = "server_name";
-const std::string ERROR_PAGE           = "error_page";
-const std::string CLIENT_MAX_BODY_SIZE = "client_max_body_size";
+const std::string INCLUDE = "include";
+
+const std::string HOST                        = "host";
+const std::string LISTEN                      = "listen";
+const std::string SERVER_NAME                 = "server_name";
+const std::string ERROR_PAGE                  = "error_page";
+const std::string CLIENT_MAX_BODY_SIZE        = "client_max_body_size";
+const std::string CGI_CACHE_SIZE              = "cgi_cache_size";
+const std::string LARGE_CLIENT_HEADER_BUFFERS = "large_client_header_buffers";
+const std::string MAX_HEADER_FIELDS           = "max_header_fields";
+const std::string ROOT                        = "root";
+const std::string CLIENT_HEADER_TIMEOUT       = "client_header_timeout";
+const std::string CLIENT_BODY_TIMEOUT         = "client_body_timeout";
+const std::string KEEPALIVE_TIMEOUT           = "keepalive_timeout";
+const std::string SEND_TIMEOUT                = "send_timeout";
+const std::string KEEPALIVE_REQUESTS          = "keepalive_requests";
+const std::string CLIENT_MIN_RATE             = "client_min_rate";
+const std::string SEND_MIN_RATE               = "send_min_rate";
+const std::string LIMIT_CONN_PER_IP           = "limit_conn_per_ip";
+const std::string SHUTDOWN_TIMEOUT            = "shutdown_timeout";
 
 const std::string ALLOWED_METHODS = "allowed_methods";
 const std::string RETURN          = "return";
@@ -21,7 +37,13 @@ extern const std::string VALID_ALLOWED_METHODS[] = {"GET", "DELETE", "POST"};
 extern const std::size_t SIZE_OF_VALID_ALLOWED_METHODS =
 	sizeof(VALID_ALLOWED_METHODS) / sizeof(VALID_ALLOWED_METHODS[0]);
 
-const std::string CGI_EXTENSION = "cgi_extension";
-const std::string UPLOAD_DIR    = "upload_dir";
+const std::string CGI_EXTENSION   = "cgi_extension";
+const std::string UPLOAD_DIR      = "upload_dir";
+const std::string CGI_CACHE_VALID = "cgi_cache_valid";
+
+const std::string PROXY_PASS    = "proxy_pass";
+const std::string PROXY_BALANCE = "proxy_balance";
+const std::string ROUND_ROBIN   = "round_robin";
+const std::string LEAST_CONN    = "least_conn";
 
 } // namespace config
@@ -12,6 +12,14 @@ namespace config {
 
 extern const std::string SERVER;
 extern const std::string LOCATION;
+extern const std::string TYPES; // serverの外(全serverのdefault)とserverの中に書ける
+
+/**
+ * @brief Directive that can be written anywhere
+ * @details include file_path; (config fileのdirectoryからの相対path)
+ */
+
+extern const std::string INCLUDE;
 
 /**
  * @brief Directive in Server Context
@@ -25,6 +33,20 @@ extern const std::string LISTEN;
 extern const std::string SERVER_NAME;
 extern const std::string ERROR_PAGE;
 extern const std::string CLIENT_MAX_BODY_SIZE;
+extern const std::string CGI_CACHE_SIZE;
+extern const std::string LARGE_CLIENT_HEADER_BUFFERS;
+extern const std::string MAX_HEADER_FIELDS;
+extern const std::string ROOT; // Location Contextでも使える
+extern const std::string CLIENT_HEADER_TIMEOUT;
+extern const std::string CLIENT_MIN_RATE;
+extern const std::string SEND_MIN_RATE;
+extern const std::string LIMIT_CONN_PER_IP;
+extern const std::string SHUTDOWN_TIMEOUT;
+// 以下はLocation Contextでも使える
+extern const std::string CLIENT_BODY_TIMEOUT;
+extern const std::string KEEPALIVE_TIMEOUT;
+extern const std::string SEND_TIMEOUT;
+extern const std::string KEEPALIVE_REQUESTS;
 
 /**
  * @brief Directive in Location Context
@@ -47,6 +69,17 @@ extern const std::size_t SIZE_OF_VALID_ALLOWED_METHODS;
 
 extern const std::string CGI_EXTENSION;
 extern const std::string UPLOAD_DIR;
+extern const std::string CGI_CACHE_VALID;
+
+/**
+ * @brief Directive in Location Context for reverse proxy
+ * @details Dir_name args;
+ */
+
+extern const std::string PROXY_PASS;
+extern const std::string PROXY_BALANCE;
+extern const std::string ROUND_ROBIN;
+extern const std::string LEAST_CONN;
 
 } // namespace config
 
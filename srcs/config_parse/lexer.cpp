@@ -27,12 +27,28 @@ Lexer::~Lexer() {}
 void Lexer::InitDefinition() {
 	context_.push_back(SERVER);
 	context_.push_back(LOCATION);
+	context_.push_back(TYPES);
+
+	directive_.push_back(INCLUDE);
 
 	// host 未実装
 	directive_.push_back(LISTEN);
 	directive_.push_back(SERVER_NAME);
 	directive_.push_back(ERROR_PAGE);
 	directive_.push_back(CLIENT_MAX_BODY_SIZE);
+	directive_.push_back(CGI_CACHE_SIZE);
+	directive_.push_back(LARGE_CLIENT_HEADER_BUFFERS);
+	directive_.push_back(MAX_HEADER_FIELDS);
+	directive_.push_back(ROOT);
+	directive_.push_back(CLIENT_HEADER_TIMEOUT);
+	directive_.push_back(CLIENT_BODY_TIMEOUT);
+	directive_.push_back(KEEPALIVE_TIMEOUT);
+	directive_.push_back(SEND_TIMEOUT);
+	directive_.push_back(KEEPALIVE_REQUESTS);
+	directive_.push_back(CLIENT_MIN_RATE);
+	directive_.push_back(SEND_MIN_RATE);
+	directive_.push_back(LIMIT_CONN_PER_IP);
+	directive_.push_back(SHUTDOWN_TIMEOUT);
 
 	directive_.push_back(ALIAS);
 	directive_.push_back(INDEX);
@@ -41,6 +57,9 @@ void Lexer::InitDefinition() {
 	directive_.push_back(RETURN);
 	directive_.push_back(CGI_EXTENSION);
 	directive_.push_back(UPLOAD_DIR);
+	directive_.push_back(CGI_CACHE_VALID);
+	directive_.push_back(PROXY_PASS);
+	directive_.push_back(PROXY_BALANCE);
 }
 
 void Lexer::LexBuffer() {
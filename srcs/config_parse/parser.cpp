@@ -15,17 +15,38 @@ Parser::Parser(const std::list<node::Node> &tokens) : tokens_(tokens) {
 Parser::~Parser() {}
 
 void Parser::ParseNode() {
+	DirectiveSet     main_directive_set;
+	context::TypeMap main_types;
+	unsigned int     main_shutdown_timeout = context::ServerCon().shutdown_timeout;
+
 	for (NodeItr it(tokens_.begin(), tokens_.end()); it != tokens_.end(); ++it) {
 		if ((*it).token_type == node::CONTEXT && (*it).token == SERVER) {
 			servers_.push_back(CreateServerContext(++it));
+		} else if ((*it).token_type == node::CONTEXT && (*it).token == TYPES) {
+			HandleTypes(main_types, main_directive_set, ++it);
+		} else if ((*it).token_type == node::DIRECTIVE && (*it).token == SHUTDOWN_TIMEOUT) {
+			HandleTimeout(main_shutdown_timeout, SHUTDOWN_TIMEOUT, main_directive_set, ++it);
+			if ((*it).token_type != node::DELIM) {
+				throw std::runtime_error("expect ';' after: " + (*--NodeItr(it)).token);
+			}
 		} else {
 			throw std::runtime_error("expect server context: " + (*it).token);
 		}
 	}
+	// serverの外のtypes, shutdown_timeoutは後ろに書かれていても全serverで使う
+	typedef std::list<context::ServerCon>::iterator Itr;
+	for (Itr it = servers_.begin(); it != servers_.end(); ++it) {
+		if (it->types.empty()) {
+			it->types = main_types;
+		}
+		it->shutdown_timeout = main_shutdown_timeout;
+	}
 }
 
 namespace {
 
+const std::string PROXY_SCHEME = "http://";
+
 template <typename T>
 bool FindDuplicated(const std::list<T> &list, const T &element) {
 	if (std::find(list.begin(), list.end(), element) != list.end()) {
@@ -67,6 +88,8 @@ context::ServerCon Parser::CreateServerContext(NodeItr &it) {
 		case node::CONTEXT:
 			if ((*it).token == LOCATION) {
 				server.location_con.push_back(CreateLocationContext(++it));
+			} else if ((*it).token == TYPES) {
+				HandleTypes(server.types, server_directive_set_, ++it);
 			} else {
 				throw std::runtime_error(
 					"invalid nest of 'server' directive after: " + (*previous_it).token
@@ -98,6 +121,32 @@ void Parser::HandleServerContextDirective(context::ServerCon &server, NodeItr &i
 		HandleClientMaxBodySize(server.client_max_body_size, ++it);
 	} else if ((*it).token == ERROR_PAGE) {
 		HandleErrorPage(server.error_page, ++it);
+	} else if ((*it).token == CGI_CACHE_SIZE) {
+		HandleCgiCacheSize(server.cgi_cache_size, ++it);
+	} else if ((*it).token == LARGE_CLIENT_HEADER_BUFFERS) {
+		HandleLargeClientHeaderBuffers(server.large_client_header_buffers, ++it);
+	} else if ((*it).token == MAX_HEADER_FIELDS) {
+		HandleMaxHeaderFields(server.max_header_fields, ++it);
+	} else if ((*it).token == ROOT) {
+		HandleRoot(server.root, server_directive_set_, ++it);
+	} else if ((*it).token == CLIENT_HEADER_TIMEOUT) {
+		HandleTimeout(
+			server.client_header_timeout, CLIENT_HEADER_TIMEOUT, server_directive_set_, ++it
+		);
+	} else if ((*it).token == CLIENT_BODY_TIMEOUT) {
+		HandleTimeout(server.client_body_timeout, CLIENT_BODY_TIMEOUT, server_directive_set_, ++it);
+	} else if ((*it).token == KEEPALIVE_TIMEOUT) {
+		HandleTimeout(server.keepalive_timeout, KEEPALIVE_TIMEOUT, server_directive_set_, ++it);
+	} else if ((*it).token == SEND_TIMEOUT) {
+		HandleTimeout(server.send_timeout, SEND_TIMEOUT, server_directive_set_, ++it);
+	} else if ((*it).token == KEEPALIVE_REQUESTS) {
+		HandleKeepaliveRequests(server.keepalive_requests, server_directive_set_, ++it);
+	} else if ((*it).token == CLIENT_MIN_RATE) {
+		HandleMinRate(server.client_min_rate, CLIENT_MIN_RATE, ++it);
+	} else if ((*it).token == SEND_MIN_RATE) {
+		HandleMinRate(server.send_min_rate, SEND_MIN_RATE, ++it);
+	} else if ((*it).token == LIMIT_CONN_PER_IP) {
+		HandleLimitConnPerIp(server.limit_conn_per_ip, ++it);
 	}
 	if ((*it).token_type != node::DELIM) {
 		throw std::runtime_error("expect ';' after: " + (*--NodeItr(it)).token);
@@ -203,6 +252,202 @@ void Parser::HandleErrorPage(std::pair<unsigned int, std::string> &error_page, N
 	++it;
 }
 
+void Parser::HandleCgiCacheSize(std::size_t &cgi_cache_size, NodeItr &it) {
+	if ((*it).token_type != node::WORD) {
+		throw std::runtime_error(
+			"invalid number of arguments in 'cgi_cache_size' directive: " + (*it).token
+		);
+	}
+	utils::Result<std::size_t> cache_size = utils::ConvertStrToSize((*it).token);
+	if (!cache_size.IsOk() || cache_size.GetValue() > CACHE_SIZE_MAX) {
+		// 0はcacheしない
+		throw std::runtime_error("invalid cgi_cache_size: " + (*it).token);
+	}
+	if (IsDuplicateDirectiveName(server_directive_set_, CGI_CACHE_SIZE)) {
+		throw std::runtime_error("'cgi_cache_size' directive is duplicated");
+	}
+	cgi_cache_size = cache_size.GetValue();
+	++it;
+}
+
+// ex. large_client_header_buffers 4 8192;
+void Parser::HandleLargeClientHeaderBuffers(
+	std::pair<std::size_t, std::size_t> &large_client_header_buffers, NodeItr &it
+) {
+	if ((*it).token_type != node::WORD || (*++NodeItr(it)).token_type != node::WORD) {
+		throw std::runtime_error(
+			"invalid number of arguments in 'large_client_header_buffers' directive: " +
+			(*it).token
+		);
+	}
+	NodeItr tmp_it = it; // number
+	++it;                // size
+	utils::Result<std::size_t> number = utils::ConvertStrToSize((*tmp_it).token);
+	if (!number.IsOk() || number.GetValue() < 1 ||
+		number.GetValue() > static_cast<std::size_t>(HEADER_BUFFER_NUMBER_MAX)) {
+		throw std::runtime_error("invalid large_client_header_buffers number: " + (*tmp_it).token);
+	}
+	utils::Result<std::size_t> size = utils::ConvertStrToSize((*it).token);
+	if (!size.IsOk() || size.GetValue() < 1 ||
+		size.GetValue() > static_cast<std::size_t>(HEADER_BUFFER_SIZE_MAX)) {
+		throw std::runtime_error("invalid large_client_header_buffers size: " + (*it).token);
+	}
+	if (IsDuplicateDirectiveName(server_directive_set_, LARGE_CLIENT_HEADER_BUFFERS)) {
+		throw std::runtime_error("'large_client_header_buffers' directive is duplicated");
+	}
+	large_client_header_buffers = std::make_pair(number.GetValue(), size.GetValue());
+	++it;
+}
+
+void Parser::HandleMaxHeaderFields(std::size_t &max_header_fields, NodeItr &it) {
+	if ((*it).token_type != node::WORD) {
+		throw std::runtime_error(
+			"invalid number of arguments in 'max_header_fields' directive: " + (*it).token
+		);
+	}
+	utils::Result<std::size_t> fields = utils::ConvertStrToSize((*it).token);
+	if (!fields.IsOk() || fields.GetValue() < 1 ||
+		fields.GetValue() > static_cast<std::size_t>(HEADER_FIELDS_MAX)) {
+		throw std::runtime_error("invalid max_header_fields: " + (*it).token);
+	}
+	if (IsDuplicateDirectiveName(server_directive_set_, MAX_HEADER_FIELDS)) {
+		throw std::runtime_error("'max_header_fields' directive is duplicated");
+	}
+	max_header_fields = fields.GetValue();
+	++it;
+}
+
+// server, locationのどちらにも書ける。存在するかどうかは起動時に絶対pathにする時に見る
+void Parser::HandleRoot(std::string &root, DirectiveSet &directive_set, NodeItr &it) {
+	if ((*it).token_type != node::WORD) {
+		throw std::runtime_error("invalid number of arguments in 'root' directive: " + (*it).token);
+	}
+	if (IsDuplicateDirectiveName(directive_set, ROOT)) {
+		throw std::runtime_error("'root' directive is duplicated");
+	}
+	root = (*it++).token;
+}
+
+// ex. client_body_timeout 10; -> 10sec
+// client_header_timeout以外はlocationにも書ける
+void Parser::HandleTimeout(
+	unsigned int      &timeout,
+	const std::string &directive_name,
+	DirectiveSet      &directive_set,
+	NodeItr           &it
+) {
+	if ((*it).token_type != node::WORD) {
+		throw std::runtime_error(
+			"invalid number of arguments in '" + directive_name + "' directive: " + (*it).token
+		);
+	}
+	utils::Result<unsigned int> timeout_sec = utils::ConvertStrToUint((*it).token);
+	if (!timeout_sec.IsOk() || timeout_sec.GetValue() < 1 ||
+		timeout_sec.GetValue() > static_cast<unsigned int>(TIMEOUT_MAX)) {
+		throw std::runtime_error("invalid " + directive_name + ": " + (*it).token);
+	}
+	if (IsDuplicateDirectiveName(directive_set, directive_name)) {
+		throw std::runtime_error("'" + directive_name + "' directive is duplicated");
+	}
+	timeout = timeout_sec.GetValue();
+	++it;
+}
+
+void Parser::HandleKeepaliveRequests(
+	std::size_t &keepalive_requests, DirectiveSet &directive_set, NodeItr &it
+) {
+	if ((*it).token_type != node::WORD) {
+		throw std::runtime_error(
+			"invalid number of arguments in 'keepalive_requests' directive: " + (*it).token
+		);
+	}
+	utils::Result<std::size_t> requests = utils::ConvertStrToSize((*it).token);
+	if (!requests.IsOk() || requests.GetValue() < 1 ||
+		requests.GetValue() > static_cast<std::size_t>(KEEPALIVE_REQUESTS_MAX)) {
+		throw std::runtime_error("invalid keepalive_requests: " + (*it).token);
+	}
+	if (IsDuplicateDirectiveName(directive_set, KEEPALIVE_REQUESTS)) {
+		throw std::runtime_error("'keepalive_requests' directive is duplicated");
+	}
+	keepalive_requests = requests.GetValue();
+	++it;
+}
+
+// ex. client_min_rate 1024 10; -> 10secの間に1024byte以上受信できなければ切る
+void Parser::HandleMinRate(
+	std::pair<std::size_t, unsigned int> &min_rate,
+	const std::string                    &directive_name,
+	NodeItr                              &it
+) {
+	if ((*it).token_type != node::WORD || (*++NodeItr(it)).token_type != node::WORD) {
+		throw std::runtime_error(
+			"invalid number of arguments in '" + directive_name + "' directive: " + (*it).token
+		);
+	}
+	NodeItr tmp_it = it; // bytes
+	++it;                // period
+	utils::Result<std::size_t> bytes = utils::ConvertStrToSize((*tmp_it).token);
+	if (!bytes.IsOk() || bytes.GetValue() < 1 ||
+		bytes.GetValue() > static_cast<std::size_t>(MIN_RATE_BYTES_MAX)) {
+		throw std::runtime_error("invalid " + directive_name + " bytes: " + (*tmp_it).token);
+	}
+	utils::Result<unsigned int> period = utils::ConvertStrToUint((*it).token);
+	if (!period.IsOk() || period.GetValue() < 1 ||
+		period.GetValue() > static_cast<unsigned int>(TIMEOUT_MAX)) {
+		throw std::runtime_error("invalid " + directive_name + " period: " + (*it).token);
+	}
+	if (IsDuplicateDirectiveName(server_directive_set_, directive_name)) {
+		throw std::runtime_error("'" + directive_name + "' directive is duplicated");
+	}
+	min_rate = std::make_pair(bytes.GetValue(), period.GetValue());
+	++it;
+}
+
+void Parser::HandleLimitConnPerIp(std::size_t &limit_conn_per_ip, NodeItr &it) {
+	if ((*it).token_type != node::WORD) {
+		throw std::runtime_error(
+			"invalid number of arguments in 'limit_conn_per_ip' directive: " + (*it).token
+		);
+	}
+	utils::Result<std::size_t> limit = utils::ConvertStrToSize((*it).token);
+	if (!limit.IsOk() || limit.GetValue() < 1 ||
+		limit.GetValue() > static_cast<std::size_t>(CONN_PER_IP_MAX)) {
+		throw std::runtime_error("invalid limit_conn_per_ip: " + (*it).token);
+	}
+	if (IsDuplicateDirectiveName(server_directive_set_, LIMIT_CONN_PER_IP)) {
+		throw std::runtime_error("'limit_conn_per_ip' directive is duplicated");
+	}
+	limit_conn_per_ip = limit.GetValue();
+	++it;
+}
+
+// ex. types { text/html html htm; image/jpeg jpeg jpg; }
+// serverの外, serverの中のどちらにも書ける。拡張子は小文字にしておき、同じ拡張子は後に書いた方を使う
+void Parser::HandleTypes(context::TypeMap &types, DirectiveSet &directive_set, NodeItr &it) {
+	if ((*it).token_type != node::L_BRACKET) {
+		throw std::runtime_error("expect { after types: " + (*it).token);
+	}
+	if (IsDuplicateDirectiveName(directive_set, TYPES)) {
+		throw std::runtime_error("'types' directive is duplicated");
+	}
+	++it; // skip L_BRACKET
+	while ((*it).token_type != node::R_BRACKET) {
+		if ((*it).token_type != node::WORD || (*++NodeItr(it)).token_type != node::WORD) {
+			throw std::runtime_error(
+				"invalid number of arguments in 'types' directive: " + (*it).token
+			);
+		}
+		const std::string &type = (*it++).token;
+		while ((*it).token_type == node::WORD) {
+			types[utils::ToLowerString((*it++).token)] = type;
+		}
+		if ((*it).token_type != node::DELIM) {
+			throw std::runtime_error("expect ';' after: " + (*--NodeItr(it)).token);
+		}
+		++it;
+	}
+}
+
 /**
  * @brief Handlers for Location Context
  * @details Handlers for each Location Directive
@@ -256,6 +501,8 @@ context::LocationCon Parser::CreateLocationContext(NodeItr &it) {
 void Parser::HandleLocationContextDirective(context::LocationCon &location, NodeItr &it) {
 	if ((*it).token == ALIAS) {
 		HandleAlias(location.alias, ++it);
+	} else if ((*it).token == ROOT) {
+		HandleRoot(location.root, location_directive_set_, ++it);
 	} else if ((*it).token == INDEX) {
 		HandleIndex(location.index, ++it);
 	} else if ((*it).token == AUTO_INDEX) {
@@ -268,6 +515,22 @@ void Parser::HandleLocationContextDirective(context::LocationCon &location, Node
 		HandleCgiExtension(location.cgi_extension, ++it);
 	} else if ((*it).token == UPLOAD_DIR) {
 		HandleUploadDirectory(location.upload_directory, ++it);
+	} else if ((*it).token == CGI_CACHE_VALID) {
+		HandleCgiCacheValid(location.cgi_cache_valid, ++it);
+	} else if ((*it).token == PROXY_PASS) {
+		HandleProxyPass(location.proxy_pass, ++it);
+	} else if ((*it).token == PROXY_BALANCE) {
+		HandleProxyBalance(location.proxy_balance, ++it);
+	} else if ((*it).token == CLIENT_BODY_TIMEOUT) {
+		HandleTimeout(
+			location.client_body_timeout, CLIENT_BODY_TIMEOUT, location_directive_set_, ++it
+		);
+	} else if ((*it).token == KEEPALIVE_TIMEOUT) {
+		HandleTimeout(location.keepalive_timeout, KEEPALIVE_TIMEOUT, location_directive_set_, ++it);
+	} else if ((*it).token == SEND_TIMEOUT) {
+		HandleTimeout(location.send_timeout, SEND_TIMEOUT, location_directive_set_, ++it);
+	} else if ((*it).token == KEEPALIVE_REQUESTS) {
+		HandleKeepaliveRequests(location.keepalive_requests, location_directive_set_, ++it);
 	}
 
 	if ((*it).token_type != node::DELIM) {
@@ -381,6 +644,72 @@ void Parser::HandleUploadDirectory(std::string &upload_directory, NodeItr &it) {
 	upload_directory = (*it++).token;
 }
 
+void Parser::HandleCgiCacheValid(unsigned int &cgi_cache_valid, NodeItr &it) {
+	if ((*it).token_type != node::WORD) {
+		throw std::runtime_error(
+			"invalid number of arguments in 'cgi_cache_valid' directive: " + (*it).token
+		);
+	}
+	// ex. cgi_cache_valid 10; -> 10sec
+	utils::Result<unsigned int> valid_time = utils::ConvertStrToUint((*it).token);
+	if (!valid_time.IsOk() || valid_time.GetValue() > CACHE_VALID_MAX) {
+		throw std::runtime_error("invalid cgi_cache_valid: " + (*it).token);
+	}
+	if (IsDuplicateDirectiveName(location_directive_set_, CGI_CACHE_VALID)) {
+		throw std::runtime_error("'cgi_cache_valid' directive is duplicated");
+	}
+	cgi_cache_valid = valid_time.GetValue();
+	++it;
+}
+
+void Parser::HandleProxyPass(std::list<context::HostPortPair> &proxy_pass, NodeItr &it) {
+	if ((*it).token_type != node::WORD) {
+		throw std::runtime_error(
+			"invalid number of arguments in 'proxy_pass' directive: " + (*it).token
+		);
+	}
+	if (IsDuplicateDirectiveName(location_directive_set_, PROXY_PASS)) {
+		throw std::runtime_error("'proxy_pass' directive is duplicated");
+	}
+	// ex. proxy_pass http://localhost:3000 http://127.0.0.1:3001;
+	while ((*it).token_type == node::WORD) {
+		const std::string &url = (*it).token;
+		if (!utils::StartWith(url, PROXY_SCHEME)) {
+			throw std::runtime_error("proxy_pass argument should start with 'http://': " + url);
+		}
+		std::vector<std::string> host_port_vec =
+			utils::SplitStr(url.substr(PROXY_SCHEME.size()), ":");
+		if (host_port_vec.size() != 2) {
+			throw std::runtime_error(
+				"proxy_pass argument should be formatted 'http://host:port': " + url
+			);
+		}
+		utils::Result<unsigned int> port_number = utils::ConvertStrToUint(host_port_vec[1]);
+		if (host_port_vec[0] == "" || !port_number.IsOk() ||
+			port_number.GetValue() < PROXY_PORT_MIN || port_number.GetValue() > PORT_MAX) {
+			throw std::runtime_error("invalid port number for proxy_pass: " + url);
+		}
+		const context::HostPortPair host_port =
+			std::make_pair(host_port_vec[0], port_number.GetValue());
+		if (FindDuplicated(proxy_pass, host_port)) {
+			throw std::runtime_error("a duplicated parameter in 'proxy_pass' directive: " + url);
+		}
+		proxy_pass.push_back(host_port);
+		++it;
+	}
+}
+
+void Parser::HandleProxyBalance(std::string &proxy_balance, NodeItr &it) {
+	if ((*it).token_type != node::WORD ||
+		((*it).token != ROUND_ROBIN && (*it).token != LEAST_CONN)) {
+		throw std::runtime_error("invalid arguments in 'proxy_balance' directive: " + (*it).token);
+	}
+	if (IsDuplicateDirectiveName(location_directive_set_, PROXY_BALANCE)) {
+		throw std::runtime_error("'proxy_balance' directive is duplicated");
+	}
+	proxy_balance = (*it++).token;
+}
+
 std::list<context::ServerCon> Parser::GetServers() const {
 	return this->servers_;
 }
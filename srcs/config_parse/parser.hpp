@@ -17,6 +17,8 @@ typedef CustomConstIterator<node::Node> NodeItr;
 
 class Parser {
   private:
+	typedef std::set<std::string> DirectiveSet;
+
 	const std::list<node::Node>  &tokens_;
 	std::list<context::ServerCon> servers_;
 	// Prohibit Copy
@@ -38,6 +40,28 @@ class Parser {
 	void HandleListen(std::list<context::HostPortPair> &host_ports, NodeItr &it);
 	void HandleClientMaxBodySize(std::size_t &client_max_body_size, NodeItr &it);
 	void HandleErrorPage(std::pair<unsigned int, std::string> &error_page, NodeItr &it);
+	void HandleCgiCacheSize(std::size_t &cgi_cache_size, NodeItr &it);
+	void HandleLargeClientHeaderBuffers(
+		std::pair<std::size_t, std::size_t> &large_client_header_buffers, NodeItr &it
+	);
+	void HandleMaxHeaderFields(std::size_t &max_header_fields, NodeItr &it);
+	void HandleRoot(std::string &root, DirectiveSet &directive_set, NodeItr &it);
+	void HandleTypes(context::TypeMap &types, DirectiveSet &directive_set, NodeItr &it);
+	void HandleTimeout(
+		unsigned int      &timeout,
+		const std::string &directive_name,
+		DirectiveSet      &directive_set,
+		NodeItr           &it
+	);
+	void HandleKeepaliveRequests(
+		std::size_t &keepalive_requests, DirectiveSet &directive_set, NodeItr &it
+	);
+	void HandleMinRate(
+		std::pair<std::size_t, unsigned int> &min_rate,
+		const std::string                    &directive_name,
+		NodeItr                              &it
+	);
+	void HandleLimitConnPerIp(std::size_t &limit_conn_per_ip, NodeItr &it);
 
 	/**
 	 * @brief Handlers for each Location Directive
@@ -50,16 +74,28 @@ class Parser {
 	void HandleReturn(std::pair<unsigned int, std::string> &redirect, NodeItr &it);
 	void HandleCgiExtension(std::string &cgi_extension, NodeItr &it);
 	void HandleUploadDirectory(std::string &upload_directory, NodeItr &it);
-
-	static const int PORT_MIN        = 1024;
-	static const int PORT_MAX        = 65535;
-	static const int STATUS_CODE_MIN = 300;
-	static const int STATUS_CODE_MAX = 599;
-	static const int BODY_SIZE_MIN   = 1;       // 1B
-	static const int BODY_SIZE_MAX   = 8388608; // 8MB
+	void HandleCgiCacheValid(unsigned int &cgi_cache_valid, NodeItr &it);
+	void HandleProxyPass(std::list<context::HostPortPair> &proxy_pass, NodeItr &it);
+	void HandleProxyBalance(std::string &proxy_balance, NodeItr &it);
+
+	static const int PORT_MIN                 = 1024;
+	static const int PORT_MAX                 = 65535;
+	static const int PROXY_PORT_MIN           = 1;
+	static const int STATUS_CODE_MIN          = 300;
+	static const int STATUS_CODE_MAX          = 599;
+	static const int BODY_SIZE_MIN            = 1;        // 1B
+	static const int BODY_SIZE_MAX            = 8388608;  // 8MB
+	static const int CACHE_SIZE_MAX           = 67108864; // 64MB
+	static const int CACHE_VALID_MAX          = 86400;    // 1day
+	static const int HEADER_BUFFER_NUMBER_MAX = 64;
+	static const int HEADER_BUFFER_SIZE_MAX   = 65536; // 64KB
+	static const int HEADER_FIELDS_MAX        = 1000;
+	static const int TIMEOUT_MAX              = 3600;   // 1hour
+	static const int KEEPALIVE_REQUESTS_MAX   = 100000;
+	static const int MIN_RATE_BYTES_MAX       = 8388608; // 8MB
+	static const int CONN_PER_IP_MAX          = 65535;
 
 	/* For duplicated parameter */
-	typedef std::set<std::string>  DirectiveSet;
 	DirectiveSet                   server_directive_set_;
 	DirectiveSet                   location_directive_set_;
 	typedef std::list<std::string> LocationUriList;
@@ -5,12 +5,7 @@
 #include "client_infos.hpp"
 #include "error_state.hpp"
 #include "virtual_server.hpp"
-
-namespace server {
-
-typedef std::list<const VirtualServer *> VirtualServerAddrList;
-
-}
+#include "virtual_server_addr_list.hpp"
 
 namespace http {
 
@@ -39,7 +34,12 @@ class IHttp {
 	virtual HttpResult GetErrorResponse(int client_fd, ErrorState state) = 0;
 
 	// Generates a HTTP response based on the CGI response.
-	virtual HttpResult GetResponseFromCgi(int client_fd, const cgi::CgiResponse &cgi_response) = 0;
+	// A local redirect (Location: /path) is re-dispatched internally as a GET to that path.
+	virtual HttpResult GetResponseFromCgi(
+		const ClientInfos                   &client_info,
+		const server::VirtualServerAddrList &virtual_servers,
+		const cgi::CgiResponse              &cgi_response
+	) = 0;
 };
 
 } // namespace http
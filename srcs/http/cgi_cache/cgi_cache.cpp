@@ -0,0 +1,153 @@
+#include "cgi_cache.hpp"
+#include "http_message.hpp"
+#include "utils.hpp"
+#include <vector>
+
+namespace http {
+namespace {
+
+typedef std::vector<std::string> DirectiveList;
+
+const std::string NO_STORE = "no-store";
+const std::string NO_CACHE = "no-cache";
+const std::string PRIVATE  = "private";
+const std::string MAX_AGE  = "max-age=";
+const std::string S_MAXAGE = "s-maxage=";
+
+// ex. "public, max-age=60" -> {"public", "max-age=60"}
+DirectiveList SplitCacheControl(const std::string &cache_control) {
+	DirectiveList        directives;
+	const DirectiveList &split = utils::SplitStr(cache_control, ",");
+
+	typedef DirectiveList::const_iterator Itr;
+	for (Itr it = split.begin(); it != split.end(); ++it) {
+		const std::string directive = utils::Trim(*it, OPTIONAL_WHITESPACE);
+		if (!directive.empty()) {
+			directives.push_back(directive);
+		}
+	}
+	return directives;
+}
+
+} // namespace
+
+CgiCache::CgiCache(std::size_t max_size) : max_size_(max_size), size_(0) {}
+
+CgiCache::~CgiCache() {}
+
+CgiCache::GetResult CgiCache::Get(const std::string &key, std::time_t now) {
+	GetResult result;
+	result.Set(false);
+	EntryMap::iterator it = entries_.find(key);
+	if (it == entries_.end()) {
+		return result;
+	}
+	if (it->second.expire_time <= now) {
+		Delete(it);
+		return result;
+	}
+	// 最近使ったものとして先頭に移動
+	lru_.splice(lru_.begin(), lru_, it->second.lru_it);
+	result.Set(true, it->second.data);
+	return result;
+}
+
+void CgiCache::Set(
+	const std::string &key, const ParsedData &data, unsigned int ttl, std::time_t now
+) {
+	EntryMap::iterator it = entries_.find(key);
+	if (it != entries_.end()) {
+		Delete(it);
+	}
+	const std::size_t size = CalculateSize(key, data);
+	if (ttl == 0 || size > max_size_) {
+		return;
+	}
+	Evict(size);
+
+	lru_.push_front(key);
+	Entry entry;
+	entry.data        = data;
+	entry.expire_time = now + ttl;
+	entry.size        = size;
+	entry.lru_it      = lru_.begin();
+	entries_[key]     = entry;
+	size_ += size;
+	utils::Debug("CgiCache", "store " + key + " (" + utils::ToString(ttl) + "s)");
+}
+
+void CgiCache::Clear() {
+	entries_.clear();
+	lru_.clear();
+	size_ = 0;
+}
+
+std::size_t CgiCache::GetSize() const {
+	return size_;
+}
+
+std::size_t CgiCache::GetMaxSize() const {
+	return max_size_;
+}
+
+CgiCache::TtlResult
+CgiCache::GetTtl(const CgiHeaderFields &header_fields, unsigned int cache_valid) {
+	TtlResult result(false, 0);
+	// cookieを含むレスポンスはclient毎に異なるので保持しない
+	if (header_fields.find(SET_COOKIE) != header_fields.end()) {
+		return result;
+	}
+	CgiHeaderFields::const_iterator it = header_fields.find(CACHE_CONTROL);
+	if (it == header_fields.end()) {
+		// scriptの指定がない場合はlocationのcgi_cache_validを使う(microcache)
+		result.Set(cache_valid != 0, cache_valid);
+		return result;
+	}
+	utils::Result<unsigned int> max_age(false, 0);
+	utils::Result<unsigned int> s_maxage(false, 0);
+
+	const DirectiveList &directives = SplitCacheControl(it->second);
+	typedef DirectiveList::const_iterator Itr;
+	for (Itr directive = directives.begin(); directive != directives.end(); ++directive) {
+		if (*directive == NO_STORE || *directive == NO_CACHE || *directive == PRIVATE) {
+			return result;
+		} else if (utils::StartWith(*directive, MAX_AGE)) {
+			max_age = utils::ConvertStrToUint(directive->substr(MAX_AGE.size()));
+		} else if (utils::StartWith(*directive, S_MAXAGE)) {
+			s_maxage = utils::ConvertStrToUint(directive->substr(S_MAXAGE.size()));
+		}
+	}
+	// 共有cacheなのでs-maxageを優先
+	if (s_maxage.IsOk()) {
+		result.Set(s_maxage.GetValue() != 0, s_maxage.GetValue());
+	} else if (max_age.IsOk()) {
+		result.Set(max_age.GetValue() != 0, max_age.GetValue());
+	} else {
+		result.Set(cache_valid != 0, cache_valid);
+	}
+	return result;
+}
+
+void CgiCache::Delete(EntryMap::iterator it) {
+	size_ -= it->second.size;
+	lru_.erase(it->second.lru_it);
+	entries_.erase(it);
+}
+
+// 新しいentryが入るまで古いものから削除
+void CgiCache::Evict(std::size_t new_entry_size) {
+	while (!lru_.empty() && size_ + new_entry_size > max_size_) {
+		Delete(entries_.find(lru_.back()));
+	}
+}
+
+std::size_t CgiCache::CalculateSize(const std::string &key, const ParsedData &data) {
+	std::size_t size = key.size() + data.body.size();
+	typedef CgiHeaderFields::const_iterator Itr;
+	for (Itr it = data.header_fields.begin(); it != data.header_fields.end(); ++it) {
+		size += it->first.size() + it->second.size();
+	}
+	return size;
+}
+
+} // namespace http
@@ -0,0 +1,64 @@
+#ifndef HTTP_CGI_CACHE_HPP_
+#define HTTP_CGI_CACHE_HPP_
+
+#include "cgi_response_parse.hpp"
+#include "result.hpp"
+#include <cstddef> // size_t
+#include <ctime>   // time_t
+#include <list>
+#include <map>
+#include <string>
+
+namespace http {
+
+// GETで実行したCGIのレスポンス(パース済み)を保持するcache
+// - key: request_target(path + query)
+// - max_sizeを超える場合は最後に使われたのが一番古いものから削除(LRU)
+class CgiCache {
+  public:
+	typedef cgi::CgiResponseParse::ParsedData   ParsedData;
+	typedef cgi::CgiResponseParse::HeaderFields CgiHeaderFields;
+	typedef utils::Result<ParsedData>           GetResult;
+	typedef utils::Result<unsigned int>         TtlResult;
+
+	explicit CgiCache(std::size_t max_size);
+	~CgiCache();
+
+	GetResult   Get(const std::string &key, std::time_t now);
+	void        Set(const std::string &key, const ParsedData &data, unsigned int ttl, std::time_t now);
+	void        Clear();
+	std::size_t GetSize() const;
+	std::size_t GetMaxSize() const;
+
+	// Cache-Control(no-store, max-age)とlocationのcgi_cache_validから保持する秒数を決める
+	static TtlResult GetTtl(const CgiHeaderFields &header_fields, unsigned int cache_valid);
+
+  private:
+	CgiCache();
+	// prohibit copy
+	CgiCache(const CgiCache &other);
+	CgiCache &operator=(const CgiCache &other);
+
+	// front: 最近使ったkey
+	typedef std::list<std::string> LruList;
+	struct Entry {
+		ParsedData        data;
+		std::time_t       expire_time;
+		std::size_t       size;
+		LruList::iterator lru_it;
+	};
+	typedef std::map<std::string, Entry> EntryMap;
+
+	void               Delete(EntryMap::iterator it);
+	void               Evict(std::size_t new_entry_size);
+	static std::size_t CalculateSize(const std::string &key, const ParsedData &data);
+
+	std::size_t max_size_;
+	std::size_t size_;
+	EntryMap    entries_;
+	LruList     lru_;
+};
+
+} // namespace http
+
+#endif /* HTTP_CGI_CACHE_HPP_ */
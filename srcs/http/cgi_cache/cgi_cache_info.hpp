@@ -0,0 +1,27 @@
+#ifndef HTTP_CGI_CACHE_INFO_HPP_
+#define HTTP_CGI_CACHE_INFO_HPP_
+
+#include <cstddef> // NULL
+#include <string>
+
+namespace server {
+
+class VirtualServer;
+
+}
+
+namespace http {
+
+// GETのcgiのみcacheの対象
+struct CgiCacheInfo {
+	CgiCacheInfo() : is_cacheable(false), virtual_server(NULL), cache_valid(0) {}
+
+	bool                         is_cacheable;
+	const server::VirtualServer *virtual_server; // cacheの単位
+	std::string                  key;            // request_target(path + query)
+	unsigned int                 cache_valid;    // locationのcgi_cache_valid
+};
+
+} // namespace http
+
+#endif /* HTTP_CGI_CACHE_INFO_HPP_ */
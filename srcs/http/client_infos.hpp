@@ -1,15 +1,21 @@
 #ifndef CLIENT_INFOS_HPP_
 #define CLIENT_INFOS_HPP_
 
+#include <cstddef> // size_t
 #include <string>
 
 namespace http {
 
 struct ClientInfos {
+	ClientInfos()
+		: fd(-1), listen_server_port(0), request_count(0), is_keep_alive_disabled(false) {}
+
 	int          fd;
 	std::string  ip;
 	unsigned int listen_server_port;
 	std::string  request_buf;
+	std::size_t  request_count; // この接続で既に処理したrequestの数
+	bool         is_keep_alive_disabled; // shutdown中なので次のresponseはConnection: close
 };
 
 } // namespace http
@@ -5,7 +5,9 @@ namespace http {
 
 enum ErrorState {
 	TIMEOUT,
-	INTERNAL_ERROR
+	INTERNAL_ERROR,
+	UPSTREAM_ERROR,
+	UPSTREAM_TIMEOUT
 };
 
 } // namespace http
@@ -3,21 +3,61 @@
 #include "client_infos.hpp"
 #include "http_message.hpp"
 #include "http_result.hpp"
+#include "http_serverinfo_check.hpp"
 #include "http_storage.hpp"
 #include "status_code.hpp"
 #include "utils.hpp"
+#include <ctime>
 #include <iostream>
 
 namespace http {
 namespace {
 
-std::string CreateLocalRedirectRequest(const std::string &location, const std::string &host) {
-	std::string response;
-	response += "GET " + location + " HTTP/1.1\r\nHost: " + host + "\r\n\r\n";
-	return response;
+typedef cgi::CgiResponseParse::HeaderFields CgiHeaderFields;
+
+// Location: /path の場合はserver内でそのpathにGETし直す(local redirect)
+utils::Result<std::string> GetLocalRedirectLocation(const CgiHeaderFields &header_fields) {
+	utils::Result<std::string>      result;
+	CgiHeaderFields::const_iterator location = header_fields.find(LOCATION);
+	if (location == header_fields.end() || !utils::StartWith(location->second, "/")) {
+		result.Set(false);
+		return result;
+	}
+	result.Set(true, location->second);
+	return result;
 }
 
-bool IsConnectionKeep(bool is_connection_close, const HeaderFields &header_fields) {
+// 元のrequestのHost, Connectionを引き継いだGETを作る
+HttpRequestResult
+CreateLocalRedirectRequest(const std::string &location, const RequestHeaderFields &header_fields) {
+	HttpRequestResult request_result;
+	request_result.request.request_line.method         = GET;
+	request_result.request.request_line.request_target = location;
+	request_result.request.request_line.version        = HTTP_VERSION;
+
+	const std::string inherited_fields[] = {HOST, CONNECTION};
+	for (std::size_t i = 0; i < sizeof(inherited_fields) / sizeof(inherited_fields[0]); ++i) {
+		RequestHeaderFields::const_iterator it = header_fields.find(inherited_fields[i]);
+		if (it != header_fields.end()) {
+			request_result.request.header_fields[it->first] = it->second;
+		}
+	}
+	return request_result;
+}
+
+// Hostが分かる前に読むので、listenしているaddrのdefault serverの上限を使う
+void SetHeaderLimits(HttpParseState &state, const server::VirtualServerAddrList &server_info) {
+	if (server_info.empty()) {
+		return;
+	}
+	const server::HeaderLimits &limits = server_info.GetDefaultServer()->GetHeaderLimits();
+	state.request_line_size_max        = limits.buffer_size;
+	state.header_line_size_max         = limits.buffer_size;
+	state.header_size_max              = limits.buffer_number * limits.buffer_size;
+	state.header_count_max             = limits.max_fields;
+}
+
+bool IsConnectionKeep(bool is_connection_close, const RequestHeaderFields &header_fields) {
 	// responseのエラーの結果なので優先
 	if (is_connection_close) {
 		return false;
@@ -29,97 +69,240 @@ bool IsConnectionKeep(bool is_connection_close, const HeaderFields &header_field
 
 Http::Http() {}
 
-Http::~Http() {}
+Http::~Http() {
+	typedef CgiCacheMap::const_iterator Itr;
+	for (Itr it = cgi_caches_.begin(); it != cgi_caches_.end(); ++it) {
+		delete it->second;
+	}
+}
 
 HttpResult
 Http::Run(const ClientInfos &client_info, const server::VirtualServerAddrList &server_info) {
-	HttpResult          result;
-	utils::Result<void> parsed_result =
-		ParseHttpRequestFormat(client_info.fd, client_info.request_buf);
+	HttpResult                result;
+	const utils::Result<void> parsed_result = ParseHttpRequestFormat(client_info, server_info);
 	if (!parsed_result.IsOk()) {
-		return CreateBadRequestResponse(client_info.fd);
+		return CreateParseErrorResponse(client_info.fd);
 	}
+	HttpRequestParsedData &data = storage_.GetClientSaveData(client_info.fd);
+	// responseを作るとdataは削除されるので先に取っておく
+	const server::ConnectionLimits *connection_limits = data.connection_limits;
 	if (IsHttpRequestFormatComplete(client_info.fd)) {
-		result = CreateHttpResponse(client_info, server_info);
+		result                   = CreateHttpResponse(client_info, server_info);
+		result.connection_limits = connection_limits;
+		return result;
+	}
+	result.connection_limits = connection_limits;
+	if (data.is_continue_required) {
+		data.is_continue_required = false;
+		result.interim_response   = HttpResponse::CreateContinueResponse();
 	}
 	return result;
 }
 
-HttpResult Http::GetResponseFromCgi(int client_fd, const cgi::CgiResponse &cgi_response) {
-	typedef utils::Result<cgi::CgiResponseParse::ParsedData> CgiParseResult;
-	HttpResult                                               result;
+HttpResult Http::GetResponseFromCgi(
+	const ClientInfos                   &client_info,
+	const server::VirtualServerAddrList &server_info,
+	const cgi::CgiResponse              &cgi_response
+) {
+	SharedCgiResponse shared_response;
+	return GetResponseFromCgi(client_info, server_info, cgi_response, shared_response);
+}
+
+// 同じcgiを待っている他のclientにも返せるresponseはshared_responseに入れる
+HttpResult Http::GetResponseFromCgi(
+	const ClientInfos                   &client_info,
+	const server::VirtualServerAddrList &server_info,
+	const cgi::CgiResponse              &cgi_response,
+	SharedCgiResponse                   &shared_response
+) {
+	typedef utils::Result<CgiParsedData> CgiParseResult;
+	shared_response.Set(false);
 	CgiParseResult cgi_parse_result = cgi::CgiResponseParse::Parse(cgi_response.response);
 	if (!cgi_parse_result.IsOk()) {
-		return GetErrorResponse(client_fd, INTERNAL_ERROR);
-	}
-	HttpRequestParsedData               data          = storage_.GetClientSaveData(client_fd);
-	cgi::CgiResponseParse::HeaderFields header_fields = cgi_parse_result.GetValue().header_fields;
-	if (header_fields.find(LOCATION) != header_fields.end() &&
-		utils::StartWith(header_fields[LOCATION], "/")) {
-		// Hostがないリクエストヘッダはエラーで弾かれている
-		result.request_buf =
-			CreateLocalRedirectRequest(
-				header_fields[LOCATION], data.request_result.request.header_fields.at(HOST)
-			) +
-			data.current_buf;
-		result.is_response_complete = false;
-	} else {
-		result.request_buf          = data.current_buf;
-		result.is_response_complete = true;
+		return GetErrorResponse(client_info.fd, INTERNAL_ERROR);
+	}
+	const CgiParsedData   &parsed = cgi_parse_result.GetValue();
+	HttpRequestParsedData &data   = storage_.GetClientSaveData(client_info.fd);
+	if (IsCgiCacheable(data.cgi_cache_info, parsed)) {
+		shared_response.Set(true, parsed);
+	}
+	// local redirectはredirect先で改めてresponseを作るのでcacheしない
+	if (!GetLocalRedirectLocation(parsed.header_fields).IsOk()) {
+		SetCgiCacheData(data.cgi_cache_info, parsed);
+	}
+	return CreateCgiHttpResult(client_info, server_info, data, parsed);
+}
+
+// 同じcgiを待っていたclientのresponseは、parse・cache済みのresponseから作る
+HttpResult Http::GetSharedResponseFromCgi(
+	const ClientInfos                   &client_info,
+	const server::VirtualServerAddrList &server_info,
+	const CgiParsedData                 &parsed
+) {
+	HttpRequestParsedData &data = storage_.GetClientSaveData(client_info.fd);
+	return CreateCgiHttpResult(client_info, server_info, data, parsed);
+}
+
+HttpResult Http::CreateCgiHttpResult(
+	const ClientInfos                   &client_info,
+	const server::VirtualServerAddrList &server_info,
+	HttpRequestParsedData               &data,
+	const CgiParsedData                 &parsed
+) {
+	const CgiHeaderFields           &header_fields = parsed.header_fields;
+	const utils::Result<std::string> location      = GetLocalRedirectLocation(header_fields);
+	if (location.IsOk()) {
+		return InternalRedirect(client_info, server_info, data, location.GetValue());
 	}
+	HttpResult result;
+	result.request_buf.swap(data.current_buf);
+	result.is_response_complete = true;
 	result.is_connection_keep =
-		(cgi_parse_result.GetValue().header_fields.find(CONNECTION) !=
-		 cgi_parse_result.GetValue().header_fields.end())
-			? (cgi_parse_result.GetValue().header_fields.at(CONNECTION) == KEEP_ALIVE)
+		(header_fields.find(CONNECTION) != header_fields.end())
+			? (header_fields.at(CONNECTION) == KEEP_ALIVE)
 			: HttpResponse::IsConnectionKeep(data.request_result.request.header_fields);
-	result.response =
-		HttpResponse::GetResponseFromCgi(cgi_parse_result.GetValue(), data.request_result);
-	storage_.DeleteClientSaveData(client_fd);
+	result.response = HttpResponse::GetResponseFromCgi(parsed, data.request_result);
+	// cgiのresponseを返すのでsave_dataは不要(dataもここで無効になる)
+	storage_.DeleteClientSaveData(client_info.fd);
 	return result;
 }
 
-utils::Result<void> Http::ParseHttpRequestFormat(int client_fd, const std::string &read_buf) {
-	utils::Result<void>   result;
-	HttpRequestParsedData save_data = storage_.GetClientSaveData(client_fd);
-	save_data.current_buf += read_buf;
-	try {
-		HttpParse::Run(save_data);
-	} catch (const HttpException &e) {
-		save_data.request_result.status_code = e.GetStatusCode();
+// request文字列を作って再parseせず、保存しているrequestをredirect先のGETに書き換えて処理し直す
+HttpResult Http::InternalRedirect(
+	const ClientInfos                   &client_info,
+	const server::VirtualServerAddrList &server_info,
+	HttpRequestParsedData               &data,
+	const std::string                   &location
+) {
+	utils::Debug("http", "internal redirect to " + location, client_info.fd);
+	const HttpRequestResult redirect_request =
+		CreateLocalRedirectRequest(location, data.request_result.request.header_fields);
+	data.request_result = redirect_request;
+	data.is_cgi_running = false;
+	return DispatchRequest(client_info, server_info, data);
+}
+
+utils::Result<void> Http::ParseHttpRequestFormat(
+	const ClientInfos &client_info, const server::VirtualServerAddrList &server_info
+) {
+	utils::Result<void>    result;
+	HttpRequestParsedData &save_data = storage_.GetClientSaveData(client_info.fd);
+	save_data.current_buf += client_info.request_buf;
+	const bool is_header_fields_parsed = save_data.is_request_format.is_header_fields;
+	if (!is_header_fields_parsed) {
+		SetHeaderLimits(save_data.parse_state, server_info);
+	}
+	HttpStatus status = HttpParse::ParseRequestHead(save_data);
+	if (status.IsOk() && !is_header_fields_parsed &&
+		save_data.is_request_format.is_header_fields) {
+		PrepareConnection(save_data, client_info, server_info);
+		if (!save_data.is_request_format.is_body_message) {
+			status = PrepareBodyMessage(save_data, server_info);
+		}
+	}
+	if (status.IsOk()) {
+		status = HttpParse::ParseRequestBody(save_data);
+	}
+	if (!status.IsOk()) {
+		save_data.request_result.status_code = StatusCode(status.GetStatusCode());
 		result.Set(false);
 	}
-	storage_.UpdateClientSaveData(client_fd, save_data);
 	return result;
 }
 
+// header fieldsを読み終えた直後に呼ぶ
+// locationのtimeoutを決め、keepalive_requestsに達したrequestとshutdown中のrequestは
+// Connection: closeとして扱う
+void Http::PrepareConnection(
+	HttpRequestParsedData               &data,
+	const ClientInfos                   &client_info,
+	const server::VirtualServerAddrList &server_info
+) {
+	HttpRequestFormat &request = data.request_result.request;
+	if (client_info.is_keep_alive_disabled) {
+		request.header_fields[CONNECTION] = CLOSE;
+	}
+	if (server_info.empty()) {
+		return;
+	}
+	data.connection_limits = &HttpServerInfoCheck::GetConnectionLimits(server_info, request);
+	if (client_info.request_count + 1 >= data.connection_limits->keepalive_requests) {
+		request.header_fields[CONNECTION] = CLOSE;
+	}
+}
+
+// header fieldsを読み終えた直後、bodyを1byteも読まないうちに呼ぶ
+// virtual serverのclient_max_body_sizeを決め、Expectに答えられるかを判定する
+HttpStatus Http::PrepareBodyMessage(
+	HttpRequestParsedData &data, const server::VirtualServerAddrList &server_info
+) {
+	const RequestHeaderFields &header_fields = data.request_result.request.header_fields;
+	// Content-Length, chunkedの合計はParseRequestBody()でこの上限と比べる
+	data.parse_state.body_size_max =
+		HttpServerInfoCheck::GetClientMaxBodySize(server_info, header_fields);
+	const RequestHeaderFields::const_iterator expect = header_fields.find(EXPECT);
+	if (expect == header_fields.end()) {
+		return HttpStatus();
+	}
+	if (utils::ToLowerString(expect->second) != CONTINUE_EXPECTATION) {
+		return HttpStatus(EXPECTATION_FAILED, "Error: unsupported expectation");
+	}
+	// bodyを既に送ってきているclientには100を返さない
+	data.is_continue_required = data.current_buf.empty();
+	return HttpStatus();
+}
+
 HttpResult Http::CreateHttpResponse(
 	const ClientInfos &client_info, const server::VirtualServerAddrList &server_info
 ) {
-	HttpResult            result;
-	HttpRequestParsedData data = storage_.GetClientSaveData(client_info.fd);
-	result.request_buf         = data.current_buf;
+	HttpRequestParsedData &data = storage_.GetClientSaveData(client_info.fd);
 
 	// CGI実行中は何もしない
 	if (data.is_cgi_running) {
+		HttpResult result;
+		result.request_buf.swap(data.current_buf);
 		result.is_response_complete = false; // same as default
 		result.is_connection_keep =
 			HttpResponse::IsConnectionKeep(data.request_result.request.header_fields);
 		return result;
 	}
-	HttpResponseResult response_result =
-		HttpResponse::Run(client_info, server_info, data.request_result, result.cgi_result);
+	return DispatchRequest(client_info, server_info, data);
+}
+
+// parse済みのrequestからresponseを作る(cgi, proxyの場合は実行の準備だけ)
+// dataはstorage_に保存されているもので、cgiの場合はそのまま残し、それ以外は削除する
+HttpResult Http::DispatchRequest(
+	const ClientInfos                   &client_info,
+	const server::VirtualServerAddrList &server_info,
+	HttpRequestParsedData               &data
+) {
+	HttpResult         result;
+	HttpResponseResult response_result = HttpResponse::Run(
+		client_info, server_info, data.request_result, result.cgi_result, result.proxy_result
+	);
 	result.is_connection_keep = IsConnectionKeep(
 		response_result.is_connection_close, data.request_result.request.header_fields
 	);
-	result.response = response_result.response;
+	result.response.swap(response_result.response);
 	if (result.cgi_result.is_cgi) {
+		// cacheにある場合はCGIを実行せずにcacheからresponseを作る
+		const CgiCache::GetResult cache_result = GetCgiCacheData(result.cgi_result.cache_info);
+		if (cache_result.IsOk()) {
+			return CreateCgiHttpResult(client_info, server_info, data, cache_result.GetValue());
+		}
 		// cgiの場合はcgiのhttp_responseを作るときにsave_dataが必要
-		// is_cgi_runningを変えて更新
-		data.is_cgi_running = true;
-		storage_.UpdateClientSaveData(client_info.fd, data);
+		data.is_cgi_running         = true;
+		data.cgi_cache_info         = result.cgi_result.cache_info;
+		result.is_response_complete = false;
+		result.request_buf.swap(data.current_buf);
+	} else if (result.proxy_result.is_proxy) {
+		// proxyのresponseはserver側でupstreamからclientに直接流すのでsave_dataは不要
+		result.request_buf.swap(data.current_buf);
+		storage_.DeleteClientSaveData(client_info.fd);
 		result.is_response_complete = false;
 	} else {
 		// httpの場合はsave_dataは不要
+		result.request_buf.swap(data.current_buf);
 		storage_.DeleteClientSaveData(client_info.fd);
 		result.is_response_complete = true;
 	}
@@ -127,11 +310,11 @@ HttpResult Http::CreateHttpResponse(
 }
 
 HttpResult Http::GetErrorResponse(int client_fd, ErrorState state) {
-	HttpResult            result;
-	HttpRequestParsedData data  = storage_.GetClientSaveData(client_fd);
+	HttpResult             result;
+	HttpRequestParsedData &data = storage_.GetClientSaveData(client_fd);
 	result.is_response_complete = true;
 	result.is_connection_keep   = false;
-	result.request_buf          = data.current_buf;
+	result.request_buf.swap(data.current_buf);
 	switch (state) {
 	case TIMEOUT:
 		result.response = HttpResponse::CreateErrorResponse(StatusCode(REQUEST_TIMEOUT));
@@ -139,6 +322,12 @@ HttpResult Http::GetErrorResponse(int client_fd, ErrorState state) {
 	case INTERNAL_ERROR:
 		result.response = HttpResponse::CreateErrorResponse(StatusCode(INTERNAL_SERVER_ERROR));
 		break;
+	case UPSTREAM_ERROR:
+		result.response = HttpResponse::CreateErrorResponse(StatusCode(BAD_GATEWAY));
+		break;
+	case UPSTREAM_TIMEOUT:
+		result.response = HttpResponse::CreateErrorResponse(StatusCode(GATEWAY_TIMEOUT));
+		break;
 	default:
 		break;
 	}
@@ -146,22 +335,80 @@ HttpResult Http::GetErrorResponse(int client_fd, ErrorState state) {
 	return result;
 }
 
-HttpResult Http::CreateBadRequestResponse(int client_fd) {
-	HttpResult            result;
-	HttpRequestParsedData data  = storage_.GetClientSaveData(client_fd);
+// parse中のエラー(400, 414, 431, bodyを読む前に判定した413, 417)
+HttpResult Http::CreateParseErrorResponse(int client_fd) {
+	HttpResult             result;
+	HttpRequestParsedData &data = storage_.GetClientSaveData(client_fd);
 	result.is_response_complete = true;
 	result.is_connection_keep   = false;
-	result.request_buf          = data.current_buf;
-	result.response             = HttpResponse::CreateErrorResponse(StatusCode(BAD_REQUEST));
+	result.request_buf.swap(data.current_buf);
+	result.response = HttpResponse::CreateErrorResponse(data.request_result.status_code);
 	storage_.DeleteClientSaveData(client_fd);
 	return result;
 }
 
 bool Http::IsHttpRequestFormatComplete(int client_fd) {
-	HttpRequestParsedData save_data = storage_.GetClientSaveData(client_fd);
+	const HttpRequestParsedData &save_data = storage_.GetClientSaveData(client_fd);
 	return save_data.is_request_format.is_request_line &&
 		   save_data.is_request_format.is_header_fields &&
 		   save_data.is_request_format.is_body_message;
 }
 
+void Http::DeleteClient(int client_fd) {
+	if (storage_.IsClientSaveData(client_fd)) {
+		storage_.DeleteClientSaveData(client_fd);
+	}
+}
+
+// reloadで使われなくなったvirtual serverのcache(同じaddressのvirtual serverが後で作られても使わない)
+void Http::DeleteCgiCache(const server::VirtualServer *virtual_server) {
+	const CgiCacheMap::iterator it = cgi_caches_.find(virtual_server);
+	if (it == cgi_caches_.end()) {
+		return;
+	}
+	delete it->second;
+	cgi_caches_.erase(it);
+}
+
+CgiCache &Http::GetCgiCache(const server::VirtualServer *virtual_server) {
+	CgiCacheMap::const_iterator it = cgi_caches_.find(virtual_server);
+	if (it != cgi_caches_.end()) {
+		return *it->second;
+	}
+	CgiCache *cgi_cache         = new CgiCache(virtual_server->GetCgiCacheSize());
+	cgi_caches_[virtual_server] = cgi_cache;
+	return *cgi_cache;
+}
+
+CgiCache::GetResult Http::GetCgiCacheData(const CgiCacheInfo &cache_info) {
+	CgiCache::GetResult result;
+	if (!cache_info.is_cacheable || cache_info.virtual_server == NULL) {
+		result.Set(false);
+		return result;
+	}
+	result = GetCgiCache(cache_info.virtual_server).Get(cache_info.key, std::time(NULL));
+	if (result.IsOk()) {
+		utils::Debug("CgiCache", "hit " + cache_info.key);
+	}
+	return result;
+}
+
+void Http::SetCgiCacheData(const CgiCacheInfo &cache_info, const CgiParsedData &parsed) {
+	if (!IsCgiCacheable(cache_info, parsed)) {
+		return;
+	}
+	const CgiCache::TtlResult ttl =
+		CgiCache::GetTtl(parsed.header_fields, cache_info.cache_valid);
+	GetCgiCache(cache_info.virtual_server)
+		.Set(cache_info.key, parsed, ttl.GetValue(), std::time(NULL));
+}
+
+// Cache-Control, Set-Cookieを見て他のclientと共有して良いresponseか
+bool Http::IsCgiCacheable(const CgiCacheInfo &cache_info, const CgiParsedData &parsed) {
+	if (!cache_info.is_cacheable || cache_info.virtual_server == NULL) {
+		return false;
+	}
+	return CgiCache::GetTtl(parsed.header_fields, cache_info.cache_valid).IsOk();
+}
+
 } // namespace http
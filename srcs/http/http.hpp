@@ -2,10 +2,12 @@
 #define HTTP_HPP_
 
 #include "IHttp.hpp"
+#include "cgi_cache.hpp"
 #include "http_parse.hpp"
 #include "http_response.hpp"
 #include "http_storage.hpp"
 #include "result.hpp"
+#include <map>
 
 namespace http {
 
@@ -14,23 +16,80 @@ struct HttpResult;
 
 class Http : public IHttp {
   public:
+	typedef cgi::CgiResponseParse::ParsedData CgiParsedData;
+	// 同じcgiを待っている他のclientにも返せるcgiのresponse(parse済み)
+	typedef utils::Result<CgiParsedData> SharedCgiResponse;
+
 	Http();
 	~Http();
 	HttpResult
 	Run(const ClientInfos &client_info, const server::VirtualServerAddrList &server_info);
 	HttpResult GetErrorResponse(int client_fd, ErrorState state);
-	HttpResult GetResponseFromCgi(int client_fd, const cgi::CgiResponse &cgi_response);
+	HttpResult GetResponseFromCgi(
+		const ClientInfos                   &client_info,
+		const server::VirtualServerAddrList &server_info,
+		const cgi::CgiResponse              &cgi_response
+	);
+	HttpResult GetResponseFromCgi(
+		const ClientInfos                   &client_info,
+		const server::VirtualServerAddrList &server_info,
+		const cgi::CgiResponse              &cgi_response,
+		SharedCgiResponse                   &shared_response
+	);
+	HttpResult GetSharedResponseFromCgi(
+		const ClientInfos                   &client_info,
+		const server::VirtualServerAddrList &server_info,
+		const CgiParsedData                 &parsed
+	);
+	void DeleteCgiCache(const server::VirtualServer *virtual_server);
+	// 途中まで受け取ったrequestを捨てる。保存していないclientでも投げない
+	void DeleteClient(int client_fd);
 
   private:
+	// virtual server毎にcgiのresponseを保持
+	typedef std::map<const server::VirtualServer *, CgiCache *> CgiCacheMap;
+
 	Http(const Http &other);
 	Http               &operator=(const Http &other);
 	HttpStorage         storage_;
-	utils::Result<void> ParseHttpRequestFormat(int client_fd, const std::string &read_buf);
+	CgiCacheMap         cgi_caches_;
+	utils::Result<void> ParseHttpRequestFormat(
+		const ClientInfos &client_info, const server::VirtualServerAddrList &server_info
+	);
+	static void PrepareConnection(
+		HttpRequestParsedData               &data,
+		const ClientInfos                   &client_info,
+		const server::VirtualServerAddrList &server_info
+	);
+	static HttpStatus
+	PrepareBodyMessage(HttpRequestParsedData &data, const server::VirtualServerAddrList &server_info);
 	HttpResult          CreateHttpResponse(
 				 const ClientInfos &client_info, const server::VirtualServerAddrList &server_info
 			 );
-	HttpResult CreateBadRequestResponse(int client_fd);
+	HttpResult DispatchRequest(
+		const ClientInfos                   &client_info,
+		const server::VirtualServerAddrList &server_info,
+		HttpRequestParsedData               &data
+	);
+	HttpResult CreateParseErrorResponse(int client_fd);
 	bool       IsHttpRequestFormatComplete(int client_fd);
+	HttpResult CreateCgiHttpResult(
+		const ClientInfos                   &client_info,
+		const server::VirtualServerAddrList &server_info,
+		HttpRequestParsedData               &data,
+		const CgiParsedData                 &parsed
+	);
+	HttpResult InternalRedirect(
+		const ClientInfos                   &client_info,
+		const server::VirtualServerAddrList &server_info,
+		HttpRequestParsedData               &data,
+		const std::string                   &location
+	);
+	// cgi cache
+	CgiCache           &GetCgiCache(const server::VirtualServer *virtual_server);
+	CgiCache::GetResult GetCgiCacheData(const CgiCacheInfo &cache_info);
+	void SetCgiCacheData(const CgiCacheInfo &cache_info, const CgiParsedData &parsed);
+	static bool IsCgiCacheable(const CgiCacheInfo &cache_info, const CgiParsedData &parsed);
 };
 
 } // namespace http
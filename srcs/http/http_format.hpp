@@ -1,6 +1,7 @@
 #ifndef HTTP_FORMAT_HPP_
 #define HTTP_FORMAT_HPP_
 
+#include "request_header_fields.hpp"
 #include <map>
 #include <string>
 
@@ -23,12 +24,13 @@ struct StatusLine {
 	std::string reason_phrase;
 };
 
+// responseのheaderはfield-nameの順に出力するのでstd::mapのまま
 typedef std::map<std::string, std::string> HeaderFields;
 
 struct HttpRequestFormat {
-	RequestLine  request_line;
-	HeaderFields header_fields;
-	std::string  body_message;
+	RequestLine         request_line;
+	RequestHeaderFields header_fields;
+	std::string         body_message;
 };
 
 struct HttpResponseFormat {
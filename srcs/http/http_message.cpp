@@ -13,6 +13,7 @@ const std::string SERVER_VERSION      = "webserv/1.1";
 const std::string GET                       = "GET";
 const std::string DELETE                    = "DELETE";
 const std::string POST                      = "POST";
+const std::string HEAD                      = "HEAD";
 const std::string DEFAULT_METHODS[]         = {GET, DELETE, POST};
 const std::size_t DEFAULT_METHODS_SIZE      = sizeof(DEFAULT_METHODS) / sizeof(DEFAULT_METHODS[0]);
 const std::string DEFAULT_ALLOWED_METHODS[] = {GET};
@@ -40,6 +41,10 @@ const std::string TRANSFER_ENCODING        = "transfer-encoding";
 const std::string CHUNKED                  = "chunked";
 const std::string LOCATION                 = "location";
 const std::string AUTHORIZATION            = "authorization";
+const std::string CACHE_CONTROL            = "cache-control";
+const std::string EXPECT                   = "expect";
+const std::string CONTINUE_EXPECTATION     = "100-continue";
+const std::string X_FORWARDED_FOR          = "x-forwarded-for";
 const std::string REQUEST_HEADER_FIELDS[]  = {
     HOST,
     USER_AGENT,
@@ -56,7 +61,9 @@ const std::size_t REQUEST_HEADER_FIELDS_SIZE =
 	sizeof(REQUEST_HEADER_FIELDS) / sizeof(REQUEST_HEADER_FIELDS[0]);
 
 // response header fields
-const std::string SERVER = "server";
+const std::string SERVER     = "server";
+const std::string DATE       = "date";
+const std::string SET_COOKIE = "set-cookie";
 
 // For multipart/form-data header fields
 const std::string CONTENT_DISPOSITION = "Content-Disposition";
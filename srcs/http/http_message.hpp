@@ -16,6 +16,7 @@ extern const std::string SERVER_VERSION;
 extern const std::string GET;
 extern const std::string DELETE;
 extern const std::string POST;
+extern const std::string HEAD;
 extern const std::string DEFAULT_METHODS[];
 extern const std::size_t DEFAULT_METHODS_SIZE;
 extern const std::string DEFAULT_ALLOWED_METHODS[];
@@ -42,10 +43,16 @@ extern const std::string TRANSFER_ENCODING;
 extern const std::string CHUNKED;
 extern const std::string LOCATION;
 extern const std::string AUTHORIZATION;
+extern const std::string CACHE_CONTROL;
+extern const std::string EXPECT;
+extern const std::string CONTINUE_EXPECTATION;
+extern const std::string X_FORWARDED_FOR;
 extern const std::string REQUEST_HEADER_FIELDS[];
 extern const std::size_t REQUEST_HEADER_FIELDS_SIZE;
 
 extern const std::string SERVER;
+extern const std::string DATE;
+extern const std::string SET_COOKIE;
 
 extern const std::string CONTENT_DISPOSITION;
 extern const std::string FILENAME;
@@ -1,9 +1,17 @@
 #ifndef HTTP_RESULT_HPP_
 #define HTTP_RESULT_HPP_
 
+#include "cgi_cache_info.hpp"
 #include "cgi_request.hpp"
+#include <list>
 #include <string>
 
+namespace server {
+
+struct ConnectionLimits;
+
+} // namespace server
+
 namespace http {
 
 struct CgiResult {
@@ -11,16 +19,36 @@ struct CgiResult {
 
 	bool            is_cgi;
 	cgi::CgiRequest cgi_request;
+	CgiCacheInfo    cache_info;
+};
+
+struct ProxyResult {
+	typedef std::pair<std::string, unsigned int> IpPortPair;
+	typedef std::list<IpPortPair>                UpstreamList;
+
+	ProxyResult() : is_proxy(false), is_head_request(false), is_idempotent(false) {}
+
+	bool         is_proxy;
+	UpstreamList upstreams; // locationのproxy_pass
+	std::string  balance;   // round_robin or least_conn
+	std::string  request;   // upstreamに送るrequest
+	bool         is_head_request;
+	bool         is_idempotent; // 送り直しても結果が変わらないmethodか
 };
 
 struct HttpResult {
-	HttpResult() : is_response_complete(false), is_connection_keep(true) {}
+	HttpResult()
+		: is_response_complete(false), is_connection_keep(true), connection_limits(NULL) {}
 
 	bool        is_response_complete;
 	bool        is_connection_keep;
 	std::string request_buf;
 	std::string response;
+	std::string interim_response; // 最終responseの前に送る1xx(Expect: 100-continue)
 	CgiResult   cgi_result;
+	ProxyResult proxy_result;
+	// header fieldsを読み終えていればlocationのtimeout, keepalive_requests(まだならNULL)
+	const server::ConnectionLimits *connection_limits;
 };
 
 } // namespace http
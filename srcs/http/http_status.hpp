@@ -0,0 +1,35 @@
+#ifndef HTTP_STATUS_HPP_
+#define HTTP_STATUS_HPP_
+
+#include "status_code.hpp"
+
+namespace http {
+
+// requestの内容で決まるエラー(3xx, 4xx)を例外を使わずに返すための結果
+// messageは文字列リテラルを指すだけなので、エラーの時もallocationしない
+// システムの失敗(500)はこれまで通りHttpExceptionで投げる
+class HttpStatus {
+  public:
+	HttpStatus() : is_ok_(true), status_code_(OK), message_("") {}
+	HttpStatus(EStatusCode status_code, const char *message)
+		: is_ok_(false), status_code_(status_code), message_(message) {}
+
+	bool IsOk() const {
+		return is_ok_;
+	}
+	EStatusCode GetStatusCode() const {
+		return status_code_;
+	}
+	const char *GetMessage() const {
+		return message_;
+	}
+
+  private:
+	bool        is_ok_;
+	EStatusCode status_code_;
+	const char *message_;
+};
+
+} // namespace http
+
+#endif
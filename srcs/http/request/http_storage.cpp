@@ -13,25 +13,16 @@ void HttpStorage::CreateClientSaveData(int client_fd) {
 }
 
 // ClientSaveDataが存在するかを確認する関数
-bool HttpStorage::IsClientSaveData(int client_fd) {
+bool HttpStorage::IsClientSaveData(int client_fd) const {
 	return save_data_.find(client_fd) != save_data_.end();
 }
 
 // ClientSaveDataを取得する関数
-const HttpRequestParsedData &HttpStorage::GetClientSaveData(int client_fd) {
+HttpRequestParsedData &HttpStorage::GetClientSaveData(int client_fd) {
 	if (!IsClientSaveData(client_fd)) {
 		CreateClientSaveData(client_fd);
 	}
-	return save_data_.at(client_fd);
-}
-
-// クライアント情報を更新する関数
-void HttpStorage::UpdateClientSaveData(int client_fd, const HttpRequestParsedData &client_data) {
-	if (IsClientSaveData(client_fd)) {
-		save_data_[client_fd] = client_data;
-	} else {
-		throw std::logic_error("HttpRequestParsedData doesn't exists.");
-	}
+	return save_data_[client_fd];
 }
 
 // クライアント情報を削除する関数
@@ -11,11 +11,12 @@ class HttpStorage {
 	HttpStorage();
 	~HttpStorage();
 	// Get
-	const HttpRequestParsedData &GetClientSaveData(int client_fd);
-	// Update
-	void UpdateClientSaveData(int client_fd, const HttpRequestParsedData &client_data);
+	// 返す参照はDeleteされるまで有効なので、呼び出し側はコピーせずにそのまま書き換える
+	HttpRequestParsedData &GetClientSaveData(int client_fd);
 	// Delete
 	void DeleteClientSaveData(int client_fd);
+	// Check
+	bool IsClientSaveData(int client_fd) const;
 
   private:
 	HttpStorage(const HttpStorage &other);
@@ -25,8 +26,6 @@ class HttpStorage {
 	ClientSaveDataMap                            save_data_;
 	// Create
 	void CreateClientSaveData(int client_fd);
-	// Check
-	bool IsClientSaveData(int client_fd);
 };
 
 } // namespace http
@@ -1,18 +1,20 @@
 #include "http_parse.hpp"
 #include "http_message.hpp"
+#include "scan.hpp"
 #include "utils.hpp"
-#include <algorithm> // std::find
-#include <vector>
+#include <algorithm> // min
+#include <cctype>    // isspace
+#include <limits>    // numeric_limits
 
 namespace http {
 namespace {
 
-void ValidateVCharInStr(const std::string &target, const std::string &target_name) {
+// messageはtargetにVCHAR以外が含まれていた時のもの
+HttpStatus ValidateVCharInStr(const std::string &target, const char *message) {
 	if (!utils::IsVString(target)) {
-		throw HttpException(
-			"Error: the " + target_name + " contains non-VCHR characters.", StatusCode(BAD_REQUEST)
-		);
+		return HttpStatus(BAD_REQUEST, message);
 	}
+	return HttpStatus();
 }
 
 bool IsUsAscii(int c) {
@@ -29,17 +31,77 @@ bool IsStringUsAscii(const std::string &str) {
 	return true;
 }
 
-bool IsStringUpper(const std::string &str) {
-	typedef std::string::const_iterator It;
-	for (It it = str.begin(); it != str.end(); ++it) {
-		if (!std::isupper(static_cast<unsigned char>(*it))) {
-			return false;
+bool IsOws(char c) {
+	return c == ' ' || c == '\t';
+}
+
+// header行のCRLF以外の1byteを見てcolonとfield-valueの範囲を更新
+void TrackHeaderByte(HttpParseState &state, char c, std::size_t offset) {
+	if (state.colon == std::string::npos) {
+		if (c == ':') {
+			state.colon = offset;
 		}
+		return;
 	}
-	return true;
+	if (IsOws(c)) {
+		return;
+	}
+	if (state.value_begin == std::string::npos) {
+		state.value_begin = offset;
+	}
+	state.value_end = offset + 1;
 }
 
-bool IsBodyMessageReadingRequired(const HeaderFields &header_fields) {
+// colonより後ろのCRを含まない範囲[begin, end)をまとめて見てfield-valueの範囲を更新
+void TrackHeaderValue(
+	HttpParseState &state, const std::string &buf, std::size_t begin, std::size_t end
+) {
+	while (begin < end && IsOws(buf[begin])) {
+		++begin;
+	}
+	if (begin == end) {
+		return;
+	}
+	while (IsOws(buf[end - 1])) {
+		--end;
+	}
+	if (state.value_begin == std::string::npos) {
+		state.value_begin = begin;
+	}
+	state.value_end = end;
+}
+
+// header行のCRまでを読み進めてCRの位置を返す(CRがまだ来ていなければbuf.size())
+std::size_t SkipHeaderBytes(HttpParseState &state, const std::string &buf) {
+	std::size_t pos = state.pos;
+	if (state.colon == std::string::npos) {
+		pos = utils::scan::FindEitherByte(buf, '\r', ':', pos);
+		if (pos == std::string::npos) {
+			return buf.size();
+		}
+		if (buf[pos] == '\r') {
+			return pos;
+		}
+		state.colon = pos;
+		++pos;
+	}
+	std::size_t cr = utils::scan::FindByte(buf, '\r', pos);
+	if (cr == std::string::npos) {
+		cr = buf.size();
+	}
+	TrackHeaderValue(state, buf, pos, cr);
+	return cr;
+}
+
+void ResetHeaderLine(HttpParseState &state, std::size_t line_begin) {
+	state.phase       = HttpParseState::HEADER_LINE;
+	state.line_begin  = line_begin;
+	state.colon       = std::string::npos;
+	state.value_begin = std::string::npos;
+	state.value_end   = std::string::npos;
+}
+
+bool IsBodyMessageReadingRequired(const RequestHeaderFields &header_fields) {
 	if (header_fields.find(CONTENT_LENGTH) == header_fields.end() &&
 		header_fields.find(TRANSFER_ENCODING) == header_fields.end()) {
 		return false;
@@ -47,16 +109,6 @@ bool IsBodyMessageReadingRequired(const HeaderFields &header_fields) {
 	return true;
 }
 
-// 大文字と小文字は区別なし
-utils::Result<int> HexToDec(const std::string &hex_str) {
-	std::istringstream iss(hex_str);
-	int                decimal_value;
-	if (!(iss >> std::hex >> decimal_value) || decimal_value < 0) {
-		return utils::Result<int>(false, -1);
-	}
-	return utils::Result<int>(decimal_value);
-}
-
 bool HasSpace(const std::string &str) {
 	for (std::string::const_iterator it = str.begin(); it != str.end(); ++it) {
 		if (std::isspace(*it)) {
@@ -66,93 +118,188 @@ bool HasSpace(const std::string &str) {
 	return false;
 }
 
-typedef utils::Result<std::pair<std::string::size_type, std::string> > ChunkSizeResult;
-typedef utils::Result<std::string>                                     ChunkDataResult;
+const std::size_t CHUNK_SIZE_DIGITS_MAX = 8;    // INT_MAX: 0x7FFFFFFF
+const std::size_t CHUNK_LINE_SIZE_MAX   = 4096; // chunk-size + chunk-ext
+const std::size_t TRAILER_SIZE_MAX      = 8192;
 
-ChunkSizeResult GetChunkSizeStr(const std::string &current_buf) {
-	ChunkSizeResult result;
+int HexDigitToInt(char c) {
+	if (c >= '0' && c <= '9') {
+		return c - '0';
+	}
+	if (c >= 'a' && c <= 'f') {
+		return c - 'a' + 10;
+	}
+	if (c >= 'A' && c <= 'F') {
+		return c - 'A' + 10;
+	}
+	return -1;
+}
 
-	const std::string::size_type end_of_chunk_size_pos = current_buf.find(CRLF);
-	if (end_of_chunk_size_pos == std::string::npos) {
-		if (current_buf.size() > 10) { // INT_MAX: 0x7FFFFFFF(10digits)
-			throw HttpException("Error: incorrect chunk size", StatusCode(BAD_REQUEST));
-		}
-		result.Set(false);
-		return result;
+HttpStatus BadChunk(const char *message) {
+	return HttpStatus(BAD_REQUEST, message);
+}
+
+HttpStatus HeaderFieldsTooLarge(const char *message) {
+	return HttpStatus(REQUEST_HEADER_FIELDS_TOO_LARGE, message);
+}
+
+// size_maxにはCRLFを含まないので、CRLFの分だけ余裕を持たせて比べる
+bool IsOverSizeMax(std::size_t size, std::size_t size_max) {
+	return size > size_max && size - size_max > CRLF.size();
+}
+
+// read_end: header fieldsの先頭から読み終えたbyte数
+HttpStatus CheckHeaderSize(const HttpParseState &state, std::size_t read_end) {
+	if (IsOverSizeMax(read_end - state.line_begin, state.header_line_size_max)) {
+		return HeaderFieldsTooLarge("Error: header field line is too long");
 	}
-	const std::string chunk_size_str = current_buf.substr(0, end_of_chunk_size_pos);
-	if (!HexToDec(chunk_size_str).IsOk()) {
-		throw HttpException(
-			"Error: chunk size is not a hexadecimal number", StatusCode(BAD_REQUEST)
-		);
+	if (IsOverSizeMax(read_end, state.header_size_max)) {
+		return HeaderFieldsTooLarge("Error: header fields are too large");
 	}
-	result.SetValue(std::make_pair(end_of_chunk_size_pos, chunk_size_str));
-	return result;
+	return HttpStatus();
 }
 
-ChunkDataResult GetChunkData(
-	const std::string     &current_buf,
-	std::string::size_type end_of_chunk_size_pos,
-	std::size_t            chunk_size
-) {
-	ChunkDataResult result;
-
-	// "chunk_size\r\n"の次の文字からfind
-	const std::string::size_type end_of_chunk_data_pos =
-		current_buf.find(CRLF, end_of_chunk_size_pos + CRLF.size());
-	if (end_of_chunk_data_pos == std::string::npos) {
-		// CRLFがないかつ"3\r\nXXX\rX"のようにchunk_date以降が(chunk_size+1)より多かったら早期に400
-		if (current_buf.size() > end_of_chunk_size_pos + CRLF.size() + chunk_size + 1) {
-			throw HttpException(
-				"Error: Missing or incorrect chunked transfer encoding terminator",
-				StatusCode(BAD_REQUEST)
-			);
+HttpStatus PayloadTooLarge() {
+	return HttpStatus(PAYLOAD_TOO_LARGE, "Error: request body exceeds client_max_body_size");
+}
+
+// chunk-ext = *( BWS ";" BWS chunk-ext-name [ BWS "=" BWS chunk-ext-val ] )
+// 値は使わないので、';'から始まっていてVCHAR, SP, HTABだけで出来ていればよい
+HttpStatus ValidateChunkExtension(const std::string &buf, std::size_t begin, std::size_t end) {
+	while (begin < end && IsOws(buf[begin])) {
+		++begin;
+	}
+	if (begin == end) {
+		return HttpStatus();
+	}
+	if (buf[begin] != ';') {
+		return BadChunk("Error: chunk size is not a hexadecimal number");
+	}
+	for (std::size_t i = begin; i < end; ++i) {
+		const unsigned char c = static_cast<unsigned char>(buf[i]);
+		if ((c < 0x20 && c != '\t') || c == 0x7f) {
+			return BadChunk("Error: invalid chunk extension");
 		}
-		result.Set(false);
-		return result;
 	}
-	const std::string chunk_data = current_buf.substr(
-		end_of_chunk_size_pos + CRLF.size(),
-		end_of_chunk_data_pos - end_of_chunk_size_pos - CRLF.size()
-	);
-	result.SetValue(chunk_data);
-	return result;
+	return HttpStatus();
 }
 
-void ThrowMissingHostHeaderField(const HeaderFields &header_fields) {
-	if (header_fields.count(HOST) == 0) {
-		throw HttpException("Error: missing Host header field.", StatusCode(BAD_REQUEST));
+// beginから始まる"chunk-size [ chunk-ext ] CRLF"を読む
+// 行が揃っていればchunk_sizeとchunk-dataの先頭をセットしてis_completeをtrueにする
+HttpStatus ParseChunkSizeLine(
+	const std::string &buf,
+	std::size_t        begin,
+	bool              &is_complete,
+	std::size_t       &chunk_size,
+	std::size_t       &data_begin
+) {
+	is_complete = false;
+	std::size_t digits_begin = begin;
+	// 先頭の"0x"は読み飛ばす
+	if (buf.compare(begin, 2, "0x") == 0 || buf.compare(begin, 2, "0X") == 0) {
+		digits_begin += 2;
+	}
+	std::size_t value = 0;
+	std::size_t pos   = digits_begin;
+	for (; pos < buf.size() && HexDigitToInt(buf[pos]) >= 0; ++pos) {
+		if (pos - digits_begin == CHUNK_SIZE_DIGITS_MAX) {
+			return BadChunk("Error: incorrect chunk size");
+		}
+		value = value * 16 + HexDigitToInt(buf[pos]);
 	}
+	if (pos == buf.size()) {
+		return HttpStatus();
+	}
+	if (pos == digits_begin || !(buf[pos] == ';' || IsOws(buf[pos]) || buf[pos] == '\r')) {
+		return BadChunk("Error: chunk size is not a hexadecimal number");
+	}
+	if (value > static_cast<std::size_t>(std::numeric_limits<int>::max())) {
+		return BadChunk("Error: incorrect chunk size");
+	}
+	const std::size_t line_end = utils::scan::FindCrlf(buf, pos);
+	if (line_end == std::string::npos) {
+		if (buf.size() - begin > CHUNK_LINE_SIZE_MAX) {
+			return BadChunk("Error: too long chunk extension");
+		}
+		return HttpStatus();
+	}
+	if (line_end - begin > CHUNK_LINE_SIZE_MAX) {
+		return BadChunk("Error: too long chunk extension");
+	}
+	const HttpStatus status = ValidateChunkExtension(buf, pos, line_end);
+	if (!status.IsOk()) {
+		return status;
+	}
+	is_complete = true;
+	chunk_size  = value;
+	data_begin  = line_end + CRLF.size();
+	return HttpStatus();
 }
 
-void ThrowMissingContentTypeHeaderField(const HeaderFields &header_fields) {
-	if (!header_fields.count(CONTENT_TYPE)) {
-		throw HttpException("Error: missing Content-Type header field.", StatusCode(BAD_REQUEST));
+// trailer-section = *( field-line CRLF ) CRLF
+// 中身は使わずに読み捨てる。空行まで揃っていれば次の位置をセットしてis_completeをtrueにする
+HttpStatus SkipTrailerSection(
+	const std::string &buf, std::size_t begin, bool &is_complete, std::size_t &end
+) {
+	is_complete     = false;
+	std::size_t pos = begin;
+	while (true) {
+		std::size_t name_end = utils::scan::FindEitherByte(buf, ':', '\r', pos);
+		if (name_end == std::string::npos) {
+			name_end = buf.size();
+		}
+		// field-nameの部分は行が揃う前でもtokenでなければ400
+		if (!utils::scan::IsToken(buf.substr(pos, name_end - pos))) {
+			return BadChunk("Error: invalid trailer field");
+		}
+		const std::size_t line_end = utils::scan::FindCrlf(buf, pos);
+		if (std::min(line_end, buf.size()) - begin > TRAILER_SIZE_MAX) {
+			return BadChunk("Error: too large trailer section");
+		}
+		if (line_end == std::string::npos) {
+			return HttpStatus();
+		}
+		if (line_end == pos) {
+			is_complete = true;
+			end         = line_end + CRLF.size();
+			return HttpStatus();
+		}
+		if (name_end == pos || buf[name_end] != ':') {
+			return BadChunk("Error: invalid trailer field");
+		}
+		pos = line_end + CRLF.size();
 	}
 }
 
-void ThrowMissingBodyRequiredHeaderField(const HeaderFields &header_fields) {
+HttpStatus ValidateBodyRequiredHeaderField(const RequestHeaderFields &header_fields) {
 	if (!IsBodyMessageReadingRequired(header_fields)) {
-		throw HttpException(
-			"Error: missing either Content-Length or Transfer-Encoding header field.",
-			StatusCode(BAD_REQUEST)
+		return HttpStatus(
+			BAD_REQUEST, "Error: missing either Content-Length or Transfer-Encoding header field."
 		);
 	}
 	// Transfer-Encodingのみ存在する場合、そのheader-field-valueがchunked以外はエラー
 	if (header_fields.count(TRANSFER_ENCODING) && header_fields.at(TRANSFER_ENCODING) != CHUNKED) {
-		throw HttpException(
-			"Error: invalid value for the Transfer-Encoding header; only chunked is allowed.",
-			StatusCode(BAD_REQUEST)
+		return HttpStatus(
+			BAD_REQUEST,
+			"Error: invalid value for the Transfer-Encoding header; only chunked is allowed."
 		);
 	}
+	return HttpStatus();
 }
 
-void ValidateInvalidHeaderFields(const HeaderFields &header_fields, const std::string &method) {
-	ThrowMissingHostHeaderField(header_fields);
+HttpStatus ValidateInvalidHeaderFields(
+	const RequestHeaderFields &header_fields, const std::string &method
+) {
+	if (header_fields.count(HOST) == 0) {
+		return HttpStatus(BAD_REQUEST, "Error: missing Host header field.");
+	}
 	if (method == POST) {
-		ThrowMissingContentTypeHeaderField(header_fields);
-		ThrowMissingBodyRequiredHeaderField(header_fields);
+		if (!header_fields.count(CONTENT_TYPE)) {
+			return HttpStatus(BAD_REQUEST, "Error: missing Content-Type header field.");
+		}
+		return ValidateBodyRequiredHeaderField(header_fields);
 	}
+	return HttpStatus();
 }
 
 // Boundary以外のContent-Typeヘッダーを小文字に変換
@@ -181,66 +328,183 @@ std::string ToLowerContentTypeHeaderExceptBoundary(const std::string &header_fie
 
 } // namespace
 
-void HttpParse::ParseRequestLine(HttpRequestParsedData &data) {
+HttpParseState::HttpParseState()
+	: phase(REQUEST_LINE),
+	  pos(0),
+	  line_begin(0),
+	  sp_count(0),
+	  first_sp(std::string::npos),
+	  second_sp(std::string::npos),
+	  colon(std::string::npos),
+	  value_begin(std::string::npos),
+	  value_end(std::string::npos),
+	  content_length(0),
+	  body_size_max(std::numeric_limits<std::size_t>::max()),
+	  request_line_size_max(std::numeric_limits<std::size_t>::max()),
+	  header_line_size_max(std::numeric_limits<std::size_t>::max()),
+	  header_size_max(std::numeric_limits<std::size_t>::max()),
+	  header_count_max(std::numeric_limits<std::size_t>::max()),
+	  header_count(0) {}
+
+HttpStatus HttpParse::ParseRequestLine(HttpRequestParsedData &data) {
 	if (data.is_request_format.is_request_line) {
-		return;
-	}
-	size_t pos = data.current_buf.find(CRLF);
-	if (pos == std::string::npos) {
-		return;
+		return HttpStatus();
+	}
+	HttpParseState    &state = data.parse_state;
+	const std::string &buf   = data.current_buf;
+	for (; state.pos < buf.size(); ++state.pos) {
+		if (state.phase == HttpParseState::REQUEST_LINE) {
+			// 区切り文字(CR, SP)以外は読み飛ばす
+			state.pos = utils::scan::FindEitherByte(buf, '\r', ' ', state.pos);
+			if (state.pos == std::string::npos) {
+				state.pos = buf.size();
+				break;
+			}
+		}
+		const char c = buf[state.pos];
+		if (state.phase == HttpParseState::REQUEST_LINE_LF) {
+			if (c == '\n') {
+				break;
+			}
+			// LFが続かないCRは普通の文字として扱う(VCHARのチェックで弾かれる)
+			state.phase = HttpParseState::REQUEST_LINE;
+		}
+		if (c == '\r') {
+			state.phase = HttpParseState::REQUEST_LINE_LF;
+		} else if (c == ' ') {
+			++state.sp_count;
+			if (state.first_sp == std::string::npos) {
+				state.first_sp = state.pos;
+			} else if (state.second_sp == std::string::npos) {
+				state.second_sp = state.pos;
+			}
+		}
 	}
-	std::string request_line = data.current_buf.substr(0, pos);
-	data.current_buf.erase(0, pos + CRLF.size());
-	data.request_result.request.request_line = SetRequestLine(utils::SplitStr(request_line, SP));
+	// request lineの終わりが来なくても上限を超えた時点で414
+	const std::size_t read_size = (state.pos == buf.size()) ? buf.size() : state.pos + 1;
+	if (IsOverSizeMax(read_size, state.request_line_size_max)) {
+		data.current_buf.erase(0, state.pos);
+		return HttpStatus(URI_TOO_LONG, "Error: request line is too long");
+	}
+	if (state.pos == buf.size()) {
+		return HttpStatus();
+	}
+	// buf[state.pos]がrequest line終わりのLF
+	const std::size_t line_end = state.pos - 1;
+	++state.pos;
+	RequestLine      request_line;
+	const HttpStatus status = SetRequestLine(buf, state, line_end, request_line);
+	// request lineの分だけ消してheader fieldsはcurrent_bufの先頭から読む
+	data.current_buf.erase(0, state.pos);
+	if (!status.IsOk()) {
+		return status;
+	}
+	data.request_result.request.request_line = request_line;
 	data.is_request_format.is_request_line   = true;
+	state.pos                                = 0;
+	ResetHeaderLine(state, 0);
+	return HttpStatus();
 }
 
-void HttpParse::ParseHeaderFields(HttpRequestParsedData &data) {
+HttpStatus HttpParse::ParseHeaderFields(HttpRequestParsedData &data) {
 	if (!data.is_request_format.is_request_line) {
-		return;
+		return HttpStatus();
 	}
 	if (data.is_request_format.is_header_fields) {
-		return;
+		return HttpStatus();
+	}
+	HttpParseState      &state         = data.parse_state;
+	const std::string   &buf           = data.current_buf;
+	RequestHeaderFields &header_fields = data.request_result.request.header_fields;
+	for (; state.pos < buf.size(); ++state.pos) {
+		if (state.phase == HttpParseState::HEADER_LINE) {
+			state.pos = SkipHeaderBytes(state, buf);
+			if (state.pos == buf.size()) {
+				break;
+			}
+		}
+		const char c = buf[state.pos];
+		if (state.phase == HttpParseState::HEADER_LINE_LF) {
+			if (c == '\n') {
+				const HttpStatus size_status = CheckHeaderSize(state, state.pos + 1);
+				if (!size_status.IsOk()) {
+					return size_status;
+				}
+				// 空行ならheader fieldsの終わり
+				if (state.pos - 1 == state.line_begin) {
+					++state.pos;
+					return FinishHeaderFields(data);
+				}
+				if (++state.header_count > state.header_count_max) {
+					return HeaderFieldsTooLarge("Error: too many header fields");
+				}
+				if (state.header_error.IsOk()) {
+					state.header_error = SetHeaderField(header_fields, buf, state);
+				}
+				ResetHeaderLine(state, state.pos + 1);
+				continue;
+			}
+			// LFが続かないCRは普通の文字として扱う(VCHARのチェックで弾かれる)
+			state.phase = HttpParseState::HEADER_LINE;
+			TrackHeaderByte(state, '\r', state.pos - 1);
+		}
+		if (c == '\r') {
+			state.phase = HttpParseState::HEADER_LINE_LF;
+		} else {
+			TrackHeaderByte(state, c, state.pos);
+		}
 	}
-	size_t pos = data.current_buf.find(HEADER_FIELDS_END);
-	if (pos == std::string::npos) {
-		return;
+	// 行の終わりが来ていなくても上限を超えていれば431
+	return CheckHeaderSize(state, buf.size());
+}
+
+// 読み終えたheader fieldsをまとめてcurrent_bufから消す
+HttpStatus HttpParse::FinishHeaderFields(HttpRequestParsedData &data) {
+	HttpParseState &state = data.parse_state;
+	data.current_buf.erase(0, state.pos);
+	state.pos = 0;
+	if (!state.header_error.IsOk()) {
+		return state.header_error;
+	}
+	const RequestHeaderFields &header_fields = data.request_result.request.header_fields;
+	const HttpStatus           status =
+		ValidateInvalidHeaderFields(header_fields, data.request_result.request.request_line.method);
+	if (!status.IsOk()) {
+		return status;
 	}
-	std::string header_fields = data.current_buf.substr(0, pos);
-	data.current_buf.erase(0, pos + HEADER_FIELDS_END.size());
-	data.request_result.request.header_fields =
-		SetHeaderFields(utils::SplitStr(header_fields, CRLF));
-	ValidateInvalidHeaderFields(
-		data.request_result.request.header_fields, data.request_result.request.request_line.method
-	);
 	data.is_request_format.is_header_fields = true;
-	if (!IsBodyMessageReadingRequired(data.request_result.request.header_fields)) {
+	if (!IsBodyMessageReadingRequired(header_fields)) {
 		data.is_request_format.is_body_message = true;
+		return HttpStatus();
+	}
+	const RequestHeaderFields::const_iterator content_length = header_fields.find(CONTENT_LENGTH);
+	if (content_length != header_fields.end()) {
+		state.content_length = utils::ConvertStrToSize(content_length->second).GetValue();
 	}
+	return HttpStatus();
 }
 
-void HttpParse::ParseBodyMessage(HttpRequestParsedData &data) {
+HttpStatus HttpParse::ParseBodyMessage(HttpRequestParsedData &data) {
 	if (!data.is_request_format.is_request_line) {
-		return;
+		return HttpStatus();
 	}
 	if (!data.is_request_format.is_header_fields) {
-		return;
+		return HttpStatus();
 	}
 	if (data.is_request_format.is_body_message) {
-		return;
+		return HttpStatus();
 	}
 	if (data.request_result.request.header_fields.find(TRANSFER_ENCODING) !=
 			data.request_result.request.header_fields.end() &&
 		data.request_result.request.header_fields.at(TRANSFER_ENCODING) == CHUNKED) {
-		ParseChunkedRequest(data);
-		return;
+		return ParseChunkedRequest(data);
 	}
-	// todo: HttpRequestParsedDataクラスでcontent_lengthを保持？
-	// why: ParseBodyMessageが呼ばれるたびにcontent_lengthを変換するのを避けるため
-	const size_t content_length =
-		utils::ConvertStrToSize(data.request_result.request.header_fields[CONTENT_LENGTH])
-			.GetValue();
-	size_t readable_content_length =
+	// content_lengthはheader fieldsを読み終えた時に変換済み
+	const size_t content_length = data.parse_state.content_length;
+	if (content_length > data.parse_state.body_size_max) {
+		return PayloadTooLarge();
+	}
+	size_t       readable_content_length =
 		content_length - data.request_result.request.body_message.size();
 	if (data.current_buf.size() >= readable_content_length) {
 		data.request_result.request.body_message +=
@@ -251,174 +515,229 @@ void HttpParse::ParseBodyMessage(HttpRequestParsedData &data) {
 		data.request_result.request.body_message += data.current_buf;
 		data.current_buf.clear();
 	}
+	return HttpStatus();
 }
 
-void HttpParse::ParseChunkedRequest(HttpRequestParsedData &data) {
+// chunk-dataはchunk-sizeの分だけ数えて読み、完全に揃ったchunkだけbody_messageに移す
+// 揃ったchunkはcurrent_bufから最後にまとめて消すので、届いたbyte数に比例した時間で済む
+HttpStatus HttpParse::ParseChunkedRequest(HttpRequestParsedData &data) {
 	if (data.request_result.request.header_fields.find(CONTENT_LENGTH) !=
 		data.request_result.request.header_fields.end()) {
-		throw HttpException(
-			"Error: Content-Length and Transfer-Encoding are both specified",
-			StatusCode(BAD_REQUEST)
+		return HttpStatus(
+			BAD_REQUEST, "Error: Content-Length and Transfer-Encoding are both specified"
 		);
 	}
-
-	ChunkSizeResult chunk_size_result = GetChunkSizeStr(data.current_buf);
-	if (!chunk_size_result.IsOk()) {
-		return;
-	}
-	std::string::size_type end_of_chunk_size_pos = chunk_size_result.GetValue().first;
-	std::string            chunk_size_str        = chunk_size_result.GetValue().second;
-	std::size_t            chunk_size            = HexToDec(chunk_size_str).GetValue();
-
+	std::string &buf      = data.current_buf;
+	std::string &body     = data.request_result.request.body_message;
+	std::size_t  consumed = 0;
+	HttpStatus   status;
+	bool         is_complete = false;
+	std::size_t  chunk_size  = 0;
+	std::size_t  data_begin  = 0;
 	while (true) {
-		const ChunkDataResult chunk_data_result =
-			GetChunkData(data.current_buf, end_of_chunk_size_pos, chunk_size);
-		if (!chunk_data_result.IsOk()) {
-			return;
-		}
-		const std::string chunk_data = chunk_data_result.GetValue();
-		if (chunk_data.size() != chunk_size) {
-			throw HttpException(
-				"Error: chunk size and chunk data size are different", StatusCode(BAD_REQUEST)
-			);
+		status = ParseChunkSizeLine(buf, consumed, is_complete, chunk_size, data_begin);
+		if (!status.IsOk() || !is_complete) {
+			break;
 		}
-		// sizeとdataが揃ったのでbody_messageに追加 & current_bufからまとめてerase
-		data.request_result.request.body_message += chunk_data;
-		const std::size_t chunk_size_and_data_length =
-			chunk_size_str.size() + CRLF.size() + chunk_data.size() + CRLF.size();
-		data.current_buf.erase(0, chunk_size_and_data_length);
 		if (chunk_size == 0) {
+			std::size_t end = 0;
+			status          = SkipTrailerSection(buf, data_begin, is_complete, end);
+			if (status.IsOk() && is_complete) {
+				consumed                               = end;
+				data.is_request_format.is_body_message = true;
+			}
 			break;
 		}
-
-		chunk_size_result = GetChunkSizeStr(data.current_buf);
-		if (!chunk_size_result.IsOk()) {
-			return;
+		// chunk-dataが揃うのを待たずにsize行の時点で上限を超えるか判定する
+		if (chunk_size > data.parse_state.body_size_max - body.size()) {
+			status = PayloadTooLarge();
+			break;
 		}
-		end_of_chunk_size_pos = chunk_size_result.GetValue().first;
-		chunk_size_str        = chunk_size_result.GetValue().second;
-		chunk_size            = HexToDec(chunk_size_str).GetValue();
+		const std::size_t data_end = data_begin + chunk_size;
+		// chunk-dataの直後がCRLFでなければ、揃う前でも400
+		if ((buf.size() > data_end && buf[data_end] != '\r') ||
+			(buf.size() > data_end + 1 && buf[data_end + 1] != '\n')) {
+			status = BadChunk("Error: chunk size and chunk data size are different");
+			break;
+		}
+		if (buf.size() < data_end + CRLF.size()) {
+			break;
+		}
+		body.append(buf, data_begin, chunk_size);
+		consumed = data_end + CRLF.size();
 	}
+	// エラーの場合も揃ったchunkの分は消す
+	buf.erase(0, consumed);
+	return status;
+}
 
-	data.is_request_format.is_body_message = true;
+HttpStatus HttpParse::Run(HttpRequestParsedData &data) {
+	const HttpStatus status = ParseRequestHead(data);
+	if (!status.IsOk()) {
+		return status;
+	}
+	return ParseRequestBody(data);
 }
 
-void HttpParse::Run(HttpRequestParsedData &data) {
-	ParseRequestLine(data);
-	ParseHeaderFields(data);
-	ParseBodyMessage(data);
+HttpStatus HttpParse::ParseRequestHead(HttpRequestParsedData &data) {
+	const HttpStatus status = ParseRequestLine(data);
+	if (!status.IsOk()) {
+		return status;
+	}
+	return ParseHeaderFields(data);
 }
 
-RequestLine HttpParse::SetRequestLine(const std::vector<std::string> &request_line_info) {
-	CheckValidRequestLine(request_line_info);
-	RequestLine request_line;
-	request_line.method         = request_line_info[0];
-	request_line.request_target = request_line_info[1];
-	request_line.version        = request_line_info[2];
-	return request_line;
+HttpStatus HttpParse::ParseRequestBody(HttpRequestParsedData &data) {
+	return ParseBodyMessage(data);
 }
 
-HeaderFields HttpParse::SetHeaderFields(const std::vector<std::string> &header_fields_info) {
-	HeaderFields                                     header_fields;
-	typedef std::vector<std::string>::const_iterator It;
-	for (It it = header_fields_info.begin(); it != header_fields_info.end(); ++it) {
-		std::size_t colon_pos          = (*it).find_first_of(':');
-		std::string header_field_name  = utils::ToLowerString((*it).substr(0, colon_pos));
-		std::string header_field_value = (*it).substr(colon_pos + 1);
-		header_field_value             = utils::Trim(header_field_value, OPTIONAL_WHITESPACE);
-		if (header_field_name == CONTENT_TYPE) {
-			header_field_value = ToLowerContentTypeHeaderExceptBoundary(header_field_value);
-		} else {
-			header_field_value = utils::ToLowerString(header_field_value);
-		}
+// 必要な要素だけbufのoffsetから取り出す
+HttpStatus HttpParse::SetRequestLine(
+	const std::string    &buf,
+	const HttpParseState &state,
+	std::size_t           line_end,
+	RequestLine          &request_line
+) {
+	if (state.sp_count != 2) {
+		return HttpStatus(BAD_REQUEST, "Error: invalid number of status line elements");
+	}
+	request_line.method.assign(buf, 0, state.first_sp);
+	request_line.request_target.assign(
+		buf, state.first_sp + 1, state.second_sp - state.first_sp - 1
+	);
+	request_line.version.assign(buf, state.second_sp + 1, line_end - state.second_sp - 1);
+	return CheckValidRequestLine(request_line);
+}
+
+HttpStatus HttpParse::SetHeaderField(
+	RequestHeaderFields &header_fields, const std::string &buf, const HttpParseState &state
+) {
+	if (state.colon == std::string::npos) {
+		return HttpStatus(BAD_REQUEST, "Error: the header field doesn't have a colon.");
+	}
+	std::string header_field_name(buf, state.line_begin, state.colon - state.line_begin);
+	utils::scan::ToLower(header_field_name);
+	std::string header_field_value;
+	if (state.value_begin != std::string::npos) {
+		header_field_value.assign(buf, state.value_begin, state.value_end - state.value_begin);
+	}
+	if (header_field_name == CONTENT_TYPE) {
+		header_field_value = ToLowerContentTypeHeaderExceptBoundary(header_field_value);
+	} else {
+		utils::scan::ToLower(header_field_value);
+	}
 
+	const HttpStatus status =
 		CheckValidHeaderFieldNameAndValue(header_field_name, header_field_value);
-		typedef std::pair<HeaderFields::const_iterator, bool> Result;
-		Result result = header_fields.insert(std::make_pair(header_field_name, header_field_value));
-		if (result.second == false) {
-			throw HttpException(
-				"Error: The value already exists in header fields", StatusCode(BAD_REQUEST)
-			);
-		}
+	if (!status.IsOk()) {
+		return status;
+	}
+	typedef std::pair<RequestHeaderFields::const_iterator, bool> Result;
+	Result result = header_fields.insert(std::make_pair(header_field_name, header_field_value));
+	if (result.second == false) {
+		return HttpStatus(BAD_REQUEST, "Error: The value already exists in header fields");
 	}
-	return header_fields;
+	return HttpStatus();
 }
 
-void HttpParse::CheckValidRequestLine(const std::vector<std::string> &request_line_info) {
-	if (request_line_info.size() != 3) {
-		throw HttpException(
-			"Error: invalid number of status line elements", StatusCode(BAD_REQUEST)
-		);
+HttpStatus HttpParse::CheckValidRequestLine(const RequestLine &request_line) {
+	HttpStatus status = CheckValidMethod(request_line.method);
+	if (!status.IsOk()) {
+		return status;
+	}
+	status = CheckValidRequestTarget(request_line.request_target);
+	if (!status.IsOk()) {
+		return status;
 	}
-	CheckValidMethod(request_line_info[0]);
-	CheckValidRequestTarget(request_line_info[1]);
-	CheckValidVersion(request_line_info[2]);
+	return CheckValidVersion(request_line.version);
 }
 
-void HttpParse::CheckValidMethod(const std::string &method) {
+HttpStatus HttpParse::CheckValidMethod(const std::string &method) {
 	if (!method.size()) {
-		throw HttpException("Error: the method don't exist.", StatusCode(BAD_REQUEST));
+		return HttpStatus(BAD_REQUEST, "Error: the method don't exist.");
 	}
-	ValidateVCharInStr(method, "method");
-	if (IsStringUsAscii(method) == false || IsStringUpper(method) == false) {
-		throw HttpException(
-			"Error: This method contains lowercase or non-USASCII characters.",
-			StatusCode(BAD_REQUEST)
+	const HttpStatus status =
+		ValidateVCharInStr(method, "Error: the method contains non-VCHR characters.");
+	if (!status.IsOk()) {
+		return status;
+	}
+	if (IsStringUsAscii(method) == false || !utils::scan::IsUpperAlpha(method)) {
+		return HttpStatus(
+			BAD_REQUEST, "Error: This method contains lowercase or non-USASCII characters."
 		);
 	}
+	return HttpStatus();
 }
 
-void HttpParse::CheckValidRequestTarget(const std::string &request_target) {
+HttpStatus HttpParse::CheckValidRequestTarget(const std::string &request_target) {
 	if (!request_target.size()) {
-		throw HttpException("Error: the request target don't exist.", StatusCode(BAD_REQUEST));
+		return HttpStatus(BAD_REQUEST, "Error: the request target don't exist.");
+	}
+	const HttpStatus status = ValidateVCharInStr(
+		request_target, "Error: the request target contains non-VCHR characters."
+	);
+	if (!status.IsOk()) {
+		return status;
 	}
-	ValidateVCharInStr(request_target, "request target");
 	if (request_target.empty() || request_target[0] != '/') {
-		throw HttpException(
-			"Error: the request target is missing the '/' character at the beginning",
-			StatusCode(BAD_REQUEST)
+		return HttpStatus(
+			BAD_REQUEST,
+			"Error: the request target is missing the '/' character at the beginning"
 		);
 	}
+	return HttpStatus();
 }
 
-void HttpParse::CheckValidVersion(const std::string &version) {
+HttpStatus HttpParse::CheckValidVersion(const std::string &version) {
 	if (!version.size()) {
-		throw HttpException("Error: the http version don't exist.", StatusCode(BAD_REQUEST));
+		return HttpStatus(BAD_REQUEST, "Error: the http version don't exist.");
+	}
+	const HttpStatus status =
+		ValidateVCharInStr(version, "Error: the http version contains non-VCHR characters.");
+	if (!status.IsOk()) {
+		return status;
 	}
-	ValidateVCharInStr(version, "http version");
 	if (version != HTTP_VERSION) {
-		throw HttpException(
-			"Error: The version is not supported by webserv", StatusCode(BAD_REQUEST)
-		);
+		return HttpStatus(BAD_REQUEST, "Error: The version is not supported by webserv");
 	}
+	return HttpStatus();
 }
 
-void HttpParse::CheckValidHeaderFieldNameAndValue(
+HttpStatus HttpParse::CheckValidHeaderFieldNameAndValue(
 	const std::string &header_field_name, const std::string &header_field_value
 ) {
 	if (!header_field_name.size()) {
-		throw HttpException(
-			"Error: the name of Header field don't exist.", StatusCode(BAD_REQUEST)
-		);
+		return HttpStatus(BAD_REQUEST, "Error: the name of Header field don't exist.");
+	}
+	HttpStatus status = ValidateVCharInStr(
+		header_field_name, "Error: the name of header field contains non-VCHR characters."
+	);
+	if (!status.IsOk()) {
+		return status;
+	}
+	status = ValidateVCharInStr(
+		header_field_value, "Error: the value of header field contains non-VCHR characters."
+	);
+	if (!status.IsOk()) {
+		return status;
 	}
-	ValidateVCharInStr(header_field_name, "name of header field");
-	ValidateVCharInStr(header_field_value, "value of header field");
 	if (HasSpace(header_field_name)) {
-		throw HttpException(
-			"Error: the name of Header field has a space.", StatusCode(BAD_REQUEST)
+		return HttpStatus(BAD_REQUEST, "Error: the name of Header field has a space.");
+	}
+	if (!utils::scan::IsToken(header_field_name)) {
+		return HttpStatus(
+			BAD_REQUEST, "Error: the name of Header field contains non-token characters."
 		);
 	}
 	if (header_field_name == HOST && header_field_value.empty()) {
-		throw HttpException(
-			"Error: the value of Host header field is empty.", StatusCode(BAD_REQUEST)
-		);
+		return HttpStatus(BAD_REQUEST, "Error: the value of Host header field is empty.");
 	} else if (header_field_name == CONTENT_LENGTH &&
 			   !utils::ConvertStrToSize(header_field_value).IsOk()) {
-		throw HttpException(
-			"Error: the value of Content-Length header field is not a number.",
-			StatusCode(BAD_REQUEST)
+		return HttpStatus(
+			BAD_REQUEST, "Error: the value of Content-Length header field is not a number."
 		);
 	}
+	return HttpStatus();
 }
 
 // status_line && header
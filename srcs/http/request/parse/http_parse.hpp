@@ -1,12 +1,19 @@
 #ifndef HTTP_PARSE_HPP_
 #define HTTP_PARSE_HPP_
 
-#include "http_exception.hpp"
+#include "cgi_cache_info.hpp"
 #include "http_format.hpp"
+#include "http_status.hpp"
+#include <cstddef>
 #include <map>
 #include <stdexcept> //runtime_error
 #include <string>
-#include <vector>
+
+namespace server {
+
+struct ConnectionLimits;
+
+} // namespace server
 
 namespace http {
 
@@ -24,39 +31,95 @@ struct IsHttpRequestFormat {
 	bool is_body_message;
 };
 
+// request line/header fieldsを1byteずつ読む状態機械の途中状態
+// 位置は全てcurrent_bufのoffsetで持ち、読んだbyteは次のRunで読み直さない
+struct HttpParseState {
+	enum Phase {
+		REQUEST_LINE,    // request lineを読んでいる
+		REQUEST_LINE_LF, // request lineのCRの次
+		HEADER_LINE,     // header行を読んでいる
+		HEADER_LINE_LF   // header行のCRの次
+	};
+	HttpParseState();
+
+	Phase       phase;
+	std::size_t pos;        // 次に読むoffset
+	std::size_t line_begin; // 読んでいる行の先頭
+	// request line
+	std::size_t sp_count;
+	std::size_t first_sp;
+	std::size_t second_sp;
+	// header行
+	std::size_t colon;       // 最初の':'
+	std::size_t value_begin; // 前後のOWSを除いたfield-valueの範囲
+	std::size_t value_end;
+	// header fieldsの途中でエラーになってもheader fieldsの終わりまで読んでから返す
+	HttpStatus  header_error;
+	std::size_t content_length;
+	// client_max_body_size(header fieldsを読んだ後にvirtual serverから決まる。それまでは無制限)
+	std::size_t body_size_max;
+	// request line, header fieldsの上限(超えたら改行を待たずに414, 431)
+	std::size_t request_line_size_max;
+	std::size_t header_line_size_max;
+	std::size_t header_size_max;
+	std::size_t header_count_max;
+	std::size_t header_count;
+};
+
 struct HttpRequestParsedData {
-	HttpRequestParsedData() : is_cgi_running(false) {}
+	HttpRequestParsedData()
+		: is_cgi_running(false), is_continue_required(false), connection_limits(NULL) {}
 
 	// HTTP各書式のパースしたかどうか
 	IsHttpRequestFormat is_request_format;
+	// request line/header fieldsをどこまで読んだか
+	HttpParseState parse_state;
 	// HttpRequestResult
 	HttpRequestResult request_result;
 	// HTTP各書式をパースする前の読み込んだ情報
 	std::string current_buf;
 	// CGI実行中かどうか
 	bool is_cgi_running;
+	// CGIのresponseをcacheするときに使う
+	CgiCacheInfo cgi_cache_info;
+	// Expect: 100-continueに対してbodyを読む前に100を返す必要があるか
+	bool is_continue_required;
+	// header fieldsを読んだ後にlocationから決まるtimeout, keepalive_requests
+	const server::ConnectionLimits *connection_limits;
 };
 
 class HttpParse {
   public:
-	static void Run(HttpRequestParsedData &data);
+	static HttpStatus Run(HttpRequestParsedData &data);
+	// bodyを読む前にclient_max_body_sizeを決められるように、headerとbodyを分けて読む
+	static HttpStatus ParseRequestHead(HttpRequestParsedData &data);
+	static HttpStatus ParseRequestBody(HttpRequestParsedData &data);
 
   private:
 	HttpParse();
 	~HttpParse();
-	static void ParseRequestLine(HttpRequestParsedData &data);
-	static void ParseHeaderFields(HttpRequestParsedData &data);
-	static void ParseBodyMessage(HttpRequestParsedData &data);
-	static void ParseChunkedRequest(HttpRequestParsedData &data);
-
-	static RequestLine  SetRequestLine(const std::vector<std::string> &request_line);
-	static HeaderFields SetHeaderFields(const std::vector<std::string> &header_fields_info);
-	static void         CheckValidRequestLine(const std::vector<std::string> &request_line_info);
-	static void         CheckValidMethod(const std::string &method);
-	static void         CheckValidRequestTarget(const std::string &request_target);
-	static void         CheckValidVersion(const std::string &version);
-
-	static void CheckValidHeaderFieldNameAndValue(
+	static HttpStatus ParseRequestLine(HttpRequestParsedData &data);
+	static HttpStatus ParseHeaderFields(HttpRequestParsedData &data);
+	static HttpStatus ParseBodyMessage(HttpRequestParsedData &data);
+	static HttpStatus ParseChunkedRequest(HttpRequestParsedData &data);
+
+	static HttpStatus FinishHeaderFields(HttpRequestParsedData &data);
+
+	static HttpStatus SetRequestLine(
+		const std::string    &buf,
+		const HttpParseState &state,
+		std::size_t           line_end,
+		RequestLine          &request_line
+	);
+	static HttpStatus SetHeaderField(
+		RequestHeaderFields &header_fields, const std::string &buf, const HttpParseState &state
+	);
+	static HttpStatus CheckValidRequestLine(const RequestLine &request_line);
+	static HttpStatus CheckValidMethod(const std::string &method);
+	static HttpStatus CheckValidRequestTarget(const std::string &request_target);
+	static HttpStatus CheckValidVersion(const std::string &version);
+
+	static HttpStatus CheckValidHeaderFieldNameAndValue(
 		const std::string &header_field_name, const std::string &header_field_value
 	);
 };
@@ -0,0 +1,201 @@
+#include "request_header_fields.hpp"
+#include <algorithm> // copy, fill
+#include <stdexcept> // out_of_range
+
+namespace http {
+namespace {
+
+// HeaderFieldIdの順(http_messageのstd::stringは静的初期化順に依存するので使わない)
+const char *const HEADER_NAMES[HEADER_ID_SIZE] = {
+	"host",
+	"user-agent",
+	"accept",
+	"accept-encoding",
+	"connection",
+	"content-type",
+	"content-length",
+	"transfer-encoding",
+	"location",
+	"authorization",
+	"cache-control",
+	"expect",
+	"x-forwarded-for"
+};
+
+// (長さ + 先頭 * 4 + 末尾) % 32 が上の名前で衝突しないように選んだperfect hash
+const std::size_t   HASH_TABLE_SIZE             = 32;
+const HeaderFieldId HASH_TABLE[HASH_TABLE_SIZE] = {
+	HEADER_UNKNOWN,           HEADER_X_FORWARDED_FOR, HEADER_CONTENT_LENGTH,  HEADER_UNKNOWN,
+	HEADER_CONNECTION,        HEADER_CACHE_CONTROL,   HEADER_LOCATION,        HEADER_UNKNOWN,
+	HEADER_TRANSFER_ENCODING, HEADER_UNKNOWN,         HEADER_UNKNOWN,         HEADER_UNKNOWN,
+	HEADER_UNKNOWN,           HEADER_UNKNOWN,         HEADER_EXPECT,          HEADER_UNKNOWN,
+	HEADER_UNKNOWN,           HEADER_UNKNOWN,         HEADER_USER_AGENT,      HEADER_UNKNOWN,
+	HEADER_UNKNOWN,           HEADER_UNKNOWN,         HEADER_UNKNOWN,         HEADER_UNKNOWN,
+	HEADER_HOST,              HEADER_UNKNOWN,         HEADER_ACCEPT_ENCODING, HEADER_UNKNOWN,
+	HEADER_UNKNOWN,           HEADER_CONTENT_TYPE,    HEADER_ACCEPT,          HEADER_AUTHORIZATION
+};
+
+std::size_t Hash(const std::string &name) {
+	const unsigned char first = static_cast<unsigned char>(name[0]);
+	const unsigned char last  = static_cast<unsigned char>(name[name.size() - 1]);
+	return (name.size() + first * 4 + last) % HASH_TABLE_SIZE;
+}
+
+} // namespace
+
+const std::size_t RequestHeaderFields::NPOS;
+
+RequestHeaderFields::RequestHeaderFields() {
+	std::fill(slots_, slots_ + HEADER_ID_SIZE, NPOS);
+}
+
+RequestHeaderFields::~RequestHeaderFields() {}
+
+RequestHeaderFields::RequestHeaderFields(const RequestHeaderFields &other) {
+	*this = other;
+}
+
+RequestHeaderFields &RequestHeaderFields::operator=(const RequestHeaderFields &other) {
+	if (this != &other) {
+		fields_ = other.fields_;
+		std::copy(other.slots_, other.slots_ + HEADER_ID_SIZE, slots_);
+	}
+	return *this;
+}
+
+RequestHeaderFields::iterator RequestHeaderFields::begin() {
+	return fields_.begin();
+}
+
+RequestHeaderFields::const_iterator RequestHeaderFields::begin() const {
+	return fields_.begin();
+}
+
+RequestHeaderFields::iterator RequestHeaderFields::end() {
+	return fields_.end();
+}
+
+RequestHeaderFields::const_iterator RequestHeaderFields::end() const {
+	return fields_.end();
+}
+
+RequestHeaderFields::size_type RequestHeaderFields::size() const {
+	return fields_.size();
+}
+
+bool RequestHeaderFields::empty() const {
+	return fields_.empty();
+}
+
+void RequestHeaderFields::clear() {
+	fields_.clear();
+	std::fill(slots_, slots_ + HEADER_ID_SIZE, NPOS);
+}
+
+RequestHeaderFields::iterator RequestHeaderFields::find(const std::string &name) {
+	const std::size_t index = FindIndex(name);
+	return index == NPOS ? fields_.end() : fields_.begin() + index;
+}
+
+RequestHeaderFields::const_iterator RequestHeaderFields::find(const std::string &name) const {
+	const std::size_t index = FindIndex(name);
+	return index == NPOS ? fields_.end() : fields_.begin() + index;
+}
+
+RequestHeaderFields::size_type RequestHeaderFields::count(const std::string &name) const {
+	return FindIndex(name) == NPOS ? 0 : 1;
+}
+
+const std::string &RequestHeaderFields::at(const std::string &name) const {
+	const std::size_t index = FindIndex(name);
+	if (index == NPOS) {
+		throw std::out_of_range("RequestHeaderFields::at: " + name);
+	}
+	return fields_[index].second;
+}
+
+std::string &RequestHeaderFields::operator[](const std::string &name) {
+	return insert(value_type(name, std::string())).first->second;
+}
+
+std::pair<RequestHeaderFields::iterator, bool>
+RequestHeaderFields::insert(const value_type &field) {
+	const HeaderFieldId id = GetId(field.first);
+	if (id != HEADER_UNKNOWN && slots_[id] != NPOS) {
+		return std::make_pair(fields_.begin() + slots_[id], false);
+	}
+	if (id == HEADER_UNKNOWN) {
+		const std::size_t index = FindIndex(field.first);
+		if (index != NPOS) {
+			return std::make_pair(fields_.begin() + index, false);
+		}
+	} else {
+		slots_[id] = fields_.size();
+	}
+	fields_.push_back(field);
+	return std::make_pair(fields_.end() - 1, true);
+}
+
+RequestHeaderFields::size_type RequestHeaderFields::erase(const std::string &name) {
+	const std::size_t index = FindIndex(name);
+	if (index == NPOS) {
+		return 0;
+	}
+	fields_.erase(fields_.begin() + index);
+	RebuildSlots();
+	return 1;
+}
+
+HeaderFieldId RequestHeaderFields::GetId(const std::string &name) {
+	if (name.empty()) {
+		return HEADER_UNKNOWN;
+	}
+	const HeaderFieldId id = HASH_TABLE[Hash(name)];
+	if (id == HEADER_UNKNOWN || name != HEADER_NAMES[id]) {
+		return HEADER_UNKNOWN;
+	}
+	return id;
+}
+
+std::size_t RequestHeaderFields::FindIndex(const std::string &name) const {
+	const HeaderFieldId id = GetId(name);
+	if (id != HEADER_UNKNOWN) {
+		return slots_[id];
+	}
+	for (std::size_t i = 0; i < fields_.size(); ++i) {
+		if (fields_[i].first == name) {
+			return i;
+		}
+	}
+	return NPOS;
+}
+
+void RequestHeaderFields::RebuildSlots() {
+	std::fill(slots_, slots_ + HEADER_ID_SIZE, NPOS);
+	for (std::size_t i = 0; i < fields_.size(); ++i) {
+		const HeaderFieldId id = GetId(fields_[i].first);
+		if (id != HEADER_UNKNOWN) {
+			slots_[id] = i;
+		}
+	}
+}
+
+bool operator==(const RequestHeaderFields &lhs, const RequestHeaderFields &rhs) {
+	if (lhs.size() != rhs.size()) {
+		return false;
+	}
+	typedef RequestHeaderFields::const_iterator Itr;
+	for (Itr it = lhs.begin(); it != lhs.end(); ++it) {
+		const Itr found = rhs.find(it->first);
+		if (found == rhs.end() || found->second != it->second) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool operator!=(const RequestHeaderFields &lhs, const RequestHeaderFields &rhs) {
+	return !(lhs == rhs);
+}
+
+} // namespace http
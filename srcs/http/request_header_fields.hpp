@@ -0,0 +1,81 @@
+#ifndef REQUEST_HEADER_FIELDS_HPP_
+#define REQUEST_HEADER_FIELDS_HPP_
+
+#include <cstddef> // size_t
+#include <string>
+#include <utility> // pair
+#include <vector>
+
+namespace http {
+
+// よく使うheaderのid(RequestHeaderFieldsの固定slotの位置)
+enum HeaderFieldId {
+	HEADER_HOST,
+	HEADER_USER_AGENT,
+	HEADER_ACCEPT,
+	HEADER_ACCEPT_ENCODING,
+	HEADER_CONNECTION,
+	HEADER_CONTENT_TYPE,
+	HEADER_CONTENT_LENGTH,
+	HEADER_TRANSFER_ENCODING,
+	HEADER_LOCATION,
+	HEADER_AUTHORIZATION,
+	HEADER_CACHE_CONTROL,
+	HEADER_EXPECT,
+	HEADER_X_FORWARDED_FOR,
+	HEADER_ID_SIZE,
+	HEADER_UNKNOWN = HEADER_ID_SIZE
+};
+
+// requestのheader fieldsを届いた順にvectorへ平らに持つ
+// よく使うheaderはperfect hashでidにしてslotから直接引き、それ以外は線形に探す
+// field-nameは小文字にしたものを渡す(std::mapと同じ使い方ができるようにしている)
+class RequestHeaderFields {
+  public:
+	typedef std::pair<std::string, std::string> value_type;
+	typedef std::vector<value_type>             FieldList;
+	typedef FieldList::iterator                 iterator;
+	typedef FieldList::const_iterator           const_iterator;
+	typedef FieldList::size_type                size_type;
+
+	RequestHeaderFields();
+	~RequestHeaderFields();
+	RequestHeaderFields(const RequestHeaderFields &other);
+	RequestHeaderFields &operator=(const RequestHeaderFields &other);
+
+	iterator       begin();
+	const_iterator begin() const;
+	iterator       end();
+	const_iterator end() const;
+	size_type      size() const;
+	bool           empty() const;
+	void           clear();
+
+	iterator           find(const std::string &name);
+	const_iterator     find(const std::string &name) const;
+	size_type          count(const std::string &name) const;
+	const std::string &at(const std::string &name) const;
+	std::string       &operator[](const std::string &name);
+	// 既にある場合は上書きしない(std::map::insertと同じ)
+	std::pair<iterator, bool> insert(const value_type &field);
+	size_type                 erase(const std::string &name);
+
+	static HeaderFieldId GetId(const std::string &name);
+
+  private:
+	static const std::size_t NPOS = static_cast<std::size_t>(-1);
+
+	std::size_t FindIndex(const std::string &name) const;
+	void        RebuildSlots();
+
+	FieldList   fields_;
+	std::size_t slots_[HEADER_ID_SIZE]; // idごとのfields_のindex(無ければNPOS)
+};
+
+// 順番によらず同じfieldを持っていれば等しい
+bool operator==(const RequestHeaderFields &lhs, const RequestHeaderFields &rhs);
+bool operator!=(const RequestHeaderFields &lhs, const RequestHeaderFields &rhs);
+
+} // namespace http
+
+#endif
@@ -3,6 +3,7 @@
 
 #include "cgi_request.hpp"
 #include "result.hpp"
+#include <cstddef> // size_t
 #include <map>
 #include <string>
 
@@ -12,9 +13,11 @@ struct HttpRequestFormat;
 
 class CgiParse {
   public:
+	// cgi_script: locationのrootから始まるpath, root_length: その先頭のrootの長さ
 	static cgi::CgiRequest Parse(
 		const http::HttpRequestFormat &request,
 		const std::string             &cgi_script,
+		std::size_t                    root_length,
 		const std::string             &cgi_extension,
 		const std::string             &server_port,
 		const std::string             &client_ip
@@ -28,6 +31,7 @@ class CgiParse {
 	static cgi::MetaMap CreateRequestMetaVariables(
 		const http::HttpRequestFormat &request,
 		const std::string             &cgi_script,
+		std::size_t                    root_length,
 		const std::string             &cgi_extension,
 		const std::string             &server_port,
 		const std::string             &client_ip
@@ -29,29 +29,6 @@ std::string FileToString(const std::ifstream &file) {
 	return ss.str();
 }
 
-// ファイルの拡張子に基づいてContent-Typeを決定する関数: デフォルトはapplication/octet-stream
-std::string DetermineContentType(const std::string &path) {
-	const std::string txt_extension  = ".txt";
-	const std::string html_extension = ".html";
-	const std::string json_extension = ".json";
-	const std::string pdf_extension  = ".pdf";
-	const std::string jpeg_extension = ".jpeg";
-	const std::string jpg_extension  = ".jpg";
-
-	if (utils::EndWith(path, txt_extension)) {
-		return http::TEXT_PLAIN;
-	} else if (utils::EndWith(path, html_extension)) {
-		return http::TEXT_HTML;
-	} else if (utils::EndWith(path, json_extension)) {
-		return http::APPLICATION_JSON;
-	} else if (utils::EndWith(path, pdf_extension)) {
-		return http::APPLICATION_PDF;
-	} else if (utils::EndWith(path, jpeg_extension) || utils::EndWith(path, jpg_extension)) {
-		return http::IMAGE_JPEG;
-	}
-	return APPLICATION_OCTET_STREAM;
-}
-
 // ヘルパー関数: 文字列のクオートを削除
 std::string RemoveQuotes(const std::string &str) {
 	if (utils::GetFrontChar(str) == '"' && utils::GetBackChar(str) == '"') {
@@ -62,61 +39,80 @@ std::string RemoveQuotes(const std::string &str) {
 
 } // namespace
 
-StatusCode Method::Handler(
-	const std::string  &path,
-	const std::string  &method,
-	const AllowMethods &allow_methods,
-	const std::string  &request_body_message,
-	const HeaderFields &request_header_fields,
-	std::string        &response_body_message,
-	HeaderFields       &response_header_fields,
-	const std::string  &index_file_path,
-	bool                autoindex_on,
-	const std::string  &file_upload_path
+HttpStatus Method::Handler(
+	const std::string         &path,
+	std::size_t                root_length,
+	const server::MimeTypes   &mime_types,
+	const std::string         &method,
+	const AllowMethods        &allow_methods,
+	const std::string         &request_body_message,
+	const RequestHeaderFields &request_header_fields,
+	std::string               &response_body_message,
+	HeaderFields              &response_header_fields,
+	const std::string         &index_file_path,
+	bool                       autoindex_on,
+	const std::string         &file_upload_path,
+	StatusCode                &status_code
 ) {
-	StatusCode status_code(OK);
 	if (!IsSupportedMethod(method)) {
-		throw HttpException("Error: Not Implemented", StatusCode(NOT_IMPLEMENTED));
+		return HttpStatus(NOT_IMPLEMENTED, "Error: Not Implemented");
 	}
 	if (!IsAllowedMethod(method, allow_methods)) {
-		throw HttpException("Error: Method Not Allowed", StatusCode(METHOD_NOT_ALLOWED));
+		return HttpStatus(METHOD_NOT_ALLOWED, "Error: Method Not Allowed");
 	}
+	status_code = StatusCode(OK);
 	if (method == GET) {
-		status_code = GetHandler(
-			path, response_body_message, response_header_fields, index_file_path, autoindex_on
+		return GetHandler(
+			path,
+			root_length,
+			mime_types,
+			response_body_message,
+			response_header_fields,
+			index_file_path,
+			autoindex_on
 		);
 	} else if (method == POST) {
-		status_code = PostHandler(
+		return PostHandler(
 			file_upload_path,
 			request_body_message,
 			request_header_fields,
 			response_body_message,
-			response_header_fields
+			response_header_fields,
+			status_code
 		);
 	} else if (method == DELETE) {
-		status_code = DeleteHandler(path, response_body_message);
+		return DeleteHandler(path, response_body_message, status_code);
 	}
-	return status_code;
+	return HttpStatus();
 }
 
-StatusCode Method::GetHandler(
-	const std::string &path,
-	std::string       &response_body_message,
-	HeaderFields      &response_header_fields,
-	const std::string &index_file_path,
-	bool               autoindex_on
+HttpStatus Method::GetHandler(
+	const std::string       &path,
+	std::size_t              root_length,
+	const server::MimeTypes &mime_types,
+	std::string             &response_body_message,
+	HeaderFields            &response_header_fields,
+	const std::string       &index_file_path,
+	bool                     autoindex_on
 ) {
-	StatusCode  status_code(OK);
-	const Stat &info = TryStat(path);
+	struct stat      stat_buf;
+	const HttpStatus status = TryStat(path, stat_buf);
+	if (!status.IsOk()) {
+		return status;
+	}
+	const Stat info(stat_buf);
 	if (info.IsDirectory()) {
 		// No empty string because the path has '/'
 		if (path[path.size() - 1] != '/') {
-			throw HttpException("Error: Moved Permanently", StatusCode(MOVED_PERMANENTLY));
+			return HttpStatus(MOVED_PERMANENTLY, "Error: Moved Permanently");
 		} else if (!index_file_path.empty()) {
-			response_body_message                = ReadFile(path + index_file_path);
-			response_header_fields[CONTENT_TYPE] = DetermineContentType(path + index_file_path);
+			const HttpStatus read_status = ReadFile(path + index_file_path, response_body_message);
+			if (!read_status.IsOk()) {
+				return read_status;
+			}
+			response_header_fields[CONTENT_TYPE] = mime_types.GetContentType(path + index_file_path);
 		} else if (autoindex_on) {
-			utils::Result<std::string> result = AutoindexHandler(path);
+			utils::Result<std::string> result = AutoindexHandler(path, path.substr(root_length));
 			response_body_message             = result.GetValue();
 			if (!result.IsOk()) {
 				throw HttpException(
@@ -124,150 +120,173 @@ StatusCode Method::GetHandler(
 				);
 			}
 		} else {
-			throw HttpException("Error: Forbidden", StatusCode(FORBIDDEN));
+			return HttpStatus(FORBIDDEN, "Error: Forbidden");
 		}
 	} else if (info.IsRegularFile()) {
 		if (!info.IsReadableFile()) {
-			throw HttpException("Error: Forbidden", StatusCode(FORBIDDEN));
-		} else {
-			response_body_message                = ReadFile(path);
-			response_header_fields[CONTENT_TYPE] = DetermineContentType(path);
+			return HttpStatus(FORBIDDEN, "Error: Forbidden");
 		}
+		const HttpStatus read_status = ReadFile(path, response_body_message);
+		if (!read_status.IsOk()) {
+			return read_status;
+		}
+		response_header_fields[CONTENT_TYPE] = mime_types.GetContentType(path);
 	} else {
-		throw HttpException("Error: Not Found", StatusCode(NOT_FOUND));
+		return HttpStatus(NOT_FOUND, "Error: Not Found");
 	}
-	return status_code;
+	return HttpStatus();
 }
 
-StatusCode Method::PostHandler(
-	const std::string  &file_upload_path,
-	const std::string  &request_body_message,
-	const HeaderFields &request_header_fields,
-	std::string        &response_body_message,
-	HeaderFields       &response_header_fields
+HttpStatus Method::PostHandler(
+	const std::string         &file_upload_path,
+	const std::string         &request_body_message,
+	const RequestHeaderFields &request_header_fields,
+	std::string               &response_body_message,
+	HeaderFields              &response_header_fields,
+	StatusCode                &status_code
 ) {
 
 	if (file_upload_path.empty()) {
-		return EchoPostHandler(request_body_message, response_body_message, response_header_fields);
+		EchoPostHandler(request_body_message, response_body_message, response_header_fields);
+		status_code = StatusCode(OK);
+		return HttpStatus();
 	} else if (request_header_fields.find(CONTENT_TYPE) != request_header_fields.end() &&
 			   utils::StartWith(request_header_fields.at(CONTENT_TYPE), MULTIPART_FORM_DATA)) {
 		// Content-Type: multipart/form-data; boundary=----WebKitFormBoundary7MA4YWxkTrZu0gW
 		// のようにContent-Typeがmultipart/form-dataの場合
+		status_code = StatusCode(CREATED);
 		return FileCreationHandlerForMultiPart(
 			file_upload_path, request_body_message, request_header_fields, response_body_message
 		);
 	} else if (!IsExistPath(file_upload_path)) {
+		status_code = StatusCode(CREATED);
 		return FileCreationHandler(file_upload_path, request_body_message, response_body_message);
 	}
-	const Stat &info = TryStat(file_upload_path);
-	StatusCode  status_code(NO_CONTENT);
+	struct stat      stat_buf;
+	const HttpStatus status = TryStat(file_upload_path, stat_buf);
+	if (!status.IsOk()) {
+		return status;
+	}
+	const Stat info(stat_buf);
 	if (info.IsDirectory()) {
-		throw HttpException("Error: Forbidden", StatusCode(FORBIDDEN));
-	} else if (info.IsRegularFile()) {
-		response_body_message = HttpResponse::CreateDefaultBodyMessage(status_code);
-	} else {
+		return HttpStatus(FORBIDDEN, "Error: Forbidden");
+	} else if (!info.IsRegularFile()) {
 		// - upload_file_pathがシンボリックリンク
 		// - upload_file_pathが特殊ファイル（デバイスファイル、ソケットファイルなど）
-		throw HttpException("Error: Forbidden", StatusCode(FORBIDDEN));
+		return HttpStatus(FORBIDDEN, "Error: Forbidden");
 	}
-	return status_code;
+	status_code           = StatusCode(NO_CONTENT);
+	response_body_message = HttpResponse::CreateDefaultBodyMessage(status_code);
+	return HttpStatus();
 }
 
-StatusCode Method::DeleteHandler(const std::string &path, std::string &response_body_message) {
-	const Stat &info        = TryStat(path);
-	StatusCode  status_code = StatusCode(NO_CONTENT);
-	if (info.IsDirectory()) {
-		throw HttpException("Error: Forbidden", StatusCode(FORBIDDEN));
+HttpStatus Method::DeleteHandler(
+	const std::string &path, std::string &response_body_message, StatusCode &status_code
+) {
+	struct stat      stat_buf;
+	const HttpStatus status = TryStat(path, stat_buf);
+	if (!status.IsOk()) {
+		return status;
+	}
+	if (Stat(stat_buf).IsDirectory()) {
+		return HttpStatus(FORBIDDEN, "Error: Forbidden");
 	}
 	if (std::remove(path.c_str()) == SYSTEM_ERROR) {
-		SystemExceptionHandler(errno);
-	} else {
-		response_body_message = HttpResponse::CreateDefaultBodyMessage(status_code);
+		return SystemErrorHandler(errno);
 	}
-	return status_code;
+	status_code           = StatusCode(NO_CONTENT);
+	response_body_message = HttpResponse::CreateDefaultBodyMessage(status_code);
+	return HttpStatus();
 }
 
-void Method::SystemExceptionHandler(int error_number) {
+// requestの対象によるもの(403, 404)だけを返し、それ以外のシステムの失敗は500で投げる
+HttpStatus Method::SystemErrorHandler(int error_number) {
 	if (error_number == EACCES || error_number == EPERM) {
-		throw HttpException("Error: Forbidden", StatusCode(FORBIDDEN));
+		return HttpStatus(FORBIDDEN, "Error: Forbidden");
 	} else if (error_number == ENOENT || error_number == ENOTDIR || error_number == ELOOP ||
 			   error_number == ENAMETOOLONG) {
-		throw HttpException("Error: Not Found", StatusCode(NOT_FOUND));
-	} else {
-		throw HttpException("Error: Internal Server Error", StatusCode(INTERNAL_SERVER_ERROR));
+		return HttpStatus(NOT_FOUND, "Error: Not Found");
 	}
+	throw HttpException("Error: Internal Server Error", StatusCode(INTERNAL_SERVER_ERROR));
 }
 
-StatusCode Method::FileCreationHandlerForMultiPart(
-	const std::string  &path,
-	const std::string  &request_body_message,
-	const HeaderFields &request_header_fields,
-	std::string        &response_body_message
+HttpStatus Method::FileCreationHandlerForMultiPart(
+	const std::string         &path,
+	const std::string         &request_body_message,
+	const RequestHeaderFields &request_header_fields,
+	std::string               &response_body_message
 ) {
-	std::vector<Method::Part> parts =
-		DecodeMultipartFormData(request_header_fields.at(CONTENT_TYPE), request_body_message);
+	std::vector<Method::Part> parts;
+	HttpStatus                status = DecodeMultipartFormData(
+		   request_header_fields.at(CONTENT_TYPE), request_body_message, parts
+	   );
+	if (!status.IsOk()) {
+		return status;
+	}
 	for (std::vector<Method::Part>::iterator it = parts.begin(); it != parts.end(); ++it) {
 		// Content-Disposition: form-data; name="file"; filename="test.txt"
 		// のようにfilenameが含まれる場合 そのパスにファイルを作成する
 		if ((*it).headers.find(CONTENT_DISPOSITION) == (*it).headers.end()) {
-			throw HttpException(
-				"Error: Invalid part format, missing Content-Disposition", StatusCode(BAD_REQUEST)
+			return HttpStatus(
+				BAD_REQUEST, "Error: Invalid part format, missing Content-Disposition"
 			);
 		}
-		std::map<std::string, std::string> content_disposition =
-			ParseContentDisposition((*it).headers[CONTENT_DISPOSITION]);
+		ContentDisposition content_disposition;
+		status = ParseContentDisposition((*it).headers[CONTENT_DISPOSITION], content_disposition);
+		if (!status.IsOk()) {
+			return status;
+		}
 		if (content_disposition.find(FILENAME) == content_disposition.end()) {
-			throw HttpException(
-				"Error: Invalid part format, missing filename", StatusCode(BAD_REQUEST)
-			);
+			return HttpStatus(BAD_REQUEST, "Error: Invalid part format, missing filename");
 		}
 		std::string file_name = content_disposition[FILENAME];
 		std::string file_path = path + "/" + file_name;
 		// upload_dir + "/" + file_name にファイルを作成
-		FileCreationHandler(file_path, (*it).body, response_body_message);
+		status = FileCreationHandler(file_path, (*it).body, response_body_message);
+		if (!status.IsOk()) {
+			return status;
+		}
 	}
-	StatusCode status_code(CREATED);
-	response_body_message = HttpResponse::CreateDefaultBodyMessage(status_code);
-	return status_code;
+	response_body_message = HttpResponse::CreateDefaultBodyMessage(StatusCode(CREATED));
+	return HttpStatus();
 }
 
-StatusCode Method::FileCreationHandler(
+HttpStatus Method::FileCreationHandler(
 	const std::string &path,
 	const std::string &request_body_message,
 	std::string       &response_body_message
 ) {
 	std::ofstream file(path.c_str(), std::ios::binary);
 	if (file.fail()) {
-		SystemExceptionHandler(errno);
+		return SystemErrorHandler(errno);
 	}
 	file.write(request_body_message.c_str(), request_body_message.length());
 	if (file.fail()) {
+		const int write_errno = errno;
 		file.close();
 		if (std::remove(path.c_str()) == SYSTEM_ERROR) {
-			SystemExceptionHandler(errno);
+			return SystemErrorHandler(errno);
 		}
-		SystemExceptionHandler(errno);
+		return SystemErrorHandler(write_errno);
 	}
-	StatusCode status_code(CREATED);
-	response_body_message = HttpResponse::CreateDefaultBodyMessage(status_code);
-	return status_code;
+	response_body_message = HttpResponse::CreateDefaultBodyMessage(StatusCode(CREATED));
+	return HttpStatus();
 }
 
-Stat Method::TryStat(const std::string &path) {
-	struct stat stat_buf;
+HttpStatus Method::TryStat(const std::string &path, struct stat &stat_buf) {
 	if (stat(path.c_str(), &stat_buf) == SYSTEM_ERROR) {
-		SystemExceptionHandler(errno);
+		return SystemErrorHandler(errno);
 	}
-	Stat info(stat_buf);
-	return info;
+	return HttpStatus();
 }
 
-std::string Method::ReadFile(const std::string &file_path) {
+HttpStatus Method::ReadFile(const std::string &file_path, std::string &content) {
 	std::ifstream file(file_path.c_str());
 	if (!file) {
-		SystemExceptionHandler(errno);
+		return SystemErrorHandler(errno);
 	}
-	return FileToString(file);
+	content = FileToString(file);
+	return HttpStatus();
 }
 
 bool Method::IsSupportedMethod(const std::string &method) {
@@ -289,7 +308,8 @@ bool Method::IsAllowedMethod(
 	}
 }
 
-utils::Result<std::string> Method::AutoindexHandler(const std::string &path) {
+utils::Result<std::string>
+Method::AutoindexHandler(const std::string &path, const std::string &display_path) {
 	utils::Result<std::string> result;
 	DIR                       *dir = opendir(path.c_str());
 	std::string                response_body_message;
@@ -299,13 +319,6 @@ utils::Result<std::string> Method::AutoindexHandler(const std::string &path) {
 		return result;
 	}
 
-	std::string       display_path = path;
-	const std::string root_path    = "/root";
-	std::size_t       pos          = path.find(root_path);
-	if (pos != std::string::npos) {
-		display_path = path.substr(pos + root_path.length());
-	}
-
 	struct dirent *entry;
 	response_body_message += "<html>\n"
 							 "<head><title>Index of " +
@@ -353,43 +366,50 @@ utils::Result<std::string> Method::AutoindexHandler(const std::string &path) {
 	return result;
 }
 
-StatusCode Method::EchoPostHandler(
+void Method::EchoPostHandler(
 	const std::string &request_body_message,
 	std::string       &response_body_message,
 	HeaderFields      &response_header_fields
 ) {
 	response_body_message                = request_body_message;
 	response_header_fields[CONTENT_TYPE] = TEXT_PLAIN;
-	return StatusCode(OK);
 }
 
 // multipart/form-dataをデコードする関数
-std::vector<Method::Part>
-Method::DecodeMultipartFormData(const std::string &content_type, const std::string &body) {
-	std::vector<Method::Part> parts;
-	std::string               boundary  = ExtractBoundary(content_type);
-	std::vector<std::string>  raw_parts = utils::SplitStr(body, boundary);
+HttpStatus Method::DecodeMultipartFormData(
+	const std::string &content_type, const std::string &body, std::vector<Part> &parts
+) {
+	std::string      boundary;
+	const HttpStatus status = ExtractBoundary(content_type, boundary);
+	if (!status.IsOk()) {
+		return status;
+	}
+	std::vector<std::string> raw_parts = utils::SplitStr(body, boundary);
 	if (raw_parts.size() < 3) { // boundary + パート + boundary が最低でも必要
-		throw HttpException("Error: Invalid multipart/form-data format", StatusCode(BAD_REQUEST));
+		return HttpStatus(BAD_REQUEST, "Error: Invalid multipart/form-data format");
 	}
 	for (std::vector<std::string>::const_iterator raw_part =
 			 raw_parts.begin() + 1;       // 最初のパートは空文字列
 		 raw_part != raw_parts.end() - 1; // 最後のパートはboundary + "--"
 		 ++raw_part) {
-		parts.push_back(ParsePart(*raw_part));
+		Part             part;
+		const HttpStatus part_status = ParsePart(*raw_part, part);
+		if (!part_status.IsOk()) {
+			return part_status;
+		}
+		parts.push_back(part);
 	}
 	if (raw_parts.back() != "--\r\n") {
 		// 最後はboundary + "--"(----WebKitFormBoundary7MA4YWxkTrZu0gW--)
-		throw HttpException(
-			"Error: Invalid multipart/form-data format, final boundary not found",
-			StatusCode(BAD_REQUEST)
+		return HttpStatus(
+			BAD_REQUEST, "Error: Invalid multipart/form-data format, final boundary not found"
 		);
 	}
-	return parts;
+	return HttpStatus();
 }
 
 // Boundaryを抽出する関数
-std::string Method::ExtractBoundary(const std::string &content_type) {
+HttpStatus Method::ExtractBoundary(const std::string &content_type, std::string &boundary) {
 	const std::string boundary_prefix = BOUNDARY + "=";
 	std::size_t       pos             = content_type.find(boundary_prefix);
 	// Content-Type: multipart/form-data; boundary=--WebKitFormBoundary7MA4YWxkTrZu0gW; abcd=efgh
@@ -400,40 +420,34 @@ std::string Method::ExtractBoundary(const std::string &content_type) {
 		if (end == std::string::npos) {
 			end = content_type.length();
 		}
-		return "--" + content_type.substr(start, end - start);
+		boundary = "--" + content_type.substr(start, end - start);
+		return HttpStatus();
 	}
-	throw HttpException(
-		"Error: Boundary not found in Content-Type header", StatusCode(BAD_REQUEST)
-	);
+	return HttpStatus(BAD_REQUEST, "Error: Boundary not found in Content-Type header");
 }
 
 // ヘッダーとボディを分割する関数
-Method::Part Method::ParsePart(const std::string &part) {
-	Part        result;
-	std::size_t header_end = part.find(HEADER_FIELDS_END);
+HttpStatus Method::ParsePart(const std::string &raw_part, Part &part) {
+	std::size_t header_end = raw_part.find(HEADER_FIELDS_END);
 	if (header_end == std::string::npos) {
-		throw HttpException(
-			"Error: Invalid part format, headers and body not properly separated",
-			StatusCode(BAD_REQUEST)
+		return HttpStatus(
+			BAD_REQUEST, "Error: Invalid part format, headers and body not properly separated"
 		);
 	}
 	// ----WebKitFormBoundary7MA4YWxkTrZu0gW\r\nContent-Disposition: form-data; name="file";
 	// のboundary=----WebKitFormBoundary7MA4YWxkTrZu0gW以降の\r\nから始まる
 	// -- + boundary + CRLF で区切られていなければならない
-	if (!utils::StartWith(part, CRLF)) {
-		throw HttpException(
-			"Error: Invalid part format, headers not properly terminated with CRLF",
-			StatusCode(BAD_REQUEST)
+	if (!utils::StartWith(raw_part, CRLF)) {
+		return HttpStatus(
+			BAD_REQUEST, "Error: Invalid part format, headers not properly terminated with CRLF"
 		);
 	}
-	std::string headers = part.substr(CRLF.length(), header_end);
-	result.body         = part.substr(header_end + CRLF.length() * 2);
-	if (!utils::EndWith(result.body, CRLF)) { // bodyの終端はCRLFで終わっているとする
-		throw HttpException(
-			"Error: Invalid part format, body not properly terminated", StatusCode(BAD_REQUEST)
-		);
+	std::string headers = raw_part.substr(CRLF.length(), header_end);
+	part.body           = raw_part.substr(header_end + CRLF.length() * 2);
+	if (!utils::EndWith(part.body, CRLF)) { // bodyの終端はCRLFで終わっているとする
+		return HttpStatus(BAD_REQUEST, "Error: Invalid part format, body not properly terminated");
 	}
-	result.body = result.body.substr(0, result.body.length() - CRLF.length());
+	part.body = part.body.substr(0, part.body.length() - CRLF.length());
 
 	std::size_t pos = 0;
 	std::size_t end = headers.find(CRLF, pos);
@@ -441,56 +455,53 @@ Method::Part Method::ParsePart(const std::string &part) {
 		std::string              header            = headers.substr(pos, end - pos);
 		std::vector<std::string> header_name_value = utils::SplitStr(header, ": ");
 		if (header_name_value.size() != 2) {
-			throw HttpException("Error: Invalid header format", StatusCode(BAD_REQUEST));
-		} else if (result.headers.find(header_name_value[0]) != result.headers.end()) {
-			throw HttpException("Error: Duplicate header name in part", StatusCode(BAD_REQUEST));
+			return HttpStatus(BAD_REQUEST, "Error: Invalid header format");
+		} else if (part.headers.find(header_name_value[0]) != part.headers.end()) {
+			return HttpStatus(BAD_REQUEST, "Error: Duplicate header name in part");
 		}
-		result.headers[header_name_value[0]] = header_name_value[1];
-		pos                                  = end + CRLF.length();
-		end                                  = headers.find(CRLF, pos);
+		part.headers[header_name_value[0]] = header_name_value[1];
+		pos                                = end + CRLF.length();
+		end                                = headers.find(CRLF, pos);
 	}
-	return result;
+	return HttpStatus();
 }
 
 // Content-Disposition ヘッダーをパースする関数
-std::map<std::string, std::string> Method::ParseContentDisposition(const std::string &header) {
-	std::map<std::string, std::string> result;
-	std::istringstream                 stream(header);
-	std::string                        part;
+HttpStatus Method::ParseContentDisposition(
+	const std::string &content_disposition, ContentDisposition &result
+) {
+	std::istringstream stream(content_disposition);
+	std::string        part;
 
 	// form-data; name="file"; filename="a.txt"
 	std::getline(stream, part, ';'); // form-data
 	if (part != "form-data") {
-		throw HttpException(
-			"Error: Content-Disposition type must be 'form-data'", StatusCode(BAD_REQUEST)
-		);
+		return HttpStatus(BAD_REQUEST, "Error: Content-Disposition type must be 'form-data'");
 	}
 	// セミコロンで分割
 	while (std::getline(stream, part, ';')) {
 		part            = utils::Trim(part, OPTIONAL_WHITESPACE);
 		std::size_t pos = part.find('=');
 		if (pos == std::string::npos) {
-			throw HttpException(
-				"Error: Invalid Content-Disposition header format", StatusCode(BAD_REQUEST)
-			);
+			return HttpStatus(BAD_REQUEST, "Error: Invalid Content-Disposition header format");
 		}
 		// filename="a.txt"のような形で来る
 		std::string key   = utils::Trim(part.substr(0, pos), OPTIONAL_WHITESPACE);
 		std::string value = utils::Trim(part.substr(pos + 1), OPTIONAL_WHITESPACE);
 		value             = RemoveQuotes(value);
 		if (result.find(key) != result.end()) {
-			throw HttpException(
-				"Error: Duplicate field name in Content-Disposition header", StatusCode(BAD_REQUEST)
+			return HttpStatus(
+				BAD_REQUEST, "Error: Duplicate field name in Content-Disposition header"
 			);
 		}
 		result[key] = value;
 	}
 	if (result.find("name") == result.end()) {
-		throw HttpException(
-			"Error: Content-Disposition header must contain 'name' field", StatusCode(BAD_REQUEST)
+		return HttpStatus(
+			BAD_REQUEST, "Error: Content-Disposition header must contain 'name' field"
 		);
 	}
-	return result;
+	return HttpStatus();
 }
 
 } // namespace http
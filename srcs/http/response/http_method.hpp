@@ -1,10 +1,14 @@
 #ifndef HTTP_METHOD_HPP_
 #define HTTP_METHOD_HPP_
 
+#include "http_status.hpp"
+#include "mime_types.hpp"
+#include "request_header_fields.hpp"
 #include "stat.hpp"
 #include "status_code.hpp"
 #include "utils.hpp"
 #include <list>
+#include <map>
 
 namespace http {
 
@@ -13,71 +17,87 @@ typedef std::map<std::string, std::string> HeaderFields;
 class Method {
   public:
 	typedef std::list<std::string> AllowMethods;
-	static StatusCode              Handler(
-					 const std::string  &path,
-					 const std::string  &method,
-					 const AllowMethods &allow_methods,
-					 const std::string  &request_body_message,
-					 const HeaderFields &request_header_fields,
-					 std::string        &response_body_message,
-					 HeaderFields       &response_header_fields,
-					 const std::string  &index_file_path,
-					 bool                autoindex_on,
-					 const std::string  &file_upload_path
-				 );
+
+	// 成功した場合のstatus code(200, 201, 204)はstatus_codeに入れる
+	// root_lengthはpathの先頭のrootの長さ(autoindexではrootより後ろを表示する)
+	// GETで返すfileのContent-Typeはmime_typesから引く
+	static HttpStatus Handler(
+		const std::string         &path,
+		std::size_t                root_length,
+		const server::MimeTypes   &mime_types,
+		const std::string         &method,
+		const AllowMethods        &allow_methods,
+		const std::string         &request_body_message,
+		const RequestHeaderFields &request_header_fields,
+		std::string               &response_body_message,
+		HeaderFields              &response_header_fields,
+		const std::string         &index_file_path,
+		bool                       autoindex_on,
+		const std::string         &file_upload_path,
+		StatusCode                &status_code
+	);
 	static bool
 	IsAllowedMethod(const std::string &method, const std::list<std::string> &allow_methods);
 
   private:
 	static bool       IsSupportedMethod(const std::string &method);
-	static StatusCode GetHandler(
-		const std::string &path,
-		std::string       &body_message,
-		HeaderFields      &response_header_fields,
-		const std::string &index_file_path,
-		bool               autoindex_on
+	static HttpStatus GetHandler(
+		const std::string       &path,
+		std::size_t              root_length,
+		const server::MimeTypes &mime_types,
+		std::string             &body_message,
+		HeaderFields            &response_header_fields,
+		const std::string       &index_file_path,
+		bool                     autoindex_on
 	);
-	static StatusCode PostHandler(
-		const std::string  &file_upload_path,
-		const std::string  &request_body_message,
-		const HeaderFields &request_header_fields,
-		std::string        &response_body_message,
-		HeaderFields       &response_header_fields
+	static HttpStatus PostHandler(
+		const std::string         &file_upload_path,
+		const std::string         &request_body_message,
+		const RequestHeaderFields &request_header_fields,
+		std::string               &response_body_message,
+		HeaderFields              &response_header_fields,
+		StatusCode                &status_code
 	);
-	static StatusCode  DeleteHandler(const std::string &path, std::string &response_body_message);
-	static Stat        TryStat(const std::string &path);
-	static std::string ReadFile(const std::string &file_path);
-	static void        SystemExceptionHandler(int error_number);
-	static StatusCode  FileCreationHandler(
-		 const std::string &path,
-		 const std::string &request_body_message,
-		 std::string       &response_body_message
-	 );
-	static StatusCode FileCreationHandlerForMultiPart(
-		const std::string  &path,
-		const std::string  &request_body_message,
-		const HeaderFields &request_header_fields,
-		std::string        &response_body_message
+	static HttpStatus DeleteHandler(
+		const std::string &path, std::string &response_body_message, StatusCode &status_code
 	);
-	static StatusCode EchoPostHandler(
+	static HttpStatus TryStat(const std::string &path, struct stat &stat_buf);
+	static HttpStatus ReadFile(const std::string &file_path, std::string &content);
+	static HttpStatus SystemErrorHandler(int error_number);
+	static HttpStatus FileCreationHandler(
+		const std::string &path,
+		const std::string &request_body_message,
+		std::string       &response_body_message
+	);
+	static HttpStatus FileCreationHandlerForMultiPart(
+		const std::string         &path,
+		const std::string         &request_body_message,
+		const RequestHeaderFields &request_header_fields,
+		std::string               &response_body_message
+	);
+	static void EchoPostHandler(
 		const std::string &request_body_message,
 		std::string       &response_body_message,
 		HeaderFields      &response_header_fields
 	);
-	static utils::Result<std::string> AutoindexHandler(const std::string &path);
+	static utils::Result<std::string>
+	AutoindexHandler(const std::string &path, const std::string &display_path);
 
 	// マルチパート用のパートを表す構造体
 	struct Part {
 		std::map<std::string, std::string> headers;
 		std::string                        body;
 	};
+	typedef std::map<std::string, std::string> ContentDisposition;
 	// multipart/form-dataをデコードする関数
-	static std::vector<Part>
-	DecodeMultipartFormData(const std::string &content_type, const std::string &body);
-	static std::string ExtractBoundary(const std::string &content_type);
-	static Part        ParsePart(const std::string &part);
-	static std::map<std::string, std::string>
-	ParseContentDisposition(const std::string &content_disposition);
+	static HttpStatus DecodeMultipartFormData(
+		const std::string &content_type, const std::string &body, std::vector<Part> &parts
+	);
+	static HttpStatus ExtractBoundary(const std::string &content_type, std::string &boundary);
+	static HttpStatus ParsePart(const std::string &raw_part, Part &part);
+	static HttpStatus ParseContentDisposition(
+		const std::string &content_disposition, ContentDisposition &result
+	);
 };
 
 } // namespace http
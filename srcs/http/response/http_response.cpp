@@ -5,6 +5,8 @@
 #include "http_exception.hpp"
 #include "http_message.hpp"
 #include "http_parse.hpp"
+#include "http_response_serializer.hpp"
+#include "proxy_parse.hpp"
 #include <fstream>
 #include <iostream>
 #include <sstream>
@@ -13,26 +15,9 @@
 namespace http {
 namespace {
 
-std::string GetPathAfterRoot(const std::string &path) {
-	const std::string root = "/root";
-	size_t            pos  = path.find(root);
-	if (pos != std::string::npos) {
-		return path.substr(pos + root.length());
-	}
-	return path;
-}
-
-std::string GetCwd() {
-	const char            *file_path = __FILE__;
-	std::string            path(file_path);
-	std::string::size_type pos       = path.find_last_of("/\\");
-	std::string            directory = (pos != std::string::npos) ? path.substr(0, pos) : "";
-	return directory;
-}
-
+// file_pathは起動時にserverのrootからの絶対pathにしてある
 std::string ReadErrorFile(const std::string &file_path) {
-	const std::string root_path = GetCwd() + "/../../../root";
-	std::ifstream     file((root_path + file_path).c_str());
+	std::ifstream file(file_path.c_str());
 	if (!file) {
 		if (errno == EACCES || errno == EPERM) {
 			return HttpResponse::CreateDefaultBodyMessage(StatusCode(FORBIDDEN));
@@ -47,6 +32,14 @@ std::string ReadErrorFile(const std::string &file_path) {
 	return ss.str();
 }
 
+std::string CreateErrorBodyMessage(const StatusCode &status_code, const ErrorPage &error_page) {
+	if (error_page.IsOk() && status_code.GetEStatusCode() == error_page.GetValue().first) {
+		utils::Debug("ErrorPage", error_page.GetValue().second);
+		return ReadErrorFile(error_page.GetValue().second);
+	}
+	return HttpResponse::CreateDefaultBodyMessage(status_code);
+}
+
 bool IsErrorConnectionClose(EStatusCode status_code) {
 	return status_code == http::BAD_REQUEST || status_code == http::INTERNAL_SERVER_ERROR;
 }
@@ -61,88 +54,108 @@ bool IsExistPath(const std::string &path) {
 	return access(path.c_str(), F_OK) == 0;
 }
 
+// GETのみcacheの対象(同じrequest_targetなら同じresponseになる前提)
+void SetCgiCacheInfo(
+	CgiCacheInfo                &cache_info,
+	const CheckServerInfoResult &server_info_result,
+	const HttpRequestFormat     &request
+) {
+	if (request.request_line.method != GET || !request.body_message.empty()) {
+		return;
+	}
+	cache_info.is_cacheable   = true;
+	cache_info.virtual_server = server_info_result.virtual_server;
+	cache_info.key            = request.request_line.request_target;
+	cache_info.cache_valid    = server_info_result.cgi_cache_valid;
+}
+
 } // namespace
 
 HttpResponseResult HttpResponse::Run(
 	const http::ClientInfos             &client_info,
 	const server::VirtualServerAddrList &server_info,
 	const HttpRequestResult             &request_info,
-	CgiResult                           &cgi_result
+	CgiResult                           &cgi_result,
+	ProxyResult                         &proxy_result
 ) {
-	HttpResponseFormatResult response_format_result =
-		CreateHttpResponseFormat(client_info, server_info, request_info, cgi_result);
-	if (cgi_result.is_cgi) {
+	HttpResponseFormatResult response_format_result = CreateHttpResponseFormat(
+		client_info, server_info, request_info, cgi_result, proxy_result
+	);
+	if (cgi_result.is_cgi || proxy_result.is_proxy) {
 		return HttpResponseResult(false, "");
 	}
-	return HttpResponseResult(
-		response_format_result.is_connection_close,
-		CreateHttpResponse(response_format_result.http_response_format)
-	);
+	// responseは一時的なstd::stringを経由せずに直接書き出す
+	HttpResponseResult result(response_format_result.is_connection_close, "");
+	HttpResponseSerializer::Serialize(response_format_result.http_response_format, result.response);
+	return result;
 }
 
 HttpResponseFormatResult HttpResponse::CreateHttpResponseFormat(
 	const http::ClientInfos             &client_info,
 	const server::VirtualServerAddrList &server_info,
 	const HttpRequestResult             &request_info,
-	CgiResult                           &cgi_result
+	CgiResult                           &cgi_result,
+	ProxyResult                         &proxy_result
 ) {
 	StatusCode   status_code(OK);
 	HeaderFields response_header_fields = InitResponseHeaderFields(request_info);
 	std::string  response_body_message;
-	utils::Result< std::pair<unsigned int, std::string> > error_page;
+	ErrorPage    error_page;
+	HttpStatus   status;
 
 	try {
 		const CheckServerInfoResult &server_info_result =
 			HttpServerInfoCheck::Check(server_info, request_info.request);
-		error_page = server_info_result.error_page;
-		if (server_info_result.redirect.IsOk()) {
-			// redirect時のエラーでconnection:closeで返したい場合はcatchに入ってくれる
-			return HttpResponseFormatResult(
-				false, HandleRedirect(response_header_fields, server_info_result)
-			);
-		}
-		if (IsCgi(
-				server_info_result.cgi_extension,
-				server_info_result.path,
-				request_info.request.request_line.method,
-				server_info_result.allowed_methods
-			)) {
-			// これはパースした結果
-			cgi::CgiRequest cgi_request = CgiParse::Parse(
-				request_info.request,
-				server_info_result.path,
-				server_info_result.cgi_extension,
-				utils::ToString(client_info.listen_server_port),
-				client_info.ip
-			);
-			if (!IsExistPath(cgi_request.meta_variables[cgi::SCRIPT_NAME])) {
-				throw HttpException("Error: Not Found", StatusCode(NOT_FOUND));
+		status = server_info_result.status;
+		if (status.IsOk()) {
+			// virtual serverとlocationが決まった時だけerror_pageを使う
+			error_page = server_info_result.error_page;
+			if (server_info_result.redirect.IsOk()) {
+				HttpResponseFormat redirect_format;
+				status =
+					HandleRedirect(response_header_fields, server_info_result, redirect_format);
+				if (status.IsOk()) {
+					return HttpResponseFormatResult(false, redirect_format);
+				}
+			} else if (!server_info_result.proxy_pass.empty()) {
+				// responseはupstreamから受け取ったものをそのまま返す
+				status = SetProxyResult(
+					proxy_result, server_info_result, request_info.request, client_info.ip
+				);
+			} else if (IsCgi(
+						   server_info_result.cgi_extension,
+						   server_info_result.path,
+						   server_info_result.root_length
+					   )) {
+				status = SetCgiResult(
+					cgi_result, server_info_result, request_info.request, client_info
+				);
+			} else {
+				status = Method::Handler(
+					server_info_result.path,
+					server_info_result.root_length,
+					server_info_result.virtual_server->GetMimeTypes(),
+					request_info.request.request_line.method,
+					server_info_result.allowed_methods,
+					request_info.request.body_message,
+					request_info.request.header_fields,
+					response_body_message,
+					response_header_fields,
+					server_info_result.index,
+					server_info_result.autoindex,
+					server_info_result.file_upload_path,
+					status_code
+				);
 			}
-			cgi_result.is_cgi      = true;
-			cgi_result.cgi_request = cgi_request;
-		} else {
-			status_code = Method::Handler(
-				server_info_result.path,
-				request_info.request.request_line.method,
-				server_info_result.allowed_methods,
-				request_info.request.body_message,
-				request_info.request.header_fields,
-				response_body_message,
-				response_header_fields,
-				server_info_result.index,
-				server_info_result.autoindex,
-				server_info_result.file_upload_path
-			);
 		}
 	} catch (const HttpException &e) {
+		// システムの失敗(500)だけがここに来る
+		status = HttpStatus(e.GetStatusCode().GetEStatusCode(), "Error: Internal Server Error");
+	}
+	if (!status.IsOk()) {
 		// ステータスコードが300番台以上の場合
-		status_code = e.GetStatusCode();
-		if (error_page.IsOk() && status_code.GetEStatusCode() == error_page.GetValue().first) {
-			utils::Debug("ErrorPage", error_page.GetValue().second);
-			response_body_message = ReadErrorFile(error_page.GetValue().second);
-		} else {
-			response_body_message = CreateDefaultBodyMessage(status_code);
-		}
+		status_code           = StatusCode(status.GetStatusCode());
+		response_body_message = CreateErrorBodyMessage(status_code, error_page);
 	}
 	response_header_fields[CONTENT_LENGTH] = utils::ToString(response_body_message.length());
 	SetErrorConnectionClose(response_header_fields, status_code.GetEStatusCode());
@@ -157,26 +170,63 @@ HttpResponseFormatResult HttpResponse::CreateHttpResponseFormat(
 }
 
 std::string HttpResponse::CreateDefaultBodyMessage(const StatusCode &status_code) {
-	std::ostringstream body_message;
-	body_message << "<html>" << CRLF << "<head><title>" << status_code.GetStatusCode() << SP
-				 << status_code.GetReasonPhrase() << "</title></head>" << CRLF << "<body>" << CRLF
-				 << "<center><h1>" << status_code.GetStatusCode() << SP
-				 << status_code.GetReasonPhrase() << "</h1></center>" << CRLF << "<hr><center>"
-				 << SERVER_VERSION << "</center>" << CRLF << "</body>" << CRLF << "</html>" << CRLF;
-	return body_message.str();
+	return status_code.GetDefaultBodyMessage();
 }
 
 std::string HttpResponse::CreateHttpResponse(const HttpResponseFormat &response) {
-	std::ostringstream response_stream;
-	response_stream << response.status_line.version << SP << response.status_line.status_code << SP
-					<< response.status_line.reason_phrase << CRLF;
-	typedef HeaderFields::const_iterator It;
-	for (It it = response.header_fields.begin(); it != response.header_fields.end(); ++it) {
-		response_stream << it->first << ":" << SP << it->second << CRLF;
+	std::string buffer;
+	HttpResponseSerializer::Serialize(response, buffer);
+	return buffer;
+}
+
+HttpStatus HttpResponse::SetProxyResult(
+	ProxyResult                 &proxy_result,
+	const CheckServerInfoResult &server_info_result,
+	const HttpRequestFormat     &request,
+	const std::string           &client_ip
+) {
+	if (!Method::IsAllowedMethod(request.request_line.method, server_info_result.allowed_methods)) {
+		return HttpStatus(METHOD_NOT_ALLOWED, "Error: Method Not Allowed");
+	}
+	proxy_result.is_proxy        = true;
+	proxy_result.upstreams       = server_info_result.proxy_pass;
+	proxy_result.balance         = server_info_result.proxy_balance;
+	proxy_result.request         = ProxyParse::CreateRequest(request, client_ip);
+	proxy_result.is_head_request = request.request_line.method == HEAD;
+	proxy_result.is_idempotent   = request.request_line.method == GET ||
+								 request.request_line.method == HEAD ||
+								 request.request_line.method == DELETE;
+	return HttpStatus();
+}
+
+HttpStatus HttpResponse::SetCgiResult(
+	CgiResult                   &cgi_result,
+	const CheckServerInfoResult &server_info_result,
+	const HttpRequestFormat     &request,
+	const http::ClientInfos     &client_info
+) {
+	// methodがGETかPOSTかつallow_methodかどうか
+	const std::string &method = request.request_line.method;
+	if (!Method::IsAllowedMethod(method, server_info_result.allowed_methods) ||
+		(method != GET && method != POST)) {
+		return HttpStatus(METHOD_NOT_ALLOWED, "Error: Method Not Allowed");
+	}
+	// これはパースした結果
+	cgi::CgiRequest cgi_request = CgiParse::Parse(
+		request,
+		server_info_result.path,
+		server_info_result.root_length,
+		server_info_result.cgi_extension,
+		utils::ToString(client_info.listen_server_port),
+		client_info.ip
+	);
+	if (!IsExistPath(cgi_request.meta_variables[cgi::SCRIPT_NAME])) {
+		return HttpStatus(NOT_FOUND, "Error: Not Found");
 	}
-	response_stream << CRLF;
-	response_stream << response.body_message;
-	return response_stream.str();
+	cgi_result.is_cgi      = true;
+	cgi_result.cgi_request = cgi_request;
+	SetCgiCacheInfo(cgi_result.cache_info, server_info_result, request);
+	return HttpStatus();
 }
 
 HeaderFields HttpResponse::InitResponseHeaderFields(const HttpRequestResult &request_info) {
@@ -191,16 +241,13 @@ HeaderFields HttpResponse::InitResponseHeaderFields(const HttpRequestResult &req
 	return response_header_fields;
 }
 
-bool HttpResponse::IsConnectionKeep(const HeaderFields &request_header_fields) {
-	HeaderFields::const_iterator it = request_header_fields.find(CONNECTION);
+bool HttpResponse::IsConnectionKeep(const RequestHeaderFields &request_header_fields) {
+	RequestHeaderFields::const_iterator it = request_header_fields.find(CONNECTION);
 	return it == request_header_fields.end() || it->second != CLOSE;
 }
 
 bool HttpResponse::IsCgi(
-	const std::string          &cgi_extension,
-	const std::string          &path,
-	const std::string          &method,
-	const Method::AllowMethods &allowed_methods
+	const std::string &cgi_extension, const std::string &path, std::size_t root_length
 ) {
 	// cgi_extensionがあるかどうか
 	if (cgi_extension.empty()) {
@@ -208,18 +255,13 @@ bool HttpResponse::IsCgi(
 	}
 	// pathにcgi_extensionで設定された拡張子が含まれているかどうか
 	// falseの場合はpathに普通のリクエストとして送られる
-	if (GetPathAfterRoot(path).find(cgi_extension) == std::string::npos) {
-		return false;
-	}
-	// methodがGETかPOSTかつallow_methodかどうか
-	if (!(Method::IsAllowedMethod(method, allowed_methods)) || (method != GET && method != POST)) {
-		throw HttpException("Error: Method Not Allowed", StatusCode(METHOD_NOT_ALLOWED));
-	}
-	return true;
+	return path.find(cgi_extension, root_length) != std::string::npos;
 }
 
-HttpResponseFormat HttpResponse::HandleRedirect(
-	HeaderFields &response_header_fields, const CheckServerInfoResult &server_info_result
+HttpStatus HttpResponse::HandleRedirect(
+	HeaderFields                &response_header_fields,
+	const CheckServerInfoResult &server_info_result,
+	HttpResponseFormat          &redirect_format
 ) {
 	// httpがない場合は現在のサーバーに送り、httpがある場合はそのまま
 	const std::string prefix = "http://";
@@ -232,17 +274,17 @@ HttpResponseFormat HttpResponse::HandleRedirect(
 	utils::Debug("Redirect", response_header_fields[LOCATION]);
 	// サーバーで用意しているステータス以外を指定した場合はbodyやphraseを返さない
 	if (server_info_result.redirect.GetValue().first == MOVED_PERMANENTLY) {
-		throw HttpException("Moved Permanently", StatusCode(MOVED_PERMANENTLY));
+		return HttpStatus(MOVED_PERMANENTLY, "Moved Permanently");
 	} else if (server_info_result.redirect.GetValue().first == FOUND) {
-		throw HttpException("Found", StatusCode(FOUND));
-	} else {
-		response_header_fields[CONTENT_LENGTH] = "0";
-		const std::string redirect_status_code =
-			utils::ToString(server_info_result.redirect.GetValue().first);
-		return HttpResponseFormat(
-			StatusLine(HTTP_VERSION, redirect_status_code, ""), response_header_fields, ""
-		);
+		return HttpStatus(FOUND, "Found");
 	}
+	response_header_fields[CONTENT_LENGTH] = "0";
+	const std::string redirect_status_code =
+		utils::ToString(server_info_result.redirect.GetValue().first);
+	redirect_format = HttpResponseFormat(
+		StatusLine(HTTP_VERSION, redirect_status_code, ""), response_header_fields, ""
+	);
+	return HttpStatus();
 }
 
 std::string HttpResponse::CreateErrorResponse(const StatusCode &status_code) {
@@ -257,6 +299,11 @@ std::string HttpResponse::CreateErrorResponse(const StatusCode &status_code) {
 	return CreateHttpResponse(response);
 }
 
+// 1xxはheader fieldsもbodyも持たないstatus lineだけのresponse
+std::string HttpResponse::CreateContinueResponse() {
+	return StatusCode(CONTINUE).GetStatusLine() + CRLF;
+}
+
 std::string HttpResponse::GetResponseFromCgi(
 	const cgi::CgiResponseParse::ParsedData &cgi_parsed_data, const HttpRequestResult &request_info
 ) {
@@ -6,6 +6,7 @@
 #include "http_method.hpp"
 #include "http_result.hpp"
 #include "http_serverinfo_check.hpp"
+#include "http_status.hpp"
 #include "status_code.hpp"
 #include "utils.hpp"
 #include <map>
@@ -39,6 +40,8 @@ class Stat;
 //    GetInternalServerErrorBodyMessage();
 // };
 
+typedef utils::Result< std::pair<unsigned int, std::string> > ErrorPage;
+
 struct HttpResponseResult {
 	HttpResponseResult(bool is_connection_close, const std::string &response)
 		: is_connection_close(is_connection_close), response(response) {}
@@ -62,9 +65,11 @@ class HttpResponse {
 					   Run(const http::ClientInfos             &client_info,
 						   const server::VirtualServerAddrList &server_info,
 						   const HttpRequestResult             &request_info,
-						   CgiResult                           &cgi_result);
+						   CgiResult                           &cgi_result,
+						   ProxyResult                         &proxy_result);
 	static std::string CreateErrorResponse(const StatusCode &status_code);
-	static bool        IsConnectionKeep(const HeaderFields &request_header_fields);
+	static std::string CreateContinueResponse();
+	static bool        IsConnectionKeep(const RequestHeaderFields &request_header_fields);
 	static std::string CreateDefaultBodyMessage(const StatusCode &status_code);
 	static std::string GetResponseFromCgi(
 		const cgi::CgiResponseParse::ParsedData &cgi_parsed_data,
@@ -80,17 +85,28 @@ class HttpResponse {
 		const http::ClientInfos             &client_info,
 		const server::VirtualServerAddrList &server_info,
 		const HttpRequestResult             &request_info,
-		CgiResult                           &cgi_result
+		CgiResult                           &cgi_result,
+		ProxyResult                         &proxy_result
 	);
 	static HeaderFields InitResponseHeaderFields(const HttpRequestResult &request_info);
-	static bool         IsCgi(
-				const std::string          &cgi_extension,
-				const std::string          &path,
-				const std::string          &method,
-				const Method::AllowMethods &allowed_methods
-			);
-	static HttpResponseFormat HandleRedirect(
-		HeaderFields &response_header_fields, const CheckServerInfoResult &server_info_result
+	static bool
+	IsCgi(const std::string &cgi_extension, const std::string &path, std::size_t root_length);
+	static HttpStatus HandleRedirect(
+		HeaderFields                &response_header_fields,
+		const CheckServerInfoResult &server_info_result,
+		HttpResponseFormat          &redirect_format
+	);
+	static HttpStatus SetProxyResult(
+		ProxyResult                 &proxy_result,
+		const CheckServerInfoResult &server_info_result,
+		const HttpRequestFormat     &request,
+		const std::string           &client_ip
+	);
+	static HttpStatus SetCgiResult(
+		CgiResult                   &cgi_result,
+		const CheckServerInfoResult &server_info_result,
+		const HttpRequestFormat     &request,
+		const http::ClientInfos     &client_info
 	);
 };
 
@@ -0,0 +1,120 @@
+#include "http_response_serializer.hpp"
+#include "http_message.hpp"
+
+namespace http {
+namespace {
+
+const char *const DAY_NAMES[]   = {"Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"};
+const char *const MONTH_NAMES[] = {
+	"Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"
+};
+
+void AppendNumber(std::string &buffer, int number, std::size_t width) {
+	char        digits[16];
+	std::size_t size = 0;
+	do {
+		digits[size++] = static_cast<char>('0' + number % 10);
+		number /= 10;
+	} while (number > 0 && size < sizeof(digits));
+	for (; size < width; ++size) {
+		digits[size] = '0';
+	}
+	while (size > 0) {
+		buffer += digits[--size];
+	}
+}
+
+// IMF-fixdate(RFC 9110 5.6.7) localeに依存しないように自分で組み立てる
+void CreateDateHeaderLine(std::time_t now, std::string &line) {
+	struct tm gmt;
+	gmtime_r(&now, &gmt);
+	line.clear();
+	line += DATE;
+	line += ":";
+	line += SP;
+	line += DAY_NAMES[gmt.tm_wday];
+	line += ", ";
+	AppendNumber(line, gmt.tm_mday, 2);
+	line += SP;
+	line += MONTH_NAMES[gmt.tm_mon];
+	line += SP;
+	AppendNumber(line, gmt.tm_year + 1900, 4);
+	line += SP;
+	AppendNumber(line, gmt.tm_hour, 2);
+	line += ":";
+	AppendNumber(line, gmt.tm_min, 2);
+	line += ":";
+	AppendNumber(line, gmt.tm_sec, 2);
+	line += " GMT";
+	line += CRLF;
+}
+
+std::size_t CountHeaderLineSize(const std::string &name, const std::string &value) {
+	return name.size() + 1 + SP.size() + value.size() + CRLF.size();
+}
+
+void AppendHeaderLine(std::string &buffer, const std::string &name, const std::string &value) {
+	buffer += name;
+	buffer += ':';
+	buffer += SP;
+	buffer += value;
+	buffer += CRLF;
+}
+
+} // namespace
+
+void HttpResponseSerializer::Serialize(const HttpResponseFormat &response, std::string &buffer) {
+	Serialize(response, std::time(NULL), buffer);
+}
+
+void HttpResponseSerializer::Serialize(
+	const HttpResponseFormat &response, std::time_t now, std::string &buffer
+) {
+	const StatusLine  &status_line = response.status_line;
+	const std::string &date_line   = GetDateHeaderLine(now);
+	typedef HeaderFields::const_iterator It;
+
+	std::size_t size = status_line.version.size() + SP.size() + status_line.status_code.size() +
+					   SP.size() + status_line.reason_phrase.size() + CRLF.size();
+	for (It it = response.header_fields.begin(); it != response.header_fields.end(); ++it) {
+		size += CountHeaderLineSize(it->first, it->second);
+	}
+	size += date_line.size() + CRLF.size() + response.body_message.size();
+
+	buffer.clear();
+	buffer.reserve(size);
+	buffer += status_line.version;
+	buffer += SP;
+	buffer += status_line.status_code;
+	buffer += SP;
+	buffer += status_line.reason_phrase;
+	buffer += CRLF;
+	// header fieldsに既にdateがある場合(cgiなど)はそちらを使う
+	bool is_date_written = false;
+	for (It it = response.header_fields.begin(); it != response.header_fields.end(); ++it) {
+		if (!is_date_written && it->first >= DATE) {
+			if (it->first != DATE) {
+				buffer += date_line;
+			}
+			is_date_written = true;
+		}
+		AppendHeaderLine(buffer, it->first, it->second);
+	}
+	if (!is_date_written) {
+		buffer += date_line;
+	}
+	buffer += CRLF;
+	buffer += response.body_message;
+}
+
+const std::string &HttpResponseSerializer::GetDateHeaderLine(std::time_t now) {
+	static std::string date_line;
+	static std::time_t date_line_time = static_cast<std::time_t>(-1);
+	if (now != date_line_time || date_line.empty()) {
+		CreateDateHeaderLine(now, date_line);
+		date_line_time = now;
+	}
+	return date_line;
+}
+
+} // namespace http
@@ -0,0 +1,28 @@
+#ifndef HTTP_RESPONSE_SERIALIZER_HPP_
+#define HTTP_RESPONSE_SERIALIZER_HPP_
+
+#include "http_format.hpp"
+#include <ctime>
+#include <string>
+
+namespace http {
+
+// HttpResponseFormatを1つのbufferに書き出す
+// 先に全体の長さを数えてreserveするので、bufferのcapacityが足りていれば確保し直さない
+// header fieldsはfield-nameの順に出力し、dateはその順の位置に差し込む
+class HttpResponseSerializer {
+  public:
+	static void Serialize(const HttpResponseFormat &response, std::string &buffer);
+	static void
+	Serialize(const HttpResponseFormat &response, std::time_t now, std::string &buffer);
+	// "date: Sun, 06 Nov 1994 08:49:37 GMT\r\n" (同じ秒の間は作り直さない)
+	static const std::string &GetDateHeaderLine(std::time_t now);
+
+  private:
+	HttpResponseSerializer();
+	~HttpResponseSerializer();
+};
+
+} // namespace http
+
+#endif
@@ -1,27 +1,18 @@
 #include "http_serverinfo_check.hpp"
-#include "http_exception.hpp"
 #include "http_message.hpp"
 #include "status_code.hpp"
 #include "utils.hpp"
-#include <algorithm>
 #include <cstdlib>
 #include <iostream>
 
 namespace http {
 namespace {
 
-std::string GetCwd() {
-	const char            *file_path = __FILE__;
-	std::string            path(file_path);
-	std::string::size_type pos       = path.find_last_of("/\\");
-	std::string            directory = (pos != std::string::npos) ? path.substr(0, pos) : "";
-	return directory;
-}
-
-void CheckPayloadTooLarge(std::size_t payload_size, std::size_t client_max_body_size) {
+HttpStatus CheckPayloadTooLarge(std::size_t payload_size, std::size_t client_max_body_size) {
 	if (payload_size > client_max_body_size) {
-		throw HttpException("Error: payload too large.", StatusCode(PAYLOAD_TOO_LARGE));
+		return HttpStatus(PAYLOAD_TOO_LARGE, "Error: payload too large.");
 	}
+	return HttpStatus();
 }
 
 } // namespace
@@ -32,57 +23,87 @@ CheckServerInfoResult HttpServerInfoCheck::Check(
 	CheckServerInfoResult        result;
 	const server::VirtualServer *vs = FindVirtualServer(server_infos, request.header_fields);
 	result.host_name                = request.header_fields.at(HOST);
-	CheckVirtualServer(result, *vs, request.header_fields, request.body_message.size());
-	CheckLocationList(result, vs->GetLocationList(), request.request_line.request_target);
+	result.virtual_server           = vs;
+
+	result.status =
+		CheckVirtualServer(result, *vs, request.header_fields, request.body_message.size());
+	if (!result.status.IsOk()) {
+		return result;
+	}
+	result.status = CheckLocationList(result, *vs, request.request_line.request_target);
 	return result;
 }
 
+std::size_t HttpServerInfoCheck::GetClientMaxBodySize(
+	const server::VirtualServerAddrList &server_infos, const RequestHeaderFields &header_fields
+) {
+	return FindVirtualServer(server_infos, header_fields)->GetClientMaxBodySize();
+}
+
+const server::ConnectionLimits &HttpServerInfoCheck::GetConnectionLimits(
+	const server::VirtualServerAddrList &server_infos, const HttpRequestFormat &request
+) {
+	const server::VirtualServer *virtual_server =
+		FindVirtualServer(server_infos, request.header_fields);
+	const server::Location *location =
+		virtual_server->FindLocation(request.request_line.request_target);
+	return location == NULL ? virtual_server->GetConnectionLimits() : location->connection_limits;
+}
+
+// server_nameに無いhostの場合はdefault server
 const server::VirtualServer *HttpServerInfoCheck::FindVirtualServer(
-	const server::VirtualServerAddrList &virtual_servers, const HeaderFields &header_fields
+	const server::VirtualServerAddrList &virtual_servers, const RequestHeaderFields &header_fields
 ) {
-	typedef server::VirtualServerAddrList::const_iterator VsAddrListItr;
-	for (VsAddrListItr it = virtual_servers.begin(); it != virtual_servers.end(); ++it) {
-		// localhost:8080 -> localhost
-		std::string host_value = header_fields.at(HOST);
-		std::size_t colon_pos  = host_value.find_first_of(':');
-		std::string host_name  = host_value.substr(0, colon_pos);
-		if (std::find(
-				(*it)->GetServerNameList().begin(), (*it)->GetServerNameList().end(), host_name
-			) != (*it)->GetServerNameList().end()) {
-			return *it;
-		}
-	}
-	return virtual_servers.front();
-	// 見つからなかった場合は一番最初のサーバーを返す（デフォルトサーバー）
+	return virtual_servers.FindVirtualServer(header_fields.at(HOST));
 }
 
 // Check VirtualServer
-void HttpServerInfoCheck::CheckVirtualServer(
+HttpStatus HttpServerInfoCheck::CheckVirtualServer(
 	CheckServerInfoResult       &result,
 	const server::VirtualServer &virtual_server,
-	const HeaderFields          &header_fields,
+	const RequestHeaderFields   &header_fields,
 	std::size_t                  request_body_size
 ) {
 	if (header_fields.find(CONTENT_LENGTH) != header_fields.end()) {
 		utils::Result<std::size_t> content_length =
 			utils::ConvertStrToSize(header_fields.at(CONTENT_LENGTH));
 		if (content_length.IsOk()) {
-			CheckPayloadTooLarge(content_length.GetValue(), virtual_server.GetClientMaxBodySize());
+			const HttpStatus status = CheckPayloadTooLarge(
+				content_length.GetValue(), virtual_server.GetClientMaxBodySize()
+			);
+			if (!status.IsOk()) {
+				return status;
+			}
 		}
 	}
-	CheckPayloadTooLarge(request_body_size, virtual_server.GetClientMaxBodySize());
+	const HttpStatus status =
+		CheckPayloadTooLarge(request_body_size, virtual_server.GetClientMaxBodySize());
+	if (!status.IsOk()) {
+		return status;
+	}
 	if (!virtual_server.GetErrorPage().second.empty()) {
 		result.error_page.Set(true, virtual_server.GetErrorPage());
 	}
+	return HttpStatus();
 }
 
 // Check LocationList
-void HttpServerInfoCheck::CheckLocationList(
-	CheckServerInfoResult &result,
-	const VsLocationList  &locations,
-	const std::string     &request_target
+HttpStatus HttpServerInfoCheck::CheckLocationList(
+	CheckServerInfoResult       &result,
+	const server::VirtualServer &virtual_server,
+	const std::string           &request_target
 ) {
-	const server::Location &match_location = FindLocation(result, locations, request_target);
+	// ex. request.target /www/target.html
+	// location1 /www/data/
+	// location1 /www/
+	// location2 /
+	// -> /www/
+	result.path                   = request_target;
+	const server::Location *match = virtual_server.FindLocation(request_target);
+	if (match == NULL) {
+		return HttpStatus(NOT_FOUND, "Error: location not found");
+	}
+	const server::Location &match_location = *match;
 	CheckIndex(result, match_location);
 	CheckAutoIndex(result, match_location);
 	CheckAlias(result, match_location);
@@ -90,39 +111,16 @@ void HttpServerInfoCheck::CheckLocationList(
 	CheckAllowedMethods(result, match_location);
 	CheckCgiExtension(result, match_location);
 	CheckUploadPath(result, match_location);
-	const std::string ROOT_PATH = GetCwd() + "/../../../../root";
-	result.path                 = ROOT_PATH + result.path;
+	CheckCgiCacheValid(result, match_location);
+	CheckProxyPass(result, match_location);
+	// rootは起動時に絶対pathにしてあるので先頭に足すだけ
+	result.path.insert(0, match_location.root);
+	result.root_length = match_location.root.size();
 	// upload_dirがない場合はそのまま返す
 	if (!result.file_upload_path.empty()) {
-		result.file_upload_path = ROOT_PATH + result.file_upload_path;
-	}
-	return;
-}
-
-const server::Location HttpServerInfoCheck::FindLocation(
-	CheckServerInfoResult &result,
-	const VsLocationList  &locations,
-	const std::string     &request_target
-) {
-	server::Location match_loc;
-
-	// ex. request.target /www/target.html:
-	// uri = /www/, target = target.html
-	// location1 /www/data/
-	// location1 /www/
-	// location2 /
-	// -> /www/
-	result.path = request_target;
-	for (VsLocationList::const_iterator it = locations.begin(); it != locations.end(); ++it) {
-		if ((utils::StartWith(request_target, (*it).request_uri)) &&
-			(*it).request_uri.length() > match_loc.request_uri.length()) { // Longest Match
-			match_loc = *it;
-		}
-	}
-	if (match_loc.request_uri.empty()) {
-		throw HttpException("Error: location not found", StatusCode(NOT_FOUND));
+		result.file_upload_path.insert(0, match_location.root);
 	}
-	return match_loc;
+	return HttpStatus();
 }
 
 void HttpServerInfoCheck::CheckIndex(
@@ -208,4 +206,17 @@ void HttpServerInfoCheck::CheckUploadPath(
 	result.file_upload_path            = file_upload_path;
 }
 
+void HttpServerInfoCheck::CheckCgiCacheValid(
+	CheckServerInfoResult &result, const server::Location &location
+) {
+	result.cgi_cache_valid = location.cgi_cache_valid;
+}
+
+void HttpServerInfoCheck::CheckProxyPass(
+	CheckServerInfoResult &result, const server::Location &location
+) {
+	result.proxy_pass    = location.proxy_pass;
+	result.proxy_balance = location.proxy_balance;
+}
+
 } // namespace http
@@ -2,21 +2,18 @@
 #define HTTP_SERVERINFO_CHECK_HPP_
 
 #include "http_format.hpp"
+#include "http_status.hpp"
 #include "result.hpp"
 #include "virtual_server.hpp"
+#include "virtual_server_addr_list.hpp"
 #include <list>
 #include <string>
 
-namespace server {
-
-typedef std::list<const VirtualServer *> VirtualServerAddrList;
-
-}
-
 namespace http {
 
 struct CheckServerInfoResult {
-	std::string path; // alias, indexを見る
+	std::string path;        // alias, indexを見る
+	std::size_t root_length; // pathの先頭のlocationのrootの長さ
 	std::string index;
 	bool        autoindex;
 
@@ -24,13 +21,25 @@ struct CheckServerInfoResult {
 	std::list<std::string> allowed_methods;
 	std::string            cgi_extension;
 	std::string            file_upload_path;
+	unsigned int           cgi_cache_valid;
+
+	// cgiのresponseをcacheする単位
+	const server::VirtualServer *virtual_server;
+
+	// reverse proxy
+	server::Location::UpstreamList proxy_pass;
+	std::string                    proxy_balance;
+
+	// 4xxの場合はここにstatus codeが入る(他のメンバーは途中までしか埋まっていない)
+	HttpStatus status;
 
 	utils::Result< std::pair<unsigned int, std::string> > redirect;
 	utils::Result< std::pair<unsigned int, std::string> > error_page;
 
 	std::string host_name;
 	std::string server_port;
-	CheckServerInfoResult() : autoindex(false) {
+	CheckServerInfoResult()
+		: root_length(0), autoindex(false), cgi_cache_valid(0), virtual_server(NULL) {
 		redirect.Set(false);
 		error_page.Set(false);
 	};
@@ -42,25 +51,20 @@ class HttpServerInfoCheck {
 	~HttpServerInfoCheck();
 
 	static const server::VirtualServer *FindVirtualServer(
-		const server::VirtualServerAddrList &virtual_servers, const HeaderFields &header_fields
+		const server::VirtualServerAddrList &virtual_servers,
+		const RequestHeaderFields           &header_fields
 	);
-	static void CheckVirtualServer(
+	static HttpStatus CheckVirtualServer(
 		CheckServerInfoResult       &result,
 		const server::VirtualServer &virtual_server,
-		const HeaderFields          &header_fields,
+		const RequestHeaderFields   &header_fields,
 		std::size_t                  request_body_size
 	);
 
-	typedef server::VirtualServer::LocationList VsLocationList;
-	static void                                 CheckLocationList(
-										CheckServerInfoResult &result,
-										const VsLocationList  &locations,
-										const std::string     &request_target
-									);
-	static const server::Location FindLocation(
-		CheckServerInfoResult &result,
-		const VsLocationList  &locations,
-		const std::string     &request_target
+	static HttpStatus CheckLocationList(
+		CheckServerInfoResult       &result,
+		const server::VirtualServer &virtual_server,
+		const std::string           &request_target
 	);
 	static void CheckIndex(CheckServerInfoResult &result, const server::Location &location);
 	static void CheckAutoIndex(CheckServerInfoResult &result, const server::Location &location);
@@ -70,10 +74,21 @@ class HttpServerInfoCheck {
 	CheckAllowedMethods(CheckServerInfoResult &result, const server::Location &location);
 	static void CheckCgiExtension(CheckServerInfoResult &result, const server::Location &location);
 	static void CheckUploadPath(CheckServerInfoResult &result, const server::Location &location);
+	static void
+	CheckCgiCacheValid(CheckServerInfoResult &result, const server::Location &location);
+	static void CheckProxyPass(CheckServerInfoResult &result, const server::Location &location);
 
   public:
 	static CheckServerInfoResult
 	Check(const server::VirtualServerAddrList &server_infos, const HttpRequestFormat &request);
+	// header fieldsだけでvirtual serverを決めてbodyの上限を返す(bodyを読む前に使う)
+	static std::size_t GetClientMaxBodySize(
+		const server::VirtualServerAddrList &server_infos, const RequestHeaderFields &header_fields
+	);
+	// request line, header fieldsで決まるlocationの接続の設定(locationが無ければserverの設定)
+	static const server::ConnectionLimits &GetConnectionLimits(
+		const server::VirtualServerAddrList &server_infos, const HttpRequestFormat &request
+	);
 };
 
 } // namespace http
@@ -0,0 +1,90 @@
+#include "proxy_parse.hpp"
+#include "http_format.hpp"
+#include "http_message.hpp"
+#include "utils.hpp"
+#include <algorithm>
+#include <vector>
+
+namespace http {
+namespace {
+
+// upstreamとの接続ごとに決め直すのでそのまま転送しないheader
+const std::string HOP_BY_HOP_HEADERS[] = {
+	CONNECTION,
+	KEEP_ALIVE,
+	"proxy-connection",
+	"te",
+	"trailer",
+	"upgrade",
+	TRANSFER_ENCODING,
+	CONTENT_LENGTH,
+	// 100-continueはwebservがbodyを全部受け取ってから転送するので不要
+	EXPECT
+};
+const std::size_t HOP_BY_HOP_HEADERS_SIZE =
+	sizeof(HOP_BY_HOP_HEADERS) / sizeof(HOP_BY_HOP_HEADERS[0]);
+
+// "keep-alive, X-Foo" -> {"keep-alive", "x-foo"}
+ProxyParse::ConnectionOptionSet CreateConnectionOptions(const RequestHeaderFields &header_fields) {
+	ProxyParse::ConnectionOptionSet connection_options;
+	const RequestHeaderFields::const_iterator connection = header_fields.find(CONNECTION);
+	if (connection == header_fields.end()) {
+		return connection_options;
+	}
+	const std::vector<std::string> tokens = utils::SplitStr(connection->second, ",");
+	typedef std::vector<std::string>::const_iterator Itr;
+	for (Itr it = tokens.begin(); it != tokens.end(); ++it) {
+		const std::string token = utils::Trim(*it, OPTIONAL_WHITESPACE);
+		if (!token.empty()) {
+			connection_options.insert(utils::ToLowerString(token));
+		}
+	}
+	return connection_options;
+}
+
+} // namespace
+
+// bodyはparse済み(chunkedもdecode済み)なのでcontent-lengthを付け直す
+// upstreamとの接続は使い回すので常にkeep-alive
+// Connectionに書かれたheaderもclientとの接続だけのものなので送らない(RFC 9110 7.6.1)
+std::string
+ProxyParse::CreateRequest(const HttpRequestFormat &request, const std::string &client_ip) {
+	std::string proxy_request;
+	proxy_request += request.request_line.method + SP + request.request_line.request_target + SP +
+					 HTTP_VERSION + CRLF;
+
+	const ConnectionOptionSet connection_options = CreateConnectionOptions(request.header_fields);
+	typedef RequestHeaderFields::const_iterator Itr;
+	for (Itr it = request.header_fields.begin(); it != request.header_fields.end(); ++it) {
+		if (IsHopByHopHeader(it->first) || it->first == X_FORWARDED_FOR ||
+			connection_options.count(it->first) != 0) {
+			continue;
+		}
+		proxy_request += it->first + ":" + SP + it->second + CRLF;
+	}
+	const RequestHeaderFields::const_iterator forwarded_for =
+		request.header_fields.find(X_FORWARDED_FOR);
+	if (forwarded_for != request.header_fields.end()) {
+		proxy_request += X_FORWARDED_FOR + ":" + SP + forwarded_for->second + ", " + client_ip + CRLF;
+	} else {
+		proxy_request += X_FORWARDED_FOR + ":" + SP + client_ip + CRLF;
+	}
+	if (!request.body_message.empty() || request.request_line.method == POST) {
+		proxy_request += CONTENT_LENGTH + ":" + SP +
+						 utils::ToString(request.body_message.size()) + CRLF;
+	}
+	proxy_request += CONNECTION + ":" + SP + KEEP_ALIVE + CRLF;
+	proxy_request += CRLF;
+	proxy_request += request.body_message;
+	return proxy_request;
+}
+
+bool ProxyParse::IsHopByHopHeader(const std::string &header_field_name) {
+	return std::find(
+			   HOP_BY_HOP_HEADERS,
+			   HOP_BY_HOP_HEADERS + HOP_BY_HOP_HEADERS_SIZE,
+			   header_field_name
+		   ) != HOP_BY_HOP_HEADERS + HOP_BY_HOP_HEADERS_SIZE;
+}
+
+} // namespace http
@@ -0,0 +1,29 @@
+#ifndef PROXY_PARSE_HPP_
+#define PROXY_PARSE_HPP_
+
+#include <set>
+#include <string>
+
+namespace http {
+
+struct HttpRequestFormat;
+
+// clientからのrequestをupstreamに送るrequestに変換する
+class ProxyParse {
+  public:
+	typedef std::set<std::string> ConnectionOptionSet;
+
+	static std::string CreateRequest(const HttpRequestFormat &request, const std::string &client_ip);
+
+  private:
+	ProxyParse();
+	~ProxyParse();
+	ProxyParse(const ProxyParse &other);
+	ProxyParse &operator=(const ProxyParse &other);
+
+	static bool IsHopByHopHeader(const std::string &header_field_name);
+};
+
+} // namespace http
+
+#endif
@@ -1,56 +1,179 @@
 #include "status_code.hpp"
+#include "http_message.hpp"
 #include "utils.hpp"
+#include <sstream>
+#include <stdexcept> // out_of_range
+#include <vector>
 
 namespace http {
+namespace {
 
-StatusCode::ReasonPhrase StatusCode::InitReasonPhrase() {
-	ReasonPhrase init_reason_phrase;
-	init_reason_phrase[OK]                    = "OK";
-	init_reason_phrase[CREATED]               = "Created";
-	init_reason_phrase[NO_CONTENT]            = "No Content";
-	init_reason_phrase[MOVED_PERMANENTLY]     = "Moved Permanently";
-	init_reason_phrase[FOUND]                 = "Found";
-	init_reason_phrase[BAD_REQUEST]           = "Bad Request";
-	init_reason_phrase[FORBIDDEN]             = "Forbidden";
-	init_reason_phrase[NOT_FOUND]             = "Not Found";
-	init_reason_phrase[METHOD_NOT_ALLOWED]    = "Method Not Allowed";
-	init_reason_phrase[REQUEST_TIMEOUT]       = "Request Timeout";
-	init_reason_phrase[PAYLOAD_TOO_LARGE]     = "Payload Too Large";
-	init_reason_phrase[INTERNAL_SERVER_ERROR] = "Internal Server Error";
-	init_reason_phrase[NOT_IMPLEMENTED]       = "Not Implemented";
-	return init_reason_phrase;
-}
-
-StatusCode::StatusCode(EStatusCode status_code)
-	: status_code_(status_code),
-	  str_status_code_(utils::ToString(status_code)),
-	  reason_phrase_(InitReasonPhrase()) {}
+struct StatusCodeEntry {
+	EStatusCode status_code;
+	const char *reason_phrase;
+};
 
-StatusCode::~StatusCode() {}
+// 静的に初期化される(実行時の初期化順に依存しない)
+const StatusCodeEntry STATUS_CODE_ENTRIES[] = {
+	{CONTINUE, "Continue"},
+	{SWITCHING_PROTOCOLS, "Switching Protocols"},
+	{PROCESSING, "Processing"},
+	{EARLY_HINTS, "Early Hints"},
+	{OK, "OK"},
+	{CREATED, "Created"},
+	{ACCEPTED, "Accepted"},
+	{NON_AUTHORITATIVE_INFORMATION, "Non-Authoritative Information"},
+	{NO_CONTENT, "No Content"},
+	{RESET_CONTENT, "Reset Content"},
+	{PARTIAL_CONTENT, "Partial Content"},
+	{MULTI_STATUS, "Multi-Status"},
+	{ALREADY_REPORTED, "Already Reported"},
+	{IM_USED, "IM Used"},
+	{MULTIPLE_CHOICES, "Multiple Choices"},
+	{MOVED_PERMANENTLY, "Moved Permanently"},
+	{FOUND, "Found"},
+	{SEE_OTHER, "See Other"},
+	{NOT_MODIFIED, "Not Modified"},
+	{USE_PROXY, "Use Proxy"},
+	{TEMPORARY_REDIRECT, "Temporary Redirect"},
+	{PERMANENT_REDIRECT, "Permanent Redirect"},
+	{BAD_REQUEST, "Bad Request"},
+	{UNAUTHORIZED, "Unauthorized"},
+	{PAYMENT_REQUIRED, "Payment Required"},
+	{FORBIDDEN, "Forbidden"},
+	{NOT_FOUND, "Not Found"},
+	{METHOD_NOT_ALLOWED, "Method Not Allowed"},
+	{NOT_ACCEPTABLE, "Not Acceptable"},
+	{PROXY_AUTHENTICATION_REQUIRED, "Proxy Authentication Required"},
+	{REQUEST_TIMEOUT, "Request Timeout"},
+	{CONFLICT, "Conflict"},
+	{GONE, "Gone"},
+	{LENGTH_REQUIRED, "Length Required"},
+	{PRECONDITION_FAILED, "Precondition Failed"},
+	{PAYLOAD_TOO_LARGE, "Payload Too Large"},
+	{URI_TOO_LONG, "URI Too Long"},
+	{UNSUPPORTED_MEDIA_TYPE, "Unsupported Media Type"},
+	{RANGE_NOT_SATISFIABLE, "Range Not Satisfiable"},
+	{EXPECTATION_FAILED, "Expectation Failed"},
+	{MISDIRECTED_REQUEST, "Misdirected Request"},
+	{UNPROCESSABLE_CONTENT, "Unprocessable Content"},
+	{LOCKED, "Locked"},
+	{FAILED_DEPENDENCY, "Failed Dependency"},
+	{TOO_EARLY, "Too Early"},
+	{UPGRADE_REQUIRED, "Upgrade Required"},
+	{PRECONDITION_REQUIRED, "Precondition Required"},
+	{TOO_MANY_REQUESTS, "Too Many Requests"},
+	{REQUEST_HEADER_FIELDS_TOO_LARGE, "Request Header Fields Too Large"},
+	{UNAVAILABLE_FOR_LEGAL_REASONS, "Unavailable For Legal Reasons"},
+	{INTERNAL_SERVER_ERROR, "Internal Server Error"},
+	{NOT_IMPLEMENTED, "Not Implemented"},
+	{BAD_GATEWAY, "Bad Gateway"},
+	{SERVICE_UNAVAILABLE, "Service Unavailable"},
+	{GATEWAY_TIMEOUT, "Gateway Timeout"},
+	{HTTP_VERSION_NOT_SUPPORTED, "HTTP Version Not Supported"},
+	{VARIANT_ALSO_NEGOTIATES, "Variant Also Negotiates"},
+	{INSUFFICIENT_STORAGE, "Insufficient Storage"},
+	{LOOP_DETECTED, "Loop Detected"},
+	{NOT_EXTENDED, "Not Extended"},
+	{NETWORK_AUTHENTICATION_REQUIRED, "Network Authentication Required"}
+};
+const std::size_t STATUS_CODE_ENTRY_SIZE =
+	sizeof(STATUS_CODE_ENTRIES) / sizeof(STATUS_CODE_ENTRIES[0]);
+
+const std::size_t STATUS_CODE_MIN = 100;
+const std::size_t STATUS_CODE_MAX = 599;
 
-StatusCode::StatusCode(const StatusCode &other) {
-	*this = other;
+struct StatusCodeInfo {
+	std::string status_code;
+	std::string reason_phrase;
+	std::string status_line;
+	std::string default_body_message;
+};
+
+std::string CreateDefaultBodyMessage(const std::string &status_code, const char *reason_phrase) {
+	std::ostringstream body_message;
+	body_message << "<html>" << CRLF << "<head><title>" << status_code << SP << reason_phrase
+				 << "</title></head>" << CRLF << "<body>" << CRLF << "<center><h1>"
+				 << status_code << SP << reason_phrase << "</h1></center>" << CRLF
+				 << "<hr><center>" << SERVER_VERSION << "</center>" << CRLF << "</body>" << CRLF
+				 << "</html>" << CRLF;
+	return body_message.str();
 }
 
+// 全てのstatus codeの文字列を最初に使われた時に一度だけ作り、codeから直接引く
+// (CRLFなどのstd::stringの静的初期化が終わった後に作られる)
+class StatusCodeTable {
+  public:
+	StatusCodeTable() : infos_(STATUS_CODE_ENTRY_SIZE) {
+		for (std::size_t i = 0; i <= STATUS_CODE_MAX - STATUS_CODE_MIN; ++i) {
+			indexes_[i] = STATUS_CODE_ENTRY_SIZE;
+		}
+		for (std::size_t i = 0; i < STATUS_CODE_ENTRY_SIZE; ++i) {
+			const StatusCodeEntry &entry = STATUS_CODE_ENTRIES[i];
+			StatusCodeInfo        &info  = infos_[i];
+			info.status_code             = utils::ToString(entry.status_code);
+			info.reason_phrase           = entry.reason_phrase;
+			info.status_line =
+				HTTP_VERSION + SP + info.status_code + SP + info.reason_phrase + CRLF;
+			info.default_body_message =
+				CreateDefaultBodyMessage(info.status_code, entry.reason_phrase);
+			indexes_[entry.status_code - STATUS_CODE_MIN] = i;
+		}
+	}
+
+	const StatusCodeInfo &Find(EStatusCode status_code) const {
+		const std::size_t code = static_cast<std::size_t>(status_code);
+		if (code < STATUS_CODE_MIN || code > STATUS_CODE_MAX ||
+			indexes_[code - STATUS_CODE_MIN] == STATUS_CODE_ENTRY_SIZE) {
+			throw std::out_of_range("StatusCode: unknown status code");
+		}
+		return infos_[indexes_[code - STATUS_CODE_MIN]];
+	}
+
+  private:
+	std::vector<StatusCodeInfo> infos_;
+	// codeごとのinfos_のindex(無ければSTATUS_CODE_ENTRY_SIZE)
+	std::size_t indexes_[STATUS_CODE_MAX - STATUS_CODE_MIN + 1];
+};
+
+const StatusCodeInfo &FindInfo(EStatusCode status_code) {
+	static const StatusCodeTable table;
+	return table.Find(status_code);
+}
+
+} // namespace
+
+StatusCode::StatusCode(EStatusCode status_code) : status_code_(status_code) {}
+
+StatusCode::~StatusCode() {}
+
+StatusCode::StatusCode(const StatusCode &other) : status_code_(other.status_code_) {}
+
 StatusCode &StatusCode::operator=(const StatusCode &other) {
 	if (this != &other) {
-		status_code_     = other.status_code_;
-		str_status_code_ = other.str_status_code_;
-		reason_phrase_   = other.reason_phrase_;
+		status_code_ = other.status_code_;
 	}
 	return *this;
 }
 
-const std::string &StatusCode::GetStatusCode() const {
-	return str_status_code_;
-}
-
 EStatusCode StatusCode::GetEStatusCode() const {
 	return status_code_;
 }
 
+const std::string &StatusCode::GetStatusCode() const {
+	return FindInfo(status_code_).status_code;
+}
+
 const std::string &StatusCode::GetReasonPhrase() const {
-	return reason_phrase_.at(status_code_);
+	return FindInfo(status_code_).reason_phrase;
+}
+
+const std::string &StatusCode::GetStatusLine() const {
+	return FindInfo(status_code_).status_line;
+}
+
+const std::string &StatusCode::GetDefaultBodyMessage() const {
+	return FindInfo(status_code_).default_body_message;
 }
 
 } // namespace http
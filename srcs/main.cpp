@@ -1,5 +1,7 @@
+#include "binary_upgrade.hpp"
 #include "config.hpp"
 #include "server.hpp"
+#include "server_signal.hpp"
 #include "start_up_exception.hpp"
 #include "utils.hpp"
 #include <csignal>
@@ -22,18 +24,32 @@ SignalResult SetSignalHandler() {
 	if (std::signal(SIGPIPE, SIG_IGN) == SIG_ERR) {
 		result.Set(false);
 	}
+	if (std::signal(SIGHUP, server::ServerSignal::HandleReload) == SIG_ERR) {
+		result.Set(false);
+	}
+	if (std::signal(SIGTERM, server::ServerSignal::HandleShutdown) == SIG_ERR ||
+		std::signal(SIGQUIT, server::ServerSignal::HandleShutdown) == SIG_ERR) {
+		result.Set(false);
+	}
+	if (std::signal(SIGUSR2, server::ServerSignal::HandleUpgrade) == SIG_ERR) {
+		result.Set(false);
+	}
 	return result;
 }
 
 } // namespace
 
 // Throw server::StartUpException until server.Init() completes.
+// A failure while handling one client is contained in server.Run(),
+// so only server-wide failures (e.g. epoll) re-run the server here.
+// server.Run() returns after a graceful shutdown(SIGTERM, SIGQUIT).
 void RunServer() {
 	while (true) {
 		try {
 			server::Server server(config::ConfigInstance->servers_);
 			server.Init();
 			server.Run();
+			return;
 		} catch (const server::StartUpException &e) {
 			throw;
 		} catch (const std::exception &e) {
@@ -49,6 +65,8 @@ int main(int argc, char **argv) {
 		PrintUsage();
 		return EXIT_FAILURE;
 	}
+	// SIGUSR2で同じcommand lineの新しいbinaryを起動する
+	server::BinaryUpgrade::SetArgv(argv);
 	const SignalResult result = SetSignalHandler();
 	if (!result.IsOk()) {
 		utils::PrintError("signal failed");
@@ -0,0 +1,143 @@
+#include "binary_upgrade.hpp"
+#include "system_exception.hpp"
+#include "utils.hpp"
+#include <cerrno>
+#include <csignal>    // kill,SIGQUIT
+#include <cstdlib>    // getenv,setenv,unsetenv,exit
+#include <cstring>    // strerror
+#include <fcntl.h>    // fcntl
+#include <limits>     // numeric_limits
+#include <stdexcept>  // runtime_error
+#include <sys/wait.h> // waitpid
+#include <unistd.h>   // fork,execvp,getpid,getppid
+#include <vector>
+
+namespace server {
+namespace {
+
+// {5, 6} -> "5;6"
+std::string JoinFds(const BinaryUpgrade::FdList &fds) {
+	std::string fds_str;
+
+	typedef BinaryUpgrade::FdList::const_iterator Itr;
+	for (Itr it = fds.begin(); it != fds.end(); ++it) {
+		if (it != fds.begin()) {
+			fds_str += ";";
+		}
+		fds_str += utils::ToString(*it);
+	}
+	return fds_str;
+}
+
+// 環境変数の値を取り出して消す(無い時は空文字)
+std::string TakeEnv(const char *name) {
+	const char *value = std::getenv(name);
+	if (value == NULL) {
+		return "";
+	}
+	const std::string value_str(value);
+	unsetenv(name);
+	return value_str;
+}
+
+} // namespace
+
+const char *const BinaryUpgrade::ENV_LISTEN_FDS = "WEBSERV_LISTEN_FDS";
+const char *const BinaryUpgrade::ENV_OLD_PID    = "WEBSERV_OLD_PID";
+
+char *const *BinaryUpgrade::argv_    = NULL;
+pid_t        BinaryUpgrade::old_pid_ = 0;
+
+BinaryUpgrade::BinaryUpgrade() {}
+
+BinaryUpgrade::~BinaryUpgrade() {}
+
+void BinaryUpgrade::SetArgv(char *const *argv) {
+	argv_ = argv;
+}
+
+pid_t BinaryUpgrade::Exec(const FdList &listen_fds) {
+	if (argv_ == NULL) {
+		throw SystemException("binary upgrade: argv is not set");
+	}
+	const std::string old_pid = utils::ToString(getpid());
+	const pid_t       pid     = fork();
+	if (pid == SYSTEM_ERROR) {
+		throw SystemException("fork failed: " + std::string(std::strerror(errno)));
+	}
+	// 子プロセスはexecするだけ(失敗したらexitする)
+	if (pid == 0) {
+		ExecNewBinary(listen_fds, old_pid);
+	}
+	return pid;
+}
+
+// 子プロセス: listen fdだけCLOEXECを外してexecする(client, pipe等は全てCLOEXEC)
+void BinaryUpgrade::ExecNewBinary(const FdList &listen_fds, const std::string &old_pid) {
+	typedef FdList::const_iterator Itr;
+	for (Itr it = listen_fds.begin(); it != listen_fds.end(); ++it) {
+		if (fcntl(*it, F_SETFD, 0) == SYSTEM_ERROR) {
+			utils::PrintError("fcntl F_SETFD failed: " + std::string(std::strerror(errno)));
+			std::exit(EXIT_FAILURE);
+		}
+	}
+	if (setenv(ENV_LISTEN_FDS, JoinFds(listen_fds).c_str(), 1) == SYSTEM_ERROR ||
+		setenv(ENV_OLD_PID, old_pid.c_str(), 1) == SYSTEM_ERROR) {
+		utils::PrintError("setenv failed: " + std::string(std::strerror(errno)));
+		std::exit(EXIT_FAILURE);
+	}
+	execvp(argv_[0], argv_);
+	utils::PrintError("execvp failed: " + std::string(std::strerror(errno)));
+	std::exit(EXIT_FAILURE);
+}
+
+bool BinaryUpgrade::IsExited(pid_t pid) {
+	int status = 0;
+	return waitpid(pid, &status, WNOHANG) != 0;
+}
+
+// serverを作り直した時や値が不正だった時に、同じfdをもう一度使わないように先に消しておく
+BinaryUpgrade::FdList BinaryUpgrade::TakeInheritedFds() {
+	const std::string listen_fds = TakeEnv(ENV_LISTEN_FDS);
+	const std::string old_pid    = TakeEnv(ENV_OLD_PID);
+
+	FdList                         inherited_fds;
+	const std::vector<std::string> fds = utils::SplitStr(listen_fds, ";");
+	typedef std::vector<std::string>::const_iterator Itr;
+	for (Itr it = fds.begin(); it != fds.end(); ++it) {
+		if (!it->empty()) {
+			inherited_fds.push_back(ConvertToFd(*it));
+		}
+	}
+	const utils::Result<unsigned int> convert_result = utils::ConvertStrToUint(old_pid);
+	old_pid_ = convert_result.IsOk() ? static_cast<pid_t>(convert_result.GetValue()) : 0;
+	return inherited_fds;
+}
+
+int BinaryUpgrade::ConvertToFd(const std::string &str) {
+	static const unsigned int FD_MAX = std::numeric_limits<int>::max();
+
+	const utils::Result<unsigned int> convert_result = utils::ConvertStrToUint(str);
+	if (!convert_result.IsOk() || convert_result.GetValue() > FD_MAX) {
+		throw std::runtime_error(std::string(ENV_LISTEN_FDS) + ": invalid fd: " + str);
+	}
+	return static_cast<int>(convert_result.GetValue());
+}
+
+void BinaryUpgrade::NotifyOldProcess() {
+	// 古いprocessが既に終了していたら(親が変わっていたら)何もしない
+	if (old_pid_ <= 0 || getppid() != old_pid_) {
+		old_pid_ = 0;
+		return;
+	}
+	if (kill(old_pid_, SIGQUIT) == SYSTEM_ERROR) {
+		utils::PrintError("kill failed: " + std::string(std::strerror(errno)));
+	} else {
+		utils::Debug(
+			"server", "send SIGQUIT to the old process (pid: " + utils::ToString(old_pid_) + ")"
+		);
+	}
+	old_pid_ = 0;
+}
+
+} // namespace server
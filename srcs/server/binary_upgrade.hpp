@@ -0,0 +1,57 @@
+#ifndef SERVER_BINARY_UPGRADE_HPP_
+#define SERVER_BINARY_UPGRADE_HPP_
+
+#include <list>
+#include <string>
+#include <sys/types.h> // pid_t
+
+namespace server {
+
+/**
+ * @brief Hands the listening sockets over to a new webserv binary (SIGUSR2).
+ *
+ * The old process fork()s and exec()s the same command line with the listen fds left open.
+ * The new process adopts them instead of bind()ing again, so no connection is refused.
+ * Once it has started listening it sends SIGQUIT to the old process, which then drains.
+ */
+class BinaryUpgrade {
+  public:
+	typedef std::list<int> FdList;
+
+	// main()で一度だけ呼ぶ。新しいbinaryも同じargvで起動する
+	static void SetArgv(char *const *argv);
+	// 新しいbinaryのpidを返す
+	// throw(SystemException)
+	static pid_t Exec(const FdList &listen_fds);
+	// 新しいbinaryが起動に失敗して終了したか(終了していればwaitする)
+	static bool IsExited(pid_t pid);
+	// 古いprocessから渡されたlisten fd。一度取ったら環境変数から消す
+	// throw(std::runtime_error)
+	static FdList TakeInheritedFds();
+	// "5" -> 5 (ENV_LISTEN_FDSの1要素)
+	// throw(std::runtime_error)
+	static int ConvertToFd(const std::string &str);
+	// 引き継いだlisten fdで受け始めたら古いprocessをgraceful shutdownさせる
+	static void NotifyOldProcess();
+
+	static const char *const ENV_LISTEN_FDS;
+	static const char *const ENV_OLD_PID;
+
+  private:
+	BinaryUpgrade();
+	~BinaryUpgrade();
+	// prohibit copy
+	BinaryUpgrade(const BinaryUpgrade &other);
+	BinaryUpgrade &operator=(const BinaryUpgrade &other);
+	// function
+	static void ExecNewBinary(const FdList &listen_fds, const std::string &old_pid);
+	// const
+	static const int SYSTEM_ERROR = -1;
+	// variable
+	static char *const *argv_;
+	static pid_t        old_pid_;
+};
+
+} // namespace server
+
+#endif /* SERVER_BINARY_UPGRADE_HPP_ */
@@ -55,6 +55,8 @@ void CgiManager::DeleteCgi(int client_fd) {
 	delete cgi;
 	// CgiAddrMapから削除
 	cgi_addr_map_.erase(client_fd);
+	// 残っているwaiterは呼び出し側でPopCollapse()されていなければ破棄
+	DeleteCollapse(client_fd);
 }
 
 CgiManager::GetFdResult CgiManager::GetReadFd(int client_fd) const {
@@ -134,6 +136,144 @@ bool CgiManager::IsCgiExist(int fd) const {
 	return false;
 }
 
+// AddNewCgi()したclient_fdを同じkeyのrequestのleaderにする
+void CgiManager::SetCollapseKey(int client_fd, const CollapseKey &key) {
+	if (cgi_addr_map_.count(client_fd) == 0) {
+		throw std::logic_error("SetCollapseKey: client_fd doesn't exists");
+	}
+	if (leader_fd_map_.count(key) != 0) {
+		throw std::logic_error("SetCollapseKey: key already exists");
+	}
+	leader_fd_map_[key]          = client_fd;
+	collapse_map_[client_fd].key = key;
+}
+
+// 同じkeyのcgiが実行中ならwaiterとして追加してtrueを返す
+bool CgiManager::AddWaiter(const CollapseKey &key, int client_fd, const cgi::CgiRequest &request) {
+	const LeaderFdMap::const_iterator it = leader_fd_map_.find(key);
+	if (it == leader_fd_map_.end()) {
+		return false;
+	}
+	const int leader_fd = it->second;
+	collapse_map_[leader_fd].waiters.push_back(Waiter(client_fd, request));
+	waiter_fd_map_[client_fd] = leader_fd;
+	return true;
+}
+
+// leaderのcgiが終わったらkeyとwaiterを全て取り出す
+CgiManager::Collapse CgiManager::PopCollapse(int client_fd) {
+	Collapse                    collapse;
+	const CollapseMap::iterator it = collapse_map_.find(client_fd);
+	if (it == collapse_map_.end()) {
+		return collapse;
+	}
+	collapse.key = it->second.key;
+	collapse.waiters.swap(it->second.waiters);
+	const WaiterList &waiters = collapse.waiters;
+	for (WaiterList::const_iterator waiter = waiters.begin(); waiter != waiters.end(); ++waiter) {
+		waiter_fd_map_.erase(waiter->client_fd);
+	}
+	DeleteCollapse(client_fd);
+	return collapse;
+}
+
+// leaderが切断された場合、実行中のcgiを先頭のwaiterに引き継いで新しいleaderのclient_fdを返す
+CgiManager::GetFdResult CgiManager::HandOverCgi(int client_fd) {
+	GetFdResult                 result;
+	const CollapseMap::iterator it = collapse_map_.find(client_fd);
+	if (it == collapse_map_.end() || it->second.waiters.empty()) {
+		result.Set(false);
+		return result;
+	}
+	Collapse     collapse      = it->second;
+	const Waiter new_leader    = collapse.waiters.front();
+	const int    new_leader_fd = new_leader.client_fd;
+	collapse.waiters.pop_front();
+	collapse_map_.erase(it);
+
+	// cgiとpipe_fdの紐づけを新しいleaderに移す
+	Cgi *cgi = GetCgi(client_fd);
+	cgi_addr_map_.erase(client_fd);
+	cgi_addr_map_[new_leader_fd] = cgi;
+	if (cgi->IsReadRequired()) {
+		client_fd_map_[cgi->GetReadFd()] = new_leader_fd;
+	}
+	if (cgi->IsWriteRequired()) {
+		client_fd_map_[cgi->GetWriteFd()] = new_leader_fd;
+	}
+
+	// 残りのwaiterは新しいleaderを待つ
+	waiter_fd_map_.erase(new_leader_fd);
+	for (WaiterList::const_iterator waiter = collapse.waiters.begin();
+		 waiter != collapse.waiters.end();
+		 ++waiter) {
+		waiter_fd_map_[waiter->client_fd] = new_leader_fd;
+	}
+	leader_fd_map_[collapse.key] = new_leader_fd;
+	collapse_map_[new_leader_fd] = collapse;
+
+	result.SetValue(new_leader_fd);
+	return result;
+}
+
+// leaderのcgiが失敗した場合、先頭のwaiterを新しいleaderにして残りのwaiterはそれを待つ
+// 新しいleaderはAddNewCgi()までなので、RunCgi()は呼び出し側で行う
+// throw(SystemException)
+CgiManager::GetFdResult CgiManager::PromoteWaiter(const Collapse &collapse) {
+	GetFdResult result;
+	WaiterList  waiters = collapse.waiters;
+	// 同じkeyのcgiを既に実行し直していればそれを待つ
+	if (waiters.empty() || leader_fd_map_.count(collapse.key) != 0) {
+		for (WaiterList::const_iterator it = waiters.begin(); it != waiters.end(); ++it) {
+			AddWaiter(collapse.key, it->client_fd, it->request);
+		}
+		result.Set(false);
+		return result;
+	}
+	const Waiter new_leader = waiters.front();
+	waiters.pop_front();
+	AddNewCgi(new_leader.client_fd, new_leader.request);
+	SetCollapseKey(new_leader.client_fd, collapse.key);
+	for (WaiterList::const_iterator it = waiters.begin(); it != waiters.end(); ++it) {
+		AddWaiter(collapse.key, it->client_fd, it->request);
+	}
+	result.SetValue(new_leader.client_fd);
+	return result;
+}
+
+// waiterが切断された場合はleaderの待ちリストから外す
+void CgiManager::DeleteWaiter(int client_fd) {
+	const FdMap::iterator it = waiter_fd_map_.find(client_fd);
+	if (it == waiter_fd_map_.end()) {
+		return;
+	}
+	WaiterList &waiters = collapse_map_[it->second].waiters;
+	for (WaiterList::iterator waiter = waiters.begin(); waiter != waiters.end(); ++waiter) {
+		if (waiter->client_fd == client_fd) {
+			waiters.erase(waiter);
+			break;
+		}
+	}
+	waiter_fd_map_.erase(it);
+}
+
+bool CgiManager::IsWaiter(int client_fd) const {
+	return waiter_fd_map_.count(client_fd) != 0;
+}
+
+void CgiManager::DeleteCollapse(int client_fd) {
+	const CollapseMap::iterator it = collapse_map_.find(client_fd);
+	if (it == collapse_map_.end()) {
+		return;
+	}
+	const WaiterList &waiters = it->second.waiters;
+	for (WaiterList::const_iterator waiter = waiters.begin(); waiter != waiters.end(); ++waiter) {
+		waiter_fd_map_.erase(waiter->client_fd);
+	}
+	leader_fd_map_.erase(it->second.key);
+	collapse_map_.erase(it);
+}
+
 CgiManager::Cgi *CgiManager::GetCgi(int client_fd) {
 	try {
 		return cgi_addr_map_.at(client_fd);
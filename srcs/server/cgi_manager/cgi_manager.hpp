@@ -3,10 +3,14 @@
 
 #include "cgi.hpp"
 #include "utils.hpp"
+#include <list>
 #include <map>
+#include <string>
 
 namespace server {
 
+class VirtualServer;
+
 // "client_fd - cgi_instance", "pipe_fd - client_fd" を紐づけて全cgi_instanceを保持・取得
 class CgiManager {
   public:
@@ -15,6 +19,22 @@ class CgiManager {
 	typedef CgiAddrMap::const_iterator ItrCgiAddrMap;
 	typedef std::map<int, int>         FdMap;
 	typedef utils::Result<int>         GetFdResult;
+	// 同じvirtual_server・request_targetのGETは実行中の1つのcgiにまとめる
+	typedef std::pair<const VirtualServer *, std::string> CollapseKey;
+
+	// 実行中のcgiのresponseを待っているclient
+	struct Waiter {
+		Waiter(int client_fd, const cgi::CgiRequest &request)
+			: client_fd(client_fd), request(request) {}
+		int             client_fd;
+		cgi::CgiRequest request; // 自分でcgiを実行し直す場合に使う
+	};
+	typedef std::list<Waiter> WaiterList;
+	// cgiを実行しているclient(leader)毎のwaiter
+	struct Collapse {
+		CollapseKey key;
+		WaiterList  waiters;
+	};
 
 	CgiManager();
 	~CgiManager();
@@ -30,6 +50,14 @@ class CgiManager {
 	cgi::CgiResponse   AddAndGetResponse(int client_fd, const std::string &read_buf);
 	void               ReplaceNewRequest(int client_fd, const std::string &new_request_str);
 	bool               IsCgiExist(int fd) const;
+	// request collapsing
+	void        SetCollapseKey(int client_fd, const CollapseKey &key);
+	bool        AddWaiter(const CollapseKey &key, int client_fd, const cgi::CgiRequest &request);
+	Collapse    PopCollapse(int client_fd);
+	GetFdResult HandOverCgi(int client_fd);
+	GetFdResult PromoteWaiter(const Collapse &collapse);
+	void        DeleteWaiter(int client_fd);
+	bool        IsWaiter(int client_fd) const;
 
   private:
 	// Prohibit copy
@@ -39,12 +67,22 @@ class CgiManager {
 	// functions
 	Cgi       *GetCgi(int client_fd);
 	const Cgi *GetCgi(int client_fd) const;
+	void       DeleteCollapse(int client_fd);
+
+	typedef std::map<CollapseKey, int> LeaderFdMap;
+	typedef std::map<int, Collapse>    CollapseMap;
 
 	// variables
 	// client_fd毎にCgiをnewして保持
 	CgiAddrMap cgi_addr_map_;
 	// pipe_fdとclient_fdを紐づけ
 	FdMap client_fd_map_;
+	// CollapseKeyとleaderのclient_fdを紐づけ
+	LeaderFdMap leader_fd_map_;
+	// leaderのclient_fdとwaiterを紐づけ
+	CollapseMap collapse_map_;
+	// waiterのclient_fdとleaderのclient_fdを紐づけ
+	FdMap waiter_fd_map_;
 };
 
 } // namespace server
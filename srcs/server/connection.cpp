@@ -4,12 +4,14 @@
 #include "server_info.hpp"
 #include "system_exception.hpp"
 #include "utils.hpp" // ConvertUintToStr
+#include <arpa/inet.h>  // inet_pton
 #include <cerrno>
 #include <cstring>      // strerror
+#include <fcntl.h>      // fcntl
 #include <netdb.h>      // getaddrinfo,freeaddrinfo
 #include <netinet/in.h> // struct sockaddr
 #include <stdexcept>    // runtime_error
-#include <sys/socket.h> // socket,setsockopt,bind,listen,accept
+#include <sys/socket.h> // socket,setsockopt,bind,listen,accept4
 #include <unistd.h>     // close
 
 namespace server {
@@ -107,8 +109,10 @@ Connection::BindResult Connection::TryBind(AddrInfo *addrinfo) const {
 
 	for (; addrinfo != NULL; addrinfo = addrinfo->ai_next) {
 		// socket
-		const int server_fd =
-			socket(addrinfo->ai_family, addrinfo->ai_socktype, addrinfo->ai_protocol);
+		// CLOEXEC: cgiの子プロセスにlisten中のsocketを渡さない(binary upgradeの時だけ外す)
+		const int server_fd = socket(
+			addrinfo->ai_family, addrinfo->ai_socktype | SOCK_CLOEXEC, addrinfo->ai_protocol
+		);
 		if (server_fd == SYSTEM_ERROR) {
 			continue;
 		}
@@ -190,7 +194,9 @@ Connection::IpPortPair Connection::GetListenServerIpPort(int client_fd) {
 ClientInfo Connection::Accept(int server_fd) {
 	struct sockaddr_storage client_sock_addr = {};
 	socklen_t               addrlen          = sizeof(client_sock_addr);
-	const int client_fd = accept(server_fd, (struct sockaddr *)&client_sock_addr, &addrlen);
+	// CLOEXEC: cgiの子プロセスや新しいbinaryにclientとの接続を渡さない
+	const int client_fd =
+		accept4(server_fd, (struct sockaddr *)&client_sock_addr, &addrlen, SOCK_CLOEXEC);
 	if (client_fd == SYSTEM_ERROR) {
 		throw SystemException("accept failed: " + std::string(std::strerror(errno)));
 	}
@@ -212,4 +218,62 @@ bool Connection::IsListenServerFd(int sock_fd) const {
 	return listen_server_fds_.count(sock_fd) == 1;
 }
 
+// closeは呼び出し側でする
+void Connection::DeleteListenServerFd(int sock_fd) {
+	listen_server_fds_.erase(sock_fd);
+}
+
+// binary upgrade: 古いprocessがlistenしていたsocketをbindし直さずにそのまま使う
+// throw(SystemException)
+Connection::HostPortPair Connection::Inherit(int server_fd) {
+	int       is_listening = 0;
+	socklen_t optlen       = sizeof(is_listening);
+	const int status = getsockopt(server_fd, SOL_SOCKET, SO_ACCEPTCONN, &is_listening, &optlen);
+	if (status == SYSTEM_ERROR || is_listening == 0) {
+		throw SystemException("not a listening socket: fd " + utils::ToString(server_fd));
+	}
+	// execの為に外されていたCLOEXECを戻す
+	if (fcntl(server_fd, F_SETFD, FD_CLOEXEC) == SYSTEM_ERROR) {
+		throw SystemException("fcntl F_SETFD failed: " + std::string(std::strerror(errno)));
+	}
+	const HostPortPair host_port = GetListenServerIpPort(server_fd);
+	listen_server_fds_.insert(server_fd);
+	return host_port;
+}
+
+// Non-blocking connect() to the upstream server.
+// The connection is complete when the socket becomes writable (check with IsConnectSucceeded()).
+// throw(SystemException)
+int Connection::ConnectToUpstream(const IpPortPair &ip_port) {
+	struct sockaddr_in upstream_addr = {};
+	upstream_addr.sin_family         = AF_INET;
+	upstream_addr.sin_port           = htons(ip_port.second);
+	if (inet_pton(AF_INET, ip_port.first.c_str(), &upstream_addr.sin_addr) != 1) {
+		throw SystemException("inet_pton failed: " + ip_port.first);
+	}
+
+	// CLOEXEC: cgiの子プロセスにupstreamとの接続を渡さない
+	const int upstream_fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if (upstream_fd == SYSTEM_ERROR) {
+		throw SystemException("socket failed: " + std::string(std::strerror(errno)));
+	}
+	if (connect(upstream_fd, (struct sockaddr *)&upstream_addr, sizeof(upstream_addr)) ==
+			SYSTEM_ERROR &&
+		errno != EINPROGRESS) {
+		const std::string error = std::strerror(errno);
+		close(upstream_fd);
+		throw SystemException("connect failed: " + error);
+	}
+	return upstream_fd;
+}
+
+bool Connection::IsConnectSucceeded(int sock_fd) {
+	int       error     = 0;
+	socklen_t error_len = sizeof(error);
+	if (getsockopt(sock_fd, SOL_SOCKET, SO_ERROR, &error, &error_len) == SYSTEM_ERROR) {
+		return false;
+	}
+	return error == 0;
+}
+
 } // namespace server
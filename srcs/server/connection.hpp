@@ -29,6 +29,12 @@ class Connection {
 	int               Connect(const HostPortPair &host_port);
 	static ClientInfo Accept(int server_fd);
 	bool              IsListenServerFd(int sock_fd) const;
+	void              DeleteListenServerFd(int sock_fd);
+	// for binary upgrade
+	HostPortPair Inherit(int server_fd);
+	// for proxy_pass
+	static int  ConnectToUpstream(const IpPortPair &ip_port);
+	static bool IsConnectSucceeded(int sock_fd);
 
   private:
 	// prohibit copy
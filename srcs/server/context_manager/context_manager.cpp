@@ -1,10 +1,13 @@
 #include "context_manager.hpp"
 #include "client_info.hpp"
 #include "server_info.hpp"
+#include <stdexcept> // logic_error
 
 namespace server {
 
-ContextManager::ContextManager() {}
+ContextManager::ContextManager() : current_snapshot_(0) {
+	virtual_servers_[current_snapshot_] = VirtualServerStorage();
+}
 
 ContextManager::~ContextManager() {}
 
@@ -14,25 +17,74 @@ ContextManager::ContextManager(const ContextManager &other) {
 
 ContextManager &ContextManager::operator=(const ContextManager &other) {
 	if (this != &other) {
-		virtual_servers_ = other.virtual_servers_;
-		sock_context_    = other.sock_context_;
+		virtual_servers_  = other.virtual_servers_;
+		current_snapshot_ = other.current_snapshot_;
+		client_snapshots_ = other.client_snapshots_;
+		sock_context_     = other.sock_context_;
 	}
 	return *this;
 }
 
+// 新しいsnapshotは空で作り、SetCurrentSnapshot()するまで新しいclientには使わない
+ContextManager::SnapshotId ContextManager::AddSnapshot() {
+	const SnapshotId snapshot_id = virtual_servers_.rbegin()->first + 1;
+	virtual_servers_[snapshot_id] = VirtualServerStorage();
+	return snapshot_id;
+}
+
+void ContextManager::SetCurrentSnapshot(SnapshotId snapshot_id) {
+	if (virtual_servers_.count(snapshot_id) == 0) {
+		throw std::logic_error("SetCurrentSnapshot: snapshot doesn't exist");
+	}
+	current_snapshot_ = snapshot_id;
+}
+
+// 今のsnapshotは消さない
+void ContextManager::DeleteSnapshot(SnapshotId snapshot_id) {
+	if (snapshot_id == current_snapshot_) {
+		return;
+	}
+	virtual_servers_.erase(snapshot_id);
+}
+
+// 今のsnapshot以外で、使っているclientがいなくなったもの
+ContextManager::SnapshotIdList ContextManager::GetUnusedSnapshots() const {
+	SnapshotIdList unused_snapshots;
+	if (virtual_servers_.size() == 1) {
+		return unused_snapshots;
+	}
+	std::map<SnapshotId, bool> is_used;
+	typedef ClientSnapshotMap::const_iterator ItClient;
+	for (ItClient it = client_snapshots_.begin(); it != client_snapshots_.end(); ++it) {
+		is_used[it->second] = true;
+	}
+	typedef VirtualServerStorageMap::const_iterator ItSnapshot;
+	for (ItSnapshot it = virtual_servers_.begin(); it != virtual_servers_.end(); ++it) {
+		if (it->first < current_snapshot_ && is_used.count(it->first) == 0) {
+			unused_snapshots.push_back(it->first);
+		}
+	}
+	return unused_snapshots;
+}
+
 void ContextManager::AddVirtualServer(const VirtualServer &virtual_server) {
-	virtual_servers_.AddVirtualServer(virtual_server);
+	GetLatestSnapshot().AddVirtualServer(virtual_server);
+}
+
+// return: 新しく追加したか
+bool ContextManager::AddServerInfo(const HostPortPair &host_port) {
+	GetLatestSnapshot().InitHostPortPair(host_port);
+	return sock_context_.AddServerInfo(host_port);
 }
 
-void ContextManager::AddServerInfo(const HostPortPair &host_port) {
-	sock_context_.AddServerInfo(host_port);
-	virtual_servers_.InitHostPortPair(host_port);
+void ContextManager::DeleteServerInfo(const HostPortPair &host_port) {
+	sock_context_.DeleteServerInfo(host_port);
 }
 
 void ContextManager::AddMapping(
 	const HostPortPair &host_port, const VirtualServer *virtual_server
 ) {
-	virtual_servers_.AddMapping(host_port, virtual_server);
+	GetLatestSnapshot().AddMapping(host_port, virtual_server);
 }
 
 void ContextManager::SetListenSockFd(const HostPortPair &host_port, int server_fd) {
@@ -42,14 +94,21 @@ void ContextManager::SetListenSockFd(const HostPortPair &host_port, int server_f
 void ContextManager::AddClientInfo(const ClientInfo &client_info) {
 	const int client_fd = client_info.GetFd();
 	sock_context_.AddClientInfo(client_fd, client_info);
+	client_snapshots_[client_fd] = current_snapshot_;
 }
 
 void ContextManager::DeleteClientInfo(int client_fd) {
 	sock_context_.DeleteClientInfo(client_fd);
+	client_snapshots_.erase(client_fd);
 }
 
 const VirtualServerStorage::VirtualServerList &ContextManager::GetAllVirtualServer() const {
-	return virtual_servers_.GetAllVirtualServerList();
+	return GetLatestSnapshot().GetAllVirtualServerList();
+}
+
+const VirtualServerStorage::VirtualServerList &
+ContextManager::GetAllVirtualServer(SnapshotId snapshot_id) const {
+	return GetSnapshot(snapshot_id).GetAllVirtualServerList();
 }
 
 const VirtualServerStorage::VirtualServerAddrList &
@@ -58,7 +117,7 @@ ContextManager::GetVirtualServerAddrList(int client_fd) const {
 	const VirtualServer::HostPortPair host_port =
 		std::make_pair(client_info.GetListenIp(), client_info.GetListenPort());
 
-	return virtual_servers_.GetVirtualServerAddrList(host_port);
+	return GetSnapshot(client_snapshots_.at(client_fd)).GetVirtualServerAddrList(host_port);
 }
 
 const std::string &ContextManager::GetClientIp(int client_fd) const {
@@ -71,4 +130,33 @@ unsigned int ContextManager::GetListenServerPort(int client_fd) const {
 	return client_info.GetListenPort();
 }
 
+// ipからの今の接続数
+std::size_t ContextManager::GetConnectionCount(const std::string &ip) const {
+	return sock_context_.GetConnectionCount(ip);
+}
+
+int ContextManager::GetListenSockFd(const HostPortPair &host_port) const {
+	return sock_context_.GetSockFd(host_port);
+}
+
+ContextManager::HostPortList ContextManager::GetListenHostPorts() const {
+	return sock_context_.GetListenHostPorts();
+}
+
+VirtualServerStorage &ContextManager::GetLatestSnapshot() {
+	return virtual_servers_.rbegin()->second;
+}
+
+const VirtualServerStorage &ContextManager::GetLatestSnapshot() const {
+	return virtual_servers_.rbegin()->second;
+}
+
+const VirtualServerStorage &ContextManager::GetSnapshot(SnapshotId snapshot_id) const {
+	try {
+		return virtual_servers_.at(snapshot_id);
+	} catch (const std::exception &e) {
+		throw std::logic_error("GetSnapshot: snapshot doesn't exist");
+	}
+}
+
 } // namespace server
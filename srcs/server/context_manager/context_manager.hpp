@@ -4,35 +4,62 @@
 #include "sock_context.hpp"
 #include "virtual_server.hpp"
 #include "virtual_server_storage.hpp"
+#include <cstddef> // size_t
+#include <list>
+#include <map>
 
 namespace server {
 
 // holds and manages virtual server info and socket context(server socket info, client socket info).
+// virtual serverはconfigを読むたびにsnapshotとして追加し、clientは接続した時のsnapshotを使い続ける
 class ContextManager {
   public:
 	typedef VirtualServer::HostPortPair HostPortPair;
+	typedef SockContext::HostPortList   HostPortList;
+	typedef unsigned int                SnapshotId;
+	typedef std::list<SnapshotId>       SnapshotIdList;
 
 	ContextManager();
 	~ContextManager();
 	ContextManager(const ContextManager &other);
 	ContextManager &operator=(const ContextManager &other);
-	// functions
+	// snapshot
+	SnapshotId     AddSnapshot();
+	void           SetCurrentSnapshot(SnapshotId snapshot_id);
+	void           DeleteSnapshot(SnapshotId snapshot_id);
+	SnapshotIdList GetUnusedSnapshots() const;
+	// functions (virtual serverは最後に追加したsnapshotに追加する)
 	void AddVirtualServer(const VirtualServer &virtual_server);
 	void AddMapping(const HostPortPair &host_port, const VirtualServer *virtual_server);
 	void SetListenSockFd(const HostPortPair &host_port, int server_fd);
-	void AddServerInfo(const HostPortPair &host_port);
+	bool AddServerInfo(const HostPortPair &host_port);
+	void DeleteServerInfo(const HostPortPair &host_port);
 	void AddClientInfo(const ClientInfo &client_info);
 	void DeleteClientInfo(int client_fd);
 	// getter
 	const VirtualServerStorage::VirtualServerList     &GetAllVirtualServer() const;
+	const VirtualServerStorage::VirtualServerList     &GetAllVirtualServer(SnapshotId snapshot_id
+	) const;
 	const VirtualServerStorage::VirtualServerAddrList &GetVirtualServerAddrList(int client_fd
 	) const;
 	const std::string                                 &GetClientIp(int client_fd) const;
 	unsigned int                                       GetListenServerPort(int client_fd) const;
+	std::size_t  GetConnectionCount(const std::string &ip) const;
+	int          GetListenSockFd(const HostPortPair &host_port) const;
+	HostPortList GetListenHostPorts() const;
 
   private:
-	VirtualServerStorage virtual_servers_;
-	SockContext          sock_context_;
+	typedef std::map<SnapshotId, VirtualServerStorage> VirtualServerStorageMap;
+	typedef std::map<int, SnapshotId>                  ClientSnapshotMap;
+
+	VirtualServerStorage       &GetLatestSnapshot();
+	const VirtualServerStorage &GetLatestSnapshot() const;
+	const VirtualServerStorage &GetSnapshot(SnapshotId snapshot_id) const;
+
+	VirtualServerStorageMap virtual_servers_;
+	SnapshotId              current_snapshot_; // 新しいclientに使うsnapshot
+	ClientSnapshotMap       client_snapshots_; // clientが接続した時のsnapshot
+	SockContext             sock_context_;
 };
 
 } // namespace server
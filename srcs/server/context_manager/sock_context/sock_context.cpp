@@ -32,16 +32,19 @@ SockContext &SockContext::operator=(const SockContext &other) {
 	if (this != &other) {
 		server_context_ = other.server_context_;
 		client_context_ = other.client_context_;
+		ip_counts_      = other.ip_counts_;
 	}
 	return *this;
 }
 
-void SockContext::AddServerInfo(const HostPortPair &host_port) {
+// return: 新しく追加したか
+bool SockContext::AddServerInfo(const HostPortPair &host_port) {
 	if (server_context_.count(host_port) > 0) {
-		return;
+		return false;
 	}
 	const ServerInfo server_info(host_port);
 	server_context_[host_port] = server_info;
+	return true;
 }
 
 void SockContext::SetSockFd(const HostPortPair &host_port, int server_fd) {
@@ -53,16 +56,31 @@ void SockContext::SetSockFd(const HostPortPair &host_port, int server_fd) {
 	}
 }
 
+// listenしているfdはServer側でcloseする
+void SockContext::DeleteServerInfo(const HostPortPair &host_port) {
+	server_context_.erase(host_port);
+}
+
 void SockContext::AddClientInfo(int client_fd, const ClientInfo &client_info) {
 	typedef std::pair<ClientInfoMap::const_iterator, bool> InsertResult;
 	const InsertResult result = client_context_.insert(std::make_pair(client_fd, client_info));
 	if (result.second == false) {
 		throw std::logic_error("ClientInfo already exists");
 	}
+	++ip_counts_[client_info.GetIp()];
 }
 
 void SockContext::DeleteClientInfo(int client_fd) {
-	client_context_.erase(client_fd);
+	const ClientInfoMap::iterator client = client_context_.find(client_fd);
+	if (client == client_context_.end()) {
+		return;
+	}
+	// 接続が無くなったIPは残さない
+	const IpCountMap::iterator ip_count = ip_counts_.find(client->second.GetIp());
+	if (ip_count != ip_counts_.end() && --ip_count->second == 0) {
+		ip_counts_.erase(ip_count);
+	}
+	client_context_.erase(client);
 }
 
 const ClientInfo &SockContext::GetClientInfo(int client_fd) const {
@@ -73,4 +91,28 @@ const ClientInfo &SockContext::GetClientInfo(int client_fd) const {
 	}
 }
 
+std::size_t SockContext::GetConnectionCount(const std::string &ip) const {
+	const IpCountMap::const_iterator it = ip_counts_.find(ip);
+	return it == ip_counts_.end() ? 0 : it->second;
+}
+
+// listenしていなければSYSTEM_ERROR
+int SockContext::GetSockFd(const HostPortPair &host_port) const {
+	const ServerInfoMap::const_iterator it = server_context_.find(host_port);
+	return it == server_context_.end() ? SYSTEM_ERROR : it->second.GetFd();
+}
+
+// 0.0.0.0:portでまとめてlistenしているhost:portは含まない
+SockContext::HostPortList SockContext::GetListenHostPorts() const {
+	HostPortList host_ports;
+
+	typedef ServerInfoMap::const_iterator Itr;
+	for (Itr it = server_context_.begin(); it != server_context_.end(); ++it) {
+		if (it->second.GetFd() != SYSTEM_ERROR) {
+			host_ports.push_back(it->first);
+		}
+	}
+	return host_ports;
+}
+
 } // namespace server
@@ -1,6 +1,8 @@
 #ifndef SERVER_CONTEXTMANAGER_SOCKCONTEXT_SOCKCONTEXT_HPP_
 #define SERVER_CONTEXTMANAGER_SOCKCONTEXT_SOCKCONTEXT_HPP_
 
+#include <cstddef> // size_t
+#include <list>
 #include <map>
 #include <string>
 
@@ -15,18 +17,24 @@ class SockContext {
 	typedef std::pair<std::string, unsigned int> HostPortPair;
 	typedef std::map<HostPortPair, ServerInfo>   ServerInfoMap;
 	typedef std::map<int, ClientInfo>            ClientInfoMap;
+	typedef std::map<std::string, std::size_t>   IpCountMap; // IPごとの接続数
+	typedef std::list<HostPortPair>              HostPortList;
 
 	SockContext();
 	~SockContext();
 	SockContext(const SockContext &other);
 	SockContext &operator=(const SockContext &other);
 	// functions
-	void AddServerInfo(const HostPortPair &host_port);
+	bool AddServerInfo(const HostPortPair &host_port);
 	void SetSockFd(const HostPortPair &host_port, int server_fd);
+	void DeleteServerInfo(const HostPortPair &host_port);
 	void AddClientInfo(int client_fd, const ClientInfo &client_info);
 	void DeleteClientInfo(int client_fd);
 	// getter
 	const ClientInfo &GetClientInfo(int client_fd) const;
+	std::size_t       GetConnectionCount(const std::string &ip) const;
+	int               GetSockFd(const HostPortPair &host_port) const;
+	HostPortList      GetListenHostPorts() const;
 
   private:
 	// const
@@ -34,6 +42,7 @@ class SockContext {
 	// variables
 	ServerInfoMap server_context_;
 	ClientInfoMap client_context_;
+	IpCountMap    ip_counts_; // client_context_と一緒に増減させる
 };
 
 } // namespace server
@@ -2,6 +2,7 @@
 #define SERVER_CONTEXTMANAGER_VIRTUALSERVERSTORAGE_HPP_
 
 #include "virtual_server.hpp"
+#include "virtual_server_addr_list.hpp"
 #include <list>
 #include <map>
 
@@ -13,7 +14,7 @@ class VirtualServerStorage {
 	typedef std::list<VirtualServer> VirtualServerList;
 
 	typedef VirtualServer::HostPortPair                   HostPortPair;
-	typedef std::list<const VirtualServer *>              VirtualServerAddrList;
+	typedef server::VirtualServerAddrList                 VirtualServerAddrList;
 	typedef std::map<HostPortPair, VirtualServerAddrList> VirtualServerAddrListMap;
 
 	VirtualServerStorage();
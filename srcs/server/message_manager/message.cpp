@@ -4,18 +4,17 @@
 namespace server {
 namespace message {
 
-Message::Message(int client_fd)
-	: client_fd_(client_fd),
-	  start_time_(GetCurrentTime()),
-	  is_timeout_(false),
-	  is_complete_request_message_(true) {}
-
-Message::Message(int client_fd, const std::string &request_buf)
+// 最初のrequestはheader fieldsを待つ
+Message::Message(int client_fd, const ConnectionLimits &connection_limits)
 	: client_fd_(client_fd),
 	  start_time_(GetCurrentTime()),
 	  is_timeout_(false),
 	  is_complete_request_message_(true),
-	  request_buf_(request_buf) {}
+	  connection_limits_(connection_limits),
+	  timer_phase_(READ_HEADER),
+	  request_count_(0),
+	  rate_start_time_(start_time_),
+	  rate_bytes_(0) {}
 
 Message::~Message() {}
 
@@ -31,29 +30,81 @@ Message &Message::operator=(const Message &other) {
 		is_complete_request_message_ = other.is_complete_request_message_;
 		request_buf_                 = other.request_buf_;
 		responses_                   = other.responses_;
+		connection_limits_           = other.connection_limits_;
+		timer_phase_                 = other.timer_phase_;
+		request_count_               = other.request_count_;
+		rate_start_time_             = other.rate_start_time_;
+		rate_bytes_                  = other.rate_bytes_;
 	}
 	return *this;
 }
 
-bool Message::IsNewTimeoutExceeded(double timeout_sec) const {
+bool Message::IsNewTimeoutExceeded() const {
 	if (is_timeout_) {
 		return false;
 	}
 	const Time   current_time  = GetCurrentTime();
 	const double diff_time_sec = std::difftime(current_time, start_time_);
-	return diff_time_sec >= timeout_sec;
+	return diff_time_sec >= GetTimeout();
+}
+
+// periodが経つたびに、その間に受信/送信したbyte数がmin_rateに届いているかを見る
+// 1byteずつ送ってtimeoutを延ばし続けるような接続を切るため
+bool Message::IsBelowMinRate() {
+	const DataRate &min_rate = GetMinRate();
+	if (is_timeout_ || min_rate.bytes == 0) {
+		return false;
+	}
+	const Time current_time = GetCurrentTime();
+	if (std::difftime(current_time, rate_start_time_) < min_rate.period) {
+		return false;
+	}
+	const bool is_below_min_rate = rate_bytes_ < min_rate.bytes;
+	rate_start_time_             = current_time;
+	rate_bytes_                  = 0;
+	return is_below_min_rate;
 }
 
-void Message::UpdateTime() {
-	start_time_ = GetCurrentTime();
+// keep-aliveで次のrequestを待っているだけ(受信したものも返すものも無い)
+bool Message::IsIdle() const {
+	return timer_phase_ == WAIT_REQUEST && request_buf_.empty() && responses_.empty();
+}
+
+void Message::StartTimer(TimerPhase phase) {
+	if (timer_phase_ != phase) {
+		rate_start_time_ = GetCurrentTime();
+		rate_bytes_      = 0;
+	}
+	timer_phase_ = phase;
+	start_time_  = GetCurrentTime();
+}
+
+void Message::CountRequest() {
+	++request_count_;
 }
 
 void Message::AddRequestBuf(const std::string &request_buf) {
 	request_buf_ += request_buf;
+	rate_bytes_ += request_buf.size();
 }
 
-void Message::DeleteRequestBuf() {
-	request_buf_.clear();
+void Message::AddSentSize(std::size_t sent_size) {
+	rate_bytes_ += sent_size;
+}
+
+// 受信したbufferはコピーせずに中身ごとhttpへ渡す
+void Message::TakeRequestBuf(std::string &request_buf) {
+	request_buf.clear();
+	request_buf.swap(request_buf_);
+}
+
+// httpが使わなかった分を受け取り、その後に受信した分の前に戻す
+void Message::RestoreRequestBuf(std::string &unused_buf) {
+	if (!request_buf_.empty()) {
+		unused_buf += request_buf_;
+	}
+	request_buf_.swap(unused_buf);
+	unused_buf.clear();
 }
 
 void Message::AddBackResponse(ConnectionState connection_state, const std::string &response_str) {
@@ -81,6 +132,17 @@ bool Message::IsResponseExist() const {
 	return !responses_.empty();
 }
 
+// まだ送っていないresponseの合計サイズ
+std::size_t Message::GetResponseSize() const {
+	std::size_t size = 0;
+
+	typedef ResponseDeque::const_iterator Itr;
+	for (Itr it = responses_.begin(); it != responses_.end(); ++it) {
+		size += it->response_str.size();
+	}
+	return size;
+}
+
 int Message::GetFd() const {
 	return client_fd_;
 }
@@ -93,6 +155,14 @@ const std::string &Message::GetRequestBuf() const {
 	return request_buf_;
 }
 
+TimerPhase Message::GetTimerPhase() const {
+	return timer_phase_;
+}
+
+std::size_t Message::GetRequestCount() const {
+	return request_count_;
+}
+
 void Message::SetTimeout() {
 	is_timeout_ = true;
 }
@@ -101,9 +171,43 @@ void Message::SetIsCompleteRequest(bool is_complete_request_message) {
 	is_complete_request_message_ = is_complete_request_message;
 }
 
+void Message::SetConnectionLimits(const ConnectionLimits &connection_limits) {
+	connection_limits_ = connection_limits;
+}
+
 Message::Time Message::GetCurrentTime() {
 	return std::time(NULL);
 }
 
+unsigned int Message::GetTimeout() const {
+	switch (timer_phase_) {
+	case WAIT_REQUEST:
+		return connection_limits_.keepalive_timeout;
+	case READ_HEADER:
+		return connection_limits_.client_header_timeout;
+	case READ_BODY:
+		return connection_limits_.client_body_timeout;
+	case SEND_RESPONSE:
+		return connection_limits_.send_timeout;
+	default:
+		return BACKEND_TIMEOUT;
+	}
+}
+
+// keep-aliveで待っている間とcgi, upstreamを待っている間は見ない
+const DataRate &Message::GetMinRate() const {
+	static const DataRate NO_MIN_RATE;
+
+	switch (timer_phase_) {
+	case READ_HEADER:
+	case READ_BODY:
+		return connection_limits_.client_min_rate;
+	case SEND_RESPONSE:
+		return connection_limits_.send_min_rate;
+	default:
+		return NO_MIN_RATE;
+	}
+}
+
 } // namespace message
 } // namespace server
@@ -1,6 +1,8 @@
 #ifndef SERVER_MESSAGE_HPP_
 #define SERVER_MESSAGE_HPP_
 
+#include "virtual_server.hpp"
+#include <cstddef> // size_t
 #include <ctime>
 #include <deque>
 #include <string>
@@ -13,6 +15,15 @@ enum ConnectionState {
 	CLOSE
 };
 
+// どこを待っているか(それぞれ別のtimeoutを使う)
+enum TimerPhase {
+	WAIT_REQUEST,  // responseを送り終えて次のrequestを待っている: keepalive_timeout
+	READ_HEADER,   // request line, header fieldsを受信中: client_header_timeout
+	READ_BODY,     // bodyを受信中(受信するたびに測り直す): client_body_timeout
+	WAIT_BACKEND,  // cgi, upstreamのresponseを待っている
+	SEND_RESPONSE  // responseを送信中(送れるたびに測り直す): send_timeout
+};
+
 struct Response {
 	Response() : connection_state(KEEP) {};
 	Response(ConnectionState connection_state, const std::string &response_str)
@@ -27,43 +38,62 @@ class Message {
 	typedef std::time_t          Time;
 	typedef std::deque<Response> ResponseDeque;
 
-	explicit Message(int client_fd);
-	Message(int client_fd, const std::string &request_buf);
+	Message(int client_fd, const ConnectionLimits &connection_limits);
 	~Message();
 	Message(const Message &other);
 	Message &operator=(const Message &other);
 
 	// functions
-	bool IsNewTimeoutExceeded(double timeout_sec) const;
-	void UpdateTime();
+	bool IsNewTimeoutExceeded() const;
+	bool IsBelowMinRate();
+	bool IsIdle() const;
+	void StartTimer(TimerPhase phase);
+	void CountRequest();
+	void AddSentSize(std::size_t sent_size);
 	// request_buf
 	void AddRequestBuf(const std::string &request_buf);
-	void DeleteRequestBuf();
+	void TakeRequestBuf(std::string &request_buf);
+	void RestoreRequestBuf(std::string &unused_buf);
 	// response
 	void     AddBackResponse(ConnectionState connection_state, const std::string &response_str);
 	void     AddFrontResponse(ConnectionState connection_state, const std::string &response_str);
-	Response PopFrontResponse();
-	bool     IsResponseExist() const;
+	Response    PopFrontResponse();
+	bool        IsResponseExist() const;
+	std::size_t GetResponseSize() const;
 
 	// getter
 	int                GetFd() const;
 	bool               GetIsCompleteRequest() const;
 	const std::string &GetRequestBuf() const;
+	TimerPhase         GetTimerPhase() const;
+	std::size_t        GetRequestCount() const;
 	// setter
 	void SetTimeout();
 	void SetIsCompleteRequest(bool is_complete_request_message);
+	void SetConnectionLimits(const ConnectionLimits &connection_limits);
+
+	// cgi, upstreamを待つ時間(sec)
+	static const unsigned int BACKEND_TIMEOUT = 3;
 
   private:
 	Message();
 	// function
-	static Time GetCurrentTime();
+	static Time     GetCurrentTime();
+	unsigned int    GetTimeout() const;
+	const DataRate &GetMinRate() const;
 	// variables
-	int           client_fd_;
-	Time          start_time_;
-	bool          is_timeout_;
-	bool          is_complete_request_message_;
-	std::string   request_buf_;
-	ResponseDeque responses_;
+	int              client_fd_;
+	Time             start_time_;
+	bool             is_timeout_;
+	bool             is_complete_request_message_;
+	std::string      request_buf_;
+	ResponseDeque    responses_;
+	ConnectionLimits connection_limits_; // header fieldsを読むまではlisten addrのdefault server
+	TimerPhase       timer_phase_;
+	std::size_t      request_count_; // この接続で処理し始めたrequestの数
+	// min_rateのperiodごとに受信/送信したbyte数を数える(timer_phase_が変わったら数え直す)
+	Time        rate_start_time_;
+	std::size_t rate_bytes_;
 };
 
 } // namespace message
@@ -18,10 +18,10 @@ MessageManager &MessageManager::operator=(const MessageManager &other) {
 	return *this;
 }
 
-void MessageManager::AddNewMessage(int client_fd) {
+void MessageManager::AddNewMessage(int client_fd, const ConnectionLimits &connection_limits) {
 	typedef std::pair<MessageMap::const_iterator, bool> InsertResult;
 
-	message::Message message(client_fd);
+	message::Message message(client_fd, connection_limits);
 	InsertResult     result = messages_.insert(std::make_pair(client_fd, message));
 	if (result.second == false) {
 		throw std::logic_error("AddNewMessage: message is already exist");
@@ -37,13 +37,14 @@ bool MessageManager::IsMessageExist(int client_fd) const {
 	return messages_.count(client_fd) != 0;
 }
 
-MessageManager::TimeoutFds MessageManager::GetNewTimeoutFds(double timeout) {
+// 各messageの待っているものに応じたtimeoutを超えたfd
+MessageManager::TimeoutFds MessageManager::GetNewTimeoutFds() {
 	TimeoutFds timeout_fds_;
 
 	typedef MessageMap::iterator Itr;
 	for (Itr it = messages_.begin(); it != messages_.end();) {
 		message::Message &message = it->second;
-		if (message.IsNewTimeoutExceeded(timeout)) {
+		if (message.IsNewTimeoutExceeded()) {
 			timeout_fds_.push_back(message.GetFd());
 			message.SetTimeout();
 		}
@@ -52,13 +53,58 @@ MessageManager::TimeoutFds MessageManager::GetNewTimeoutFds(double timeout) {
 	return timeout_fds_;
 }
 
-// Called when all of response_str is sent and connection is keep-alive
-void MessageManager::UpdateTime(int client_fd) {
+// 受信/送信がmin_rateより遅いfd
+MessageManager::TimeoutFds MessageManager::GetBelowMinRateFds() {
+	TimeoutFds below_min_rate_fds;
+
+	typedef MessageMap::iterator Itr;
+	for (Itr it = messages_.begin(); it != messages_.end(); ++it) {
+		message::Message &message = it->second;
+		if (message.IsBelowMinRate()) {
+			below_min_rate_fds.push_back(message.GetFd());
+		}
+	}
+	return below_min_rate_fds;
+}
+
+// keep-aliveで次のrequestを待っているだけのfd
+MessageManager::TimeoutFds MessageManager::GetIdleFds() const {
+	TimeoutFds idle_fds;
+
+	typedef MessageMap::const_iterator Itr;
+	for (Itr it = messages_.begin(); it != messages_.end(); ++it) {
+		if (it->second.IsIdle()) {
+			idle_fds.push_back(it->first);
+		}
+	}
+	return idle_fds;
+}
+
+// 待つものが変わった時・受信/送信が進んだ時に測り直す
+void MessageManager::StartTimer(int client_fd, message::TimerPhase phase) {
+	try {
+		message::Message &message = messages_.at(client_fd);
+		message.StartTimer(phase);
+	} catch (const std::exception &e) {
+		throw std::logic_error("StartTimer: " + std::string(e.what()));
+	}
+}
+
+void MessageManager::CountRequest(int client_fd) {
+	try {
+		message::Message &message = messages_.at(client_fd);
+		message.CountRequest();
+	} catch (const std::exception &e) {
+		throw std::logic_error("CountRequest: " + std::string(e.what()));
+	}
+}
+
+void MessageManager::AddSentSize(int client_fd, std::size_t sent_size) {
 	try {
 		message::Message &message = messages_.at(client_fd);
-		message.UpdateTime();
+		message.AddSentSize(sent_size);
 	} catch (const std::exception &e) {
-		throw std::logic_error("UpdateTime: " + std::string(e.what()));
+		throw std::logic_error("AddSentSize: " + std::string(e.what()));
 	}
 }
 
@@ -71,13 +117,21 @@ void MessageManager::AddRequestBuf(int client_fd, const std::string &request_buf
 	}
 }
 
-void MessageManager::SetNewRequestBuf(int client_fd, const std::string &request_buf) {
+void MessageManager::TakeRequestBuf(int client_fd, std::string &request_buf) {
 	try {
 		message::Message &message = messages_.at(client_fd);
-		message.DeleteRequestBuf();
-		message.AddRequestBuf(request_buf);
+		message.TakeRequestBuf(request_buf);
+	} catch (const std::exception &e) {
+		throw std::logic_error("TakeRequestBuf: " + std::string(e.what()));
+	}
+}
+
+void MessageManager::RestoreRequestBuf(int client_fd, std::string &unused_buf) {
+	try {
+		message::Message &message = messages_.at(client_fd);
+		message.RestoreRequestBuf(unused_buf);
 	} catch (const std::exception &e) {
-		throw std::logic_error("SetNewRequestBuf: " + std::string(e.what()));
+		throw std::logic_error("RestoreRequestBuf: " + std::string(e.what()));
 	}
 }
 
@@ -130,6 +184,24 @@ bool MessageManager::IsCompleteRequest(int client_fd) const {
 	}
 }
 
+bool MessageManager::IsIdle(int client_fd) const {
+	try {
+		const message::Message &message = messages_.at(client_fd);
+		return message.IsIdle();
+	} catch (const std::exception &e) {
+		throw std::logic_error("IsIdle: " + std::string(e.what()));
+	}
+}
+
+std::size_t MessageManager::GetResponseSize(int client_fd) const {
+	try {
+		const message::Message &message = messages_.at(client_fd);
+		return message.GetResponseSize();
+	} catch (const std::exception &e) {
+		throw std::logic_error("GetResponseSize: " + std::string(e.what()));
+	}
+}
+
 const std::string &MessageManager::GetRequestBuf(int client_fd) const {
 	try {
 		const message::Message &message = messages_.at(client_fd);
@@ -139,6 +211,28 @@ const std::string &MessageManager::GetRequestBuf(int client_fd) const {
 	}
 }
 
+message::TimerPhase MessageManager::GetTimerPhase(int client_fd) const {
+	try {
+		const message::Message &message = messages_.at(client_fd);
+		return message.GetTimerPhase();
+	} catch (const std::exception &e) {
+		throw std::logic_error("GetTimerPhase: " + std::string(e.what()));
+	}
+}
+
+std::size_t MessageManager::GetRequestCount(int client_fd) const {
+	try {
+		const message::Message &message = messages_.at(client_fd);
+		return message.GetRequestCount();
+	} catch (const std::exception &e) {
+		throw std::logic_error("GetRequestCount: " + std::string(e.what()));
+	}
+}
+
+std::size_t MessageManager::GetMessageCount() const {
+	return messages_.size();
+}
+
 void MessageManager::SetIsCompleteRequest(int client_fd, bool is_complete_request) {
 	try {
 		message::Message &message = messages_.at(client_fd);
@@ -148,4 +242,15 @@ void MessageManager::SetIsCompleteRequest(int client_fd, bool is_complete_reques
 	}
 }
 
+void MessageManager::SetConnectionLimits(
+	int client_fd, const ConnectionLimits &connection_limits
+) {
+	try {
+		message::Message &message = messages_.at(client_fd);
+		message.SetConnectionLimits(connection_limits);
+	} catch (const std::exception &e) {
+		throw std::logic_error("SetConnectionLimits: " + std::string(e.what()));
+	}
+}
+
 } // namespace server
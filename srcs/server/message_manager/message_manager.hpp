@@ -19,14 +19,19 @@ class MessageManager {
 	MessageManager &operator=(const MessageManager &other);
 
 	// functions
-	void       AddNewMessage(int client_fd);
+	void       AddNewMessage(int client_fd, const ConnectionLimits &connection_limits);
 	void       DeleteMessage(int client_fd);
 	bool       IsMessageExist(int client_fd) const;
-	TimeoutFds GetNewTimeoutFds(double timeout);
-	void       UpdateTime(int client_fd);
+	TimeoutFds GetNewTimeoutFds();
+	TimeoutFds GetBelowMinRateFds();
+	TimeoutFds GetIdleFds() const;
+	void       StartTimer(int client_fd, message::TimerPhase phase);
+	void       CountRequest(int client_fd);
+	void       AddSentSize(int client_fd, std::size_t sent_size);
 	// request_buf
 	void AddRequestBuf(int client_fd, const std::string &request_buf);
-	void SetNewRequestBuf(int client_fd, const std::string &request_buf);
+	void TakeRequestBuf(int client_fd, std::string &request_buf);
+	void RestoreRequestBuf(int client_fd, std::string &unused_buf);
 	// response
 	void AddNormalResponse(
 		int client_fd, message::ConnectionState connection_state, const std::string &response
@@ -37,11 +42,17 @@ class MessageManager {
 	message::Response PopHeadResponse(int client_fd);
 	bool              IsResponseExist(int client_fd) const;
 	bool              IsCompleteRequest(int client_fd) const;
+	bool              IsIdle(int client_fd) const;
+	std::size_t       GetResponseSize(int client_fd) const;
 
 	// getter
-	const std::string &GetRequestBuf(int client_fd) const;
+	const std::string  &GetRequestBuf(int client_fd) const;
+	message::TimerPhase GetTimerPhase(int client_fd) const;
+	std::size_t         GetRequestCount(int client_fd) const;
+	std::size_t         GetMessageCount() const;
 	// setter
 	void SetIsCompleteRequest(int client_fd, bool is_complete_request);
+	void SetConnectionLimits(int client_fd, const ConnectionLimits &connection_limits);
 
   private:
 	// variable
@@ -0,0 +1,125 @@
+#include "proxy.hpp"
+
+namespace server {
+
+Proxy::Proxy(const http::ProxyResult &proxy_result, bool is_client_keep)
+	: upstreams_(proxy_result.upstreams),
+	  balance_(proxy_result.balance),
+	  upstream_fd_(-1),
+	  is_reused_(false),
+	  is_connected_(false),
+	  request_(proxy_result.request),
+	  unsent_request_(proxy_result.request),
+	  is_head_request_(proxy_result.is_head_request),
+	  is_idempotent_(proxy_result.is_idempotent),
+	  is_client_keep_(is_client_keep),
+	  response_(is_head_request_, is_client_keep_),
+	  is_paused_(false) {}
+
+Proxy::~Proxy() {}
+
+void Proxy::SetUpstream(const IpPortPair &ip_port, int upstream_fd, bool is_reused) {
+	tried_upstreams_.insert(ip_port);
+	upstream_     = ip_port;
+	upstream_fd_  = upstream_fd;
+	is_reused_    = is_reused;
+	// poolから取り出した接続は接続済み
+	is_connected_ = is_reused;
+}
+
+// upstreamとの接続を閉じた後、別の接続でrequestを最初から送り直せるようにする
+void Proxy::ResetUpstream(bool is_retry_same_upstream) {
+	if (is_retry_same_upstream) {
+		tried_upstreams_.erase(upstream_);
+	}
+	upstream_fd_    = -1;
+	is_reused_      = false;
+	is_connected_   = false;
+	unsent_request_ = request_;
+	response_       = ProxyResponse(is_head_request_, is_client_keep_);
+	is_paused_      = false;
+}
+
+const Proxy::IpPortPair &Proxy::GetUpstream() const {
+	return upstream_;
+}
+
+int Proxy::GetUpstreamFd() const {
+	return upstream_fd_;
+}
+
+bool Proxy::IsUpstreamExist() const {
+	return upstream_fd_ != -1;
+}
+
+bool Proxy::IsReused() const {
+	return is_reused_;
+}
+
+bool Proxy::IsConnected() const {
+	return is_connected_;
+}
+
+// upstreamとの接続が失敗した時に別の接続で送り直してよいか
+// - connect自体の失敗はupstreamがrequestを受け取っていないのでどのmethodでも送り直す
+// - poolから取り出した接続が切られていた場合は、requestを1byteも書いていないか
+//   冪等なmethodの時だけ送り直す(POSTを二重に処理させないため)
+bool Proxy::IsRetryable() const {
+	if (!is_connected_) {
+		return true;
+	}
+	if (!is_reused_) {
+		return false;
+	}
+	return unsent_request_.size() == request_.size() || is_idempotent_;
+}
+
+void Proxy::SetConnected() {
+	is_connected_ = true;
+}
+
+const Proxy::UpstreamList &Proxy::GetUpstreams() const {
+	return upstreams_;
+}
+
+const std::string &Proxy::GetBalance() const {
+	return balance_;
+}
+
+bool Proxy::IsTried(const IpPortPair &ip_port) const {
+	return tried_upstreams_.count(ip_port) != 0;
+}
+
+const std::string &Proxy::GetRequest() const {
+	return unsent_request_;
+}
+
+void Proxy::ReplaceNewRequest(const std::string &new_request_str) {
+	unsent_request_ = new_request_str;
+}
+
+bool Proxy::IsRequestSent() const {
+	return unsent_request_.empty();
+}
+
+ProxyResponse::AddResult Proxy::AddResponse(const std::string &read_buf) {
+	return response_.Add(read_buf);
+}
+
+bool Proxy::AddResponseEof() {
+	return response_.AddEof();
+}
+
+const ProxyResponse &Proxy::GetResponse() const {
+	return response_;
+}
+
+bool Proxy::IsPaused() const {
+	return is_paused_;
+}
+
+void Proxy::SetPaused(bool is_paused) {
+	is_paused_ = is_paused;
+}
+
+} // namespace server
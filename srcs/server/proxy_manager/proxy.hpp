@@ -0,0 +1,71 @@
+#ifndef SERVER_PROXY_HPP_
+#define SERVER_PROXY_HPP_
+
+#include "http_result.hpp"
+#include "proxy_response.hpp"
+#include <set>
+#include <string>
+
+namespace server {
+
+// 1つのclientのrequestをupstreamに中継する間の状態を保持する
+class Proxy {
+  public:
+	typedef http::ProxyResult::IpPortPair   IpPortPair;
+	typedef http::ProxyResult::UpstreamList UpstreamList;
+	typedef std::set<IpPortPair>            IpPortSet;
+
+	Proxy(const http::ProxyResult &proxy_result, bool is_client_keep);
+	~Proxy();
+
+	// upstream
+	void                SetUpstream(const IpPortPair &ip_port, int upstream_fd, bool is_reused);
+	void                ResetUpstream(bool is_retry_same_upstream);
+	const IpPortPair   &GetUpstream() const;
+	int                 GetUpstreamFd() const;
+	bool                IsUpstreamExist() const;
+	bool                IsReused() const;
+	bool                IsConnected() const;
+	bool                IsRetryable() const;
+	void                SetConnected();
+	const UpstreamList &GetUpstreams() const;
+	const std::string  &GetBalance() const;
+	bool                IsTried(const IpPortPair &ip_port) const;
+	// request
+	const std::string &GetRequest() const;
+	void               ReplaceNewRequest(const std::string &new_request_str);
+	bool               IsRequestSent() const;
+	// response
+	ProxyResponse::AddResult AddResponse(const std::string &read_buf);
+	bool                     AddResponseEof();
+	const ProxyResponse     &GetResponse() const;
+	// backpressure
+	bool IsPaused() const;
+	void SetPaused(bool is_paused);
+
+  private:
+	Proxy();
+	// Prohibit copy
+	Proxy(const Proxy &other);
+	Proxy &operator=(const Proxy &other);
+
+	// variables
+	const UpstreamList upstreams_; // locationのproxy_pass
+	const std::string  balance_;
+	IpPortSet          tried_upstreams_;
+	IpPortPair         upstream_;
+	int                upstream_fd_;
+	bool               is_reused_;
+	bool               is_connected_;
+	const std::string  request_;
+	std::string        unsent_request_; // upstreamにまだ送っていない分
+	const bool         is_head_request_;
+	const bool         is_idempotent_;
+	const bool         is_client_keep_;
+	ProxyResponse      response_;
+	bool               is_paused_; // clientへの送信待ちが多い間はupstreamから読まない
+};
+
+} // namespace server
+
+#endif /* SERVER_PROXY_HPP_ */
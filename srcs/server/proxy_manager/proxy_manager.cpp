@@ -0,0 +1,251 @@
+#include "proxy_manager.hpp"
+#include "connection.hpp"
+#include "system_exception.hpp"
+#include <set>
+#include <stdexcept> // logic_error
+#include <unistd.h>  // close
+#include <vector>
+
+namespace server {
+
+namespace {
+
+const std::string LEAST_CONN = "least_conn";
+
+} // namespace
+
+ProxyManager::ProxyManager() {}
+
+ProxyManager::~ProxyManager() {
+	typedef ProxyAddrMap::const_iterator ItProxy;
+	for (ItProxy it = proxy_addr_map_.begin(); it != proxy_addr_map_.end(); ++it) {
+		const Proxy *proxy = it->second;
+		if (proxy->IsUpstreamExist()) {
+			close(proxy->GetUpstreamFd());
+		}
+		delete proxy;
+	}
+	typedef IdleFdMap::const_iterator ItIdle;
+	for (ItIdle it = idle_fd_map_.begin(); it != idle_fd_map_.end(); ++it) {
+		close(it->first);
+	}
+}
+
+void ProxyManager::AddNewProxy(
+	int client_fd, const http::ProxyResult &proxy_result, bool is_client_keep
+) {
+	if (IsProxyExist(client_fd)) {
+		throw std::logic_error("AddNewProxy: proxy is already exist");
+	}
+	proxy_addr_map_[client_fd] = new Proxy(proxy_result, is_client_keep);
+}
+
+// poolに接続があれば使い回し、なければ新しく接続を始める(non-blocking)
+// すぐに失敗したupstreamは除外して次のupstreamを試す。全て失敗したらfalse
+ProxyManager::GetFdResult ProxyManager::Connect(int client_fd, std::time_t now) {
+	GetFdResult result;
+	Proxy      &proxy = GetProxy(client_fd);
+
+	while (true) {
+		const SelectResult select_result = SelectUpstream(proxy, now);
+		if (!select_result.IsOk()) {
+			result.Set(false);
+			return result;
+		}
+		const IpPortPair &ip_port  = select_result.GetValue();
+		Upstream         &upstream = upstream_map_[ip_port];
+
+		bool              is_reused = true;
+		GetFdResult       fd_result = upstream.PopIdleFd();
+		if (fd_result.IsOk()) {
+			idle_fd_map_.erase(fd_result.GetValue());
+		} else {
+			is_reused = false;
+			fd_result = ConnectToUpstream(ip_port);
+		}
+		if (!fd_result.IsOk()) {
+			upstream.MarkFailed(now);
+			proxy.SetUpstream(ip_port, -1, false);
+			continue;
+		}
+		const int upstream_fd = fd_result.GetValue();
+		proxy.SetUpstream(ip_port, upstream_fd, is_reused);
+		upstream.IncrementActiveCount();
+		client_fd_map_[upstream_fd] = client_fd;
+		result.SetValue(upstream_fd);
+		return result;
+	}
+}
+
+// upstreamとの接続を閉じて、次のConnect()でrequestを送り直せるようにする
+// poolから使い回した接続はupstream側でtimeoutしていただけかもしれないので失敗扱いにしない
+void ProxyManager::CloseUpstream(int client_fd, bool is_failed, std::time_t now) {
+	Proxy &proxy = GetProxy(client_fd);
+	if (!proxy.IsUpstreamExist()) {
+		return;
+	}
+	const int  upstream_fd            = proxy.GetUpstreamFd();
+	const bool is_retry_same_upstream = proxy.IsReused();
+	if (is_failed && !is_retry_same_upstream) {
+		upstream_map_[proxy.GetUpstream()].MarkFailed(now);
+	}
+	ReleaseUpstreamFd(client_fd);
+	close(upstream_fd);
+	proxy.ResetUpstream(is_retry_same_upstream);
+}
+
+// responseを全て受け取った後に呼ぶ。使い回せる接続はpoolに戻す
+void ProxyManager::FinishProxy(int client_fd) {
+	Proxy &proxy = GetProxy(client_fd);
+	if (proxy.IsUpstreamExist()) {
+		const int         upstream_fd = proxy.GetUpstreamFd();
+		const IpPortPair &ip_port     = proxy.GetUpstream();
+		Upstream         &upstream    = upstream_map_[ip_port];
+
+		ReleaseUpstreamFd(client_fd);
+		upstream.MarkSucceeded();
+		if (proxy.GetResponse().IsUpstreamKeep() && upstream.AddIdleFd(upstream_fd)) {
+			idle_fd_map_[upstream_fd] = ip_port;
+		} else {
+			close(upstream_fd);
+		}
+	}
+	delete &proxy;
+	proxy_addr_map_.erase(client_fd);
+}
+
+void ProxyManager::DeleteProxy(int client_fd) {
+	if (!IsProxyExist(client_fd)) {
+		return;
+	}
+	Proxy &proxy = GetProxy(client_fd);
+	if (proxy.IsUpstreamExist()) {
+		const int upstream_fd = proxy.GetUpstreamFd();
+		ReleaseUpstreamFd(client_fd);
+		close(upstream_fd);
+	}
+	delete &proxy;
+	proxy_addr_map_.erase(client_fd);
+}
+
+// poolにある接続をupstreamがcloseした場合など
+void ProxyManager::DeleteIdleFd(int idle_fd) {
+	const IdleFdMap::iterator it = idle_fd_map_.find(idle_fd);
+	if (it == idle_fd_map_.end()) {
+		return;
+	}
+	upstream_map_[it->second].DeleteIdleFd(idle_fd);
+	idle_fd_map_.erase(it);
+	close(idle_fd);
+}
+
+bool ProxyManager::IsProxyExist(int client_fd) const {
+	return proxy_addr_map_.count(client_fd) != 0;
+}
+
+bool ProxyManager::IsUpstreamFd(int fd) const {
+	return client_fd_map_.count(fd) != 0;
+}
+
+bool ProxyManager::IsIdleFd(int fd) const {
+	return idle_fd_map_.count(fd) != 0;
+}
+
+int ProxyManager::GetClientFd(int upstream_fd) const {
+	try {
+		return client_fd_map_.at(upstream_fd);
+	} catch (const std::exception &e) {
+		throw std::logic_error("GetClientFd: " + std::string(e.what()));
+	}
+}
+
+Proxy &ProxyManager::GetProxy(int client_fd) {
+	try {
+		return *proxy_addr_map_.at(client_fd);
+	} catch (const std::exception &e) {
+		throw std::logic_error("GetProxy: " + std::string(e.what()));
+	}
+}
+
+// まだ試していないupstreamから選ぶ。downしていないものを優先し、全てdownなら試してみる
+ProxyManager::SelectResult ProxyManager::SelectUpstream(const Proxy &proxy, std::time_t now) {
+	UpstreamList alive_upstreams;
+	UpstreamList down_upstreams;
+
+	const UpstreamList &upstreams = proxy.GetUpstreams();
+	typedef UpstreamList::const_iterator Itr;
+	for (Itr it = upstreams.begin(); it != upstreams.end(); ++it) {
+		if (proxy.IsTried(*it)) {
+			continue;
+		}
+		if (upstream_map_[*it].IsDown(now)) {
+			down_upstreams.push_back(*it);
+		} else {
+			alive_upstreams.push_back(*it);
+		}
+	}
+	const UpstreamList &candidates = alive_upstreams.empty() ? down_upstreams : alive_upstreams;
+	if (candidates.empty()) {
+		SelectResult result;
+		result.Set(false);
+		return result;
+	}
+	if (proxy.GetBalance() == LEAST_CONN) {
+		return SelectLeastConn(candidates);
+	}
+	return SelectRoundRobin(upstreams, candidates);
+}
+
+// proxy_passに書いた順に選ぶ。順番のupstreamが候補でなければその次
+ProxyManager::SelectResult ProxyManager::SelectRoundRobin(
+	const UpstreamList &upstreams, const UpstreamList &candidates
+) {
+	const std::vector<IpPortPair> group(upstreams.begin(), upstreams.end());
+	const std::set<IpPortPair>    candidate_set(candidates.begin(), candidates.end());
+	unsigned int                 &next_index = round_robin_map_[upstreams];
+
+	for (std::size_t i = 0; i < group.size(); ++i) {
+		const std::size_t index = (next_index + i) % group.size();
+		if (candidate_set.count(group[index]) != 0) {
+			next_index = (index + 1) % group.size();
+			return SelectResult(true, group[index]);
+		}
+	}
+	return SelectResult(true, candidates.front());
+}
+
+// 処理中の接続が一番少ないupstreamを選ぶ。同じ数なら先に書いたもの
+ProxyManager::SelectResult ProxyManager::SelectLeastConn(const UpstreamList &candidates) {
+	IpPortPair   selected     = candidates.front();
+	unsigned int active_count = upstream_map_[selected].GetActiveCount();
+
+	typedef UpstreamList::const_iterator Itr;
+	for (Itr it = candidates.begin(); it != candidates.end(); ++it) {
+		const unsigned int count = upstream_map_[*it].GetActiveCount();
+		if (count < active_count) {
+			selected     = *it;
+			active_count = count;
+		}
+	}
+	return SelectResult(true, selected);
+}
+
+ProxyManager::GetFdResult ProxyManager::ConnectToUpstream(const IpPortPair &ip_port) {
+	GetFdResult result;
+	try {
+		result.SetValue(Connection::ConnectToUpstream(ip_port));
+	} catch (const SystemException &e) {
+		utils::PrintError(e.what());
+		result.Set(false);
+	}
+	return result;
+}
+
+// 接続をclientから切り離す(closeは呼び出し側)
+void ProxyManager::ReleaseUpstreamFd(int client_fd) {
+	Proxy &proxy = GetProxy(client_fd);
+	client_fd_map_.erase(proxy.GetUpstreamFd());
+	upstream_map_[proxy.GetUpstream()].DecrementActiveCount();
+}
+
+} // namespace server
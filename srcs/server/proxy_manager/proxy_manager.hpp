@@ -0,0 +1,72 @@
+#ifndef SERVER_PROXY_MANAGER_HPP_
+#define SERVER_PROXY_MANAGER_HPP_
+
+#include "http_result.hpp"
+#include "proxy.hpp"
+#include "upstream.hpp"
+#include "utils.hpp"
+#include <ctime>
+#include <map>
+
+namespace server {
+
+// "client_fd - proxy_instance", "upstream_fd - client_fd" を紐づけて全proxy_instanceを保持・取得
+// upstream毎のkeep-alive接続のpool, 負荷分散, 接続失敗したupstreamの除外もここで行う
+// fdのepollへの登録・削除は呼び出し側(Server)で行う
+class ProxyManager {
+  public:
+	typedef Proxy::IpPortPair                IpPortPair;
+	typedef Proxy::UpstreamList              UpstreamList;
+	typedef std::map<int, Proxy *>           ProxyAddrMap;
+	typedef std::map<IpPortPair, Upstream>   UpstreamMap;
+	typedef std::map<int, int>               FdMap;
+	typedef std::map<int, IpPortPair>        IdleFdMap;
+	typedef std::map<UpstreamList, unsigned> RoundRobinMap;
+	typedef utils::Result<int>               GetFdResult;
+
+	ProxyManager();
+	~ProxyManager();
+
+	// functions
+	void AddNewProxy(int client_fd, const http::ProxyResult &proxy_result, bool is_client_keep);
+	GetFdResult Connect(int client_fd, std::time_t now);
+	void        CloseUpstream(int client_fd, bool is_failed, std::time_t now);
+	void        FinishProxy(int client_fd);
+	void        DeleteProxy(int client_fd);
+	void        DeleteIdleFd(int idle_fd);
+	bool        IsProxyExist(int client_fd) const;
+	bool        IsUpstreamFd(int fd) const;
+	bool        IsIdleFd(int fd) const;
+	int         GetClientFd(int upstream_fd) const;
+	Proxy      &GetProxy(int client_fd);
+
+  private:
+	// Prohibit copy
+	ProxyManager(const ProxyManager &other);
+	ProxyManager &operator=(const ProxyManager &other);
+
+	typedef utils::Result<IpPortPair> SelectResult;
+
+	// functions
+	SelectResult SelectUpstream(const Proxy &proxy, std::time_t now);
+	SelectResult SelectRoundRobin(const UpstreamList &upstreams, const UpstreamList &candidates);
+	SelectResult SelectLeastConn(const UpstreamList &candidates);
+	GetFdResult  ConnectToUpstream(const IpPortPair &ip_port);
+	void         ReleaseUpstreamFd(int client_fd);
+
+	// variables
+	// client_fd毎にProxyをnewして保持
+	ProxyAddrMap proxy_addr_map_;
+	// upstream毎の状態(接続pool, 接続数, 失敗)
+	UpstreamMap upstream_map_;
+	// 使用中のupstream_fdとclient_fdを紐づけ
+	FdMap client_fd_map_;
+	// poolにあるupstream_fdとupstreamを紐づけ
+	IdleFdMap idle_fd_map_;
+	// proxy_passのupstream毎に次に選ぶ位置
+	RoundRobinMap round_robin_map_;
+};
+
+} // namespace server
+
+#endif /* SERVER_PROXY_MANAGER_HPP_ */
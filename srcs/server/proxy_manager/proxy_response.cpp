@@ -0,0 +1,348 @@
+#include "proxy_response.hpp"
+#include "http_message.hpp"
+#include "utils.hpp"
+#include <algorithm> // min
+#include <cctype>    // isxdigit
+#include <cerrno>
+#include <cstdlib> // strtoul
+#include <set>
+#include <vector>
+
+namespace server {
+namespace {
+
+const std::string PROXY_CONNECTION = "proxy-connection";
+
+utils::Result<std::size_t> ConvertHexStrToSize(const std::string &str) {
+	utils::Result<std::size_t> convert_result(false, 0);
+	if (str.empty() || !std::isxdigit(static_cast<unsigned char>(str[0]))) {
+		return convert_result;
+	}
+
+	char            *end;
+	static const int BASE   = 16;
+	errno                   = 0;
+	const unsigned long num = std::strtoul(str.c_str(), &end, BASE);
+	if (errno == ERANGE || *end != '\0') {
+		return convert_result;
+	}
+	convert_result.Set(true, static_cast<std::size_t>(num));
+	return convert_result;
+}
+
+// "HTTP/1.1 200 OK" -> 200
+utils::Result<unsigned int> GetStatusCode(const std::string &status_line) {
+	utils::Result<unsigned int> result(false, 0);
+	if (!utils::StartWith(status_line, "HTTP/1.")) {
+		return result;
+	}
+	const std::size_t sp_pos = status_line.find(http::SP);
+	if (sp_pos == std::string::npos) {
+		return result;
+	}
+	return utils::ConvertStrToUint(status_line.substr(sp_pos + 1, 3));
+}
+
+bool IsNoBodyStatus(unsigned int status_code) {
+	return (status_code >= 100 && status_code < 200) || status_code == 204 ||
+		   status_code == 304;
+}
+
+// 100 Continue等は最終responseの前に届くだけなので読み捨てる(101は最終response)
+bool IsInterimStatus(unsigned int status_code) {
+	return status_code >= 100 && status_code < 200 && status_code != 101;
+}
+
+// header lineのfield-nameを小文字で返す
+std::string GetFieldName(const std::string &line, std::size_t colon_pos) {
+	return utils::ToLowerString(line.substr(0, colon_pos));
+}
+
+// Connectionに書かれたtoken(upstreamとの接続だけのheader)を集める
+std::set<std::string> CreateConnectionOptions(const std::vector<std::string> &lines) {
+	std::set<std::string> connection_options;
+	typedef std::vector<std::string>::const_iterator Itr;
+	for (Itr it = lines.begin() + 1; it != lines.end(); ++it) {
+		const std::size_t colon_pos = it->find(':');
+		if (colon_pos == std::string::npos || GetFieldName(*it, colon_pos) != http::CONNECTION) {
+			continue;
+		}
+		const std::vector<std::string> tokens = utils::SplitStr(it->substr(colon_pos + 1), ",");
+		typedef std::vector<std::string>::const_iterator ItToken;
+		for (ItToken it_token = tokens.begin(); it_token != tokens.end(); ++it_token) {
+			const std::string token = utils::Trim(*it_token, http::OPTIONAL_WHITESPACE);
+			if (!token.empty()) {
+				connection_options.insert(utils::ToLowerString(token));
+			}
+		}
+	}
+	return connection_options;
+}
+
+} // namespace
+
+ProxyResponse::ProxyResponse(bool is_head_request, bool is_client_keep)
+	: state_(HEADER),
+	  is_head_request_(is_head_request),
+	  is_client_keep_(is_client_keep),
+	  is_upstream_keep_(true),
+	  remaining_size_(0) {}
+
+ProxyResponse::~ProxyResponse() {}
+
+ProxyResponse::ProxyResponse(const ProxyResponse &other) {
+	*this = other;
+}
+
+ProxyResponse &ProxyResponse::operator=(const ProxyResponse &other) {
+	if (this != &other) {
+		state_            = other.state_;
+		is_head_request_  = other.is_head_request_;
+		is_client_keep_   = other.is_client_keep_;
+		is_upstream_keep_ = other.is_upstream_keep_;
+		buf_              = other.buf_;
+		remaining_size_   = other.remaining_size_;
+	}
+	return *this;
+}
+
+ProxyResponse::AddResult ProxyResponse::Add(const std::string &read_buf) {
+	AddResult   result;
+	std::string send_str;
+	std::string body = read_buf;
+
+	if (state_ == HEADER) {
+		buf_ += read_buf;
+	}
+	// 1xxのresponseを読み捨てた後は、続きを最終responseのheaderとして読む
+	while (state_ == HEADER) {
+		const std::size_t header_end = buf_.find(http::HEADER_FIELDS_END);
+		if (header_end == std::string::npos) {
+			if (buf_.size() > HEADER_SIZE_MAX) {
+				result.Set(false);
+			}
+			return result;
+		}
+		body = buf_.substr(header_end + http::HEADER_FIELDS_END.size());
+		buf_.erase(header_end + http::CRLF.size());
+		const utils::Result<std::string> header_result = ParseHeader();
+		if (!header_result.IsOk()) {
+			result.Set(false);
+			return result;
+		}
+		send_str = header_result.GetValue();
+		if (state_ == HEADER) {
+			buf_ = body;
+		}
+	}
+	std::size_t pos = 0;
+	if (!ParseBody(body, pos)) {
+		result.Set(false);
+		return result;
+	}
+	if (pos < body.size()) {
+		// responseの後ろに余計なものが付いていた接続は使い回さない
+		is_upstream_keep_ = false;
+	}
+	send_str += body.substr(0, pos);
+	result.SetValue(send_str);
+	return result;
+}
+
+bool ProxyResponse::AddEof() {
+	is_upstream_keep_ = false;
+	if (state_ == BODY_UNTIL_CLOSE) {
+		state_ = COMPLETE;
+	}
+	return state_ == COMPLETE;
+}
+
+bool ProxyResponse::IsHeaderComplete() const {
+	return state_ != HEADER;
+}
+
+bool ProxyResponse::IsComplete() const {
+	return state_ == COMPLETE;
+}
+
+bool ProxyResponse::IsUpstreamKeep() const {
+	return is_upstream_keep_;
+}
+
+bool ProxyResponse::IsClientKeep() const {
+	return is_client_keep_;
+}
+
+// buf_: "status-line CRLF *(header-field CRLF)"
+// return: clientに送るstatus-line + header (1xxは空を返し、stateはHEADERのまま)
+utils::Result<std::string> ProxyResponse::ParseHeader() {
+	utils::Result<std::string>     result;
+	const std::vector<std::string> lines = utils::SplitStr(buf_, http::CRLF);
+	buf_.clear();
+	if (lines.empty()) {
+		result.Set(false);
+		return result;
+	}
+
+	const utils::Result<unsigned int> status_code = GetStatusCode(lines.front());
+	if (!status_code.IsOk()) {
+		result.Set(false);
+		return result;
+	}
+	if (IsInterimStatus(status_code.GetValue())) {
+		return result;
+	}
+	if (utils::StartWith(lines.front(), "HTTP/1.0")) {
+		is_upstream_keep_ = false;
+	}
+
+	// Connectionに書かれたheaderはclientに送らない(RFC 9110 7.6.1)
+	const std::set<std::string> connection_options = CreateConnectionOptions(lines);
+	bool                        is_chunked         = false;
+	bool                        has_length         = false;
+	std::string                 header             = lines.front() + http::CRLF;
+	if (connection_options.count(http::CLOSE) != 0) {
+		is_upstream_keep_ = false;
+	}
+	typedef std::vector<std::string>::const_iterator Itr;
+	for (Itr it = lines.begin() + 1; it != lines.end(); ++it) {
+		if (it->empty()) {
+			continue;
+		}
+		const std::size_t colon_pos = it->find(':');
+		if (colon_pos == std::string::npos) {
+			result.Set(false);
+			return result;
+		}
+		const std::string name  = GetFieldName(*it, colon_pos);
+		const std::string value = utils::ToLowerString(
+			utils::Trim(it->substr(colon_pos + 1), http::OPTIONAL_WHITESPACE)
+		);
+		if (name == http::CONNECTION || name == http::KEEP_ALIVE || name == PROXY_CONNECTION) {
+			// upstreamとの接続についてのheaderなのでclientには送らない
+			continue;
+		}
+		if (name == http::TRANSFER_ENCODING) {
+			is_chunked = value.find(http::CHUNKED) != std::string::npos;
+		} else if (name == http::CONTENT_LENGTH) {
+			const utils::Result<std::size_t> content_length = utils::ConvertStrToSize(value);
+			if (!content_length.IsOk() || has_length) {
+				result.Set(false);
+				return result;
+			}
+			has_length      = true;
+			remaining_size_ = content_length.GetValue();
+		} else if (connection_options.count(name) != 0) {
+			continue;
+		}
+		header += *it + http::CRLF;
+	}
+
+	if (is_head_request_ || IsNoBodyStatus(status_code.GetValue())) {
+		state_ = COMPLETE;
+	} else if (is_chunked) {
+		state_ = CHUNK_SIZE;
+	} else if (has_length) {
+		state_ = remaining_size_ == 0 ? COMPLETE : BODY_LENGTH;
+	} else {
+		// closeまでがbodyなのでclientにもcloseで終わりを伝える
+		state_            = BODY_UNTIL_CLOSE;
+		is_upstream_keep_ = false;
+		is_client_keep_   = false;
+	}
+	header += http::CONNECTION + ":" + http::SP +
+			  (is_client_keep_ ? http::KEEP_ALIVE : http::CLOSE) + http::CRLF;
+	header += http::CRLF;
+	result.SetValue(header);
+	return result;
+}
+
+// bodyをpos以降から読み進める(bodyの中身は変更しない)
+bool ProxyResponse::ParseBody(const std::string &body, std::size_t &pos) {
+	while (pos < body.size() && state_ != COMPLETE) {
+		switch (state_) {
+		case BODY_LENGTH: {
+			const std::size_t size = std::min(remaining_size_, body.size() - pos);
+			pos += size;
+			remaining_size_ -= size;
+			if (remaining_size_ == 0) {
+				state_ = COMPLETE;
+			}
+			break;
+		}
+		case BODY_UNTIL_CLOSE:
+			pos = body.size();
+			break;
+		case CHUNK_SIZE:
+			if (!ReadLine(body, pos)) {
+				return buf_.size() <= HEADER_SIZE_MAX;
+			}
+			if (!ParseChunkSizeLine()) {
+				return false;
+			}
+			break;
+		case CHUNK_DATA: {
+			const std::size_t size = std::min(remaining_size_, body.size() - pos);
+			pos += size;
+			remaining_size_ -= size;
+			if (remaining_size_ == 0) {
+				state_ = CHUNK_DATA_END;
+			}
+			break;
+		}
+		case CHUNK_DATA_END:
+			if (!ReadLine(body, pos)) {
+				break;
+			}
+			buf_.clear();
+			state_ = CHUNK_SIZE;
+			break;
+		case CHUNK_TRAILER:
+			if (!ReadLine(body, pos)) {
+				return buf_.size() <= HEADER_SIZE_MAX;
+			}
+			// 空行でtrailerが終わる
+			if (buf_ == http::CRLF) {
+				state_ = COMPLETE;
+			}
+			buf_.clear();
+			break;
+		default:
+			return false;
+		}
+	}
+	return true;
+}
+
+// chunk-size [; chunk-ext] CRLF
+bool ProxyResponse::ParseChunkSizeLine() {
+	std::string       line    = utils::Trim(buf_, http::CRLF);
+	const std::size_t ext_pos = line.find(';');
+	if (ext_pos != std::string::npos) {
+		line.erase(ext_pos);
+	}
+	buf_.clear();
+	const utils::Result<std::size_t> chunk_size =
+		ConvertHexStrToSize(utils::Trim(line, http::OPTIONAL_WHITESPACE));
+	if (!chunk_size.IsOk()) {
+		return false;
+	}
+	remaining_size_ = chunk_size.GetValue();
+	state_          = remaining_size_ == 0 ? CHUNK_TRAILER : CHUNK_DATA;
+	return true;
+}
+
+// LFまでbuf_に追加する。LFまで読めた場合はtrue
+bool ProxyResponse::ReadLine(const std::string &body, std::size_t &pos) {
+	const std::size_t lf_pos = body.find('\n', pos);
+	if (lf_pos == std::string::npos) {
+		buf_ += body.substr(pos);
+		pos = body.size();
+		return false;
+	}
+	buf_ += body.substr(pos, lf_pos + 1 - pos);
+	pos = lf_pos + 1;
+	return true;
+}
+
+} // namespace server
@@ -0,0 +1,66 @@
+#ifndef SERVER_PROXY_RESPONSE_HPP_
+#define SERVER_PROXY_RESPONSE_HPP_
+
+#include "result.hpp"
+#include <cstddef> // size_t
+#include <string>
+
+namespace server {
+
+// upstreamからのresponseの区切りを見ながら、clientに送れる分をそのまま返す
+// - headerだけConnectionをclient側の接続に合わせて書き換える
+// - bodyはContent-Length, chunked, closeまでの3通りで終わりを判定する
+class ProxyResponse {
+  public:
+	typedef utils::Result<std::string> AddResult;
+
+	ProxyResponse(bool is_head_request, bool is_client_keep);
+	~ProxyResponse();
+	ProxyResponse(const ProxyResponse &other);
+	ProxyResponse &operator=(const ProxyResponse &other);
+
+	// 読み込んだ分を追加してclientに送る分を返す。不正なresponseの場合はfalse
+	AddResult Add(const std::string &read_buf);
+	// upstreamがcloseした場合に呼ぶ。closeまでがbodyのresponseなら完了
+	bool AddEof();
+
+	// getter
+	bool IsHeaderComplete() const;
+	bool IsComplete() const;
+	bool IsUpstreamKeep() const;
+	bool IsClientKeep() const;
+
+	static const std::size_t HEADER_SIZE_MAX = 8192;
+
+  private:
+	ProxyResponse();
+
+	enum State {
+		HEADER,
+		BODY_LENGTH,
+		BODY_UNTIL_CLOSE,
+		CHUNK_SIZE,
+		CHUNK_DATA,
+		CHUNK_DATA_END,
+		CHUNK_TRAILER,
+		COMPLETE
+	};
+
+	// functions
+	utils::Result<std::string> ParseHeader();
+	bool                       ParseBody(const std::string &body, std::size_t &pos);
+	bool                       ParseChunkSizeLine();
+	bool                       ReadLine(const std::string &body, std::size_t &pos);
+
+	// variables
+	State       state_;
+	bool        is_head_request_;
+	bool        is_client_keep_;
+	bool        is_upstream_keep_;
+	std::string buf_;            // 途中までのheader, chunkの行
+	std::size_t remaining_size_; // Content-Length, chunk-sizeの残り
+};
+
+} // namespace server
+
+#endif /* SERVER_PROXY_RESPONSE_HPP_ */
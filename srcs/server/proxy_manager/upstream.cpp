@@ -0,0 +1,86 @@
+#include "upstream.hpp"
+#include <algorithm> // find
+
+namespace server {
+
+Upstream::Upstream() : active_count_(0), fail_count_(0), down_until_(0) {}
+
+Upstream::~Upstream() {}
+
+Upstream::Upstream(const Upstream &other) {
+	*this = other;
+}
+
+Upstream &Upstream::operator=(const Upstream &other) {
+	if (this != &other) {
+		idle_fds_     = other.idle_fds_;
+		active_count_ = other.active_count_;
+		fail_count_   = other.fail_count_;
+		down_until_   = other.down_until_;
+	}
+	return *this;
+}
+
+// 最後に使った接続から使う(upstream側でtimeoutしている可能性が低い)
+Upstream::GetFdResult Upstream::PopIdleFd() {
+	GetFdResult result;
+	if (idle_fds_.empty()) {
+		result.Set(false);
+		return result;
+	}
+	result.SetValue(idle_fds_.back());
+	idle_fds_.pop_back();
+	return result;
+}
+
+// poolが一杯の場合はfalse(呼び出し側でcloseする)
+bool Upstream::AddIdleFd(int upstream_fd) {
+	if (idle_fds_.size() >= IDLE_FD_MAX) {
+		return false;
+	}
+	idle_fds_.push_back(upstream_fd);
+	return true;
+}
+
+void Upstream::DeleteIdleFd(int upstream_fd) {
+	const FdList::iterator it = std::find(idle_fds_.begin(), idle_fds_.end(), upstream_fd);
+	if (it != idle_fds_.end()) {
+		idle_fds_.erase(it);
+	}
+}
+
+const Upstream::FdList &Upstream::GetIdleFds() const {
+	return idle_fds_;
+}
+
+void Upstream::IncrementActiveCount() {
+	++active_count_;
+}
+
+void Upstream::DecrementActiveCount() {
+	if (active_count_ > 0) {
+		--active_count_;
+	}
+}
+
+unsigned int Upstream::GetActiveCount() const {
+	return active_count_;
+}
+
+void Upstream::MarkFailed(std::time_t now) {
+	++fail_count_;
+	if (fail_count_ >= MAX_FAILS) {
+		down_until_ = now + FAIL_TIMEOUT;
+	}
+}
+
+void Upstream::MarkSucceeded() {
+	fail_count_ = 0;
+	down_until_ = 0;
+}
+
+bool Upstream::IsDown(std::time_t now) const {
+	return now < down_until_;
+}
+
+} // namespace server
@@ -0,0 +1,51 @@
+#ifndef SERVER_UPSTREAM_HPP_
+#define SERVER_UPSTREAM_HPP_
+
+#include "result.hpp"
+#include <ctime>
+#include <list>
+#include <string>
+
+namespace server {
+
+// proxy_passの1つのupstream serverの状態を保持する
+// - keep-aliveで使い終わった接続を保持して使い回す
+// - 接続に失敗したらFAIL_TIMEOUTの間は選ばない(passive health check)
+class Upstream {
+  public:
+	typedef std::list<int>     FdList;
+	typedef utils::Result<int> GetFdResult;
+
+	Upstream();
+	~Upstream();
+	Upstream(const Upstream &other);
+	Upstream &operator=(const Upstream &other);
+
+	// idle connection pool
+	GetFdResult   PopIdleFd();
+	bool          AddIdleFd(int upstream_fd);
+	void          DeleteIdleFd(int upstream_fd);
+	const FdList &GetIdleFds() const;
+	// least_conn
+	void         IncrementActiveCount();
+	void         DecrementActiveCount();
+	unsigned int GetActiveCount() const;
+	// passive health check
+	void MarkFailed(std::time_t now);
+	void MarkSucceeded();
+	bool IsDown(std::time_t now) const;
+
+	static const std::size_t  IDLE_FD_MAX  = 16;
+	static const unsigned int MAX_FAILS    = 1;
+	static const int          FAIL_TIMEOUT = 10; // sec
+
+  private:
+	FdList       idle_fds_;
+	unsigned int active_count_;
+	unsigned int fail_count_;
+	std::time_t  down_until_;
+};
+
+} // namespace server
+
+#endif /* SERVER_UPSTREAM_HPP_ */
@@ -1,23 +1,28 @@
 #include "server.hpp"
+#include "binary_upgrade.hpp"
 #include "client_info.hpp"
+#include "config.hpp"
 #include "define.hpp"
 #include "event.hpp"
 #include "send.hpp"
+#include "server_signal.hpp"
 #include "start_up_exception.hpp"
 #include "system_exception.hpp"
 #include "utils.hpp"
 #include "virtual_server.hpp"
 #include <cerrno>
+#include <climits>      // PATH_MAX
+#include <cstdlib>      // realpath
 #include <cstring>      // strerror
+#include <ctime>
 #include <fcntl.h>      // fcntl
+#include <stdexcept>    // runtime_error
 #include <sys/socket.h> // socket
+#include <sys/stat.h>   // stat
 #include <unistd.h>     // close
 
 namespace server {
 
-// todo: tmp
-const double Server::REQUEST_TIMEOUT = 3.0;
-
 namespace {
 
 typedef std::set<Server::HostPortPair> HostPortSet;
@@ -25,21 +30,95 @@ typedef std::set<Server::HostPortPair> HostPortSet;
 typedef Server::VirtualServerList::const_iterator   ItVirtualServer;
 typedef VirtualServer::HostPortList::const_iterator ItHostPort;
 
-VirtualServer::LocationList ConvertLocations(const config::context::LocationList &config_locations
+// proxy_passのhostはここで名前解決しておき、接続時にはblockingなgetaddrinfo()を呼ばない
+Location::UpstreamList ConvertProxyPass(const config::context::HostPortList &config_proxy_pass) {
+	Location::UpstreamList upstreams;
+
+	typedef config::context::HostPortList::const_iterator Itr;
+	for (Itr it = config_proxy_pass.begin(); it != config_proxy_pass.end(); ++it) {
+		const Connection::IpList ip_list = Connection::ResolveHostName(it->first);
+		upstreams.push_back(std::make_pair(ip_list.front(), it->second));
+	}
+	return upstreams;
+}
+
+// rootの指定が無い場合は起動したdirectoryのroot
+const char *const DEFAULT_ROOT = "root";
+
+// requestごとに組み立てなくて済むように、起動時にsymlinkなどを解決した絶対pathにしておく
+std::string ResolveRoot(const std::string &root) {
+	char resolved_path[PATH_MAX];
+	if (realpath(root.c_str(), resolved_path) == NULL) {
+		throw std::runtime_error("root: " + root + ": " + std::strerror(errno));
+	}
+	struct stat stat_buf;
+	if (stat(resolved_path, &stat_buf) == -1 || !S_ISDIR(stat_buf.st_mode)) {
+		throw std::runtime_error("root: " + root + ": not a directory");
+	}
+	const std::string absolute_root(resolved_path);
+	// "/"の場合もrequest_targetをそのまま足せるように末尾の'/'は付けない
+	return absolute_root == "/" ? "" : absolute_root;
+}
+
+ConnectionLimits ConvertConnectionLimits(const config::context::ServerCon &config_server) {
+	ConnectionLimits connection_limits;
+	connection_limits.client_header_timeout = config_server.client_header_timeout;
+	connection_limits.client_body_timeout   = config_server.client_body_timeout;
+	connection_limits.keepalive_timeout     = config_server.keepalive_timeout;
+	connection_limits.send_timeout          = config_server.send_timeout;
+	connection_limits.keepalive_requests    = config_server.keepalive_requests;
+	connection_limits.limit_conn_per_ip     = config_server.limit_conn_per_ip;
+
+	const config::context::ServerCon::MinRate &client_min_rate = config_server.client_min_rate;
+	const config::context::ServerCon::MinRate &send_min_rate   = config_server.send_min_rate;
+	connection_limits.client_min_rate = DataRate(client_min_rate.first, client_min_rate.second);
+	connection_limits.send_min_rate   = DataRate(send_min_rate.first, send_min_rate.second);
+	return connection_limits;
+}
+
+// locationに書かれていない(0の)ものはserverの値を使う
+ConnectionLimits ConvertConnectionLimits(
+	const config::context::LocationCon &config_location, const ConnectionLimits &server_limits
+) {
+	ConnectionLimits connection_limits = server_limits;
+	if (config_location.client_body_timeout != 0) {
+		connection_limits.client_body_timeout = config_location.client_body_timeout;
+	}
+	if (config_location.keepalive_timeout != 0) {
+		connection_limits.keepalive_timeout = config_location.keepalive_timeout;
+	}
+	if (config_location.send_timeout != 0) {
+		connection_limits.send_timeout = config_location.send_timeout;
+	}
+	if (config_location.keepalive_requests != 0) {
+		connection_limits.keepalive_requests = config_location.keepalive_requests;
+	}
+	return connection_limits;
+}
+
+VirtualServer::LocationList ConvertLocations(
+	const config::context::LocationList &config_locations,
+	const std::string                   &server_root,
+	const ConnectionLimits              &server_limits
 ) {
 	VirtualServer::LocationList location_list;
 
 	typedef config::context::LocationList::const_iterator Itr;
 	for (Itr it = config_locations.begin(); it != config_locations.end(); ++it) {
 		Location location;
-		location.request_uri      = it->request_uri;
-		location.alias            = it->alias;
-		location.index            = it->index;
-		location.autoindex        = it->autoindex;
-		location.allowed_methods  = it->allowed_methods;
-		location.redirect         = it->redirect;
-		location.cgi_extension    = it->cgi_extension;
-		location.upload_directory = it->upload_directory;
+		location.request_uri       = it->request_uri;
+		location.root              = it->root.empty() ? server_root : ResolveRoot(it->root);
+		location.alias             = it->alias;
+		location.index             = it->index;
+		location.autoindex         = it->autoindex;
+		location.allowed_methods   = it->allowed_methods;
+		location.redirect          = it->redirect;
+		location.cgi_extension     = it->cgi_extension;
+		location.upload_directory  = it->upload_directory;
+		location.cgi_cache_valid   = it->cgi_cache_valid;
+		location.proxy_pass        = ConvertProxyPass(it->proxy_pass);
+		location.proxy_balance     = it->proxy_balance;
+		location.connection_limits = ConvertConnectionLimits(*it, server_limits);
 
 		location_list.push_back(location);
 	}
@@ -62,6 +141,47 @@ void AddResolvedHostPort(
 	}
 }
 
+// 0.0.0.0:portがあれば同じportの他のipはlistenしない
+HostPortSet CreateListenHostPorts(const Server::PortIpMap &port_ip_map) {
+	HostPortSet listen_host_ports;
+
+	typedef Server::PortIpMap::const_iterator ItMap;
+	for (ItMap it_map = port_ip_map.begin(); it_map != port_ip_map.end(); ++it_map) {
+		const unsigned int   port   = it_map->first;
+		const Server::IpSet &ip_set = it_map->second;
+		if (ip_set.find(IPV4_ADDR_ANY) != ip_set.end()) {
+			listen_host_ports.insert(std::make_pair(IPV4_ADDR_ANY, port));
+			continue;
+		}
+		typedef Server::IpSet::const_iterator ItSet;
+		for (ItSet it_set = ip_set.begin(); it_set != ip_set.end(); ++it_set) {
+			listen_host_ports.insert(std::make_pair(*it_set, port));
+		}
+	}
+	return listen_host_ports;
+}
+
+// host_portと同じportを別のaddressでlistenしていて、一緒にはbindできないもの
+// (0.0.0.0:portとip:port。新しいconfigでも使うhost:portは除く)
+Server::HostPortList FindConflictingHostPorts(
+	const Server::HostPortList &listening_host_ports,
+	const HostPortSet          &listen_host_ports,
+	const Server::HostPortPair &host_port
+) {
+	Server::HostPortList conflicting_host_ports;
+
+	typedef Server::HostPortList::const_iterator Itr;
+	for (Itr it = listening_host_ports.begin(); it != listening_host_ports.end(); ++it) {
+		if (it->second != host_port.second || listen_host_ports.count(*it) != 0) {
+			continue;
+		}
+		if (it->first == IPV4_ADDR_ANY || host_port.first == IPV4_ADDR_ANY) {
+			conflicting_host_ports.push_back(*it);
+		}
+	}
+	return conflicting_host_ports;
+}
+
 VirtualServer::HostPortList ConvertHostPortSetToList(const HostPortSet &host_ports_set) {
 	return VirtualServer::HostPortList(host_ports_set.begin(), host_ports_set.end());
 }
@@ -80,15 +200,38 @@ VirtualServer::HostPortList ConvertHostPorts(const config::context::HostPortList
 }
 
 VirtualServer ConvertToVirtualServer(const config::context::ServerCon &config_server) {
+	HeaderLimits header_limits;
+	header_limits.buffer_number = config_server.large_client_header_buffers.first;
+	header_limits.buffer_size   = config_server.large_client_header_buffers.second;
+	header_limits.max_fields    = config_server.max_header_fields;
+	const ConnectionLimits connection_limits = ConvertConnectionLimits(config_server);
+	const std::string      server_root =
+		ResolveRoot(config_server.root.empty() ? DEFAULT_ROOT : config_server.root);
+	// error_pageもserverのrootからの絶対pathにしておく
+	VirtualServer::ErrorPage error_page = config_server.error_page;
+	if (!error_page.second.empty()) {
+		error_page.second = server_root + error_page.second;
+	}
 	return VirtualServer(
 		config_server.server_names,
-		ConvertLocations(config_server.location_con),
+		ConvertLocations(config_server.location_con, server_root, connection_limits),
 		ConvertHostPorts(config_server.host_ports),
 		config_server.client_max_body_size,
-		config_server.error_page
+		error_page,
+		config_server.cgi_cache_size,
+		header_limits,
+		// types {}がどこにも無ければ組み込みのtypes
+		config_server.types.empty() ? MimeTypes() : MimeTypes(config_server.types),
+		connection_limits
 	);
 }
 
+// serverの外に書くので全serverで同じ値
+unsigned int GetShutdownTimeout(const Server::ConfigServers &config_servers) {
+	return config_servers.empty() ? config::context::ServerCon().shutdown_timeout
+								  : config_servers.front().shutdown_timeout;
+}
+
 } // namespace
 
 void Server::AddVirtualServers(const ConfigServers &config_servers) {
@@ -99,7 +242,11 @@ void Server::AddVirtualServers(const ConfigServers &config_servers) {
 	}
 }
 
-Server::Server(const ConfigServers &config_servers) {
+Server::Server(const ConfigServers &config_servers)
+	: shutdown_timeout_(GetShutdownTimeout(config_servers)),
+	  is_shutting_down_(false),
+	  shutdown_deadline_(0),
+	  upgrade_pid_(-1) {
 	try {
 		AddVirtualServers(config_servers);
 	} catch (const std::exception &e) {
@@ -113,14 +260,37 @@ Server::~Server() {}
 void Server::Run() {
 	utils::Debug("server", "run server");
 
-	while (true) {
+	while (!IsShutdownComplete()) {
 		const event::EventList events = event_monitor_.GetEventList();
 		for (event::ItEventList it = events.begin(); it != events.end(); ++it) {
 			const event::Event &event = *it;
-			HandleEvent(event);
+			try {
+				HandleEvent(event);
+			} catch (const std::exception &e) {
+				// 1つのclientの失敗でserver全体を作り直さない
+				HandleEventFailure(event.fd, e.what());
+			}
 		}
 		HandleTimeoutMessages();
+		HandleBelowMinRateMessages();
+		if (ServerSignal::TakeReloadRequest() && !is_shutting_down_) {
+			HandleReloadRequest();
+		}
+		if (ServerSignal::TakeUpgradeRequest() && !is_shutting_down_) {
+			HandleUpgradeRequest();
+		}
+		if (ServerSignal::TakeShutdownRequest()) {
+			StartShutdown();
+		}
+		WaitUpgradeProcess();
+		DeleteUnusedSnapshots();
 	}
+	// 残っているclient, cgiはServerのdestructorで閉じる(cgiの子プロセスはkillしてwaitする)
+	utils::Debug(
+		"server",
+		"shutdown server (remaining clients: " +
+			utils::ToString(message_manager_.GetMessageCount()) + ")"
+	);
 }
 
 void Server::HandleEvent(const event::Event &event) {
@@ -145,7 +315,23 @@ void Server::HandleNewConnection(int server_fd) {
 
 	// add client_info, message, event
 	context_.AddClientInfo(new_client_info);
-	message_manager_.AddNewMessage(client_fd);
+	// Hostが分かるまではlistenしているaddrのdefault serverのtimeoutを使う
+	const VirtualServerAddrList &virtual_servers = GetVirtualServerList(client_fd);
+	const ConnectionLimits       connection_limits =
+		virtual_servers.empty() ? ConnectionLimits()
+								: virtual_servers.GetDefaultServer()->GetConnectionLimits();
+	// 同じIPからの接続が多すぎる時はrequestを読まずに切る
+	if (connection_limits.limit_conn_per_ip != 0 &&
+		context_.GetConnectionCount(new_client_info.GetIp()) >
+			connection_limits.limit_conn_per_ip) {
+		utils::Debug(
+			"server", "too many connections from IP: " + new_client_info.GetIp(), client_fd
+		);
+		context_.DeleteClientInfo(client_fd);
+		close(client_fd);
+		return;
+	}
+	message_manager_.AddNewMessage(client_fd, connection_limits);
 	AddEventRead(client_fd);
 	utils::Debug(
 		"server",
@@ -156,6 +342,15 @@ void Server::HandleNewConnection(int server_fd) {
 }
 
 void Server::HandleExistingConnection(const event::Event &event) {
+	// upstream_fd
+	if (proxy_manager_.IsIdleFd(event.fd)) {
+		HandleIdleUpstreamEvent(event.fd);
+		return;
+	}
+	if (proxy_manager_.IsUpstreamFd(event.fd)) {
+		HandleUpstreamEvent(event);
+		return;
+	}
 	if (event.type & event::EVENT_ERROR) {
 		HandleErrorEvent(event.fd);
 		return;
@@ -238,14 +433,15 @@ void Server::HandleReadEvent(const event::Event &event) {
 
 http::ClientInfos Server::GetClientInfos(int client_fd) const {
 	http::ClientInfos client_infos;
-	client_infos.fd                 = client_fd;
-	client_infos.ip                 = context_.GetClientIp(client_fd);
-	client_infos.listen_server_port = context_.GetListenServerPort(client_fd);
-	client_infos.request_buf        = message_manager_.GetRequestBuf(client_fd);
+	client_infos.fd                     = client_fd;
+	client_infos.ip                     = context_.GetClientIp(client_fd);
+	client_infos.listen_server_port     = context_.GetListenServerPort(client_fd);
+	client_infos.request_count          = message_manager_.GetRequestCount(client_fd);
+	client_infos.is_keep_alive_disabled = is_shutting_down_;
 	return client_infos;
 }
 
-VirtualServerAddrList Server::GetVirtualServerList(int client_fd) const {
+const VirtualServerAddrList &Server::GetVirtualServerList(int client_fd) const {
 	return context_.GetVirtualServerAddrList(client_fd);
 }
 
@@ -261,13 +457,23 @@ void Server::HandleHttpReadResult(const event::Event &event, const Read::ReadRes
 		return;
 	}
 	message_manager_.AddRequestBuf(client_fd, read_result.GetValue().read_buf);
-	std::cerr << message_manager_.GetRequestBuf(client_fd) << std::endl;
+	// keep-aliveで待っていた次のrequestが届いた / bodyの受信が進んだ
+	const message::TimerPhase phase = message_manager_.GetTimerPhase(client_fd);
+	if (phase == message::WAIT_REQUEST) {
+		message_manager_.StartTimer(client_fd, message::READ_HEADER);
+	} else if (phase == message::READ_BODY) {
+		message_manager_.StartTimer(client_fd, message::READ_BODY);
+	}
 }
 
 bool Server::IsHttpRequestBufExist(int fd) const {
 	if (IsCgi(fd)) {
 		return false;
 	}
+	// upstreamのresponseを返し終わるまで次のrequestは処理しない
+	if (proxy_manager_.IsProxyExist(fd)) {
+		return false;
+	}
 	return !message_manager_.GetRequestBuf(fd).empty();
 }
 
@@ -275,17 +481,28 @@ void Server::RunHttpAndCgi(const event::Event &event) {
 	const int client_fd = event.fd;
 
 	// Prepare to http.Run()
-	const http::ClientInfos     &client_infos    = GetClientInfos(client_fd);
+	// 受信したbufferはコピーせずにhttpへ渡し、使われなかった分だけ戻してもらう
+	http::ClientInfos            client_infos    = GetClientInfos(client_fd);
 	const VirtualServerAddrList &virtual_servers = GetVirtualServerList(client_fd);
+	message_manager_.TakeRequestBuf(client_fd, client_infos.request_buf);
 
 	http::HttpResult http_result = http_.Run(client_infos, virtual_servers);
 	// Set the unused request_buf in Http.
-	message_manager_.SetNewRequestBuf(client_fd, http_result.request_buf);
+	message_manager_.RestoreRequestBuf(client_fd, http_result.request_buf);
+	UpdateTimerAfterHttpRun(client_fd, http_result);
 	// Check if it's ready to start write/send.
 	// If not completed, the request will be re-read by the event_monitor.
 	if (!http_result.is_response_complete) {
 		message_manager_.SetIsCompleteRequest(client_fd, false);
+		// bodyを待つ前に100 Continueを返す
+		if (!http_result.interim_response.empty()) {
+			message_manager_.AddNormalResponse(
+				client_fd, message::KEEP, http_result.interim_response
+			);
+			AppendEventWrite(event);
+		}
 		HandleCgi(client_fd, http_result.cgi_result);
+		HandleProxy(client_fd, http_result);
 		return;
 	}
 	// received all request from client
@@ -297,6 +514,27 @@ void Server::RunHttpAndCgi(const event::Event &event) {
 	UpdateEventInResponseComplete(connection_state, event);
 }
 
+// header fieldsを読んだらlocationのtimeoutに切り替え、次に待つもののtimerを始める
+void Server::UpdateTimerAfterHttpRun(int client_fd, const http::HttpResult &http_result) {
+	if (http_result.connection_limits != NULL) {
+		message_manager_.SetConnectionLimits(client_fd, *http_result.connection_limits);
+	}
+	if (http_result.is_response_complete) {
+		message_manager_.CountRequest(client_fd);
+		message_manager_.StartTimer(client_fd, message::SEND_RESPONSE);
+		return;
+	}
+	if (http_result.cgi_result.is_cgi || http_result.proxy_result.is_proxy) {
+		message_manager_.CountRequest(client_fd);
+		message_manager_.StartTimer(client_fd, message::WAIT_BACKEND);
+		return;
+	}
+	if (http_result.connection_limits != NULL &&
+		message_manager_.GetTimerPhase(client_fd) == message::READ_HEADER) {
+		message_manager_.StartTimer(client_fd, message::READ_BODY);
+	}
+}
+
 void Server::HandleWriteEvent(int fd) {
 	// Prevent SendStr() if Disconnect() was called during EVENT_READ handling.
 	if (!IsMessageExist(fd)) {
@@ -329,12 +567,19 @@ void Server::SendHttpResponse(int client_fd) {
 		return;
 	}
 	const std::string &new_response_str = send_result.GetValue();
+	message_manager_.AddSentSize(client_fd, response_str.size() - new_response_str.size());
 	if (!new_response_str.empty()) {
 		// If not everything was sent, re-add the remaining unsent part to the front
 		message_manager_.AddPrimaryResponse(client_fd, connection_state, new_response_str);
+		// send_timeoutは送信が進まない時間
+		if (message_manager_.GetTimerPhase(client_fd) == message::SEND_RESPONSE) {
+			message_manager_.StartTimer(client_fd, message::SEND_RESPONSE);
+		}
+		ResumeProxyIfNeeded(client_fd);
 		return;
 	}
 	utils::Debug("server", "send response to client", client_fd);
+	ResumeProxyIfNeeded(client_fd);
 
 	if (!message_manager_.IsResponseExist(client_fd)) {
 		ReplaceEvent(client_fd, event::EVENT_READ);
@@ -344,31 +589,151 @@ void Server::SendHttpResponse(int client_fd) {
 
 void Server::HandleTimeoutMessages() {
 	// timeoutした全fdを取得
-	const MessageManager::TimeoutFds &timeout_fds =
-		message_manager_.GetNewTimeoutFds(REQUEST_TIMEOUT);
+	const MessageManager::TimeoutFds &timeout_fds = message_manager_.GetNewTimeoutFds();
 
 	// timeout用のresponseをセットしてevent監視をWRITEに変更
 	typedef MessageManager::TimeoutFds::const_iterator Itr;
 	for (Itr it = timeout_fds.begin(); it != timeout_fds.end(); ++it) {
-		const int client_fd = *it;
-		if (message_manager_.IsCompleteRequest(client_fd)) {
+		try {
+			HandleTimeoutMessage(*it);
+		} catch (const std::exception &e) {
+			AbortClient(*it, e.what());
+		}
+	}
+}
+
+void Server::HandleTimeoutMessage(int client_fd) {
+	if (proxy_manager_.IsProxyExist(client_fd)) {
+		HandleProxyTimeout(client_fd);
+		return;
+	}
+	if (message_manager_.IsCompleteRequest(client_fd)) {
+		Disconnect(client_fd);
+		return;
+	}
+
+	// 実行中のcgiのresponseはもう返さないので止める
+	AbortCgi(client_fd);
+	const http::HttpResult http_result = http_.GetErrorResponse(client_fd, http::TIMEOUT);
+	message_manager_.AddPrimaryResponse(client_fd, message::CLOSE, http_result.response);
+	ReplaceEvent(client_fd, event::EVENT_WRITE);
+	utils::Debug("server", "timeout client", client_fd);
+}
+
+// min_rateより遅いclientはresponseを返さずに切る(返しても遅くて届かないため)
+void Server::HandleBelowMinRateMessages() {
+	const MessageManager::TimeoutFds &slow_fds = message_manager_.GetBelowMinRateFds();
+
+	typedef MessageManager::TimeoutFds::const_iterator Itr;
+	for (Itr it = slow_fds.begin(); it != slow_fds.end(); ++it) {
+		utils::Debug("server", "too slow client", *it);
+		try {
+			Disconnect(*it);
+		} catch (const std::exception &e) {
+			AbortClient(*it, e.what());
+		}
+	}
+}
+
+// eventのfd(client_fd, pipe_fd, upstream_fd)を使っているclient。いなければ-1
+int Server::FindClientFd(int fd) const {
+	if (message_manager_.IsMessageExist(fd)) {
+		return fd;
+	}
+	if (proxy_manager_.IsUpstreamFd(fd)) {
+		return proxy_manager_.GetClientFd(fd);
+	}
+	if (cgi_manager_.IsCgiExist(fd)) {
+		return cgi_manager_.GetClientFd(fd);
+	}
+	return SYSTEM_ERROR;
+}
+
+void Server::HandleEventFailure(int fd, const std::string &reason) {
+	int client_fd = SYSTEM_ERROR;
+	try {
+		client_fd = FindClientFd(fd);
+	} catch (const std::exception &e) {
+		utils::PrintError(e.what());
+	}
+	if (client_fd == SYSTEM_ERROR) {
+		// listen中のsocket, poolのupstream等のclientがいないfdはlogだけ残して続ける
+		utils::PrintError("fd(" + utils::ToString(fd) + "): " + reason);
+		return;
+	}
+	AbortClient(client_fd, reason);
+}
+
+// 想定外のexceptionが起きたclientだけを終わらせ、eventループと他のclientはそのまま続ける
+// responseをまだ送り始めていなければ500、送り始めていればclose
+void Server::AbortClient(int client_fd, const std::string &reason) {
+	utils::PrintError("client(" + utils::ToString(client_fd) + "): " + reason);
+	try {
+		if (!message_manager_.IsMessageExist(client_fd)) {
+			// clientは既に切れているので残っているcgi, upstreamだけ片付ける
+			CloseProxy(client_fd);
+			AbortCgi(client_fd);
+		} else if (IsResponseStarted(client_fd)) {
 			Disconnect(client_fd);
-			continue;
+		} else {
+			SetInternalServerError(client_fd);
 		}
+		return;
+	} catch (const std::exception &e) {
+		utils::PrintError(
+			"failed to abort client(" + utils::ToString(client_fd) + "): " + e.what()
+		);
+	}
+	ForceDisconnect(client_fd);
+}
 
-		const http::HttpResult http_result = http_.GetErrorResponse(client_fd, http::TIMEOUT);
-		message_manager_.AddPrimaryResponse(client_fd, message::CLOSE, http_result.response);
-		ReplaceEvent(client_fd, event::EVENT_WRITE);
-		utils::Debug("server", "timeout client", client_fd);
+bool Server::IsResponseStarted(int client_fd) {
+	if (message_manager_.IsResponseExist(client_fd)) {
+		return true;
 	}
+	return proxy_manager_.IsProxyExist(client_fd) &&
+		   proxy_manager_.GetProxy(client_fd).GetResponse().IsHeaderComplete();
+}
+
+// Disconnect()もできなかった時: 消せるものだけ消してfdを閉じる(closeでepollからも外れる)
+void Server::ForceDisconnect(int client_fd) {
+	try {
+		CloseProxy(client_fd);
+	} catch (const std::exception &e) {
+		utils::PrintError(e.what());
+	}
+	try {
+		AbortCgi(client_fd);
+	} catch (const std::exception &e) {
+		utils::PrintError(e.what());
+	}
+	// 既に閉じたfdは別の接続で使われているかもしれないのでcloseしない
+	if (!message_manager_.IsMessageExist(client_fd)) {
+		return;
+	}
+	// 同じfd番号の次の接続に途中のrequestが残らないようにする
+	try {
+		http_.DeleteClient(client_fd);
+	} catch (const std::exception &e) {
+		utils::PrintError(e.what());
+	}
+	// closeした後に同じ番号のfdがepollに残らないよう先に外す
+	try {
+		event_monitor_.Delete(client_fd);
+	} catch (const std::exception &e) {
+		utils::PrintError(e.what());
+	}
+	message_manager_.DeleteMessage(client_fd);
+	context_.DeleteClientInfo(client_fd);
+	close(client_fd);
+	utils::Debug("server", "force disconnected client", client_fd);
+	utils::Debug("------------------------------------------");
 }
 
 // internal server error用のresponseをセットしてevent監視をWRITEに変更
 void Server::SetInternalServerError(int client_fd) {
-	if (cgi_manager_.IsCgiExist(client_fd)) {
-		// Call Cgi's destructor -> close pipe_fd -> automatically deleted from epoll
-		cgi_manager_.DeleteCgi(client_fd);
-	}
+	CloseProxy(client_fd);
+	AbortCgi(client_fd);
 
 	const http::HttpResult http_result = http_.GetErrorResponse(client_fd, http::INTERNAL_ERROR);
 	message_manager_.AddPrimaryResponse(client_fd, message::CLOSE, http_result.response);
@@ -377,16 +742,36 @@ void Server::SetInternalServerError(int client_fd) {
 }
 
 void Server::KeepConnection(int client_fd) {
-	message_manager_.UpdateTime(client_fd);
+	// 次のrequestの受信やcgi, upstreamを既に始めていればそのtimerのまま
+	if (message_manager_.GetTimerPhase(client_fd) == message::SEND_RESPONSE) {
+		message_manager_.StartTimer(
+			client_fd,
+			message_manager_.IsResponseExist(client_fd) ? message::SEND_RESPONSE
+														: message::WAIT_REQUEST
+		);
+	}
+	// shutdown中は次のrequestを待たない
+	if (is_shutting_down_ && message_manager_.IsIdle(client_fd)) {
+		Disconnect(client_fd);
+		return;
+	}
 	utils::Debug("server", "Connection: keep-alive client", client_fd);
 }
 
 // delete from event, message, context
 void Server::Disconnect(int client_fd) {
+	CloseProxy(client_fd);
 	if (cgi_manager_.IsCgiExist(client_fd)) {
-		// Call Cgi's destructor -> close pipe_fd -> automatically deleted from epoll
-		cgi_manager_.DeleteCgi(client_fd);
+		// 同じcgiを待っているclientがいれば実行中のcgiを引き継ぐ
+		const CgiManager::GetFdResult hand_over_result = cgi_manager_.HandOverCgi(client_fd);
+		if (hand_over_result.IsOk()) {
+			utils::Debug("cgi", "hand over the running cgi", hand_over_result.GetValue());
+		} else {
+			// Call Cgi's destructor -> close pipe_fd -> automatically deleted from epoll
+			cgi_manager_.DeleteCgi(client_fd);
+		}
 	}
+	cgi_manager_.DeleteWaiter(client_fd);
 	// HttpResult is not used.
 	http_.GetErrorResponse(client_fd, http::INTERNAL_ERROR);
 	event_monitor_.Delete(client_fd);
@@ -471,14 +856,19 @@ Server::AcceptResult Server::Accept(int server_fd) {
 	return result;
 }
 
-void Server::AddServerInfoToContext(const VirtualServerList &virtual_server_list) {
+// return: 新しく追加したhost:port
+Server::HostPortList Server::AddServerInfoToContext(const VirtualServerList &virtual_server_list) {
+	HostPortList added_host_ports;
 	for (ItVirtualServer it = virtual_server_list.begin(); it != virtual_server_list.end(); ++it) {
 		const VirtualServer::HostPortList &host_ports = it->GetHostPortList();
 		for (ItHostPort it_host_port = host_ports.begin(); it_host_port != host_ports.end();
 			 ++it_host_port) {
-			context_.AddServerInfo(*it_host_port);
+			if (context_.AddServerInfo(*it_host_port)) {
+				added_host_ports.push_back(*it_host_port);
+			}
 		}
 	}
+	return added_host_ports;
 }
 
 // PortIpMap -> port1:{ip1, ip2}, port2:{ip1, 0.0.0.0}, ...
@@ -498,7 +888,15 @@ Server::PortIpMap Server::CreatePortIpMap(const VirtualServerList &virtual_serve
 }
 
 void Server::Listen(const HostPortPair &host_port) {
-	const int server_fd = connection_.Connect(host_port);
+	// binary upgradeで古いprocessから渡されたものがあればbindし直さずに使う
+	const InheritedFdMap::iterator inherited = inherited_listen_fds_.find(host_port);
+	int                            server_fd = SYSTEM_ERROR;
+	if (inherited != inherited_listen_fds_.end()) {
+		server_fd = inherited->second;
+		inherited_listen_fds_.erase(inherited);
+	} else {
+		server_fd = connection_.Connect(host_port);
+	}
 	SetNonBlockingMode(server_fd);
 
 	context_.SetListenSockFd(host_port, server_fd);
@@ -509,32 +907,259 @@ void Server::Listen(const HostPortPair &host_port) {
 }
 
 void Server::ListenAllHostPorts(const VirtualServerList &virtual_server_list) {
-	const PortIpMap port_ip_map = CreatePortIpMap(virtual_server_list);
+	const HostPortSet listen_host_ports =
+		CreateListenHostPorts(CreatePortIpMap(virtual_server_list));
 
-	typedef PortIpMap::const_iterator ItMap;
-	for (ItMap it_map = port_ip_map.begin(); it_map != port_ip_map.end(); ++it_map) {
-		const unsigned int port   = it_map->first;
-		const IpSet       &ip_set = it_map->second;
-		if (ip_set.find(IPV4_ADDR_ANY) != ip_set.end()) {
-			Listen(std::make_pair(IPV4_ADDR_ANY, port));
-			continue;
+	typedef HostPortSet::const_iterator Itr;
+	for (Itr it = listen_host_ports.begin(); it != listen_host_ports.end(); ++it) {
+		Listen(*it);
+	}
+}
+
+void Server::CloseListener(const HostPortPair &host_port) {
+	const int server_fd = context_.GetListenSockFd(host_port);
+	event_monitor_.Delete(server_fd);
+	connection_.DeleteListenServerFd(server_fd);
+	context_.DeleteServerInfo(host_port);
+	close(server_fd);
+	utils::Debug(
+		"server",
+		"close listener " + host_port.first + ":" + utils::ToString(host_port.second),
+		server_fd
+	);
+}
+
+// SIGHUP: configを読み直し、読めなかった時は今のconfigのまま続ける
+void Server::HandleReloadRequest() {
+	utils::Debug("server", "reload configuration");
+	const config::Config *reloaded_config = NULL;
+	try {
+		reloaded_config = config::Config::CreateReloaded();
+		Reload(reloaded_config->servers_);
+	} catch (const std::exception &e) {
+		delete reloaded_config;
+		utils::PrintError("reload failed: " + std::string(e.what()));
+		return;
+	}
+	// serverを作り直す時にも読み直したconfigを使う
+	config::Config::Replace(reloaded_config);
+}
+
+// 新しいsnapshotに新しいconfigのvirtual serverを作り、listenできたら新しいclientに使う
+// 接続済みのclientは接続した時のsnapshotのまま(cgiもそのまま動かし続ける)
+void Server::Reload(const ConfigServers &config_servers) {
+	const ContextManager::SnapshotId snapshot_id = context_.AddSnapshot();
+	HostPortList                     added_host_ports;
+	try {
+		AddVirtualServers(config_servers);
+		const VirtualServerList &virtual_server_list = context_.GetAllVirtualServer();
+		added_host_ports = AddServerInfoToContext(virtual_server_list);
+		UpdateListeners(virtual_server_list);
+	} catch (const std::exception &e) {
+		DeleteServerInfos(added_host_ports);
+		context_.DeleteSnapshot(snapshot_id);
+		throw;
+	}
+	context_.SetCurrentSnapshot(snapshot_id);
+	shutdown_timeout_ = GetShutdownTimeout(config_servers);
+	utils::Debug("server", "reloaded configuration");
+}
+
+// 新しいhost:portをlistenしてから、使わなくなったhost:portを閉じる
+// 同じportのaddressだけを変える場合(0.0.0.0:port <-> ip:port)はbindできないので先に閉じる
+// 途中でlistenできなかった時は、このreloadでlistenしたものを閉じ、閉じたものをlistenし直す
+void Server::UpdateListeners(const VirtualServerList &virtual_server_list) {
+	const HostPortSet listen_host_ports =
+		CreateListenHostPorts(CreatePortIpMap(virtual_server_list));
+
+	HostPortList new_host_ports;
+	HostPortList closed_host_ports;
+	try {
+		typedef HostPortSet::const_iterator Itr;
+		for (Itr it = listen_host_ports.begin(); it != listen_host_ports.end(); ++it) {
+			if (context_.GetListenSockFd(*it) != SYSTEM_ERROR) {
+				continue;
+			}
+			const HostPortList conflicting_host_ports = FindConflictingHostPorts(
+				context_.GetListenHostPorts(), listen_host_ports, *it
+			);
+			typedef HostPortList::const_iterator ItConflict;
+			for (ItConflict conflict = conflicting_host_ports.begin();
+				 conflict != conflicting_host_ports.end();
+				 ++conflict) {
+				CloseListener(*conflict);
+				closed_host_ports.push_back(*conflict);
+			}
+			Listen(*it);
+			new_host_ports.push_back(*it);
 		}
-		typedef IpSet::const_iterator ItSet;
-		for (ItSet it_set = ip_set.begin(); it_set != ip_set.end(); ++it_set) {
-			Listen(std::make_pair(*it_set, port));
+	} catch (const std::exception &e) {
+		RestoreListeners(new_host_ports, closed_host_ports);
+		throw;
+	}
+
+	const HostPortList old_host_ports = context_.GetListenHostPorts();
+	typedef HostPortList::const_iterator Itr;
+	for (Itr it = old_host_ports.begin(); it != old_host_ports.end(); ++it) {
+		if (listen_host_ports.count(*it) == 0) {
+			CloseListener(*it);
+		}
+	}
+}
+
+// reloadに失敗した時、listenし始めたものを閉じて、先に閉じたものをlistenし直す
+void Server::RestoreListeners(
+	const HostPortList &new_host_ports, const HostPortList &closed_host_ports
+) {
+	typedef HostPortList::const_iterator Itr;
+	for (Itr it = new_host_ports.begin(); it != new_host_ports.end(); ++it) {
+		CloseListener(*it);
+	}
+	for (Itr it = closed_host_ports.begin(); it != closed_host_ports.end(); ++it) {
+		try {
+			context_.AddServerInfo(*it);
+			Listen(*it);
+		} catch (const std::exception &e) {
+			context_.DeleteServerInfo(*it);
+			utils::PrintError(
+				"failed to listen " + it->first + ":" + utils::ToString(it->second) + " again: " +
+				e.what()
+			);
+		}
+	}
+}
+
+void Server::DeleteServerInfos(const HostPortList &host_ports) {
+	typedef HostPortList::const_iterator Itr;
+	for (Itr it = host_ports.begin(); it != host_ports.end(); ++it) {
+		context_.DeleteServerInfo(*it);
+	}
+}
+
+// SIGTERM, SIGQUIT: 新しい接続を受けるのをやめ、処理中のrequestのresponseを返し終えるのを待つ
+// 次のrequestを待っているだけのclientはすぐ切り、それ以外は次のresponseをConnection: closeにする
+void Server::StartShutdown() {
+	if (is_shutting_down_) {
+		return;
+	}
+	is_shutting_down_  = true;
+	shutdown_deadline_ = std::time(NULL) + shutdown_timeout_;
+	utils::Debug("server", "start graceful shutdown");
+
+	const ContextManager::HostPortList listen_host_ports = context_.GetListenHostPorts();
+	typedef ContextManager::HostPortList::const_iterator ItHostPort;
+	for (ItHostPort it = listen_host_ports.begin(); it != listen_host_ports.end(); ++it) {
+		CloseListener(*it);
+	}
+	const MessageManager::TimeoutFds idle_fds = message_manager_.GetIdleFds();
+	typedef MessageManager::TimeoutFds::const_iterator ItFd;
+	for (ItFd it = idle_fds.begin(); it != idle_fds.end(); ++it) {
+		try {
+			Disconnect(*it);
+		} catch (const std::exception &e) {
+			AbortClient(*it, e.what());
 		}
 	}
 }
 
+// 全clientを返し終えたか、shutdown_timeoutを過ぎたら終わる
+bool Server::IsShutdownComplete() const {
+	if (!is_shutting_down_) {
+		return false;
+	}
+	return message_manager_.GetMessageCount() == 0 || std::time(NULL) >= shutdown_deadline_;
+}
+
+// 新しいbinaryとして起動された時は、古いprocessがlistenしていたsocketを受け取る
+void Server::InheritListenFds() {
+	const BinaryUpgrade::FdList inherited_fds = BinaryUpgrade::TakeInheritedFds();
+
+	typedef BinaryUpgrade::FdList::const_iterator Itr;
+	for (Itr it = inherited_fds.begin(); it != inherited_fds.end(); ++it) {
+		const HostPortPair host_port = connection_.Inherit(*it);
+		inherited_listen_fds_[host_port] = *it;
+		utils::Debug(
+			"server",
+			"inherit listener " + host_port.first + ":" + utils::ToString(host_port.second),
+			*it
+		);
+	}
+}
+
+// 新しいconfigでlistenしないhost:portは閉じる
+void Server::CloseUnusedInheritedFds() {
+	typedef InheritedFdMap::const_iterator Itr;
+	for (Itr it = inherited_listen_fds_.begin(); it != inherited_listen_fds_.end(); ++it) {
+		connection_.DeleteListenServerFd(it->second);
+		close(it->second);
+	}
+	inherited_listen_fds_.clear();
+}
+
+// SIGUSR2: 同じcommand lineで新しいbinaryを起動してlisten中のsocketを渡す
+// 新しいbinaryがlistenを始めるとSIGQUITが来るので、そこからgraceful shutdownする
+void Server::HandleUpgradeRequest() {
+	if (upgrade_pid_ != -1) {
+		utils::PrintError("binary upgrade is already in progress");
+		return;
+	}
+	BinaryUpgrade::FdList listen_fds;
+
+	const ContextManager::HostPortList listen_host_ports = context_.GetListenHostPorts();
+	typedef ContextManager::HostPortList::const_iterator Itr;
+	for (Itr it = listen_host_ports.begin(); it != listen_host_ports.end(); ++it) {
+		listen_fds.push_back(context_.GetListenSockFd(*it));
+	}
+	try {
+		upgrade_pid_ = BinaryUpgrade::Exec(listen_fds);
+	} catch (const SystemException &e) {
+		utils::PrintError("binary upgrade failed: " + std::string(e.what()));
+		return;
+	}
+	utils::Debug("server", "start new binary (pid: " + utils::ToString(upgrade_pid_) + ")");
+}
+
+// 新しいbinaryが起動に失敗して終了した時は、このprocessのままlistenを続ける
+void Server::WaitUpgradeProcess() {
+	if (upgrade_pid_ == -1 || !BinaryUpgrade::IsExited(upgrade_pid_)) {
+		return;
+	}
+	if (!is_shutting_down_) {
+		utils::PrintError("binary upgrade failed: the new binary exited");
+	}
+	upgrade_pid_ = -1;
+}
+
+// 古いsnapshotを使うclientが全部切れたら消す
+void Server::DeleteUnusedSnapshots() {
+	const ContextManager::SnapshotIdList unused_snapshots = context_.GetUnusedSnapshots();
+
+	typedef ContextManager::SnapshotIdList::const_iterator ItSnapshot;
+	for (ItSnapshot it = unused_snapshots.begin(); it != unused_snapshots.end(); ++it) {
+		const VirtualServerList &virtual_server_list = context_.GetAllVirtualServer(*it);
+		for (ItVirtualServer it_virtual_server = virtual_server_list.begin();
+			 it_virtual_server != virtual_server_list.end();
+			 ++it_virtual_server) {
+			http_.DeleteCgiCache(&*it_virtual_server);
+		}
+		context_.DeleteSnapshot(*it);
+		utils::Debug("server", "delete old configuration snapshot");
+	}
+}
+
 void Server::Init() {
 	const VirtualServerList &virtual_server_list = context_.GetAllVirtualServer();
 
 	AddServerInfoToContext(virtual_server_list);
 	try {
+		InheritListenFds();
 		ListenAllHostPorts(virtual_server_list);
+		CloseUnusedInheritedFds();
 	} catch (const std::exception &e) {
 		throw StartUpException(e.what());
 	}
+	// 古いprocessから引き継いだ時は、ここから受けるので古いprocessを終わらせる
+	BinaryUpgrade::NotifyOldProcess();
 }
 
 void Server::SetNonBlockingMode(int sock_fd) {
@@ -556,14 +1181,102 @@ void Server::HandleCgi(int client_fd, const http::CgiResult &cgi_result) {
 	if (!cgi_result.is_cgi) {
 		return;
 	}
+	const http::CgiCacheInfo     &cache_info = cgi_result.cache_info;
+	const CgiManager::CollapseKey collapse_key(cache_info.virtual_server, cache_info.key);
+	// cacheを有効にしているlocationでは同時に来た同じGETを実行中のcgiにまとめる
+	const bool is_collapsible = cache_info.is_cacheable && cache_info.cache_valid > 0;
+	if (is_collapsible &&
+		cgi_manager_.AddWaiter(collapse_key, client_fd, cgi_result.cgi_request)) {
+		utils::Debug("cgi", "wait for the running cgi: " + cache_info.key, client_fd);
+		return;
+	}
+	if (!StartCgi(client_fd, cgi_result.cgi_request)) {
+		return;
+	}
+	if (is_collapsible) {
+		cgi_manager_.SetCollapseKey(client_fd, collapse_key);
+	}
+}
+
+bool Server::StartCgi(int client_fd, const cgi::CgiRequest &cgi_request) {
 	try {
-		cgi_manager_.AddNewCgi(client_fd, cgi_result.cgi_request);
+		cgi_manager_.AddNewCgi(client_fd, cgi_request);
 		// RunCgi() is called only when a new Cgi is added via AddNewCgi().
 		cgi_manager_.RunCgi(client_fd);
 		AddEventForCgi(client_fd);
 	} catch (const SystemException &e) {
 		utils::PrintError(e.what());
 		SetInternalServerError(client_fd);
+		return false;
+	}
+	return true;
+}
+
+// clientにcgiのresponseを返さなくなった時に実行中/待機中のcgiを片付ける
+void Server::AbortCgi(int client_fd) {
+	if (cgi_manager_.IsCgiExist(client_fd)) {
+		const CgiManager::Collapse collapse = cgi_manager_.PopCollapse(client_fd);
+		// Call Cgi's destructor -> close pipe_fd -> automatically deleted from epoll
+		cgi_manager_.DeleteCgi(client_fd);
+		// 失敗したcgiのresponseは共有せず、waiterの1つだけがcgiを実行し直す
+		RestartCgiWaiters(collapse);
+	}
+	cgi_manager_.DeleteWaiter(client_fd);
+}
+
+// 先頭のwaiterがcgiを実行し直し、残りのwaiterはそのcgiを待つ
+// 実行し直せなければwaiterには502を返す
+void Server::RestartCgiWaiters(const CgiManager::Collapse &collapse) {
+	CgiManager::GetFdResult promote_result;
+	try {
+		promote_result = cgi_manager_.PromoteWaiter(collapse);
+	} catch (const SystemException &e) {
+		utils::PrintError(e.what());
+		SetCgiWaitersError(collapse.waiters);
+		return;
+	}
+	if (!promote_result.IsOk()) {
+		return;
+	}
+	const int new_leader_fd = promote_result.GetValue();
+	utils::Debug("cgi", "restart the collapsed cgi", new_leader_fd);
+	try {
+		cgi_manager_.RunCgi(new_leader_fd);
+		AddEventForCgi(new_leader_fd);
+	} catch (const SystemException &e) {
+		utils::PrintError(e.what());
+		const CgiManager::Collapse failed_collapse = cgi_manager_.PopCollapse(new_leader_fd);
+		cgi_manager_.DeleteCgi(new_leader_fd);
+		SetUpstreamError(new_leader_fd, http::UPSTREAM_ERROR);
+		SetCgiWaitersError(failed_collapse.waiters);
+	}
+}
+
+void Server::SetCgiWaitersError(const CgiManager::WaiterList &waiters) {
+	typedef CgiManager::WaiterList::const_iterator Itr;
+	for (Itr it = waiters.begin(); it != waiters.end(); ++it) {
+		SetUpstreamError(it->client_fd, http::UPSTREAM_ERROR);
+	}
+}
+
+// leaderのcgiのresponseを待っていた全clientに返す
+// responseはleaderの分で1度だけparse・cacheしたものを使う
+void Server::FanOutCgiResponse(
+	const CgiManager::Collapse &collapse, const SharedCgiResponse &shared_response
+) {
+	if (!shared_response.IsOk()) {
+		// no-store, Set-Cookie等のresponseは共有できないので、waiterの1つがcgiを実行し直す
+		RestartCgiWaiters(collapse);
+		return;
+	}
+	typedef CgiManager::WaiterList::const_iterator Itr;
+	for (Itr it = collapse.waiters.begin(); it != collapse.waiters.end(); ++it) {
+		const int client_fd = it->client_fd;
+		utils::Debug("cgi", "share the response of the collapsed cgi", client_fd);
+		http::HttpResult http_result = http_.GetSharedResponseFromCgi(
+			GetClientInfos(client_fd), GetVirtualServerList(client_fd), shared_response.GetValue()
+		);
+		SetCgiHttpResult(client_fd, http_result);
 	}
 }
 
@@ -616,9 +1329,12 @@ void Server::HandleCgiReadResult(int read_fd, const Read::ReadResult &read_resul
 		return;
 	}
 	utils::Debug("cgi", "Read the entire response from the child process through pipe_fd", read_fd);
+	const CgiManager::Collapse collapse = cgi_manager_.PopCollapse(client_fd);
 	// Explicitly delete from cgi_manager
 	cgi_manager_.DeleteCgi(client_fd);
-	GetHttpResponseFromCgiResponse(client_fd, cgi_response_result.GetValue());
+	const SharedCgiResponse shared_response =
+		GetHttpResponseFromCgiResponse(client_fd, cgi_response_result.GetValue());
+	FanOutCgiResponse(collapse, shared_response);
 }
 
 Server::CgiResponseResult Server::AddAndGetCgiResponse(int client_fd, const std::string &read_buf) {
@@ -632,21 +1348,32 @@ Server::CgiResponseResult Server::AddAndGetCgiResponse(int client_fd, const std:
 	return cgi_response_result;
 }
 
-void Server::GetHttpResponseFromCgiResponse(int client_fd, const cgi::CgiResponse &cgi_response) {
-	http::HttpResult http_result = http_.GetResponseFromCgi(client_fd, cgi_response);
+// return: 同じcgiを待っている他のclientにも返せるcgiのresponse
+Server::SharedCgiResponse
+Server::GetHttpResponseFromCgiResponse(int client_fd, const cgi::CgiResponse &cgi_response) {
+	SharedCgiResponse shared_response;
+	http::HttpResult  http_result = http_.GetResponseFromCgi(
+		GetClientInfos(client_fd), GetVirtualServerList(client_fd), cgi_response, shared_response
+	);
+	SetCgiHttpResult(client_fd, http_result);
+	return shared_response;
+}
 
+void Server::SetCgiHttpResult(int client_fd, http::HttpResult &http_result) {
 	// http_.Run()の後とほぼ同じ処理になる
-	message_manager_.SetNewRequestBuf(client_fd, http_result.request_buf);
+	// cgi実行中に受信した分の前に、httpが使わなかった分を戻す
+	message_manager_.RestoreRequestBuf(client_fd, http_result.request_buf);
 	if (!http_result.is_response_complete) {
-		std::cout << "request_buf: " << message_manager_.GetRequestBuf(client_fd) << std::endl;
+		// local redirect先がcgi/proxyの場合はそのまま実行する
 		message_manager_.SetIsCompleteRequest(client_fd, false);
-		// 	今だと何かしらeventが起きないとhttp_.Run()が呼ばれない流れになってるので仮にEVENT_WRITEを登録する(良くはない)
-		ReplaceEvent(client_fd, event::EVENT_WRITE);
-		utils::Debug("server", "received local redirect request from client", client_fd);
+		utils::Debug("server", "internal redirect", client_fd);
+		HandleCgi(client_fd, http_result.cgi_result);
+		HandleProxy(client_fd, http_result);
 		return;
 	}
 	// received all request from client
 	message_manager_.SetIsCompleteRequest(client_fd, true);
+	message_manager_.StartTimer(client_fd, message::SEND_RESPONSE);
 
 	const message::ConnectionState connection_state =
 		http_result.is_connection_keep ? message::KEEP : message::CLOSE;
@@ -669,4 +1396,255 @@ void Server::UpdateEventInCgiResponseComplete(
 	}
 }
 
+void Server::HandleProxy(int client_fd, const http::HttpResult &http_result) {
+	if (!http_result.proxy_result.is_proxy) {
+		return;
+	}
+	proxy_manager_.AddNewProxy(client_fd, http_result.proxy_result, http_result.is_connection_keep);
+	ConnectToUpstream(client_fd);
+}
+
+// poolの接続を使うか、non-blockingで新しく接続を始めてEVENT_WRITEで接続完了を待つ
+void Server::ConnectToUpstream(int client_fd) {
+	const ProxyManager::GetFdResult connect_result =
+		proxy_manager_.Connect(client_fd, std::time(NULL));
+	if (!connect_result.IsOk()) {
+		utils::Debug("proxy", "no upstream available", client_fd);
+		SetUpstreamError(client_fd, http::UPSTREAM_ERROR);
+		return;
+	}
+	const int upstream_fd = connect_result.GetValue();
+	try {
+		if (proxy_manager_.GetProxy(client_fd).IsReused()) {
+			event_monitor_.Replace(upstream_fd, event::EVENT_WRITE);
+		} else {
+			event_monitor_.Add(upstream_fd, event::EVENT_WRITE);
+		}
+	} catch (const SystemException &e) {
+		utils::PrintError(e.what());
+		SetInternalServerError(client_fd);
+		return;
+	}
+	utils::Debug("proxy", "connect to upstream", upstream_fd);
+}
+
+void Server::HandleUpstreamEvent(const event::Event &event) {
+	const int upstream_fd = event.fd;
+	const int client_fd   = proxy_manager_.GetClientFd(upstream_fd);
+	Proxy    &proxy       = proxy_manager_.GetProxy(client_fd);
+
+	if (event.type & event::EVENT_ERROR) {
+		HandleUpstreamFailure(client_fd);
+		return;
+	}
+	if (!proxy.IsConnected()) {
+		if (!Connection::IsConnectSucceeded(upstream_fd)) {
+			utils::Debug("proxy", "failed to connect to upstream", upstream_fd);
+			HandleUpstreamFailure(client_fd);
+			return;
+		}
+		proxy.SetConnected();
+	}
+	if ((event.type & event::EVENT_WRITE) && !proxy.IsRequestSent()) {
+		SendProxyRequest(client_fd);
+		return;
+	}
+	if (event.type & (event::EVENT_READ | event::EVENT_HANGUP)) {
+		ReadProxyResponse(client_fd);
+	}
+}
+
+// poolにある接続のeventはupstreamからのcloseなのでpoolから外す
+void Server::HandleIdleUpstreamEvent(int idle_fd) {
+	DeleteUpstreamEvent(idle_fd);
+	proxy_manager_.DeleteIdleFd(idle_fd);
+	utils::Debug("proxy", "idle upstream connection closed", idle_fd);
+}
+
+void Server::SendProxyRequest(int client_fd) {
+	Proxy    &proxy       = proxy_manager_.GetProxy(client_fd);
+	const int upstream_fd = proxy.GetUpstreamFd();
+
+	const Send::SendResult send_result = Send::SendStr(upstream_fd, proxy.GetRequest());
+	if (!send_result.IsOk()) {
+		utils::Debug("proxy", "failed to send the request to upstream", upstream_fd);
+		HandleUpstreamFailure(client_fd);
+		return;
+	}
+	proxy.ReplaceNewRequest(send_result.GetValue());
+	message_manager_.StartTimer(client_fd, message::WAIT_BACKEND);
+	if (proxy.IsRequestSent() && !ReplaceUpstreamEvent(upstream_fd, event::EVENT_READ)) {
+		SetInternalServerError(client_fd);
+	}
+}
+
+void Server::ReadProxyResponse(int client_fd) {
+	Proxy    &proxy       = proxy_manager_.GetProxy(client_fd);
+	const int upstream_fd = proxy.GetUpstreamFd();
+
+	const Read::ReadResult read_result = Read::ReadStr(upstream_fd);
+	if (!read_result.IsOk()) {
+		HandleUpstreamFailure(client_fd);
+		return;
+	}
+	if (read_result.GetValue().read_size == 0) {
+		// closeまでがbodyのresponse以外は途中で切れている
+		if (!proxy.AddResponseEof()) {
+			HandleUpstreamFailure(client_fd);
+			return;
+		}
+		FinishProxyResponse(client_fd, "");
+		return;
+	}
+	const ProxyResponse::AddResult add_result =
+		proxy.AddResponse(read_result.GetValue().read_buf);
+	if (!add_result.IsOk()) {
+		utils::Debug("proxy", "invalid response from upstream", upstream_fd);
+		HandleUpstreamFailure(client_fd);
+		return;
+	}
+	if (proxy.GetResponse().IsComplete()) {
+		FinishProxyResponse(client_fd, add_result.GetValue());
+		return;
+	}
+	AddProxyResponse(client_fd, add_result.GetValue());
+}
+
+// 読み込んだ分は全部受け取るのを待たずにclientに流す
+void Server::AddProxyResponse(int client_fd, const std::string &response) {
+	message_manager_.StartTimer(client_fd, message::WAIT_BACKEND);
+	if (response.empty()) {
+		return;
+	}
+	message_manager_.AddNormalResponse(client_fd, message::KEEP, response);
+	ReplaceEvent(client_fd, event::EVENT_READ | event::EVENT_WRITE);
+	PauseProxyIfNeeded(client_fd);
+}
+
+void Server::FinishProxyResponse(int client_fd, const std::string &response) {
+	const Proxy                   &proxy            = proxy_manager_.GetProxy(client_fd);
+	const int                      upstream_fd      = proxy.GetUpstreamFd();
+	const message::ConnectionState connection_state =
+		proxy.GetResponse().IsClientKeep() ? message::KEEP : message::CLOSE;
+
+	DeleteUpstreamEvent(upstream_fd);
+	proxy_manager_.FinishProxy(client_fd);
+	// keep-aliveの接続はupstreamからのcloseに気づけるようにEVENT_READで監視しておく
+	if (proxy_manager_.IsIdleFd(upstream_fd)) {
+		try {
+			event_monitor_.Add(upstream_fd, event::EVENT_READ);
+		} catch (const SystemException &e) {
+			utils::PrintError(e.what());
+			proxy_manager_.DeleteIdleFd(upstream_fd);
+		}
+	}
+	utils::Debug("proxy", "received the entire response from upstream", client_fd);
+
+	// received all request from client
+	message_manager_.SetIsCompleteRequest(client_fd, true);
+	message_manager_.StartTimer(client_fd, message::SEND_RESPONSE);
+	message_manager_.AddNormalResponse(client_fd, connection_state, response);
+	UpdateEventInCgiResponseComplete(connection_state, client_fd);
+}
+
+// responseをclientに返し始める前なら別の接続・upstreamでやり直すか502を返す
+// poolから使い回した接続や接続自体に失敗した場合は、requestがupstreamで処理されていないのでやり直せる
+void Server::HandleUpstreamFailure(int client_fd) {
+	const Proxy &proxy = proxy_manager_.GetProxy(client_fd);
+	if (proxy.GetResponse().IsHeaderComplete()) {
+		utils::Debug("proxy", "upstream failed while sending the response", client_fd);
+		Disconnect(client_fd);
+		return;
+	}
+	const bool is_retryable = proxy.IsRetryable();
+
+	DeleteUpstreamEvent(proxy.GetUpstreamFd());
+	proxy_manager_.CloseUpstream(client_fd, true, std::time(NULL));
+	if (is_retryable) {
+		ConnectToUpstream(client_fd);
+		return;
+	}
+	SetUpstreamError(client_fd, http::UPSTREAM_ERROR);
+}
+
+void Server::HandleProxyTimeout(int client_fd) {
+	const Proxy &proxy = proxy_manager_.GetProxy(client_fd);
+	if (proxy.GetResponse().IsHeaderComplete()) {
+		Disconnect(client_fd);
+		return;
+	}
+	if (proxy.IsUpstreamExist()) {
+		DeleteUpstreamEvent(proxy.GetUpstreamFd());
+		proxy_manager_.CloseUpstream(client_fd, true, std::time(NULL));
+	}
+	SetUpstreamError(client_fd, http::UPSTREAM_TIMEOUT);
+	utils::Debug("proxy", "upstream timeout", client_fd);
+}
+
+// 502, 504用のresponseをセットしてevent監視をWRITEに変更
+void Server::SetUpstreamError(int client_fd, http::ErrorState state) {
+	CloseProxy(client_fd);
+	message_manager_.SetIsCompleteRequest(client_fd, true);
+	message_manager_.StartTimer(client_fd, message::SEND_RESPONSE);
+
+	const http::HttpResult http_result = http_.GetErrorResponse(client_fd, state);
+	message_manager_.AddNormalResponse(client_fd, message::CLOSE, http_result.response);
+	ReplaceEvent(client_fd, event::EVENT_WRITE);
+}
+
+// clientが読むのが遅い間はupstreamからも読まない(送信待ちのresponseを溜め込まない)
+void Server::PauseProxyIfNeeded(int client_fd) {
+	Proxy &proxy = proxy_manager_.GetProxy(client_fd);
+	if (proxy.IsPaused() || message_manager_.GetResponseSize(client_fd) < PROXY_BUFFER_MAX) {
+		return;
+	}
+	if (ReplaceUpstreamEvent(proxy.GetUpstreamFd(), event::EVENT_NONE)) {
+		proxy.SetPaused(true);
+	}
+}
+
+void Server::ResumeProxyIfNeeded(int client_fd) {
+	if (!proxy_manager_.IsProxyExist(client_fd)) {
+		return;
+	}
+	Proxy &proxy = proxy_manager_.GetProxy(client_fd);
+	if (!proxy.IsPaused() || message_manager_.GetResponseSize(client_fd) >= PROXY_BUFFER_MAX) {
+		return;
+	}
+	if (ReplaceUpstreamEvent(proxy.GetUpstreamFd(), event::EVENT_READ)) {
+		proxy.SetPaused(false);
+	}
+}
+
+// upstreamとの接続を閉じてproxyを削除する
+void Server::CloseProxy(int client_fd) {
+	if (!proxy_manager_.IsProxyExist(client_fd)) {
+		return;
+	}
+	const Proxy &proxy = proxy_manager_.GetProxy(client_fd);
+	if (proxy.IsUpstreamExist()) {
+		DeleteUpstreamEvent(proxy.GetUpstreamFd());
+	}
+	proxy_manager_.DeleteProxy(client_fd);
+}
+
+bool Server::ReplaceUpstreamEvent(int upstream_fd, uint32_t type) {
+	try {
+		event_monitor_.Replace(upstream_fd, type);
+	} catch (const SystemException &e) {
+		utils::PrintError(e.what());
+		return false;
+	}
+	return true;
+}
+
+// closeする前にepollから明示的に削除する
+void Server::DeleteUpstreamEvent(int upstream_fd) {
+	try {
+		event_monitor_.Delete(upstream_fd);
+	} catch (const SystemException &e) {
+		utils::PrintError(e.what());
+	}
+}
+
 } // namespace server
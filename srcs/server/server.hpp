@@ -9,9 +9,13 @@
 #include "http.hpp"
 #include "http_result.hpp"
 #include "message_manager.hpp"
+#include "proxy_manager.hpp"
 #include "read.hpp"
+#include <ctime>
 #include <list>
+#include <map>
 #include <string>
+#include <sys/types.h> // pid_t
 
 namespace server {
 
@@ -24,6 +28,9 @@ class Server {
 	typedef std::map<unsigned int, IpSet>           PortIpMap;
 	typedef utils::Result<ClientInfo>               AcceptResult;
 	typedef utils::Result<cgi::CgiResponse>         CgiResponseResult;
+	typedef http::Http::SharedCgiResponse           SharedCgiResponse;
+	typedef std::map<HostPortPair, int>             InheritedFdMap;
+	typedef ContextManager::HostPortList            HostPortList;
 
 	explicit Server(const ConfigServers &config_servers);
 	~Server();
@@ -36,11 +43,27 @@ class Server {
 	Server(const Server &other);
 	Server &operator=(const Server &other);
 	// functions
-	void      AddVirtualServers(const ConfigServers &config_servers);
-	void      AddServerInfoToContext(const VirtualServerList &virtual_server_list);
-	void      ListenAllHostPorts(const VirtualServerList &virtual_server_list);
-	PortIpMap CreatePortIpMap(const VirtualServerList &virtual_server_list);
-	void      Listen(const HostPortPair &host_port);
+	void         AddVirtualServers(const ConfigServers &config_servers);
+	HostPortList AddServerInfoToContext(const VirtualServerList &virtual_server_list);
+	void         ListenAllHostPorts(const VirtualServerList &virtual_server_list);
+	PortIpMap    CreatePortIpMap(const VirtualServerList &virtual_server_list);
+	void         Listen(const HostPortPair &host_port);
+	void         CloseListener(const HostPortPair &host_port);
+	// for reload (SIGHUP)
+	void HandleReloadRequest();
+	void Reload(const ConfigServers &config_servers);
+	void UpdateListeners(const VirtualServerList &virtual_server_list);
+	void RestoreListeners(const HostPortList &new_host_ports, const HostPortList &closed_host_ports);
+	void DeleteServerInfos(const HostPortList &host_ports);
+	void DeleteUnusedSnapshots();
+	// for graceful shutdown (SIGTERM, SIGQUIT)
+	void StartShutdown();
+	bool IsShutdownComplete() const;
+	// for binary upgrade (SIGUSR2)
+	void InheritListenFds();
+	void CloseUnusedInheritedFds();
+	void HandleUpgradeRequest();
+	void WaitUpgradeProcess();
 	void      HandleErrorEvent(int fd);
 	void      HandleHangUpEvent(const event::Event &event);
 	void      HandleEvent(const event::Event &event);
@@ -51,9 +74,18 @@ class Server {
 	void      HandleHttpReadResult(const event::Event &event, const Read::ReadResult &read_result);
 	bool      IsHttpRequestBufExist(int fd) const;
 	void      RunHttpAndCgi(const event::Event &event);
+	void      UpdateTimerAfterHttpRun(int client_fd, const http::HttpResult &http_result);
 	void      HandleWriteEvent(int fd);
 	void      SendHttpResponse(int client_fd);
 	void      HandleTimeoutMessages();
+	void      HandleTimeoutMessage(int client_fd);
+	void      HandleBelowMinRateMessages();
+	// for fault isolation (1つのclientの失敗で他のclientを止めない)
+	int  FindClientFd(int fd) const;
+	void HandleEventFailure(int fd, const std::string &reason);
+	void AbortClient(int client_fd, const std::string &reason);
+	bool IsResponseStarted(int client_fd);
+	void ForceDisconnect(int client_fd);
 	void      SetInternalServerError(int client_fd);
 	void      KeepConnection(int client_fd);
 	void      Disconnect(int client_fd);
@@ -71,23 +103,50 @@ class Server {
 	// wrapper for connection
 	AcceptResult Accept(int server_fd);
 	// for Server to Http
-	http::ClientInfos     GetClientInfos(int client_fd) const;
-	VirtualServerAddrList GetVirtualServerList(int client_fd) const;
+	http::ClientInfos            GetClientInfos(int client_fd) const;
+	const VirtualServerAddrList &GetVirtualServerList(int client_fd) const;
 	// for Cgi
 	bool              IsCgi(int fd) const;
 	void              HandleCgi(int client_fd, const http::CgiResult &cgi_result);
+	bool              StartCgi(int client_fd, const cgi::CgiRequest &cgi_request);
+	void              RestartCgiWaiters(const CgiManager::Collapse &collapse);
+	void              SetCgiWaitersError(const CgiManager::WaiterList &waiters);
+	void              AbortCgi(int client_fd);
 	void              AddEventForCgi(int client_fd);
 	void              SendCgiRequest(int write_fd);
 	void              HandleCgiReadResult(int read_fd, const Read::ReadResult &read_result);
 	CgiResponseResult AddAndGetCgiResponse(int client_fd, const std::string &read_buf);
-	void GetHttpResponseFromCgiResponse(int client_fd, const cgi::CgiResponse &cgi_response);
+	SharedCgiResponse
+	GetHttpResponseFromCgiResponse(int client_fd, const cgi::CgiResponse &cgi_response);
+	void SetCgiHttpResult(int client_fd, http::HttpResult &http_result);
+	void FanOutCgiResponse(
+		const CgiManager::Collapse &collapse, const SharedCgiResponse &shared_response
+	);
 	void UpdateEventInCgiResponseComplete(
 		const message::ConnectionState connection_state, int client_fd
 	);
+	// for Proxy
+	void HandleProxy(int client_fd, const http::HttpResult &http_result);
+	void ConnectToUpstream(int client_fd);
+	void HandleUpstreamEvent(const event::Event &event);
+	void HandleIdleUpstreamEvent(int idle_fd);
+	void SendProxyRequest(int client_fd);
+	void ReadProxyResponse(int client_fd);
+	void AddProxyResponse(int client_fd, const std::string &response);
+	void FinishProxyResponse(int client_fd, const std::string &response);
+	void HandleUpstreamFailure(int client_fd);
+	void HandleProxyTimeout(int client_fd);
+	void SetUpstreamError(int client_fd, http::ErrorState state);
+	void PauseProxyIfNeeded(int client_fd);
+	void ResumeProxyIfNeeded(int client_fd);
+	void CloseProxy(int client_fd);
+	bool ReplaceUpstreamEvent(int upstream_fd, uint32_t type);
+	void DeleteUpstreamEvent(int upstream_fd);
 
 	// const
-	static const int    SYSTEM_ERROR = -1;
-	static const double REQUEST_TIMEOUT;
+	static const int SYSTEM_ERROR = -1;
+	// clientへの送信待ちがこれ以上ならupstreamからの読み込みを止める
+	static const std::size_t PROXY_BUFFER_MAX = 65536; // 64KB
 	// context(virtual server,client)
 	ContextManager context_;
 	// connection
@@ -100,6 +159,15 @@ class Server {
 	MessageManager message_manager_;
 	// cgi
 	CgiManager cgi_manager_;
+	// reverse proxy
+	ProxyManager proxy_manager_;
+	// graceful shutdown
+	unsigned int shutdown_timeout_;
+	bool         is_shutting_down_;
+	std::time_t  shutdown_deadline_;
+	// binary upgrade
+	InheritedFdMap inherited_listen_fds_; // 古いprocessから渡されたlisten fd(Init()の間だけ)
+	pid_t          upgrade_pid_;          // 起動した新しいbinary(いなければ-1)
 };
 
 } // namespace server
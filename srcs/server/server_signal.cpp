@@ -0,0 +1,55 @@
+#include "server_signal.hpp"
+
+namespace server {
+
+volatile std::sig_atomic_t ServerSignal::is_reload_requested_   = 0;
+volatile std::sig_atomic_t ServerSignal::is_shutdown_requested_ = 0;
+volatile std::sig_atomic_t ServerSignal::is_upgrade_requested_  = 0;
+
+ServerSignal::ServerSignal() {}
+
+ServerSignal::~ServerSignal() {}
+
+// SIGHUP: configを読み直す
+void ServerSignal::HandleReload(int signum) {
+	(void)signum;
+	is_reload_requested_ = 1;
+}
+
+// SIGTERM, SIGQUIT: 処理中のrequestを返し終えてから終了する
+void ServerSignal::HandleShutdown(int signum) {
+	(void)signum;
+	is_shutdown_requested_ = 1;
+}
+
+// SIGUSR2: 新しいbinaryにlisten中のsocketを渡して起動する
+void ServerSignal::HandleUpgrade(int signum) {
+	(void)signum;
+	is_upgrade_requested_ = 1;
+}
+
+bool ServerSignal::TakeReloadRequest() {
+	if (is_reload_requested_ == 0) {
+		return false;
+	}
+	is_reload_requested_ = 0;
+	return true;
+}
+
+bool ServerSignal::TakeShutdownRequest() {
+	if (is_shutdown_requested_ == 0) {
+		return false;
+	}
+	is_shutdown_requested_ = 0;
+	return true;
+}
+
+bool ServerSignal::TakeUpgradeRequest() {
+	if (is_upgrade_requested_ == 0) {
+		return false;
+	}
+	is_upgrade_requested_ = 0;
+	return true;
+}
+
+} // namespace server
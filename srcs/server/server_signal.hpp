@@ -0,0 +1,39 @@
+#ifndef SERVER_SERVER_SIGNAL_HPP_
+#define SERVER_SERVER_SIGNAL_HPP_
+
+#include <csignal> // sig_atomic_t
+
+namespace server {
+
+/**
+ * @brief Signals the running server is asked to handle.
+ *
+ * The signal handlers only set a flag.
+ * Server::Run() checks the flags between epoll_wait() calls and does the actual work.
+ */
+class ServerSignal {
+  public:
+	// signal handler
+	static void HandleReload(int signum);
+	static void HandleShutdown(int signum);
+	static void HandleUpgrade(int signum);
+	// 一度見たらfalseに戻す
+	static bool TakeReloadRequest();
+	static bool TakeShutdownRequest();
+	static bool TakeUpgradeRequest();
+
+  private:
+	ServerSignal();
+	~ServerSignal();
+	// prohibit copy
+	ServerSignal(const ServerSignal &other);
+	ServerSignal &operator=(const ServerSignal &other);
+	// variable
+	static volatile std::sig_atomic_t is_reload_requested_;
+	static volatile std::sig_atomic_t is_shutdown_requested_;
+	static volatile std::sig_atomic_t is_upgrade_requested_;
+};
+
+} // namespace server
+
+#endif /* SERVER_SERVER_SIGNAL_HPP_ */
@@ -0,0 +1,141 @@
+#include "location_trie.hpp"
+#include "virtual_server.hpp"
+#include <algorithm> // lower_bound
+
+namespace server {
+namespace {
+
+typedef std::pair<unsigned char, std::size_t> Edge;
+
+bool CompareFirstChar(const Edge &edge, unsigned char c) {
+	return edge.first < c;
+}
+
+// label[0..)とkey[pos..)の共通部分の長さ
+std::size_t
+CountCommonPrefix(const std::string &label, const std::string &key, std::size_t pos) {
+	std::size_t len = 0;
+	while (len < label.size() && pos + len < key.size() && label[len] == key[pos + len]) {
+		++len;
+	}
+	return len;
+}
+
+} // namespace
+
+const std::size_t LocationTrie::ROOT;
+const std::size_t LocationTrie::NPOS;
+
+LocationTrie::LocationTrie() {
+	nodes_.push_back(Node("", NULL));
+}
+
+LocationTrie::~LocationTrie() {}
+
+LocationTrie::LocationTrie(const LocationTrie &other) {
+	*this = other;
+}
+
+LocationTrie &LocationTrie::operator=(const LocationTrie &other) {
+	if (this != &other) {
+		nodes_ = other.nodes_;
+	}
+	return *this;
+}
+
+void LocationTrie::Build(const LocationList &locations) {
+	nodes_.clear();
+	nodes_.push_back(Node("", NULL));
+	for (LocationList::const_iterator it = locations.begin(); it != locations.end(); ++it) {
+		Insert(it->request_uri, &*it);
+	}
+}
+
+const Location *LocationTrie::Find(const std::string &request_target) const {
+	const Location *match = nodes_[ROOT].location;
+	std::size_t     node  = ROOT;
+	std::size_t     pos   = 0;
+	while (pos < request_target.size()) {
+		const std::size_t child =
+			FindChild(node, static_cast<unsigned char>(request_target[pos]));
+		if (child == NPOS) {
+			break;
+		}
+		// labelの途中で終わる・違う文字がある場合はそれより深いlocationも一致しない
+		const std::string &label = nodes_[child].label;
+		if (request_target.compare(pos, label.size(), label) != 0) {
+			break;
+		}
+		pos += label.size();
+		node = child;
+		if (nodes_[node].location != NULL) {
+			match = nodes_[node].location;
+		}
+	}
+	return match;
+}
+
+void LocationTrie::Insert(const std::string &request_uri, const Location *location) {
+	std::size_t node = ROOT;
+	std::size_t pos  = 0;
+	while (pos < request_uri.size()) {
+		const std::size_t child = FindChild(node, static_cast<unsigned char>(request_uri[pos]));
+		if (child == NPOS) {
+			AddChild(node, AddNode(request_uri.substr(pos), location));
+			return;
+		}
+		const std::string label  = nodes_[child].label;
+		const std::size_t common = CountCommonPrefix(label, request_uri, pos);
+		if (common < label.size()) {
+			// labelの途中で分かれるので、共通部分のnodeを間に挟む
+			const std::size_t middle = AddNode(label.substr(0, common), NULL);
+			nodes_[child].label      = label.substr(common);
+			AddChild(middle, child);
+			ReplaceChild(node, child, middle);
+			node = middle;
+		} else {
+			node = child;
+		}
+		pos += common;
+	}
+	if (nodes_[node].location == NULL) {
+		nodes_[node].location = location;
+	}
+}
+
+std::size_t LocationTrie::AddNode(const std::string &label, const Location *location) {
+	nodes_.push_back(Node(label, location));
+	return nodes_.size() - 1;
+}
+
+void LocationTrie::AddChild(std::size_t parent, std::size_t child) {
+	EdgeList               &children = nodes_[parent].children;
+	const unsigned char     c        = static_cast<unsigned char>(nodes_[child].label[0]);
+	const EdgeList::iterator it =
+		std::lower_bound(children.begin(), children.end(), c, CompareFirstChar);
+	children.insert(it, Edge(c, child));
+}
+
+std::size_t LocationTrie::FindChild(std::size_t parent, unsigned char c) const {
+	const EdgeList                &children = nodes_[parent].children;
+	const EdgeList::const_iterator it =
+		std::lower_bound(children.begin(), children.end(), c, CompareFirstChar);
+	if (it == children.end() || it->first != c) {
+		return NPOS;
+	}
+	return it->second;
+}
+
+void LocationTrie::ReplaceChild(
+	std::size_t parent, std::size_t old_child, std::size_t new_child
+) {
+	EdgeList &children = nodes_[parent].children;
+	for (EdgeList::iterator it = children.begin(); it != children.end(); ++it) {
+		if (it->second == old_child) {
+			it->second = new_child;
+			return;
+		}
+	}
+}
+
+} // namespace server
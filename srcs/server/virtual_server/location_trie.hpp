@@ -0,0 +1,60 @@
+#ifndef SERVER_LOCATION_TRIE_HPP_
+#define SERVER_LOCATION_TRIE_HPP_
+
+#include <cstddef> // size_t
+#include <list>
+#include <string>
+#include <utility> // pair
+#include <vector>
+
+namespace server {
+
+struct Location;
+
+// locationのrequest_uriを起動時にradix treeにしておき、最長一致するlocationを
+// request_targetの長さに比例する時間で探す
+// nodeはvectorに並べてindexで辿るので、nodeの追加でアドレスが変わっても壊れない
+// 持っているのはLocationへのポインタだけなので、元のlistより長く使わないこと
+class LocationTrie {
+  public:
+	typedef std::list<Location> LocationList;
+
+	LocationTrie();
+	~LocationTrie();
+	LocationTrie(const LocationTrie &other);
+	LocationTrie &operator=(const LocationTrie &other);
+
+	// 同じrequest_uriが複数ある場合は先にあるものを使う(線形に探していた時と同じ)
+	void Build(const LocationList &locations);
+	// request_targetがrequest_uriで始まるlocationのうち一番長いもの。無ければNULL
+	const Location *Find(const std::string &request_target) const;
+
+  private:
+	typedef std::pair<unsigned char, std::size_t> Edge; // (labelの先頭の文字, nodeのindex)
+	typedef std::vector<Edge>                     EdgeList;
+
+	struct Node {
+		Node(const std::string &label, const Location *location)
+			: label(label), location(location) {}
+
+		std::string     label;    // 親からこのnodeまでの文字列
+		const Location *location; // ここでrequest_uriが終わるlocation(無ければNULL)
+		EdgeList        children; // 先頭の文字でsortしておく
+	};
+	typedef std::vector<Node> NodeList;
+
+	static const std::size_t ROOT = 0;
+	static const std::size_t NPOS = static_cast<std::size_t>(-1);
+
+	void        Insert(const std::string &request_uri, const Location *location);
+	std::size_t AddNode(const std::string &label, const Location *location);
+	void        AddChild(std::size_t parent, std::size_t child);
+	std::size_t FindChild(std::size_t parent, unsigned char c) const;
+	void        ReplaceChild(std::size_t parent, std::size_t old_child, std::size_t new_child);
+
+	NodeList nodes_;
+};
+
+} // namespace server
+
+#endif /* SERVER_LOCATION_TRIE_HPP_ */
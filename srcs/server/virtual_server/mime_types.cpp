@@ -0,0 +1,128 @@
+#include "mime_types.hpp"
+#include <cctype> // tolower
+
+namespace server {
+namespace {
+
+// config/mime.typesを読まない場合も今までと同じContent-Typeを返すための組み込みのtypes
+const char *const BUILT_IN_TYPES[][2] = {
+	{"txt",  "text/plain"      },
+	{"html", "text/html"       },
+	{"json", "application/json"},
+	{"pdf",  "application/pdf" },
+	{"jpeg", "image/jpeg"      },
+	{"jpg",  "image/jpeg"      }
+};
+const std::size_t BUILT_IN_TYPES_SIZE = sizeof(BUILT_IN_TYPES) / sizeof(BUILT_IN_TYPES[0]);
+
+unsigned char ToLower(char c) {
+	return static_cast<unsigned char>(std::tolower(static_cast<unsigned char>(c)));
+}
+
+// 小文字にしながらのFNV-1a
+std::size_t Hash(std::string::const_iterator begin, std::string::const_iterator end) {
+	std::size_t hash = 2166136261u;
+	for (std::string::const_iterator it = begin; it != end; ++it) {
+		hash ^= ToLower(*it);
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+// keyは小文字で入っている
+bool IsEqualIgnoreCase(
+	const std::string &key, std::string::const_iterator begin, std::string::const_iterator end
+) {
+	if (key.size() != static_cast<std::size_t>(end - begin)) {
+		return false;
+	}
+	for (std::string::const_iterator it = key.begin(); it != key.end(); ++it, ++begin) {
+		if (static_cast<unsigned char>(*it) != ToLower(*begin)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+MimeTypes::TypeMap CreateBuiltInTypes() {
+	MimeTypes::TypeMap types;
+	for (std::size_t i = 0; i < BUILT_IN_TYPES_SIZE; ++i) {
+		types[BUILT_IN_TYPES[i][0]] = BUILT_IN_TYPES[i][1];
+	}
+	return types;
+}
+
+} // namespace
+
+const std::string MimeTypes::DEFAULT_TYPE = "application/octet-stream";
+
+MimeTypes::MimeTypes() : type_count_(0) {
+	Build(CreateBuiltInTypes());
+}
+
+MimeTypes::MimeTypes(const TypeMap &types) : type_count_(0) {
+	Build(types);
+}
+
+MimeTypes::~MimeTypes() {}
+
+MimeTypes::MimeTypes(const MimeTypes &other) {
+	*this = other;
+}
+
+MimeTypes &MimeTypes::operator=(const MimeTypes &other) {
+	if (this != &other) {
+		type_table_ = other.type_table_;
+		type_count_ = other.type_count_;
+	}
+	return *this;
+}
+
+const std::string *MimeTypes::Find(const std::string &extension) const {
+	return Find(extension.begin(), extension.end());
+}
+
+const std::string &MimeTypes::GetContentType(const std::string &path) const {
+	const std::size_t dot_pos   = path.rfind('.');
+	const std::size_t slash_pos = path.rfind('/');
+	// ".", "dir.d/file"のようにfile名に拡張子が無いもの
+	if (dot_pos == std::string::npos ||
+		(slash_pos != std::string::npos && dot_pos < slash_pos)) {
+		return DEFAULT_TYPE;
+	}
+	const std::string *type = Find(path.begin() + dot_pos + 1, path.end());
+	return type == NULL ? DEFAULT_TYPE : *type;
+}
+
+std::size_t MimeTypes::size() const {
+	return type_count_;
+}
+
+void MimeTypes::Build(const TypeMap &types) {
+	std::size_t bucket_size = 1;
+	while (bucket_size < types.size() * 2) {
+		bucket_size <<= 1;
+	}
+	type_table_.assign(bucket_size, Bucket());
+	for (TypeMap::const_iterator it = types.begin(); it != types.end(); ++it) {
+		const std::size_t index = Hash(it->first.begin(), it->first.end()) & (bucket_size - 1);
+		type_table_[index].push_back(TypeEntry(it->first, it->second));
+	}
+	type_count_ = types.size();
+}
+
+const std::string *
+MimeTypes::Find(std::string::const_iterator begin, std::string::const_iterator end) const {
+	if (type_count_ == 0) {
+		return NULL;
+	}
+	const Bucket &bucket = type_table_[Hash(begin, end) & (type_table_.size() - 1)];
+	for (Bucket::const_iterator it = bucket.begin(); it != bucket.end(); ++it) {
+		if (IsEqualIgnoreCase(it->first, begin, end)) {
+			return &it->second;
+		}
+	}
+	return NULL;
+}
+
+} // namespace server
@@ -0,0 +1,49 @@
+#ifndef SERVER_MIME_TYPES_HPP_
+#define SERVER_MIME_TYPES_HPP_
+
+#include <cstddef> // size_t
+#include <map>
+#include <string>
+#include <utility> // pair
+#include <vector>
+
+namespace server {
+
+// 拡張子からContent-Typeを引くhash table
+// 起動時にtypes {}から一度だけ作り、requestごとには拡張子のhashを1回計算して引くだけにする
+// 拡張子は大文字小文字を区別しない(requestごとに小文字のstringを作らずに比べる)
+class MimeTypes {
+  public:
+	typedef std::map<std::string, std::string> TypeMap; // 拡張子(小文字) -> MIME type
+
+	// types {}が無い時に使う組み込みのtypes
+	MimeTypes();
+	explicit MimeTypes(const TypeMap &types);
+	~MimeTypes();
+	MimeTypes(const MimeTypes &other);
+	MimeTypes &operator=(const MimeTypes &other);
+
+	// 拡張子('.'は含まない)のMIME type。無ければNULL
+	const std::string *Find(const std::string &extension) const;
+	// pathの最後の要素の拡張子から決める。知らない拡張子はapplication/octet-stream
+	const std::string &GetContentType(const std::string &path) const;
+	std::size_t        size() const;
+
+	static const std::string DEFAULT_TYPE;
+
+  private:
+	typedef std::pair<std::string, std::string> TypeEntry;
+	typedef std::vector<TypeEntry>              Bucket;
+	typedef std::vector<Bucket>                 TypeTable;
+
+	void Build(const TypeMap &types);
+	const std::string *
+	Find(std::string::const_iterator begin, std::string::const_iterator end) const;
+
+	TypeTable   type_table_; // bucketの数は2の累乗にして、要素数の2倍以上にしておく
+	std::size_t type_count_;
+};
+
+} // namespace server
+
+#endif /* SERVER_MIME_TYPES_HPP_ */
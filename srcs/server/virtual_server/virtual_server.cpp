@@ -3,20 +3,32 @@
 namespace server {
 
 VirtualServer::VirtualServer()
-	: client_max_body_size_(DEFAULT_CLIENT_MAX_BODY_SIZE), error_page_(std::make_pair(0, "")) {}
+	: client_max_body_size_(DEFAULT_CLIENT_MAX_BODY_SIZE),
+	  error_page_(std::make_pair(0, "")),
+	  cgi_cache_size_(DEFAULT_CGI_CACHE_SIZE) {}
 
 VirtualServer::VirtualServer(
-	const ServerNameList &server_names,
-	const LocationList   &locations,
-	const HostPortList   &host_ports,
-	std::size_t           client_max_body_size,
-	const ErrorPage      &error_page
+	const ServerNameList   &server_names,
+	const LocationList     &locations,
+	const HostPortList     &host_ports,
+	std::size_t             client_max_body_size,
+	const ErrorPage        &error_page,
+	std::size_t             cgi_cache_size,
+	const HeaderLimits     &header_limits,
+	const MimeTypes        &mime_types,
+	const ConnectionLimits &connection_limits
 )
 	: server_names_(server_names),
 	  locations_(locations),
 	  host_ports_(host_ports),
 	  client_max_body_size_(client_max_body_size),
-	  error_page_(error_page) {}
+	  error_page_(error_page),
+	  cgi_cache_size_(cgi_cache_size),
+	  header_limits_(header_limits),
+	  mime_types_(mime_types),
+	  connection_limits_(connection_limits) {
+	location_trie_.Build(locations_);
+}
 
 VirtualServer::~VirtualServer() {}
 
@@ -31,6 +43,12 @@ VirtualServer &VirtualServer::operator=(const VirtualServer &other) {
 		host_ports_           = other.host_ports_;
 		client_max_body_size_ = other.client_max_body_size_;
 		error_page_           = other.error_page_;
+		cgi_cache_size_       = other.cgi_cache_size_;
+		header_limits_        = other.header_limits_;
+		mime_types_           = other.mime_types_;
+		connection_limits_    = other.connection_limits_;
+		// trieは自分のlocations_を指すようにする
+		location_trie_.Build(locations_);
 	}
 	return *this;
 }
@@ -55,4 +73,24 @@ const VirtualServer::ErrorPage &VirtualServer::GetErrorPage() const {
 	return error_page_;
 }
 
+std::size_t VirtualServer::GetCgiCacheSize() const {
+	return cgi_cache_size_;
+}
+
+const HeaderLimits &VirtualServer::GetHeaderLimits() const {
+	return header_limits_;
+}
+
+const MimeTypes &VirtualServer::GetMimeTypes() const {
+	return mime_types_;
+}
+
+const ConnectionLimits &VirtualServer::GetConnectionLimits() const {
+	return connection_limits_;
+}
+
+const Location *VirtualServer::FindLocation(const std::string &request_target) const {
+	return location_trie_.Find(request_target);
+}
+
 } // namespace server
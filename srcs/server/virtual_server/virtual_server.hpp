@@ -1,19 +1,63 @@
 #ifndef SERVER_VIRTUALSERVER_HPP_
 #define SERVER_VIRTUALSERVER_HPP_
 
+#include "location_trie.hpp"
+#include "mime_types.hpp"
 #include <cstddef> // size_t
 #include <list>
 #include <string>
 
 namespace server {
 
+// period秒の間に最低限やり取りするbyte数(bytesが0なら見ない)
+struct DataRate {
+	DataRate() : bytes(0), period(0) {}
+	DataRate(std::size_t bytes, unsigned int period) : bytes(bytes), period(period) {}
+
+	std::size_t  bytes;
+	unsigned int period;
+};
+
+// client接続のtimeout(sec)と、1つの接続で受けるrequest数の上限
+struct ConnectionLimits {
+	ConnectionLimits()
+		: client_header_timeout(DEFAULT_CLIENT_HEADER_TIMEOUT),
+		  client_body_timeout(DEFAULT_CLIENT_BODY_TIMEOUT),
+		  keepalive_timeout(DEFAULT_KEEPALIVE_TIMEOUT),
+		  send_timeout(DEFAULT_SEND_TIMEOUT),
+		  keepalive_requests(DEFAULT_KEEPALIVE_REQUESTS),
+		  limit_conn_per_ip(0) {}
+
+	unsigned int client_header_timeout; // request line, header fieldsを読み終えるまで
+	unsigned int client_body_timeout;   // bodyの受信の間隔
+	unsigned int keepalive_timeout;     // responseを送り終えてから次のrequestまで
+	unsigned int send_timeout;          // responseの送信の間隔
+	std::size_t  keepalive_requests;
+	DataRate     client_min_rate; // request line, header fields, bodyの受信
+	DataRate     send_min_rate;   // responseの送信
+	std::size_t  limit_conn_per_ip; // 0なら無制限
+
+	static const unsigned int DEFAULT_CLIENT_HEADER_TIMEOUT = 60;
+	static const unsigned int DEFAULT_CLIENT_BODY_TIMEOUT   = 60;
+	static const unsigned int DEFAULT_KEEPALIVE_TIMEOUT     = 75;
+	static const unsigned int DEFAULT_SEND_TIMEOUT          = 60;
+	static const std::size_t  DEFAULT_KEEPALIVE_REQUESTS    = 1000;
+};
+
 struct Location {
 	typedef std::list<std::string>               AllowedMethodList;
 	typedef std::pair<unsigned int, std::string> Redirect;
+	typedef std::pair<std::string, unsigned int> IpPortPair;
+	typedef std::list<IpPortPair>                UpstreamList;
 
-	Location() : autoindex(false), redirect(std::make_pair(0, "")) {}
+	Location()
+		: autoindex(false),
+		  redirect(std::make_pair(0, "")),
+		  cgi_cache_valid(0),
+		  proxy_balance("round_robin") {}
 
 	std::string       request_uri;
+	std::string       root; // 起動時に解決した絶対path(末尾の'/'は無い)
 	std::string       alias;
 	std::string       index;
 	bool              autoindex;
@@ -21,6 +65,26 @@ struct Location {
 	Redirect          redirect;
 	std::string       cgi_extension;
 	std::string       upload_directory;
+	unsigned int      cgi_cache_valid;
+	UpstreamList      proxy_pass; // 起動時に名前解決したip:port
+	std::string       proxy_balance;
+	ConnectionLimits  connection_limits; // 書かれていないものはserverの値
+};
+
+// request line, header fieldsを読むときの上限(large_client_header_buffers, max_header_fields)
+struct HeaderLimits {
+	HeaderLimits()
+		: buffer_number(DEFAULT_BUFFER_NUMBER),
+		  buffer_size(DEFAULT_BUFFER_SIZE),
+		  max_fields(DEFAULT_MAX_FIELDS) {}
+
+	std::size_t buffer_number;
+	std::size_t buffer_size; // request line, header行1つの上限
+	std::size_t max_fields;
+
+	static const std::size_t DEFAULT_BUFFER_NUMBER = 4;
+	static const std::size_t DEFAULT_BUFFER_SIZE   = 8192;
+	static const std::size_t DEFAULT_MAX_FIELDS    = 100;
 };
 
 // virtual serverとして必要な情報を保持・取得する
@@ -35,30 +99,47 @@ class VirtualServer {
 	// default constructor: necessary for map's insert/[]
 	VirtualServer();
 	VirtualServer(
-		const ServerNameList &server_names,
-		const LocationList   &locations,
-		const HostPortList   &host_ports,
-		std::size_t           client_max_body_size,
-		const ErrorPage      &error_page
+		const ServerNameList   &server_names,
+		const LocationList     &locations,
+		const HostPortList     &host_ports,
+		std::size_t             client_max_body_size,
+		const ErrorPage        &error_page,
+		std::size_t             cgi_cache_size    = DEFAULT_CGI_CACHE_SIZE,
+		const HeaderLimits     &header_limits     = HeaderLimits(),
+		const MimeTypes        &mime_types        = MimeTypes(),
+		const ConnectionLimits &connection_limits = ConnectionLimits()
 	);
 	~VirtualServer();
 	VirtualServer(const VirtualServer &other);
 	VirtualServer &operator=(const VirtualServer &other);
 	// getter
-	const ServerNameList &GetServerNameList() const;
-	const LocationList   &GetLocationList() const;
-	const HostPortList   &GetHostPortList() const;
-	std::size_t           GetClientMaxBodySize() const;
-	const ErrorPage      &GetErrorPage() const;
+	const ServerNameList   &GetServerNameList() const;
+	const LocationList     &GetLocationList() const;
+	const HostPortList     &GetHostPortList() const;
+	std::size_t             GetClientMaxBodySize() const;
+	const ErrorPage        &GetErrorPage() const;
+	std::size_t             GetCgiCacheSize() const;
+	const HeaderLimits     &GetHeaderLimits() const;
+	const MimeTypes        &GetMimeTypes() const;
+	const ConnectionLimits &GetConnectionLimits() const;
+	// request_targetに最長一致するlocation(無ければNULL)
+	const Location *FindLocation(const std::string &request_target) const;
+
+	static const std::size_t DEFAULT_CGI_CACHE_SIZE = 1024 * 1024;
 
   private:
 	static const std::size_t DEFAULT_CLIENT_MAX_BODY_SIZE = 1024;
 	// variables
-	ServerNameList server_names_;
-	LocationList   locations_;
-	HostPortList   host_ports_;
-	std::size_t    client_max_body_size_;
-	ErrorPage      error_page_;
+	ServerNameList   server_names_;
+	LocationList     locations_;
+	HostPortList     host_ports_;
+	std::size_t      client_max_body_size_;
+	ErrorPage        error_page_;
+	std::size_t      cgi_cache_size_;
+	HeaderLimits     header_limits_;
+	MimeTypes        mime_types_;
+	ConnectionLimits connection_limits_;
+	LocationTrie     location_trie_; // locations_から作るので、locations_と一緒に作り直す
 };
 
 } // namespace server
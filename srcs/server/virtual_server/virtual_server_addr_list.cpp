@@ -0,0 +1,219 @@
+#include "virtual_server_addr_list.hpp"
+#include "virtual_server.hpp"
+#include <cctype> // tolower
+
+namespace server {
+namespace {
+
+const std::string WILDCARD_PREFIX = "*.";
+
+// FNV-1a
+std::size_t Hash(const std::string &str) {
+	std::size_t hash = 2166136261u;
+	for (std::string::const_iterator it = str.begin(); it != str.end(); ++it) {
+		hash ^= static_cast<unsigned char>(*it);
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+} // namespace
+
+const std::size_t VirtualServerAddrList::INITIAL_BUCKET_SIZE;
+
+VirtualServerAddrList::VirtualServerAddrList()
+	: host_table_(INITIAL_BUCKET_SIZE), host_count_(0), wildcard_trie_(1) {}
+
+VirtualServerAddrList::~VirtualServerAddrList() {}
+
+VirtualServerAddrList::VirtualServerAddrList(const VirtualServerAddrList &other) {
+	*this = other;
+}
+
+VirtualServerAddrList &VirtualServerAddrList::operator=(const VirtualServerAddrList &other) {
+	if (this != &other) {
+		virtual_servers_ = other.virtual_servers_;
+		host_table_      = other.host_table_;
+		host_count_      = other.host_count_;
+		wildcard_trie_   = other.wildcard_trie_;
+	}
+	return *this;
+}
+
+VirtualServerAddrList::const_iterator VirtualServerAddrList::begin() const {
+	return virtual_servers_.begin();
+}
+
+VirtualServerAddrList::const_iterator VirtualServerAddrList::end() const {
+	return virtual_servers_.end();
+}
+
+VirtualServerAddrList::size_type VirtualServerAddrList::size() const {
+	return virtual_servers_.size();
+}
+
+bool VirtualServerAddrList::empty() const {
+	return virtual_servers_.empty();
+}
+
+const VirtualServer *VirtualServerAddrList::front() const {
+	return virtual_servers_.front();
+}
+
+const VirtualServer *VirtualServerAddrList::back() const {
+	return virtual_servers_.back();
+}
+
+// 同じserver_nameが複数のserverにある場合は先に追加した方を使う
+void VirtualServerAddrList::push_back(const VirtualServer *virtual_server) {
+	virtual_servers_.push_back(virtual_server);
+	typedef VirtualServer::ServerNameList::const_iterator Itr;
+	const VirtualServer::ServerNameList &server_names = virtual_server->GetServerNameList();
+	for (Itr it = server_names.begin(); it != server_names.end(); ++it) {
+		AddServerName(*it, virtual_server);
+	}
+}
+
+const VirtualServer *VirtualServerAddrList::FindVirtualServer(const std::string &host) const {
+	if (virtual_servers_.empty()) {
+		return NULL;
+	}
+	const std::string    host_name = NormalizeHostName(host);
+	const VirtualServer *exact     = FindExactName(host_name);
+	if (exact != NULL) {
+		return exact;
+	}
+	const VirtualServer *wildcard = FindWildcardName(host_name);
+	if (wildcard != NULL) {
+		return wildcard;
+	}
+	return GetDefaultServer();
+}
+
+// listen directiveにdefault_serverは無いので、nginxと同じく最初のserver
+const VirtualServer *VirtualServerAddrList::GetDefaultServer() const {
+	return virtual_servers_.empty() ? NULL : virtual_servers_.front();
+}
+
+std::string VirtualServerAddrList::NormalizeHostName(const std::string &host) {
+	std::string host_name;
+	if (!host.empty() && host[0] == '[') {
+		// [::1]:8080 -> [::1]
+		const std::size_t end = host.find(']');
+		host_name             = host.substr(0, end == std::string::npos ? end : end + 1);
+	} else {
+		host_name = host.substr(0, host.find(':'));
+	}
+	if (!host_name.empty() && host_name[host_name.size() - 1] == '.') {
+		host_name.erase(host_name.size() - 1);
+	}
+	for (std::string::iterator it = host_name.begin(); it != host_name.end(); ++it) {
+		*it = static_cast<char>(std::tolower(static_cast<unsigned char>(*it)));
+	}
+	return host_name;
+}
+
+void VirtualServerAddrList::AddServerName(
+	const std::string &server_name, const VirtualServer *virtual_server
+) {
+	const std::string host_name = NormalizeHostName(server_name);
+	if (host_name.compare(0, WILDCARD_PREFIX.size(), WILDCARD_PREFIX) == 0 &&
+		host_name.size() > WILDCARD_PREFIX.size()) {
+		AddWildcardName(host_name.substr(WILDCARD_PREFIX.size()), virtual_server);
+		return;
+	}
+	AddExactName(host_name, virtual_server);
+}
+
+void VirtualServerAddrList::AddExactName(
+	const std::string &host_name, const VirtualServer *virtual_server
+) {
+	if (FindExactName(host_name) != NULL) {
+		return;
+	}
+	if (host_count_ >= host_table_.size()) {
+		Rehash();
+	}
+	host_table_[Hash(host_name) % host_table_.size()].push_back(
+		HostEntry(host_name, virtual_server)
+	);
+	++host_count_;
+}
+
+// example.com -> com, exampleの順にnodeを作り、最後のnodeに持たせる
+void VirtualServerAddrList::AddWildcardName(
+	const std::string &domain, const VirtualServer *virtual_server
+) {
+	std::size_t node = 0;
+	std::size_t end  = domain.size();
+	while (true) {
+		const std::size_t dot   = domain.rfind('.', end - 1);
+		const std::size_t begin = dot == std::string::npos ? 0 : dot + 1;
+		const std::string label = domain.substr(begin, end - begin);
+		const std::map<std::string, std::size_t>::const_iterator it =
+			wildcard_trie_[node].children.find(label);
+		if (it != wildcard_trie_[node].children.end()) {
+			node = it->second;
+		} else {
+			wildcard_trie_.push_back(WildcardNode());
+			wildcard_trie_[node].children[label] = wildcard_trie_.size() - 1;
+			node                                 = wildcard_trie_.size() - 1;
+		}
+		if (dot == std::string::npos || dot == 0) {
+			break;
+		}
+		end = dot;
+	}
+	if (wildcard_trie_[node].virtual_server == NULL) {
+		wildcard_trie_[node].virtual_server = virtual_server;
+	}
+}
+
+void VirtualServerAddrList::Rehash() {
+	HostTable new_table(host_table_.size() * 2);
+	for (HostTable::const_iterator bucket = host_table_.begin(); bucket != host_table_.end();
+		 ++bucket) {
+		for (Bucket::const_iterator it = bucket->begin(); it != bucket->end(); ++it) {
+			new_table[Hash(it->first) % new_table.size()].push_back(*it);
+		}
+	}
+	host_table_.swap(new_table);
+}
+
+const VirtualServer *VirtualServerAddrList::FindExactName(const std::string &host_name) const {
+	const Bucket &bucket = host_table_[Hash(host_name) % host_table_.size()];
+	for (Bucket::const_iterator it = bucket.begin(); it != bucket.end(); ++it) {
+		if (it->first == host_name) {
+			return it->second;
+		}
+	}
+	return NULL;
+}
+
+// a.b.example.com: com -> example -> b と辿り、まだlabelが残っている所の*.を使う
+// (*.example.comはexample.comそのものには一致しない)
+const VirtualServer *VirtualServerAddrList::FindWildcardName(const std::string &host_name) const {
+	const VirtualServer *match = NULL;
+	std::size_t          node  = 0;
+	std::size_t          end   = host_name.size();
+	while (end > 0) {
+		const std::size_t dot = host_name.rfind('.', end - 1);
+		if (dot == std::string::npos) {
+			break;
+		}
+		const std::string label = host_name.substr(dot + 1, end - dot - 1);
+		const std::map<std::string, std::size_t>::const_iterator it =
+			wildcard_trie_[node].children.find(label);
+		if (it == wildcard_trie_[node].children.end()) {
+			break;
+		}
+		node = it->second;
+		if (wildcard_trie_[node].virtual_server != NULL) {
+			match = wildcard_trie_[node].virtual_server;
+		}
+		end = dot;
+	}
+	return match;
+}
+
+} // namespace server
@@ -0,0 +1,79 @@
+#ifndef SERVER_VIRTUALSERVERADDRLIST_HPP_
+#define SERVER_VIRTUALSERVERADDRLIST_HPP_
+
+#include <cstddef> // size_t
+#include <list>
+#include <map>
+#include <string>
+#include <utility> // pair
+#include <vector>
+
+namespace server {
+
+class VirtualServer;
+
+// 1つのhost:portでlistenしているVirtualServerを追加された順に持つ
+// 追加する時にserver_nameを索引にしておき、Host headerからhashで引けるようにする
+// - 完全一致: server_nameのhash table
+// - *.example.com: labelを逆順(com -> example)に辿るtrie。一番長く一致したものを使う
+// - どれにも一致しなければ、最初に追加されたdefault server
+// std::listと同じ使い方もできるようにしている(VirtualServerは持たずにポインタだけ持つ)
+class VirtualServerAddrList {
+  public:
+	typedef std::list<const VirtualServer *> ServerList;
+	typedef ServerList::const_iterator       iterator;
+	typedef ServerList::const_iterator       const_iterator;
+	typedef ServerList::size_type            size_type;
+
+	VirtualServerAddrList();
+	~VirtualServerAddrList();
+	VirtualServerAddrList(const VirtualServerAddrList &other);
+	VirtualServerAddrList &operator=(const VirtualServerAddrList &other);
+
+	const_iterator       begin() const;
+	const_iterator       end() const;
+	size_type            size() const;
+	bool                 empty() const;
+	const VirtualServer *front() const;
+	const VirtualServer *back() const;
+	void                 push_back(const VirtualServer *virtual_server);
+
+	// Host headerの値(portが付いていてもよい)に対応するVirtualServer。空の場合はNULL
+	const VirtualServer *FindVirtualServer(const std::string &host) const;
+	const VirtualServer *GetDefaultServer() const;
+
+	// 小文字にしてportと末尾の'.'を取る(localhost:8080 -> localhost)
+	static std::string NormalizeHostName(const std::string &host);
+
+  private:
+	typedef std::pair<std::string, const VirtualServer *> HostEntry;
+	typedef std::vector<HostEntry>                        Bucket;
+	typedef std::vector<Bucket>                           HostTable;
+
+	// *.example.comのlabelを逆順に辿るnode
+	struct WildcardNode {
+		WildcardNode() : virtual_server(NULL) {}
+
+		std::map<std::string, std::size_t> children;       // labelとnodes_のindex
+		const VirtualServer               *virtual_server; // ここまでで終わる*.の持ち主
+	};
+	typedef std::vector<WildcardNode> WildcardTrie;
+
+	static const std::size_t INITIAL_BUCKET_SIZE = 16;
+
+	void AddServerName(const std::string &server_name, const VirtualServer *virtual_server);
+	void AddExactName(const std::string &host_name, const VirtualServer *virtual_server);
+	void AddWildcardName(const std::string &domain, const VirtualServer *virtual_server);
+	void Rehash();
+	const VirtualServer *FindExactName(const std::string &host_name) const;
+	const VirtualServer *FindWildcardName(const std::string &host_name) const;
+
+	ServerList   virtual_servers_;
+	HostTable    host_table_;
+	std::size_t  host_count_;
+	WildcardTrie wildcard_trie_;
+};
+
+} // namespace server
+
+#endif /* SERVER_VIRTUALSERVERADDRLIST_HPP_ */
@@ -1,6 +1,6 @@
+#include "scan.hpp"
 #include "utils.hpp"
-#include <algorithm> // transform
-#include <cctype>    // isdigit,tolower
+#include <cctype>  // isdigit
 #include <cerrno>
 #include <cstddef> // size_t
 #include <cstdlib> // strtoul
@@ -15,10 +15,6 @@ bool IsDigit(char c) {
 	return std::isdigit(static_cast<unsigned char>(c));
 }
 
-char ToLowerChar(char c) {
-	return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
-}
-
 } // namespace
 
 Result<unsigned int> ConvertStrToUint(const std::string &str) {
@@ -63,7 +59,7 @@ Result<std::size_t> ConvertStrToSize(const std::string &str) {
 
 std::string ToLowerString(const std::string &str) {
 	std::string lower_str = str;
-	std::transform(lower_str.begin(), lower_str.end(), lower_str.begin(), ToLowerChar);
+	scan::ToLower(lower_str);
 	return lower_str;
 }
 
@@ -1,20 +1,11 @@
-#include <cctype> // isprint
+#include "scan.hpp"
 #include <string>
 
 namespace utils {
 
-// https://en.cppreference.com/w/cpp/string/byte/isprint
-bool IsPrint(char c) {
-	return std::isprint(static_cast<unsigned char>(c));
-}
-
+// VCHAR(0x21-0x7E)とSP
 bool IsVString(const std::string &str) {
-	for (std::string::const_iterator it = str.begin(); it != str.end(); ++it) {
-		if (!IsPrint(*it)) {
-			return false;
-		}
-	}
-	return true;
+	return scan::IsPrint(str);
 }
 
 } // namespace utils
@@ -0,0 +1,254 @@
+#include "scan.hpp"
+#include "scan_kernels.hpp"
+
+namespace utils {
+namespace scan {
+namespace {
+
+// RFC 9110 tchar: "!" / "#" / "$" / "%" / "&" / "'" / "*" / "+" / "-" / "." / "^" / "_" / "`" /
+// "|" / "~" / DIGIT / ALPHA
+bool IsTokenChar(unsigned char c) {
+	if ((c >= '0' && c <= '9') || (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z')) {
+		return true;
+	}
+	switch (c) {
+	case '!':
+	case '#':
+	case '$':
+	case '%':
+	case '&':
+	case '\'':
+	case '*':
+	case '+':
+	case '-':
+	case '.':
+	case '^':
+	case '_':
+	case '`':
+	case '|':
+	case '~':
+		return true;
+	default:
+		return false;
+	}
+}
+
+const Kernels *GetKernels(Isa isa) {
+#ifdef WEBSERV_SCAN_X86
+	switch (isa) {
+	case ISA_AVX2:
+		return &AVX2_KERNELS;
+	case ISA_SSE2:
+		return &SSE2_KERNELS;
+	default:
+		break;
+	}
+#else
+	(void)isa;
+#endif
+	return &SCALAR_KERNELS;
+}
+
+struct Selection {
+	Isa            isa;
+	const Kernels *kernels;
+};
+
+Selection CreateSelection(Isa isa) {
+	Selection selection;
+	selection.isa     = isa;
+	selection.kernels = GetKernels(isa);
+	return selection;
+}
+
+// 最初の呼び出しでCPUに合わせて選ぶ
+Selection &CurrentSelection() {
+	static Selection selection = CreateSelection(GetBestIsa());
+	return selection;
+}
+
+const Kernels &CurrentKernels() {
+	return *CurrentSelection().kernels;
+}
+
+// kernelの戻り値(offset or size)をstd::stringのposに直す
+std::size_t ToPos(std::size_t offset, std::size_t size, std::size_t pos) {
+	return offset == size ? std::string::npos : pos + offset;
+}
+
+} // namespace
+
+namespace scalar {
+
+std::size_t FindByte(const char *data, std::size_t size, char c) {
+	for (std::size_t i = 0; i < size; ++i) {
+		if (data[i] == c) {
+			return i;
+		}
+	}
+	return size;
+}
+
+std::size_t FindEitherByte(const char *data, std::size_t size, char c1, char c2) {
+	for (std::size_t i = 0; i < size; ++i) {
+		if (data[i] == c1 || data[i] == c2) {
+			return i;
+		}
+	}
+	return size;
+}
+
+std::size_t FindCrlf(const char *data, std::size_t size) {
+	for (std::size_t i = 0; i + 1 < size; ++i) {
+		if (data[i] == '\r' && data[i + 1] == '\n') {
+			return i;
+		}
+	}
+	return size;
+}
+
+std::size_t FindCrlfCrlf(const char *data, std::size_t size) {
+	for (std::size_t i = 0; i + 3 < size; ++i) {
+		if (data[i] == '\r' && data[i + 1] == '\n' && data[i + 2] == '\r' &&
+			data[i + 3] == '\n') {
+			return i;
+		}
+	}
+	return size;
+}
+
+bool IsPrint(const char *data, std::size_t size) {
+	for (std::size_t i = 0; i < size; ++i) {
+		const unsigned char c = static_cast<unsigned char>(data[i]);
+		if (c < 0x20 || c > 0x7e) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool IsUpperAlpha(const char *data, std::size_t size) {
+	for (std::size_t i = 0; i < size; ++i) {
+		if (data[i] < 'A' || data[i] > 'Z') {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool IsToken(const char *data, std::size_t size) {
+	for (std::size_t i = 0; i < size; ++i) {
+		if (!IsTokenChar(static_cast<unsigned char>(data[i]))) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void ToLower(char *data, std::size_t size) {
+	for (std::size_t i = 0; i < size; ++i) {
+		if (data[i] >= 'A' && data[i] <= 'Z') {
+			data[i] = static_cast<char>(data[i] + ('a' - 'A'));
+		}
+	}
+}
+
+} // namespace scalar
+
+const Kernels SCALAR_KERNELS = {
+	scalar::FindByte,
+	scalar::FindEitherByte,
+	scalar::FindCrlf,
+	scalar::FindCrlfCrlf,
+	scalar::IsPrint,
+	scalar::IsUpperAlpha,
+	scalar::IsToken,
+	scalar::ToLower
+};
+
+Isa GetBestIsa() {
+#ifdef WEBSERV_SCAN_X86
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2")) {
+		return ISA_AVX2;
+	}
+	if (__builtin_cpu_supports("sse2")) {
+		return ISA_SSE2;
+	}
+#endif
+	return ISA_SCALAR;
+}
+
+Isa GetSelectedIsa() {
+	return CurrentSelection().isa;
+}
+
+void SelectIsa(Isa isa) {
+	const Isa best_isa = GetBestIsa();
+	CurrentSelection() = CreateSelection(isa > best_isa ? best_isa : isa);
+}
+
+const char *GetIsaName(Isa isa) {
+	switch (isa) {
+	case ISA_AVX2:
+		return "avx2";
+	case ISA_SSE2:
+		return "sse2";
+	default:
+		return "scalar";
+	}
+}
+
+std::size_t FindByte(const std::string &str, char c, std::size_t pos) {
+	if (pos >= str.size()) {
+		return std::string::npos;
+	}
+	const std::size_t size = str.size() - pos;
+	return ToPos(CurrentKernels().find_byte(str.data() + pos, size, c), size, pos);
+}
+
+std::size_t FindEitherByte(const std::string &str, char c1, char c2, std::size_t pos) {
+	if (pos >= str.size()) {
+		return std::string::npos;
+	}
+	const std::size_t size = str.size() - pos;
+	return ToPos(CurrentKernels().find_either_byte(str.data() + pos, size, c1, c2), size, pos);
+}
+
+std::size_t FindCrlf(const std::string &str, std::size_t pos) {
+	if (pos >= str.size()) {
+		return std::string::npos;
+	}
+	const std::size_t size = str.size() - pos;
+	return ToPos(CurrentKernels().find_crlf(str.data() + pos, size), size, pos);
+}
+
+std::size_t FindCrlfCrlf(const std::string &str, std::size_t pos) {
+	if (pos >= str.size()) {
+		return std::string::npos;
+	}
+	const std::size_t size = str.size() - pos;
+	return ToPos(CurrentKernels().find_crlf_crlf(str.data() + pos, size), size, pos);
+}
+
+bool IsPrint(const std::string &str) {
+	return CurrentKernels().is_print(str.data(), str.size());
+}
+
+bool IsUpperAlpha(const std::string &str) {
+	return CurrentKernels().is_upper_alpha(str.data(), str.size());
+}
+
+bool IsToken(const std::string &str) {
+	return CurrentKernels().is_token(str.data(), str.size());
+}
+
+void ToLower(std::string &str) {
+	if (str.empty()) {
+		return;
+	}
+	CurrentKernels().to_lower(&str[0], str.size());
+}
+
+} // namespace scan
+} // namespace utils
@@ -0,0 +1,34 @@
+#ifndef UTILS_SCAN_HPP_
+#define UTILS_SCAN_HPP_
+
+#include <cstddef>
+#include <string>
+
+namespace utils {
+namespace scan {
+
+// http/cgiのparseで使う区切り文字の探索・文字種のチェック
+// 実行時にCPUを見てAVX2 > SSE2 > scalarの順で使える実装を選ぶ
+enum Isa { ISA_SCALAR, ISA_SSE2, ISA_AVX2 };
+
+Isa         GetBestIsa();
+Isa         GetSelectedIsa();
+void        SelectIsa(Isa isa); // benchmark/test用。CPUが対応していなければ使える実装に落とす
+const char *GetIsaName(Isa isa);
+
+// 見つからない場合はstd::string::npos
+std::size_t FindByte(const std::string &str, char c, std::size_t pos = 0);
+std::size_t FindEitherByte(const std::string &str, char c1, char c2, std::size_t pos = 0);
+std::size_t FindCrlf(const std::string &str, std::size_t pos = 0);
+std::size_t FindCrlfCrlf(const std::string &str, std::size_t pos = 0);
+
+// 空文字列はtrue
+bool IsPrint(const std::string &str);      // 全て0x20-0x7E
+bool IsUpperAlpha(const std::string &str); // 全てA-Z
+bool IsToken(const std::string &str);      // 全てRFC 9110のtchar
+void ToLower(std::string &str);
+
+} // namespace scan
+} // namespace utils
+
+#endif /* UTILS_SCAN_HPP_ */
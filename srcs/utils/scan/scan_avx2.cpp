@@ -0,0 +1,156 @@
+#include "scan_kernels.hpp"
+
+#ifdef WEBSERV_SCAN_X86
+
+#include <immintrin.h>
+
+#define SCAN_AVX2 __attribute__((target("avx2")))
+
+namespace utils {
+namespace scan {
+namespace {
+
+const std::size_t BLOCK_SIZE = 32;
+
+SCAN_AVX2 __m256i Load(const char *data) {
+	return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data));
+}
+
+SCAN_AVX2 unsigned int ToMask(__m256i matched) {
+	return static_cast<unsigned int>(_mm256_movemask_epi8(matched));
+}
+
+// lower <= c <= upper の位置を立てる(符号付き比較なので0x80以上は範囲外)
+SCAN_AVX2 __m256i InRange(__m256i block, char lower, char upper) {
+	return _mm256_andnot_si256(
+		_mm256_or_si256(
+			_mm256_cmpgt_epi8(_mm256_set1_epi8(lower), block),
+			_mm256_cmpgt_epi8(block, _mm256_set1_epi8(upper))
+		),
+		_mm256_set1_epi8(static_cast<char>(0xff))
+	);
+}
+
+SCAN_AVX2 std::size_t FindByte(const char *data, std::size_t size, char c) {
+	const __m256i target = _mm256_set1_epi8(c);
+	std::size_t   i      = 0;
+	for (; i + BLOCK_SIZE <= size; i += BLOCK_SIZE) {
+		const unsigned int mask = ToMask(_mm256_cmpeq_epi8(Load(data + i), target));
+		if (mask != 0) {
+			return i + __builtin_ctz(mask);
+		}
+	}
+	return i + scalar::FindByte(data + i, size - i, c);
+}
+
+SCAN_AVX2 std::size_t FindEitherByte(const char *data, std::size_t size, char c1, char c2) {
+	const __m256i target1 = _mm256_set1_epi8(c1);
+	const __m256i target2 = _mm256_set1_epi8(c2);
+	std::size_t   i       = 0;
+	for (; i + BLOCK_SIZE <= size; i += BLOCK_SIZE) {
+		const __m256i      block = Load(data + i);
+		const unsigned int mask =
+			ToMask(_mm256_or_si256(_mm256_cmpeq_epi8(block, target1), _mm256_cmpeq_epi8(block, target2)));
+		if (mask != 0) {
+			return i + __builtin_ctz(mask);
+		}
+	}
+	return i + scalar::FindEitherByte(data + i, size - i, c1, c2);
+}
+
+// 1byteずらして読んだblockと合わせて"\r\n"の先頭の位置を探す
+SCAN_AVX2 std::size_t FindCrlf(const char *data, std::size_t size) {
+	const __m256i cr = _mm256_set1_epi8('\r');
+	const __m256i lf = _mm256_set1_epi8('\n');
+	std::size_t   i  = 0;
+	for (; i + BLOCK_SIZE + 1 <= size; i += BLOCK_SIZE) {
+		const unsigned int mask = ToMask(_mm256_and_si256(
+			_mm256_cmpeq_epi8(Load(data + i), cr), _mm256_cmpeq_epi8(Load(data + i + 1), lf)
+		));
+		if (mask != 0) {
+			return i + __builtin_ctz(mask);
+		}
+	}
+	return i + scalar::FindCrlf(data + i, size - i);
+}
+
+SCAN_AVX2 std::size_t FindCrlfCrlf(const char *data, std::size_t size) {
+	const __m256i cr = _mm256_set1_epi8('\r');
+	const __m256i lf = _mm256_set1_epi8('\n');
+	std::size_t   i  = 0;
+	for (; i + BLOCK_SIZE + 3 <= size; i += BLOCK_SIZE) {
+		const __m256i crlf1 = _mm256_and_si256(
+			_mm256_cmpeq_epi8(Load(data + i), cr), _mm256_cmpeq_epi8(Load(data + i + 1), lf)
+		);
+		const __m256i crlf2 = _mm256_and_si256(
+			_mm256_cmpeq_epi8(Load(data + i + 2), cr), _mm256_cmpeq_epi8(Load(data + i + 3), lf)
+		);
+		const unsigned int mask = ToMask(_mm256_and_si256(crlf1, crlf2));
+		if (mask != 0) {
+			return i + __builtin_ctz(mask);
+		}
+	}
+	return i + scalar::FindCrlfCrlf(data + i, size - i);
+}
+
+SCAN_AVX2 bool IsPrint(const char *data, std::size_t size) {
+	std::size_t i = 0;
+	for (; i + BLOCK_SIZE <= size; i += BLOCK_SIZE) {
+		if (ToMask(InRange(Load(data + i), 0x20, 0x7e)) != 0xffffffffu) {
+			return false;
+		}
+	}
+	return scalar::IsPrint(data + i, size - i);
+}
+
+SCAN_AVX2 bool IsUpperAlpha(const char *data, std::size_t size) {
+	std::size_t i = 0;
+	for (; i + BLOCK_SIZE <= size; i += BLOCK_SIZE) {
+		if (ToMask(InRange(Load(data + i), 'A', 'Z')) != 0xffffffffu) {
+			return false;
+		}
+	}
+	return scalar::IsUpperAlpha(data + i, size - i);
+}
+
+// 英数字と'-'だけのblockはまとめて通し、それ以外の記号を含むblockだけscalarで確認する
+SCAN_AVX2 bool IsToken(const char *data, std::size_t size) {
+	const __m256i hyphen = _mm256_set1_epi8('-');
+	std::size_t   i      = 0;
+	for (; i + BLOCK_SIZE <= size; i += BLOCK_SIZE) {
+		const __m256i block = Load(data + i);
+		const __m256i alnum = _mm256_or_si256(
+			_mm256_or_si256(InRange(block, '0', '9'), InRange(block, 'A', 'Z')),
+			_mm256_or_si256(InRange(block, 'a', 'z'), _mm256_cmpeq_epi8(block, hyphen))
+		);
+		if (ToMask(alnum) != 0xffffffffu && !scalar::IsToken(data + i, BLOCK_SIZE)) {
+			return false;
+		}
+	}
+	return scalar::IsToken(data + i, size - i);
+}
+
+SCAN_AVX2 void ToLower(char *data, std::size_t size) {
+	const __m256i diff = _mm256_set1_epi8('a' - 'A');
+	std::size_t   i    = 0;
+	for (; i + BLOCK_SIZE <= size; i += BLOCK_SIZE) {
+		const __m256i block = Load(data + i);
+		const __m256i upper = InRange(block, 'A', 'Z');
+		_mm256_storeu_si256(
+			reinterpret_cast<__m256i *>(data + i),
+			_mm256_add_epi8(block, _mm256_and_si256(upper, diff))
+		);
+	}
+	scalar::ToLower(data + i, size - i);
+}
+
+} // namespace
+
+const Kernels AVX2_KERNELS = {
+	FindByte, FindEitherByte, FindCrlf, FindCrlfCrlf, IsPrint, IsUpperAlpha, IsToken, ToLower
+};
+
+} // namespace scan
+} // namespace utils
+
+#endif
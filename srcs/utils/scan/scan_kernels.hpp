@@ -0,0 +1,46 @@
+#ifndef UTILS_SCAN_KERNELS_HPP_
+#define UTILS_SCAN_KERNELS_HPP_
+
+#include <cstddef>
+
+namespace utils {
+namespace scan {
+
+// 各実装の関数テーブル。位置はdataの先頭からのoffsetで、見つからない場合はsize
+struct Kernels {
+	std::size_t (*find_byte)(const char *data, std::size_t size, char c);
+	std::size_t (*find_either_byte)(const char *data, std::size_t size, char c1, char c2);
+	std::size_t (*find_crlf)(const char *data, std::size_t size);
+	std::size_t (*find_crlf_crlf)(const char *data, std::size_t size);
+	bool (*is_print)(const char *data, std::size_t size);
+	bool (*is_upper_alpha)(const char *data, std::size_t size);
+	bool (*is_token)(const char *data, std::size_t size);
+	void (*to_lower)(char *data, std::size_t size);
+};
+
+extern const Kernels SCALAR_KERNELS;
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define WEBSERV_SCAN_X86 1
+extern const Kernels SSE2_KERNELS;
+extern const Kernels AVX2_KERNELS;
+#endif
+
+// SIMD実装の端数やfallbackで使うscalar実装
+namespace scalar {
+
+std::size_t FindByte(const char *data, std::size_t size, char c);
+std::size_t FindEitherByte(const char *data, std::size_t size, char c1, char c2);
+std::size_t FindCrlf(const char *data, std::size_t size);
+std::size_t FindCrlfCrlf(const char *data, std::size_t size);
+bool        IsPrint(const char *data, std::size_t size);
+bool        IsUpperAlpha(const char *data, std::size_t size);
+bool        IsToken(const char *data, std::size_t size);
+void        ToLower(char *data, std::size_t size);
+
+} // namespace scalar
+
+} // namespace scan
+} // namespace utils
+
+#endif /* UTILS_SCAN_KERNELS_HPP_ */
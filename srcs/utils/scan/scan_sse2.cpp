@@ -0,0 +1,156 @@
+#include "scan_kernels.hpp"
+
+#ifdef WEBSERV_SCAN_X86
+
+#include <emmintrin.h>
+
+#define SCAN_SSE2 __attribute__((target("sse2")))
+
+namespace utils {
+namespace scan {
+namespace {
+
+const std::size_t BLOCK_SIZE = 16;
+
+SCAN_SSE2 __m128i Load(const char *data) {
+	return _mm_loadu_si128(reinterpret_cast<const __m128i *>(data));
+}
+
+SCAN_SSE2 unsigned int ToMask(__m128i matched) {
+	return static_cast<unsigned int>(_mm_movemask_epi8(matched));
+}
+
+// lower <= c <= upper の位置を立てる(符号付き比較なので0x80以上は範囲外)
+SCAN_SSE2 __m128i InRange(__m128i block, char lower, char upper) {
+	return _mm_andnot_si128(
+		_mm_or_si128(
+			_mm_cmplt_epi8(block, _mm_set1_epi8(lower)),
+			_mm_cmpgt_epi8(block, _mm_set1_epi8(upper))
+		),
+		_mm_set1_epi8(static_cast<char>(0xff))
+	);
+}
+
+SCAN_SSE2 std::size_t FindByte(const char *data, std::size_t size, char c) {
+	const __m128i target = _mm_set1_epi8(c);
+	std::size_t   i      = 0;
+	for (; i + BLOCK_SIZE <= size; i += BLOCK_SIZE) {
+		const unsigned int mask = ToMask(_mm_cmpeq_epi8(Load(data + i), target));
+		if (mask != 0) {
+			return i + __builtin_ctz(mask);
+		}
+	}
+	return i + scalar::FindByte(data + i, size - i, c);
+}
+
+SCAN_SSE2 std::size_t FindEitherByte(const char *data, std::size_t size, char c1, char c2) {
+	const __m128i target1 = _mm_set1_epi8(c1);
+	const __m128i target2 = _mm_set1_epi8(c2);
+	std::size_t   i       = 0;
+	for (; i + BLOCK_SIZE <= size; i += BLOCK_SIZE) {
+		const __m128i      block = Load(data + i);
+		const unsigned int mask =
+			ToMask(_mm_or_si128(_mm_cmpeq_epi8(block, target1), _mm_cmpeq_epi8(block, target2)));
+		if (mask != 0) {
+			return i + __builtin_ctz(mask);
+		}
+	}
+	return i + scalar::FindEitherByte(data + i, size - i, c1, c2);
+}
+
+// 1byteずらして読んだblockと合わせて"\r\n"の先頭の位置を探す
+SCAN_SSE2 std::size_t FindCrlf(const char *data, std::size_t size) {
+	const __m128i cr = _mm_set1_epi8('\r');
+	const __m128i lf = _mm_set1_epi8('\n');
+	std::size_t   i  = 0;
+	for (; i + BLOCK_SIZE + 1 <= size; i += BLOCK_SIZE) {
+		const unsigned int mask = ToMask(_mm_and_si128(
+			_mm_cmpeq_epi8(Load(data + i), cr), _mm_cmpeq_epi8(Load(data + i + 1), lf)
+		));
+		if (mask != 0) {
+			return i + __builtin_ctz(mask);
+		}
+	}
+	return i + scalar::FindCrlf(data + i, size - i);
+}
+
+SCAN_SSE2 std::size_t FindCrlfCrlf(const char *data, std::size_t size) {
+	const __m128i cr = _mm_set1_epi8('\r');
+	const __m128i lf = _mm_set1_epi8('\n');
+	std::size_t   i  = 0;
+	for (; i + BLOCK_SIZE + 3 <= size; i += BLOCK_SIZE) {
+		const __m128i crlf1 = _mm_and_si128(
+			_mm_cmpeq_epi8(Load(data + i), cr), _mm_cmpeq_epi8(Load(data + i + 1), lf)
+		);
+		const __m128i crlf2 = _mm_and_si128(
+			_mm_cmpeq_epi8(Load(data + i + 2), cr), _mm_cmpeq_epi8(Load(data + i + 3), lf)
+		);
+		const unsigned int mask = ToMask(_mm_and_si128(crlf1, crlf2));
+		if (mask != 0) {
+			return i + __builtin_ctz(mask);
+		}
+	}
+	return i + scalar::FindCrlfCrlf(data + i, size - i);
+}
+
+SCAN_SSE2 bool IsPrint(const char *data, std::size_t size) {
+	std::size_t i = 0;
+	for (; i + BLOCK_SIZE <= size; i += BLOCK_SIZE) {
+		if (ToMask(InRange(Load(data + i), 0x20, 0x7e)) != 0xffff) {
+			return false;
+		}
+	}
+	return scalar::IsPrint(data + i, size - i);
+}
+
+SCAN_SSE2 bool IsUpperAlpha(const char *data, std::size_t size) {
+	std::size_t i = 0;
+	for (; i + BLOCK_SIZE <= size; i += BLOCK_SIZE) {
+		if (ToMask(InRange(Load(data + i), 'A', 'Z')) != 0xffff) {
+			return false;
+		}
+	}
+	return scalar::IsUpperAlpha(data + i, size - i);
+}
+
+// 英数字と'-'だけのblockはまとめて通し、それ以外の記号を含むblockだけscalarで確認する
+SCAN_SSE2 bool IsToken(const char *data, std::size_t size) {
+	const __m128i hyphen = _mm_set1_epi8('-');
+	std::size_t   i      = 0;
+	for (; i + BLOCK_SIZE <= size; i += BLOCK_SIZE) {
+		const __m128i block = Load(data + i);
+		const __m128i alnum = _mm_or_si128(
+			_mm_or_si128(InRange(block, '0', '9'), InRange(block, 'A', 'Z')),
+			_mm_or_si128(InRange(block, 'a', 'z'), _mm_cmpeq_epi8(block, hyphen))
+		);
+		if (ToMask(alnum) != 0xffff && !scalar::IsToken(data + i, BLOCK_SIZE)) {
+			return false;
+		}
+	}
+	return scalar::IsToken(data + i, size - i);
+}
+
+SCAN_SSE2 void ToLower(char *data, std::size_t size) {
+	const __m128i diff = _mm_set1_epi8('a' - 'A');
+	std::size_t   i    = 0;
+	for (; i + BLOCK_SIZE <= size; i += BLOCK_SIZE) {
+		const __m128i block = Load(data + i);
+		const __m128i upper = InRange(block, 'A', 'Z');
+		_mm_storeu_si128(
+			reinterpret_cast<__m128i *>(data + i),
+			_mm_add_epi8(block, _mm_and_si128(upper, diff))
+		);
+	}
+	scalar::ToLower(data + i, size - i);
+}
+
+} // namespace
+
+const Kernels SSE2_KERNELS = {
+	FindByte, FindEitherByte, FindCrlf, FindCrlfCrlf, IsPrint, IsUpperAlpha, IsToken, ToLower
+};
+
+} // namespace scan
+} // namespace utils
+
+#endif
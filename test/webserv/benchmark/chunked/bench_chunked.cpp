@@ -0,0 +1,112 @@
+#include "http_parse.hpp"
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+namespace {
+
+const std::size_t BODY_SIZE  = 100 * 1024 * 1024;
+const std::size_t CHUNK_SIZE = 1024;
+const std::size_t READ_SIZE  = 65536; // server側で1回にreadする大きさ
+const std::size_t LARGE_READ = READ_SIZE * 4;
+
+const std::string HEADER = "POST / HTTP/1.1\r\nHost: host\r\nTransfer-Encoding: chunked\r\n"
+						   "Content-Type: text/plain\r\n\r\n";
+
+std::string CreateChunkedBody(std::size_t body_size, std::size_t chunk_size) {
+	std::ostringstream oss;
+	oss << std::hex << chunk_size;
+	const std::string chunk = oss.str() + "\r\n" + std::string(chunk_size, 'a') + "\r\n";
+
+	std::string body;
+	body.reserve(body_size / chunk_size * chunk.size() + 5);
+	for (std::size_t size = 0; size < body_size; size += chunk_size) {
+		body += chunk;
+	}
+	return body + "0\r\n\r\n";
+}
+
+// ==================== 置き換え前の実装 ==================== //
+// chunkごとにcurrent_bufの先頭からCRLFを探し、substrで取り出してeraseする
+
+bool ParseChunkedOld(std::string &current_buf, std::string &body_message) {
+	while (true) {
+		const std::size_t size_end = current_buf.find("\r\n");
+		if (size_end == std::string::npos) {
+			return false;
+		}
+		std::istringstream iss(current_buf.substr(0, size_end));
+		std::size_t        chunk_size = 0;
+		iss >> std::hex >> chunk_size;
+		const std::size_t data_end = current_buf.find("\r\n", size_end + 2);
+		if (data_end == std::string::npos) {
+			return false;
+		}
+		const std::string chunk_data = current_buf.substr(size_end + 2, data_end - size_end - 2);
+		body_message += chunk_data;
+		current_buf.erase(0, size_end + 2 + chunk_data.size() + 2);
+		if (chunk_size == 0) {
+			return true;
+		}
+	}
+}
+
+// ================================================= //
+
+typedef bool (*FeedFunc)(const std::string &chunked_body, std::size_t read_size);
+
+// header fieldsを読み終えたところからread_sizeずつbodyを渡す
+bool FeedNew(const std::string &chunked_body, std::size_t read_size) {
+	http::HttpRequestParsedData data;
+	data.current_buf = HEADER;
+	for (std::size_t pos = 0; pos < chunked_body.size(); pos += read_size) {
+		data.current_buf.append(chunked_body, pos, read_size);
+		const http::HttpStatus status = http::HttpParse::Run(data);
+		if (!status.IsOk()) {
+			std::cerr << status.GetMessage() << std::endl;
+			return false;
+		}
+	}
+	return data.is_request_format.is_body_message &&
+		   data.request_result.request.body_message.size() == BODY_SIZE;
+}
+
+bool FeedOld(const std::string &chunked_body, std::size_t read_size) {
+	std::string current_buf;
+	std::string body_message;
+	bool        is_complete = false;
+	for (std::size_t pos = 0; pos < chunked_body.size(); pos += read_size) {
+		current_buf.append(chunked_body, pos, read_size);
+		is_complete = ParseChunkedOld(current_buf, body_message);
+	}
+	return is_complete && body_message.size() == BODY_SIZE;
+}
+
+void Run(const std::string &name, FeedFunc feed, const std::string &chunked, std::size_t read) {
+	const std::clock_t begin   = std::clock();
+	const bool         is_ok   = feed(chunked, read);
+	const double       seconds = static_cast<double>(std::clock() - begin) / CLOCKS_PER_SEC;
+	std::cout << std::left << std::setw(6) << name << "read " << std::setw(10) << read
+			  << std::right << std::fixed << std::setprecision(3) << std::setw(8) << seconds
+			  << " s" << std::setw(10) << std::setprecision(1)
+			  << BODY_SIZE / seconds / (1024 * 1024) << " MB/s" << (is_ok ? "" : "  (NG)")
+			  << std::endl;
+}
+
+} // namespace
+
+int main() {
+	const std::string chunked = CreateChunkedBody(BODY_SIZE, CHUNK_SIZE);
+
+	std::cout << "body: " << BODY_SIZE / (1024 * 1024) << " MB in " << CHUNK_SIZE
+			  << " B chunks" << std::endl;
+	Run("old", FeedOld, chunked, READ_SIZE);
+	Run("new", FeedNew, chunked, READ_SIZE);
+	// 古い実装は1回に渡すbufferが大きいほどeraseのコストが増える
+	Run("old", FeedOld, chunked, LARGE_READ);
+	Run("new", FeedNew, chunked, LARGE_READ);
+	Run("new", FeedNew, chunked, chunked.size());
+	return 0;
+}
@@ -0,0 +1,131 @@
+#include "utils.hpp"
+#include "virtual_server.hpp"
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <sstream> // ostringstream
+#include <string>
+#include <vector>
+
+namespace {
+
+typedef server::VirtualServer::LocationList LocationList;
+
+const std::size_t LOCATION_COUNT = 2000;
+const std::size_t LOOP_COUNT     = 20000;
+
+// 生成されたconfigのように/api/<service>/v<n>/のlocationをたくさん持つ
+LocationList CreateLocationList() {
+	LocationList locations;
+	server::Location root;
+	root.request_uri = "/";
+	locations.push_back(root);
+	for (std::size_t i = 0; i < LOCATION_COUNT; ++i) {
+		std::ostringstream oss;
+		oss << "/api/service" << i % 100 << "/v" << i << "/";
+		server::Location location;
+		location.request_uri = oss.str();
+		locations.push_back(location);
+	}
+	return locations;
+}
+
+std::vector<std::string> CreateRequestTargets() {
+	std::vector<std::string> request_targets;
+	for (std::size_t i = 0; i < LOCATION_COUNT; i += 7) {
+		std::ostringstream oss;
+		oss << "/api/service" << i % 100 << "/v" << i << "/users/12345/profile.json";
+		request_targets.push_back(oss.str());
+	}
+	request_targets.push_back("/index.html");
+	return request_targets;
+}
+
+// ==================== 置き換え前の探し方 ==================== //
+// 全てのlocationをStartWithで比べて一番長いものを残す
+
+const server::Location *
+FindByScan(const LocationList &locations, const std::string &request_target) {
+	const server::Location *match = NULL;
+	for (LocationList::const_iterator it = locations.begin(); it != locations.end(); ++it) {
+		if (utils::StartWith(request_target, it->request_uri) &&
+			it->request_uri.length() > (match == NULL ? 0 : match->request_uri.length())) {
+			match = &*it;
+		}
+	}
+	return match;
+}
+
+// ================================================= //
+
+// 1回あたりの時間を返す
+template <typename Find>
+double
+Run(const std::string &name, Find find, const std::vector<std::string> &targets, double base) {
+	std::size_t        found = 0;
+	const std::clock_t begin = std::clock();
+	for (std::size_t i = 0; i < LOOP_COUNT; ++i) {
+		found += find(targets[i % targets.size()]) != NULL;
+	}
+	const double seconds = static_cast<double>(std::clock() - begin) / CLOCKS_PER_SEC;
+	std::cout << std::left << std::setw(12) << name << std::right << std::fixed
+			  << std::setprecision(3) << std::setw(8) << seconds << " s" << std::setw(12)
+			  << std::setprecision(0) << LOOP_COUNT / seconds << " lookup/s";
+	if (base > 0) {
+		std::cout << std::setw(8) << std::setprecision(2) << base / seconds << "x";
+	}
+	std::cout << (found == LOOP_COUNT ? "" : "  (NG)") << std::endl;
+	return found == LOOP_COUNT ? seconds : -1;
+}
+
+struct ScanFinder {
+	explicit ScanFinder(const LocationList &locations) : locations(locations) {}
+	const server::Location *operator()(const std::string &request_target) const {
+		return FindByScan(locations, request_target);
+	}
+	const LocationList &locations;
+};
+
+struct TrieFinder {
+	explicit TrieFinder(const server::VirtualServer &virtual_server)
+		: virtual_server(virtual_server) {}
+	const server::Location *operator()(const std::string &request_target) const {
+		return virtual_server.FindLocation(request_target);
+	}
+	const server::VirtualServer &virtual_server;
+};
+
+// 全てのrequest targetで置き換え前と同じlocationが返る
+bool IsSameMatch(
+	const server::VirtualServer &virtual_server, const std::vector<std::string> &targets
+) {
+	for (std::size_t i = 0; i < targets.size(); ++i) {
+		if (virtual_server.FindLocation(targets[i]) !=
+			FindByScan(virtual_server.GetLocationList(), targets[i])) {
+			std::cerr << "different match: " << targets[i] << std::endl;
+			return false;
+		}
+	}
+	return true;
+}
+
+} // namespace
+
+int main() {
+	const server::VirtualServer virtual_server(
+		server::VirtualServer::ServerNameList(),
+		CreateLocationList(),
+		server::VirtualServer::HostPortList(),
+		1024,
+		server::VirtualServer::ErrorPage()
+	);
+	const std::vector<std::string> targets = CreateRequestTargets();
+
+	// 右端はscanに対する速さの比
+	std::cout << "locations: " << LOCATION_COUNT << ", loop: " << LOOP_COUNT << std::endl;
+	int          ret  = 0;
+	const double scan = Run("scan", ScanFinder(virtual_server.GetLocationList()), targets, 0);
+	ret |= Run("trie", TrieFinder(virtual_server), targets, scan) < 0;
+	ret |= scan < 0 || !IsSameMatch(virtual_server, targets);
+	return ret;
+}
@@ -0,0 +1,103 @@
+#include "http_format.hpp"
+#include "http_message.hpp"
+#include "http_response_serializer.hpp"
+#include "status_code.hpp"
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+namespace {
+
+const std::size_t LOOP_COUNT = 1000000;
+const std::size_t BODY_SIZE  = 1024;
+
+// ==================== 置き換え前の実装 ==================== //
+// ostringstreamに書いてからstr()でコピーし、呼び出し元でもう一度コピーしていた
+
+std::string CreateHttpResponseOld(const http::HttpResponseFormat &response) {
+	std::ostringstream response_stream;
+	response_stream << response.status_line.version << http::SP
+					<< response.status_line.status_code << http::SP
+					<< response.status_line.reason_phrase << http::CRLF;
+	typedef http::HeaderFields::const_iterator It;
+	for (It it = response.header_fields.begin(); it != response.header_fields.end(); ++it) {
+		response_stream << it->first << ":" << http::SP << it->second << http::CRLF;
+	}
+	response_stream << http::CRLF;
+	response_stream << response.body_message;
+	return response_stream.str();
+}
+
+// ================================================= //
+
+http::HttpResponseFormat CreateResponse(http::EStatusCode code, const std::string &body) {
+	const http::StatusCode status_code(code);
+	http::HeaderFields     header_fields;
+	header_fields[http::SERVER]         = http::SERVER_VERSION;
+	header_fields[http::CONTENT_TYPE]   = http::TEXT_HTML;
+	header_fields[http::CONNECTION]     = http::KEEP_ALIVE;
+	header_fields[http::CONTENT_LENGTH] = "1024";
+	return http::HttpResponseFormat(
+		http::StatusLine(
+			http::HTTP_VERSION, status_code.GetStatusCode(), status_code.GetReasonPhrase()
+		),
+		header_fields,
+		body
+	);
+}
+
+typedef std::size_t (*SerializeFunc)(const http::HttpResponseFormat &response);
+
+std::size_t SerializeOld(const http::HttpResponseFormat &response) {
+	std::string sent;
+	sent = CreateHttpResponseOld(response);
+	return sent.size();
+}
+
+// HttpResponse::Runと同じく毎回新しいbufferに書く
+std::size_t SerializeNew(const http::HttpResponseFormat &response) {
+	std::string buffer;
+	http::HttpResponseSerializer::Serialize(response, buffer);
+	return buffer.size();
+}
+
+// connectionごとのbufferを使い回す場合
+std::size_t SerializeReused(const http::HttpResponseFormat &response) {
+	static std::string buffer;
+	http::HttpResponseSerializer::Serialize(response, buffer);
+	return buffer.size();
+}
+
+void Run(const std::string &name, SerializeFunc func, const http::HttpResponseFormat &response) {
+	std::size_t        total = 0;
+	const std::clock_t begin = std::clock();
+	for (std::size_t i = 0; i < LOOP_COUNT; ++i) {
+		total += func(response);
+	}
+	const double seconds = static_cast<double>(std::clock() - begin) / CLOCKS_PER_SEC;
+	std::cout << std::left << std::setw(14) << name << std::right << std::fixed
+			  << std::setprecision(3) << std::setw(8) << seconds << " s" << std::setw(12)
+			  << std::setprecision(0) << LOOP_COUNT / seconds << " res/s"
+			  << (total == 0 ? "  (NG)" : "") << std::endl;
+}
+
+} // namespace
+
+int main() {
+	const http::HttpResponseFormat ok = CreateResponse(http::OK, std::string(BODY_SIZE, 'a'));
+	const http::HttpResponseFormat not_found = CreateResponse(
+		http::NOT_FOUND, http::StatusCode(http::NOT_FOUND).GetDefaultBodyMessage()
+	);
+
+	// 1coreで1秒あたりに作れるresponseの数(newはdate付き)
+	std::cout << "loop: " << LOOP_COUNT << std::endl;
+	Run("200 old", SerializeOld, ok);
+	Run("200 new", SerializeNew, ok);
+	Run("200 reused", SerializeReused, ok);
+	Run("404 old", SerializeOld, not_found);
+	Run("404 new", SerializeNew, not_found);
+	Run("404 reused", SerializeReused, not_found);
+	return 0;
+}
@@ -0,0 +1,174 @@
+#include "scan.hpp"
+#include <cctype>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace utils::scan;
+
+namespace {
+
+const std::size_t HEADER_BLOCK_SIZE = 8192;
+const int         ITERATIONS        = 20000;
+
+// request line + header fieldsで8KBほどのheader blockを作る
+std::string CreateHeaderBlock() {
+	std::string block = "GET /index.html?query=benchmark HTTP/1.1\r\nHost: localhost:8080\r\n";
+	for (int i = 0; block.size() < HEADER_BLOCK_SIZE; ++i) {
+		std::ostringstream oss;
+		oss << "X-Benchmark-Field-" << i << ": Some-Mixed-Case-Value/" << i
+			<< "; charset=UTF-8, text/html\r\n";
+		block += oss.str();
+	}
+	return block + "\r\n";
+}
+
+std::vector<std::string> SplitLines(const std::string &block) {
+	std::vector<std::string> lines;
+	std::size_t              begin = 0;
+	std::size_t              end;
+	while ((end = block.find("\r\n", begin)) != std::string::npos && end != begin) {
+		lines.push_back(block.substr(begin, end - begin));
+		begin = end + 2;
+	}
+	return lines;
+}
+
+// 最適化で消されないように結果を溜める
+std::size_t g_sink = 0;
+
+// ==================== 置き換え前の実装 ==================== //
+
+void FramingStd(const std::string &block) {
+	g_sink += block.find("\r\n\r\n");
+	for (std::size_t pos = 0; (pos = block.find("\r\n", pos)) != std::string::npos; pos += 2) {
+		++g_sink;
+	}
+}
+
+void ValidateStd(const std::vector<std::string> &lines) {
+	for (std::size_t i = 0; i < lines.size(); ++i) {
+		const std::string &line = lines[i];
+		bool               ok   = true;
+		for (std::size_t j = 0; j < line.size(); ++j) {
+			ok = ok && std::isprint(static_cast<unsigned char>(line[j]));
+		}
+		g_sink += ok;
+	}
+}
+
+void ToLowerStd(std::vector<std::string> lines) {
+	for (std::size_t i = 0; i < lines.size(); ++i) {
+		std::string &line = lines[i];
+		for (std::size_t j = 0; j < line.size(); ++j) {
+			line[j] = static_cast<char>(std::tolower(static_cast<unsigned char>(line[j])));
+		}
+		g_sink += line[0];
+	}
+}
+
+// ==================== scan ==================== //
+
+void FramingScan(const std::string &block) {
+	g_sink += FindCrlfCrlf(block);
+	for (std::size_t pos = 0; (pos = FindCrlf(block, pos)) != std::string::npos; pos += 2) {
+		++g_sink;
+	}
+}
+
+void ValidateScan(const std::vector<std::string> &lines) {
+	for (std::size_t i = 0; i < lines.size(); ++i) {
+		g_sink += IsPrint(lines[i]);
+	}
+}
+
+void ToLowerScan(std::vector<std::string> lines) {
+	for (std::size_t i = 0; i < lines.size(); ++i) {
+		ToLower(lines[i]);
+		g_sink += lines[i][0];
+	}
+}
+
+// ================================================= //
+
+typedef void (*BlockFunc)(const std::string &);
+typedef void (*LinesFunc)(const std::vector<std::string> &);
+typedef void (*LinesCopyFunc)(std::vector<std::string>);
+
+// 8KBを1回処理するのにかかった時間(ns)
+double MeasureNs(std::clock_t begin, std::clock_t end) {
+	return static_cast<double>(end - begin) / CLOCKS_PER_SEC * 1e9 / ITERATIONS;
+}
+
+void PrintResult(const std::string &name, const std::string &impl, double ns) {
+	std::cout << std::left << std::setw(10) << name << std::setw(8) << impl << std::right
+			  << std::fixed << std::setprecision(1) << std::setw(10) << ns << " ns/8KB"
+			  << std::setw(10) << HEADER_BLOCK_SIZE / ns * 1e9 / (1024 * 1024) << " MB/s"
+			  << std::endl;
+}
+
+void RunBlock(
+	const std::string &name, const std::string &impl, BlockFunc f, const std::string &b
+) {
+	const std::clock_t begin = std::clock();
+	for (int i = 0; i < ITERATIONS; ++i) {
+		f(b);
+	}
+	PrintResult(name, impl, MeasureNs(begin, std::clock()));
+}
+
+void RunLines(
+	const std::string &name, const std::string &impl, LinesFunc f, const std::vector<std::string> &l
+) {
+	const std::clock_t begin = std::clock();
+	for (int i = 0; i < ITERATIONS; ++i) {
+		f(l);
+	}
+	PrintResult(name, impl, MeasureNs(begin, std::clock()));
+}
+
+void RunLinesCopy(
+	const std::string              &name,
+	const std::string              &impl,
+	LinesCopyFunc                   f,
+	const std::vector<std::string> &l
+) {
+	const std::clock_t begin = std::clock();
+	for (int i = 0; i < ITERATIONS; ++i) {
+		f(l);
+	}
+	PrintResult(name, impl, MeasureNs(begin, std::clock()));
+}
+
+} // namespace
+
+int main() {
+	const std::string              block = CreateHeaderBlock();
+	const std::vector<std::string> lines = SplitLines(block);
+	const Isa                      isas[] = {ISA_SCALAR, ISA_SSE2, ISA_AVX2};
+
+	std::cout << "header block: " << block.size() << " bytes, " << lines.size() << " lines"
+			  << std::endl;
+	std::cout << "best isa    : " << GetIsaName(GetBestIsa()) << std::endl;
+
+	RunBlock("framing", "std", FramingStd, block);
+	for (std::size_t i = 0; i < sizeof(isas) / sizeof(isas[0]); ++i) {
+		SelectIsa(isas[i]);
+		RunBlock("framing", GetIsaName(GetSelectedIsa()), FramingScan, block);
+	}
+	RunLines("vchar", "std", ValidateStd, lines);
+	for (std::size_t i = 0; i < sizeof(isas) / sizeof(isas[0]); ++i) {
+		SelectIsa(isas[i]);
+		RunLines("vchar", GetIsaName(GetSelectedIsa()), ValidateScan, lines);
+	}
+	RunLinesCopy("tolower", "std", ToLowerStd, lines);
+	for (std::size_t i = 0; i < sizeof(isas) / sizeof(isas[0]); ++i) {
+		SelectIsa(isas[i]);
+		RunLinesCopy("tolower", GetIsaName(GetSelectedIsa()), ToLowerScan, lines);
+	}
+	std::cerr << "(sink: " << g_sink << ")" << std::endl;
+	return 0;
+}
@@ -0,0 +1,146 @@
+#include "http_parse.hpp"
+#include "http_serverinfo_check.hpp"
+#include "virtual_server.hpp"
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+const std::size_t LOOP_COUNT = 200000;
+
+const std::string OK_REQUEST = "GET /index.html HTTP/1.1\r\nHost: host1\r\nUser-Agent: bench\r\n"
+							   "Accept: */*\r\n\r\n";
+// header fieldsまで読んでからHostが無いことが分かる(200と同じだけparseしてから400)
+const std::string NO_HOST_REQUEST = "GET /index.html HTTP/1.1\r\nUser-Agent: bench\r\n"
+									"Accept: */*\r\n\r\n";
+// request lineで分かる400
+const std::string BAD_VERSION_REQUEST = "GET /index.html HTTP/1.2\r\nHost: host1\r\n\r\n";
+
+http::HttpStatus Parse(const std::string &request) {
+	http::HttpRequestParsedData data;
+	data.current_buf = request;
+	return http::HttpParse::Run(data);
+}
+
+server::VirtualServer *BuildVirtualServer() {
+	server::Location::AllowedMethodList allowed_methods;
+	allowed_methods.push_back("GET");
+	server::Location location;
+	location.request_uri     = "/www/";
+	location.index           = "index.html";
+	location.allowed_methods = allowed_methods;
+
+	server::VirtualServer::LocationList locations;
+	locations.push_back(location);
+	server::VirtualServer::ServerNameList server_names;
+	server_names.push_back("host1");
+	server::VirtualServer::HostPortList host_ports;
+	host_ports.push_back(std::make_pair("localhost", 8080));
+	server::VirtualServer::ErrorPage error_page(404, "/error_pages/404.html");
+	return new server::VirtualServer(server_names, locations, host_ports, 2048, error_page);
+}
+
+http::HttpRequestFormat CreateRequest(const std::string &request_target) {
+	http::HttpRequestFormat request;
+	request.request_line.method         = "GET";
+	request.request_line.request_target = request_target;
+	request.request_line.version        = "HTTP/1.1";
+	request.header_fields["host"]       = "host1";
+	return request;
+}
+
+// ==================== 置き換え前の返し方 ==================== //
+// 4xxを例外で投げてcatchする(HttpExceptionのlog出力は除いた分)
+
+http::EStatusCode ThrowOnError(const http::HttpStatus &status) {
+	try {
+		if (!status.IsOk()) {
+			throw std::runtime_error(status.GetMessage());
+		}
+	} catch (const std::runtime_error &) {
+		return status.GetStatusCode();
+	}
+	return http::OK;
+}
+
+// ================================================= //
+
+typedef http::EStatusCode (*CaseFunc)(void);
+
+const server::VirtualServerAddrList *g_virtual_servers = NULL;
+
+http::EStatusCode ParseOk() {
+	return Parse(OK_REQUEST).GetStatusCode();
+}
+
+http::EStatusCode ParseNoHost() {
+	return Parse(NO_HOST_REQUEST).GetStatusCode();
+}
+
+http::EStatusCode ParseNoHostThrow() {
+	return ThrowOnError(Parse(NO_HOST_REQUEST));
+}
+
+http::EStatusCode ParseBadVersion() {
+	return Parse(BAD_VERSION_REQUEST).GetStatusCode();
+}
+
+http::EStatusCode RouteOk() {
+	return http::HttpServerInfoCheck::Check(*g_virtual_servers, CreateRequest("/www/a.html"))
+		.status.GetStatusCode();
+}
+
+http::EStatusCode RouteNotFound() {
+	return http::HttpServerInfoCheck::Check(*g_virtual_servers, CreateRequest("/none/a.html"))
+		.status.GetStatusCode();
+}
+
+http::EStatusCode RouteNotFoundThrow() {
+	return ThrowOnError(
+		http::HttpServerInfoCheck::Check(*g_virtual_servers, CreateRequest("/none/a.html")).status
+	);
+}
+
+// 1回あたりの時間を返す
+double Run(const std::string &name, CaseFunc func, http::EStatusCode expected, double base) {
+	bool               is_ok = true;
+	const std::clock_t begin = std::clock();
+	for (std::size_t i = 0; i < LOOP_COUNT; ++i) {
+		is_ok &= func() == expected;
+	}
+	const double seconds = static_cast<double>(std::clock() - begin) / CLOCKS_PER_SEC;
+	std::cout << std::left << std::setw(20) << name << std::right << std::fixed
+			  << std::setprecision(3) << std::setw(8) << seconds << " s" << std::setw(12)
+			  << std::setprecision(0) << LOOP_COUNT / seconds << " req/s";
+	if (base > 0) {
+		std::cout << std::setw(8) << std::setprecision(2) << base / seconds << "x";
+	}
+	std::cout << (is_ok ? "" : "  (NG)") << std::endl;
+	return is_ok ? seconds : -1;
+}
+
+} // namespace
+
+int main() {
+	server::VirtualServerAddrList virtual_servers;
+	virtual_servers.push_back(BuildVirtualServer());
+	g_virtual_servers = &virtual_servers;
+
+	// 右端は200に対する速さの比
+	std::cout << "loop: " << LOOP_COUNT << std::endl;
+	int          ret   = 0;
+	const double parse = Run("parse 200", ParseOk, http::OK, 0);
+	ret |= Run("parse 400 no host", ParseNoHost, http::BAD_REQUEST, parse) < 0;
+	ret |= Run("parse 400 (throw)", ParseNoHostThrow, http::BAD_REQUEST, parse) < 0;
+	ret |= Run("parse 400 version", ParseBadVersion, http::BAD_REQUEST, parse) < 0;
+	const double route = Run("route 200", RouteOk, http::OK, 0);
+	ret |= Run("route 404", RouteNotFound, http::NOT_FOUND, route) < 0;
+	ret |= Run("route 404 (throw)", RouteNotFoundThrow, http::NOT_FOUND, route) < 0;
+	ret |= parse < 0 || route < 0;
+
+	delete virtual_servers.front();
+	return ret;
+}
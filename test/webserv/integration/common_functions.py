@@ -1,4 +1,5 @@
 import os
+import re
 import subprocess
 import time
 
@@ -32,7 +33,23 @@ def delete_file(file_path):
         raise AssertionError
 
 
+# dateは送られた時刻で変わるので、IMF-fixdateの形であることを確かめて取り除く
+DATE_HEADER_LINE = (
+    r"\r\ndate: (Mon|Tue|Wed|Thu|Fri|Sat|Sun), \d{2} "
+    r"(Jan|Feb|Mar|Apr|May|Jun|Jul|Aug|Sep|Oct|Nov|Dec) \d{4} \d{2}:\d{2}:\d{2} GMT(?=\r\n)"
+)
+
+
+def remove_date_header(response):
+    if isinstance(response, bytes):
+        return re.sub(DATE_HEADER_LINE.encode(), b"", response)
+    if isinstance(response, str):
+        return re.sub(DATE_HEADER_LINE, "", response)
+    return response
+
+
 def assert_response(response, expected_response):
+    response = remove_date_header(response)
     assert (
         response == expected_response
     ), f"Expected response\n\n {repr(expected_response)}, but got\n\n {repr(response)}"
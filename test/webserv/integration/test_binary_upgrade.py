@@ -0,0 +1,117 @@
+import os
+import signal
+import socket
+import subprocess
+import tempfile
+import time
+import unittest
+from http import HTTPStatus
+from http.client import HTTPConnection
+
+from http_module.assert_http_response import assert_status_line
+
+PORT = 9210
+UPGRADE_TIMEOUT = 10  # 古いprocessが終了するまで待つ秒数
+
+CONFIG_FORMAT = """
+server {{
+	listen {port};
+	server_name localhost;
+
+	location / {{
+		alias /html/;
+		index index.html;
+	}}
+}}
+"""
+
+
+# configのpathが同じwebservのpid(新しいbinaryも同じargvで起動される)
+def find_webserv_pids(config_path: str) -> list:
+    pids = []
+    for pid in os.listdir("/proc"):
+        if not pid.isdigit():
+            continue
+        try:
+            with open(f"/proc/{pid}/cmdline", "rb") as f:
+                cmdline = f.read().split(b"\0")
+        except OSError:
+            continue
+        if len(cmdline) > 1 and cmdline[1] == config_path.encode():
+            pids.append(int(pid))
+    return pids
+
+
+# SIGUSR2で新しいbinaryにlisten socketを引き継ぐテスト(専用のサーバーを起動する)
+class TestBinaryUpgrade(unittest.TestCase):
+    def setUp(self):
+        fd, self.config_path = tempfile.mkstemp(suffix=".conf")
+        with os.fdopen(fd, "w") as f:
+            f.write(CONFIG_FORMAT.format(port=PORT))
+        self.process = subprocess.Popen(
+            ["./webserv", self.config_path],
+            stdout=subprocess.DEVNULL,
+            stderr=subprocess.DEVNULL,
+        )
+        time.sleep(1)  # サーバーが起動するのを待つ
+
+    def tearDown(self):
+        # 新しいbinaryはこのprocessの子ではないのでpidを探して止める
+        for pid in find_webserv_pids(self.config_path):
+            if pid != self.process.pid:
+                os.kill(pid, signal.SIGTERM)
+        self.process.terminate()
+        try:
+            self.process.wait(timeout=5)
+        except subprocess.TimeoutExpired:
+            self.process.kill()
+            self.process.wait()
+        os.remove(self.config_path)
+
+    def assert_get_ok(self, con: HTTPConnection) -> None:
+        con.request("GET", "/")
+        response = con.getresponse()
+        assert_status_line(response, HTTPStatus.OK)
+        response.read()
+
+    def test_upgrade_keeps_port_and_old_process_exits(self):
+        old_pid = self.process.pid
+        self.assert_get_ok(HTTPConnection("localhost", PORT))
+
+        self.process.send_signal(signal.SIGUSR2)
+        # 引き継いでいる間も接続を断らない
+        deadline = time.time() + UPGRADE_TIMEOUT
+        while self.process.poll() is None and time.time() < deadline:
+            self.assert_get_ok(HTTPConnection("localhost", PORT))
+            time.sleep(0.1)
+
+        # 古いprocessはgraceful shutdownして正常終了する
+        self.assertEqual(self.process.wait(timeout=1), 0)
+        new_pids = find_webserv_pids(self.config_path)
+        self.assertEqual(len(new_pids), 1)
+        self.assertNotEqual(new_pids[0], old_pid)
+        self.assert_get_ok(HTTPConnection("localhost", PORT))
+
+    def test_upgrade_finishes_request_in_progress(self):
+        # 引き継ぐ前に受け取り始めたrequestは古いprocessがresponseを返してから閉じる
+        sock = socket.create_connection(("127.0.0.1", PORT))
+        sock.sendall(b"GET / HTTP/1.1\r\nHost: localhost\r\n")
+        time.sleep(0.5)
+
+        self.process.send_signal(signal.SIGUSR2)
+        time.sleep(1)  # 新しいbinaryが起動するのを待つ
+        sock.sendall(b"\r\n")
+        response = b""
+        while True:
+            data = sock.recv(1024)
+            if not data:
+                break
+            response += data
+        sock.close()
+        self.assertTrue(response.startswith(b"HTTP/1.1 200 OK\r\n"))
+        self.assertIn(b"\r\nconnection: close\r\n", response)
+        self.assertEqual(self.process.wait(timeout=UPGRADE_TIMEOUT), 0)
+        self.assert_get_ok(HTTPConnection("localhost", PORT))
+
+if __name__ == "__main__":
+    unittest.main()
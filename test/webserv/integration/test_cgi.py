@@ -1,4 +1,5 @@
 import unittest
+from concurrent.futures import ThreadPoolExecutor
 from http import HTTPStatus
 from http.client import HTTPConnection, HTTPException, HTTPResponse
 
@@ -366,3 +367,59 @@ class TestCGI(unittest.TestCase):
             self.assertEqual(response.read().decode(), "")
         except HTTPException as e:
             self.fail(f"Request failed: {e}")
+
+    def test_cgi_cache_valid(self):
+        try:
+            # cgi_cache_validがあるlocationは2回目以降CGIを実行せずにcacheを返す
+            self.con.request("GET", "/cgi-bin/cache/print_pid.pl")
+            response = self.con.getresponse()
+            assert_status_line(response, HTTPStatus.OK)
+            first_body = response.read().decode()
+
+            self.con.request("GET", "/cgi-bin/cache/print_pid.pl")
+            response = self.con.getresponse()
+            assert_status_line(response, HTTPStatus.OK)
+            assert_header(response, "Connection", "keep-alive")
+            self.assertEqual(response.read().decode(), first_body)
+
+            # queryが違う場合は別のcache
+            self.con.request("GET", "/cgi-bin/cache/print_pid.pl?cache=1")
+            response = self.con.getresponse()
+            assert_status_line(response, HTTPStatus.OK)
+            self.assertNotEqual(response.read().decode(), first_body)
+        except HTTPException as e:
+            self.fail(f"Request failed: {e}")
+
+    def test_cgi_cache_no_store(self):
+        try:
+            # Cache-Control: no-storeの場合は毎回CGIを実行する
+            self.con.request("GET", "/cgi-bin/cache/print_pid_no_store.pl")
+            response = self.con.getresponse()
+            assert_status_line(response, HTTPStatus.OK)
+            first_body = response.read().decode()
+
+            self.con.request("GET", "/cgi-bin/cache/print_pid_no_store.pl")
+            response = self.con.getresponse()
+            assert_status_line(response, HTTPStatus.OK)
+            self.assertNotEqual(response.read().decode(), first_body)
+        except HTTPException as e:
+            self.fail(f"Request failed: {e}")
+
+    def test_cgi_request_collapsing(self):
+        # CGIの実行中に来た同じGETは1つのCGIにまとめられ、同じresponseが返る
+        def request_sleep_print_pid(_: int) -> str:
+            con = HTTPConnection("localhost", SERVER_PORT)
+            try:
+                con.request("GET", "/cgi-bin/cache/sleep_print_pid.pl?collapse=1")
+                response = con.getresponse()
+                assert_status_line(response, HTTPStatus.OK)
+                return response.read().decode()
+            finally:
+                con.close()
+
+        try:
+            with ThreadPoolExecutor(max_workers=5) as executor:
+                bodies = list(executor.map(request_sleep_print_pid, range(5)))
+            self.assertEqual(len(set(bodies)), 1)
+        except HTTPException as e:
+            self.fail(f"Request failed: {e}")
@@ -0,0 +1,136 @@
+import os
+import resource
+import socket
+import subprocess
+import tempfile
+import time
+import unittest
+from http import HTTPStatus
+from http.client import HTTPConnection
+
+from http_module.assert_http_response import assert_status_line
+
+PORT = 9230
+BODY_SIZE = 7900000  # client_max_body_size以下
+MEMORY_MARGIN = 4 * 1024 * 1024  # 起動後のメモリに足す分(BODY_SIZEのrequestは受け取れない)
+
+CONFIG_FORMAT = """
+server {{
+	listen {port};
+	server_name localhost;
+	client_max_body_size 8000000;
+
+	location / {{
+		alias /html/;
+		index index.html;
+	}}
+
+	location /upload {{
+		upload_dir /upload;
+		allowed_methods GET POST DELETE;
+	}}
+}}
+"""
+
+
+def get_vm_size(pid: int) -> int:
+    with open(f"/proc/{pid}/status") as f:
+        for line in f:
+            if line.startswith("VmSize:"):
+                return int(line.split()[1]) * 1024
+    raise RuntimeError("VmSize not found")
+
+
+def count_fds(pid: int) -> int:
+    return len(os.listdir(f"/proc/{pid}/fd"))
+
+
+# 1つのclientの処理で起きたexceptionがそのclientだけで済むかのテスト(専用のサーバーを起動する)
+class TestClientFailure(unittest.TestCase):
+    def setUp(self):
+        fd, self.config_path = tempfile.mkstemp(suffix=".conf")
+        with os.fdopen(fd, "w") as f:
+            f.write(CONFIG_FORMAT.format(port=PORT))
+        self.log = tempfile.TemporaryFile()
+        self.process = subprocess.Popen(
+            ["./webserv", self.config_path],
+            stdout=subprocess.DEVNULL,
+            stderr=self.log,
+        )
+        time.sleep(1)  # サーバーが起動するのを待つ
+
+    def tearDown(self):
+        self.process.terminate()
+        try:
+            self.process.wait(timeout=5)
+        except subprocess.TimeoutExpired:
+            self.process.kill()
+            self.process.wait()
+        self.log.close()
+        os.remove(self.config_path)
+        if os.path.exists("root/upload/failure"):
+            os.remove("root/upload/failure")
+
+    def read_log(self) -> str:
+        self.log.seek(0)
+        return self.log.read().decode(errors="replace")
+
+    def assert_get_ok(self, con: HTTPConnection) -> None:
+        con.request("GET", "/")
+        response = con.getresponse()
+        assert_status_line(response, HTTPStatus.OK)
+        response.read()
+
+    def send_large_request(self) -> bytes:
+        sock = socket.create_connection(("127.0.0.1", PORT))
+        sock.sendall(
+            b"POST /upload/failure HTTP/1.1\r\nHost: localhost\r\n"
+            b"Content-Type: text/plain\r\n"
+            b"Content-Length: " + str(BODY_SIZE).encode() + b"\r\n\r\n"
+        )
+        response = b""
+        try:
+            chunk = b"a" * (1 << 20)
+            sent = 0
+            while sent < BODY_SIZE:
+                sock.sendall(chunk[: BODY_SIZE - sent])
+                sent += len(chunk)
+            sock.settimeout(5)
+            while True:
+                data = sock.recv(1024)
+                if not data:
+                    break
+                response += data
+        except OSError:
+            # 500を返して閉じた後に送った分でresetされることがある
+            pass
+        sock.close()
+        return response
+
+    def test_failed_client_does_not_affect_others(self):
+        other = HTTPConnection("localhost", PORT)
+        self.assert_get_ok(other)
+        fd_count = count_fds(self.process.pid)
+
+        # bodyを受け取る途中でstd::bad_allocになるようにメモリを制限する
+        limit = get_vm_size(self.process.pid) + MEMORY_MARGIN
+        resource.prlimit(self.process.pid, resource.RLIMIT_AS, (limit, limit))
+        response = self.send_large_request()
+        if response:
+            self.assertTrue(response.startswith(b"HTTP/1.1 500 Internal Server Error\r\n"))
+            self.assertIn(b"\r\nconnection: close\r\n", response)
+        self.assertIn("bad_alloc", self.read_log())
+
+        # serverは続き、失敗したclientのfdは閉じている
+        time.sleep(0.5)
+        self.assertIsNone(self.process.poll())
+        self.assertEqual(count_fds(self.process.pid), fd_count)
+
+        # 接続済みのclientも新しいclientも続けて使える
+        self.assert_get_ok(other)
+        other.close()
+        self.assert_get_ok(HTTPConnection("localhost", PORT))
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -160,3 +160,93 @@ class TestConnectionUseSocket(unittest.TestCase):
             raise AssertionError
         finally:
             delete_file(UPLOAD_FILE_PATH)
+
+    # Expect: 100-continueにはbodyを送る前に100 Continueが返ってくる
+    def test_06_expect_100_continue(self) -> None:
+        UPLOAD_FILE_PATH = "root/upload/expect_request_file"
+        delete_file(UPLOAD_FILE_PATH)
+
+        try:
+            self.con.sock.send(
+                b"POST /upload/expect_request_file HTTP/1.1\r\n"
+                b"Host: localhost\r\n"
+                b"Connection: close\r\n"
+                b"Content-Type: text/plain\r\n"
+                b"Content-Length: 9\r\n"
+                b"Expect: 100-continue\r\n\r\n"
+            )
+            self.con.sock.settimeout(TIMEOUT)
+            interim = self.con.sock.recv(BUFFER_SIZE)
+            assert interim == b"HTTP/1.1 100 Continue\r\n\r\n"
+
+            self.con.sock.send(b"Wikipedia")
+            response = receive_with_timeout(self.con.sock)
+            if response is None:
+                raise AssertionError
+            assert response.startswith("HTTP/1.1 201 Created\r\n")
+            assert_file_content(UPLOAD_FILE_PATH, "Wikipedia")
+
+        except HTTPException as e:
+            print(f"Request failed: {e}")
+            raise AssertionError
+        finally:
+            delete_file(UPLOAD_FILE_PATH)
+
+    # bodyを送らなくてもheaderだけでclient_max_body_sizeを超えると分かれば413
+    def test_07_early_payload_too_large(self) -> None:
+        requests = [
+            b"Content-Length: 2097153\r\nExpect: 100-continue\r\n\r\n",
+            b"Content-Length: 2097153\r\n\r\n",
+            # chunk-sizeの行だけで判定する(0x200001 = 2097153)
+            b"Transfer-Encoding: chunked\r\n\r\n200001\r\n",
+        ]
+        for headers in requests:
+            with self.subTest(headers=headers):
+                sock = socket.create_connection(("localhost", SERVER_PORT))
+                sock.send(
+                    b"POST /upload/too_large_file HTTP/1.1\r\n"
+                    b"Host: localhost\r\n"
+                    b"Content-Type: text/plain\r\n" + headers
+                )
+                response = receive_with_timeout(sock)
+                sock.close()
+                if response is None:
+                    raise AssertionError
+                assert response.startswith("HTTP/1.1 413 Payload Too Large\r\n")
+
+    # 100-continue以外のExpectには417
+    def test_08_expectation_failed(self) -> None:
+        self.con.sock.send(
+            b"POST /upload/expect_request_file HTTP/1.1\r\n"
+            b"Host: localhost\r\n"
+            b"Content-Type: text/plain\r\n"
+            b"Content-Length: 9\r\n"
+            b"Expect: something\r\n\r\n"
+        )
+        response = receive_with_timeout(self.con.sock)
+        if response is None:
+            raise AssertionError
+        assert response.startswith("HTTP/1.1 417 Expectation Failed\r\n")
+
+    # large_client_header_buffers(default 4 8192), max_header_fields(default 100)を超えると414, 431
+    def test_09_header_limits(self) -> None:
+        requests = [
+            (b"GET /" + b"a" * 8192 + b" HTTP/1.1\r\n", "414 URI Too Long"),
+            (
+                b"GET / HTTP/1.1\r\nHost: localhost\r\nX-Long: " + b"a" * 8192,
+                "431 Request Header Fields Too Large",
+            ),
+            (
+                b"GET / HTTP/1.1\r\nHost: localhost\r\n" + b"X-Field: a\r\n" * 100,
+                "431 Request Header Fields Too Large",
+            ),
+        ]
+        for request, status in requests:
+            with self.subTest(status=status):
+                sock = socket.create_connection(("localhost", SERVER_PORT))
+                sock.send(request)
+                response = receive_with_timeout(sock)
+                sock.close()
+                if response is None:
+                    raise AssertionError
+                assert response.startswith(f"HTTP/1.1 {status}\r\n")
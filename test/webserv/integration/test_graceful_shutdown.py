@@ -0,0 +1,107 @@
+import os
+import signal
+import socket
+import subprocess
+import tempfile
+import time
+import unittest
+
+PORT = 9220
+SHUTDOWN_TIMEOUT = 3  # configのshutdown_timeout
+EXIT_MARGIN = 2  # shutdown_timeoutを過ぎてからprocessが終了するまでの猶予
+
+CONFIG_FORMAT = """
+shutdown_timeout {shutdown_timeout};
+
+server {{
+	listen {port};
+	server_name localhost;
+
+	location / {{
+		alias /html/;
+		index index.html;
+	}}
+}}
+"""
+
+
+def is_port_open(port: int) -> bool:
+    try:
+        with socket.create_connection(("127.0.0.1", port), timeout=1):
+            return True
+    except OSError:
+        return False
+
+
+def receive_all(sock: socket.socket) -> bytes:
+    response = b""
+    while True:
+        data = sock.recv(1024)
+        if not data:
+            break
+        response += data
+    return response
+
+
+# SIGTERM, SIGQUITで処理中のrequestを返し終えてから終了するテスト(専用のサーバーを起動する)
+class TestGracefulShutdown(unittest.TestCase):
+    def setUp(self):
+        fd, self.config_path = tempfile.mkstemp(suffix=".conf")
+        with os.fdopen(fd, "w") as f:
+            f.write(CONFIG_FORMAT.format(port=PORT, shutdown_timeout=SHUTDOWN_TIMEOUT))
+        self.process = subprocess.Popen(
+            ["./webserv", self.config_path],
+            stdout=subprocess.DEVNULL,
+            stderr=subprocess.DEVNULL,
+        )
+        time.sleep(1)  # サーバーが起動するのを待つ
+
+    def tearDown(self):
+        if self.process.poll() is None:
+            self.process.kill()
+            self.process.wait()
+        os.remove(self.config_path)
+
+    def assert_drain_request_in_progress(self, sig: signal.Signals) -> None:
+        # signalの前に受け取り始めたrequestは最後まで受け取ってresponseを返す
+        sock = socket.create_connection(("127.0.0.1", PORT))
+        sock.sendall(b"GET / HTTP/1.1\r\nHost: localhost\r\n")
+        time.sleep(0.5)
+
+        self.process.send_signal(sig)
+        time.sleep(0.5)
+        start = time.time()
+        # 新しい接続は受けない
+        self.assertFalse(is_port_open(PORT))
+
+        sock.sendall(b"\r\n")
+        response = receive_all(sock)
+        sock.close()
+        self.assertTrue(response.startswith(b"HTTP/1.1 200 OK\r\n"))
+        self.assertIn(b"\r\nconnection: close\r\n", response)
+
+        # 返し終えたらshutdown_timeoutを待たずに終了する
+        self.assertEqual(self.process.wait(timeout=SHUTDOWN_TIMEOUT), 0)
+        self.assertLess(time.time() - start, SHUTDOWN_TIMEOUT)
+
+    def test_sigterm_drains_request_in_progress(self):
+        self.assert_drain_request_in_progress(signal.SIGTERM)
+
+    def test_sigquit_drains_request_in_progress(self):
+        self.assert_drain_request_in_progress(signal.SIGQUIT)
+
+    def test_shutdown_timeout_stops_waiting_for_client(self):
+        # requestを送り終えないclientがいてもshutdown_timeoutで終了する
+        sock = socket.create_connection(("127.0.0.1", PORT))
+        sock.sendall(b"GET / HTTP/1.1\r\nHost: localhost\r\n")
+        time.sleep(0.5)
+
+        self.process.send_signal(signal.SIGTERM)
+        time.sleep(0.5)
+        self.assertIsNone(self.process.poll())
+        self.assertEqual(self.process.wait(timeout=SHUTDOWN_TIMEOUT + EXIT_MARGIN), 0)
+        sock.close()
+
+
+if __name__ == "__main__":
+    unittest.main()
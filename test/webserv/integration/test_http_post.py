@@ -435,11 +435,6 @@ def test_post_upload_multi_file_responses(
             timeout_response,
             CHUNKED_FILE_PATH,
         ),
-        (
-            REQUEST_POST_4XX_DIR + "408_06_max_chunk_size_and_crlf.txt",
-            timeout_response,
-            CHUNKED_FILE_PATH,
-        ),
         (
             REQUEST_POST_4XX_DIR + "413_01_too_large_content_max_body_size.txt",
             payload_too_large_response,
@@ -455,6 +450,12 @@ def test_post_upload_multi_file_responses(
             payload_too_large_response,
             MULTIPART_FILE_PATH1,
         ),
+        (
+            # chunk-dataを待たずにchunk-sizeの行だけで413
+            REQUEST_POST_4XX_DIR + "413_04_max_chunk_size_and_crlf.txt",
+            payload_too_large_response,
+            CHUNKED_FILE_PATH,
+        ),
     ],
     ids=[
         "400_01_duplicate_content_length",
@@ -490,10 +491,10 @@ def test_post_upload_multi_file_responses(
         "408_03_incomplete_chunked_body",
         "408_04_incomplete_chunked_body_0_end",
         "408_05_incomplete_chunked_body_0crlf_end",
-        "408_06_max_chunk_size_and_crlf",
         "413_01_too_large_content_max_body_size",
         "413_02_too_large_unchunked_body_size.txt",
         "413_03_too_large_multipart_body_size",
+        "413_04_max_chunk_size_and_crlf",
     ],
 )
 def test_post_4xx_responses(
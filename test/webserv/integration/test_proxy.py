@@ -0,0 +1,215 @@
+import socket
+import subprocess
+import threading
+import time
+import unittest
+from http import HTTPStatus
+from http.client import HTTPConnection, HTTPException
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+from http_module.assert_http_response import assert_header, assert_status_line
+
+UPSTREAM_PORTS = [9101, 9102]  # configに依存
+LARGE_BODY_SIZE = 1024 * 1024
+
+
+# proxy_passの先として使うupstream server
+class UpstreamHandler(BaseHTTPRequestHandler):
+    protocol_version = "HTTP/1.1"
+
+    def log_message(self, format, *args):
+        pass
+
+    def send_body(self, body: bytes) -> None:
+        self.send_response(HTTPStatus.OK)
+        self.send_header("Content-Type", "text/plain")
+        self.send_header("Content-Length", str(len(body)))
+        # webservからupstreamへの接続を使い回しているかの確認用
+        self.send_header("X-Upstream", str(self.server.server_port))
+        self.send_header("X-Upstream-Peer", str(self.client_address[1]))
+        self.send_header("X-Forwarded-For", self.headers.get("X-Forwarded-For", ""))
+        # clientとwebservの間だけのheaderが届いていないかの確認用
+        self.send_header("X-Received-Hop", self.headers.get("X-Hop", ""))
+        if self.path.endswith("/hop"):
+            self.send_header("Connection", "X-Hop")
+            self.send_header("X-Hop", "upstream")
+        self.end_headers()
+        self.wfile.write(body)
+
+    def do_GET(self):
+        if self.path.endswith("/chunked"):
+            self.send_response(HTTPStatus.OK)
+            self.send_header("Transfer-Encoding", "chunked")
+            self.end_headers()
+            for chunk in [b"hello, ", b"chunked ", b"world"]:
+                self.wfile.write(b"%x\r\n%s\r\n" % (len(chunk), chunk))
+                self.wfile.flush()
+                time.sleep(0.1)
+            self.wfile.write(b"0\r\n\r\n")
+            return
+        if self.path.endswith("/interim"):
+            # 最終responseの前に1xxを送る
+            self.send_response_only(HTTPStatus.CONTINUE)
+            self.end_headers()
+            self.wfile.flush()
+        if self.path.endswith("/large"):
+            self.send_body(b"a" * LARGE_BODY_SIZE)
+            return
+        self.send_body(f"{self.command} {self.path}".encode())
+
+    def do_POST(self):
+        length = int(self.headers.get("Content-Length", "0"))
+        self.send_body(self.rfile.read(length))
+
+
+# config/proxy_test.confを用いたテスト
+class TestProxy(unittest.TestCase):
+    @classmethod
+    def setUpClass(cls):
+        cls.upstreams = []
+        for port in UPSTREAM_PORTS:
+            upstream = ThreadingHTTPServer(("127.0.0.1", port), UpstreamHandler)
+            upstream.daemon_threads = True
+            threading.Thread(target=upstream.serve_forever, daemon=True).start()
+            cls.upstreams.append(upstream)
+        cls.process = subprocess.Popen(
+            ["./webserv", "config/proxy_test.conf"],
+            stdout=subprocess.DEVNULL,
+            stderr=subprocess.DEVNULL,
+        )
+        time.sleep(2)  # サーバーが起動するのを待つ
+
+    @classmethod
+    def tearDownClass(cls):
+        cls.process.terminate()
+        try:
+            cls.process.wait(timeout=5)
+        except subprocess.TimeoutExpired:
+            cls.process.kill()
+            cls.process.wait()
+        for upstream in cls.upstreams:
+            upstream.shutdown()
+            upstream.server_close()
+
+    def setUp(self):
+        self.con = HTTPConnection("localhost", 9100)  # configに依存
+
+    def tearDown(self):
+        self.con.close()
+
+    def request(self, method: str, target: str):
+        self.con.request(method, target)
+        return self.con.getresponse()
+
+    def test_get(self):
+        try:
+            response = self.request("GET", "/api/index?q=1")
+            assert_status_line(response, HTTPStatus.OK)
+            assert_header(response, "Connection", "keep-alive")
+            assert_header(response, "X-Forwarded-For", "127.0.0.1")
+            self.assertEqual(response.read(), b"GET /api/index?q=1")
+        except HTTPException as e:
+            self.fail(f"Request failed: {e}")
+
+    def test_post(self):
+        try:
+            self.con.request(
+                "POST",
+                "/api/echo",
+                body="This is a test payload",
+                headers={"Content-Type": "text/plain"},
+            )
+            response = self.con.getresponse()
+            assert_status_line(response, HTTPStatus.OK)
+            self.assertEqual(response.read(), b"This is a test payload")
+        except HTTPException as e:
+            self.fail(f"Request failed: {e}")
+
+    def test_connection_option_headers(self):
+        # Connectionに書かれたheaderはどちらの向きにも転送しない
+        try:
+            self.con.request(
+                "GET",
+                "/api/hop",
+                headers={"Connection": "keep-alive, X-Hop", "X-Hop": "client"},
+            )
+            response = self.con.getresponse()
+            assert_status_line(response, HTTPStatus.OK)
+            assert_header(response, "X-Received-Hop", "")
+            self.assertIsNone(response.getheader("X-Hop"))
+            response.read()
+        except HTTPException as e:
+            self.fail(f"Request failed: {e}")
+
+    def test_interim_response(self):
+        # upstreamの1xxは読み捨てて最終responseを返す
+        try:
+            response = self.request("GET", "/api/interim")
+            assert_status_line(response, HTTPStatus.OK)
+            self.assertEqual(response.read(), b"GET /api/interim")
+        except HTTPException as e:
+            self.fail(f"Request failed: {e}")
+
+    def test_chunked_response(self):
+        try:
+            response = self.request("GET", "/api/chunked")
+            assert_status_line(response, HTTPStatus.OK)
+            assert_header(response, "Transfer-Encoding", "chunked")
+            self.assertEqual(response.read(), b"hello, chunked world")
+        except HTTPException as e:
+            self.fail(f"Request failed: {e}")
+
+    def test_large_response_to_slow_client(self):
+        # clientが読まない間もwebservが止まらず、最後まで受け取れる
+        sock = socket.create_connection(("localhost", 9100))
+        sock.sendall(b"GET /api/large HTTP/1.1\r\nHost: localhost\r\n\r\n")
+        time.sleep(1)
+        other = self.request("GET", "/api/other")
+        assert_status_line(other, HTTPStatus.OK)
+        other.read()
+
+        sock.settimeout(5)
+        received = b""
+        while len(received.partition(b"\r\n\r\n")[2]) < LARGE_BODY_SIZE:
+            data = sock.recv(65536)
+            if not data:
+                break
+            received += data
+        sock.close()
+        header, _, body = received.partition(b"\r\n\r\n")
+        self.assertTrue(header.startswith(b"HTTP/1.1 200 OK"))
+        self.assertEqual(len(body), LARGE_BODY_SIZE)
+
+    def test_round_robin(self):
+        try:
+            upstreams = set()
+            for _ in range(len(UPSTREAM_PORTS)):
+                response = self.request("GET", "/api/round_robin")
+                assert_status_line(response, HTTPStatus.OK)
+                upstreams.add(int(response.getheader("X-Upstream")))
+                response.read()
+            self.assertEqual(upstreams, set(UPSTREAM_PORTS))
+        except HTTPException as e:
+            self.fail(f"Request failed: {e}")
+
+    def test_keep_alive_upstream(self):
+        try:
+            peers = []
+            for _ in range(2):
+                response = self.request("GET", "/least/keep_alive")
+                assert_status_line(response, HTTPStatus.OK)
+                assert_header(response, "X-Upstream", str(UPSTREAM_PORTS[0]))
+                peers.append(response.getheader("X-Upstream-Peer"))
+                response.read()
+            # 2回目はpoolに戻した接続を使い回す
+            self.assertEqual(peers[0], peers[1])
+        except HTTPException as e:
+            self.fail(f"Request failed: {e}")
+
+    def test_upstream_down(self):
+        try:
+            response = self.request("GET", "/down/")
+            assert_status_line(response, HTTPStatus.BAD_GATEWAY)
+            assert_header(response, "Connection", "close")
+        except HTTPException as e:
+            self.fail(f"Request failed: {e}")
@@ -0,0 +1,119 @@
+import os
+import signal
+import socket
+import subprocess
+import tempfile
+import time
+import unittest
+from http import HTTPStatus
+from http.client import HTTPConnection
+
+from http_module.assert_http_response import assert_status_line
+
+OLD_PORT = 9200  # 最初のconfigだけでlistenする
+NEW_PORT = 9201  # reload後のconfigだけでlistenする
+
+CONFIG_FORMAT = """
+server {{
+	listen {port};
+	server_name localhost;
+
+	location / {{
+		alias /html/;
+		index index.html;
+	}}
+}}
+"""
+
+
+def is_port_open(port: int, host: str = "127.0.0.1") -> bool:
+    try:
+        with socket.create_connection((host, port), timeout=1):
+            return True
+    except OSError:
+        return False
+
+
+# SIGHUPでconfigを読み直すテスト(テスト毎にconfigを書き換えるので専用のサーバーを起動する)
+class TestReload(unittest.TestCase):
+    def setUp(self):
+        fd, self.config_path = tempfile.mkstemp(suffix=".conf")
+        os.close(fd)
+        self.write_config(CONFIG_FORMAT.format(port=OLD_PORT))
+        self.process = subprocess.Popen(
+            ["./webserv", self.config_path],
+            stdout=subprocess.DEVNULL,
+            stderr=subprocess.DEVNULL,
+        )
+        time.sleep(1)  # サーバーが起動するのを待つ
+
+    def tearDown(self):
+        self.process.terminate()
+        try:
+            self.process.wait(timeout=5)
+        except subprocess.TimeoutExpired:
+            self.process.kill()
+            self.process.wait()
+        os.remove(self.config_path)
+
+    def write_config(self, config: str) -> None:
+        with open(self.config_path, "w") as f:
+            f.write(config)
+
+    def reload(self, config: str) -> None:
+        self.write_config(config)
+        self.process.send_signal(signal.SIGHUP)
+        time.sleep(1)  # 読み直すのを待つ
+
+    def assert_get_ok(self, con: HTTPConnection) -> None:
+        con.request("GET", "/")
+        response = con.getresponse()
+        assert_status_line(response, HTTPStatus.OK)
+        response.read()
+
+    def test_reload_opens_new_port_and_closes_removed_port(self):
+        self.assert_get_ok(HTTPConnection("localhost", OLD_PORT))
+        self.assertFalse(is_port_open(NEW_PORT))
+
+        self.reload(CONFIG_FORMAT.format(port=NEW_PORT))
+        self.assertIsNone(self.process.poll())
+        self.assert_get_ok(HTTPConnection("localhost", NEW_PORT))
+        self.assertFalse(is_port_open(OLD_PORT))
+
+    def test_reload_keeps_connected_client(self):
+        # reload前に接続したclientは閉じたportの接続でも前のconfigで続けられる
+        con = HTTPConnection("localhost", OLD_PORT)
+        self.assert_get_ok(con)
+
+        self.reload(CONFIG_FORMAT.format(port=NEW_PORT))
+        self.assert_get_ok(con)
+        con.close()
+
+    def test_reload_invalid_config_keeps_old_config(self):
+        self.reload("server {\n\tlisten 9201\n")
+        self.assertIsNone(self.process.poll())
+        self.assert_get_ok(HTTPConnection("localhost", OLD_PORT))
+        self.assertFalse(is_port_open(NEW_PORT))
+
+        # 直したconfigはもう一度SIGHUPすれば使われる
+        self.reload(CONFIG_FORMAT.format(port=NEW_PORT))
+        self.assert_get_ok(HTTPConnection("localhost", NEW_PORT))
+
+    def test_reload_changes_address_of_same_port(self):
+        # 0.0.0.0:portでlistenしている時は127.0.0.2でも接続できる
+        self.assertTrue(is_port_open(OLD_PORT, "127.0.0.2"))
+
+        # 同じportのaddressだけを変えても、前のsocketを閉じてlistenし直す
+        self.reload(CONFIG_FORMAT.format(port=f"127.0.0.1:{OLD_PORT}"))
+        self.assertIsNone(self.process.poll())
+        self.assert_get_ok(HTTPConnection("127.0.0.1", OLD_PORT))
+        self.assertFalse(is_port_open(OLD_PORT, "127.0.0.2"))
+
+        # 0.0.0.0:portに戻す
+        self.reload(CONFIG_FORMAT.format(port=OLD_PORT))
+        self.assert_get_ok(HTTPConnection("127.0.0.1", OLD_PORT))
+        self.assertTrue(is_port_open(OLD_PORT, "127.0.0.2"))
+
+
+if __name__ == "__main__":
+    unittest.main()
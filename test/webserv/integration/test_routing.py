@@ -89,7 +89,8 @@ class TestServerRouting(unittest.TestCase):
             assert_status_line_without_reason_phrase(
                 response, HTTPStatus.REQUEST_ENTITY_TOO_LARGE
             )
-            assert_header(response, "Connection", "keep-alive")
+            # bodyを読まずに返すので接続は切る
+            assert_header(response, "Connection", "close")
         except HTTPException as e:
             self.fail(f"Request failed: {e}")
 
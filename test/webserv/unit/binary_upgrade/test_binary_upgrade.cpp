@@ -0,0 +1,135 @@
+#include "binary_upgrade.hpp"
+#include "utils.hpp"
+#include <cstdlib>   // setenv,getenv,unsetenv
+#include <iostream>
+#include <sstream>   // ostringstream
+#include <stdexcept> // runtime_error
+#include <string>
+
+using namespace server;
+
+// ==================== Test汎用 ==================== //
+namespace {
+
+int GetTestCaseNum() {
+	static int test_case_num = 0;
+	++test_case_num;
+	return test_case_num;
+}
+
+void PrintOk() {
+	std::cout << utils::color::GREEN << GetTestCaseNum() << ".[OK]" << utils::color::RESET
+			  << std::endl;
+}
+
+void PrintNg() {
+	std::cerr << utils::color::RED << GetTestCaseNum() << ".[NG] " << utils::color::RESET
+			  << std::endl;
+}
+
+template <typename T>
+int HandleResult(const T &result, const T &expected) {
+	if (result == expected) {
+		PrintOk();
+		return EXIT_SUCCESS;
+	}
+	PrintNg();
+	std::cerr << "result  : " << result << std::endl;
+	std::cerr << "expected: " << expected << std::endl;
+	return EXIT_FAILURE;
+}
+
+// {5, 6} -> "5,6"
+std::string ToString(const BinaryUpgrade::FdList &fds) {
+	std::ostringstream oss;
+	typedef BinaryUpgrade::FdList::const_iterator Itr;
+	for (Itr it = fds.begin(); it != fds.end(); ++it) {
+		if (it != fds.begin()) {
+			oss << ",";
+		}
+		oss << *it;
+	}
+	return oss.str();
+}
+
+bool IsEnvExist(const char *name) {
+	return std::getenv(name) != NULL;
+}
+
+// 変換できない時はthrowする
+bool IsConvertError(const std::string &str) {
+	try {
+		BinaryUpgrade::ConvertToFd(str);
+		return false;
+	} catch (const std::runtime_error &e) {
+		return true;
+	}
+}
+
+// 引き継ぐlisten fdを環境変数で渡された時と同じ状態にしてから取り出す
+std::string TakeInheritedFds(const std::string &listen_fds) {
+	setenv(BinaryUpgrade::ENV_LISTEN_FDS, listen_fds.c_str(), 1);
+	setenv(BinaryUpgrade::ENV_OLD_PID, "1", 1);
+	try {
+		return ToString(BinaryUpgrade::TakeInheritedFds());
+	} catch (const std::runtime_error &e) {
+		return "error";
+	}
+}
+
+} // namespace
+
+// ================================================= //
+
+int TestConvertToFd() {
+	int ret = EXIT_SUCCESS;
+
+	// 1-3. 0以上int以下の10進数
+	ret |= HandleResult(BinaryUpgrade::ConvertToFd("0"), 0);
+	ret |= HandleResult(BinaryUpgrade::ConvertToFd("5"), 5);
+	ret |= HandleResult(BinaryUpgrade::ConvertToFd("2147483647"), 2147483647);
+
+	// 4-10. 数字以外を含む、負の数、intを超える
+	ret |= HandleResult(IsConvertError(""), true);
+	ret |= HandleResult(IsConvertError("abc"), true);
+	ret |= HandleResult(IsConvertError("5a"), true);
+	ret |= HandleResult(IsConvertError(" 5"), true);
+	ret |= HandleResult(IsConvertError("-1"), true);
+	ret |= HandleResult(IsConvertError("2147483648"), true);
+	ret |= HandleResult(IsConvertError("4294967296"), true);
+	return ret;
+}
+
+int TestTakeInheritedFds() {
+	int ret = EXIT_SUCCESS;
+
+	// 1. 古いprocessから起動されていない時は何も引き継がない
+	unsetenv(BinaryUpgrade::ENV_LISTEN_FDS);
+	ret |= HandleResult(ToString(BinaryUpgrade::TakeInheritedFds()), std::string());
+
+	// 2-4. ";"区切りのfdを順に取り出し、環境変数は消す
+	ret |= HandleResult(TakeInheritedFds("5;6"), std::string("5,6"));
+	ret |= HandleResult(IsEnvExist(BinaryUpgrade::ENV_LISTEN_FDS), false);
+	ret |= HandleResult(IsEnvExist(BinaryUpgrade::ENV_OLD_PID), false);
+
+	// 5-7. 空の要素は無視する
+	ret |= HandleResult(TakeInheritedFds("7"), std::string("7"));
+	ret |= HandleResult(TakeInheritedFds("7;;8;"), std::string("7,8"));
+	ret |= HandleResult(TakeInheritedFds(""), std::string());
+
+	// 8-11. 不正なfdがあればthrowし、次に作り直した時に使わないよう環境変数は消えている
+	ret |= HandleResult(TakeInheritedFds("5;x"), std::string("error"));
+	ret |= HandleResult(IsEnvExist(BinaryUpgrade::ENV_LISTEN_FDS), false);
+	ret |= HandleResult(IsEnvExist(BinaryUpgrade::ENV_OLD_PID), false);
+	ret |= HandleResult(TakeInheritedFds("-1"), std::string("error"));
+	return ret;
+}
+
+int main() {
+	int ret = EXIT_SUCCESS;
+
+	ret |= TestConvertToFd();
+	ret |= TestTakeInheritedFds();
+
+	return ret;
+}
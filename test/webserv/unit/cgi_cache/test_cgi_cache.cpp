@@ -0,0 +1,171 @@
+#include "cgi_cache.hpp"
+#include "http_message.hpp"
+#include "result.hpp"
+#include "utils.hpp"
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <string>
+
+using namespace http;
+
+// ==================== Test汎用 ==================== //
+namespace {
+
+int GetTestCaseNum() {
+	static int test_case_num = 0;
+	++test_case_num;
+	return test_case_num;
+}
+
+void PrintOk() {
+	std::cout << utils::color::GREEN << GetTestCaseNum() << ".[OK]" << utils::color::RESET
+			  << std::endl;
+}
+
+void PrintNg() {
+	std::cerr << utils::color::RED << GetTestCaseNum() << ".[NG] " << utils::color::RESET
+			  << std::endl;
+}
+
+template <typename T>
+int HandleResult(const T &result, const T &expected) {
+	if (result == expected) {
+		PrintOk();
+		return EXIT_SUCCESS;
+	}
+	PrintNg();
+	std::cerr << "result  : " << result << std::endl;
+	std::cerr << "expected: " << expected << std::endl;
+	return EXIT_FAILURE;
+}
+
+} // namespace
+
+// ================================================= //
+
+typedef CgiCache::ParsedData      ParsedData;
+typedef CgiCache::CgiHeaderFields CgiHeaderFields;
+
+ParsedData CreateParsedData(const std::string &body) {
+	ParsedData data;
+	data.header_fields[CONTENT_TYPE] = TEXT_PLAIN;
+	data.body                        = body;
+	return data;
+}
+
+// cache-control: の値だけ変えたheader_fieldsを作る
+CgiHeaderFields CreateCacheControl(const std::string &cache_control) {
+	CgiHeaderFields header_fields;
+	header_fields[CONTENT_TYPE]  = TEXT_PLAIN;
+	header_fields[CACHE_CONTROL] = cache_control;
+	return header_fields;
+}
+
+int TestGetAndSet() {
+	int               ret = EXIT_SUCCESS;
+	CgiCache          cache(1024);
+	const std::time_t now = 100;
+
+	// 1. 何も入っていない
+	ret |= HandleResult(cache.Get("/cgi-bin/a.pl", now).IsOk(), false);
+
+	// 2-3. 入れたら取れる
+	cache.Set("/cgi-bin/a.pl", CreateParsedData("aaa"), 10, now);
+	const CgiCache::GetResult result = cache.Get("/cgi-bin/a.pl", now + 9);
+	ret |= HandleResult(result.IsOk(), true);
+	ret |= HandleResult(result.GetValue().body, std::string("aaa"));
+
+	// 4. queryが違うものは別のkey
+	ret |= HandleResult(cache.Get("/cgi-bin/a.pl?x=1", now).IsOk(), false);
+
+	// 5-6. ttlを過ぎたら取れないし、sizeも減る
+	ret |= HandleResult(cache.Get("/cgi-bin/a.pl", now + 10).IsOk(), false);
+	ret |= HandleResult(cache.GetSize(), static_cast<std::size_t>(0));
+
+	// 7. ttl 0は保持しない
+	cache.Set("/cgi-bin/a.pl", CreateParsedData("aaa"), 0, now);
+	ret |= HandleResult(cache.Get("/cgi-bin/a.pl", now).IsOk(), false);
+
+	// 8. 同じkeyは上書き
+	cache.Set("/cgi-bin/a.pl", CreateParsedData("aaa"), 10, now);
+	cache.Set("/cgi-bin/a.pl", CreateParsedData("bbb"), 10, now);
+	ret |= HandleResult(cache.Get("/cgi-bin/a.pl", now).GetValue().body, std::string("bbb"));
+	return ret;
+}
+
+int TestEvict() {
+	int               ret = EXIT_SUCCESS;
+	const std::time_t now = 100;
+	// 1 entry: key(2) + body(100) + "content-type"(12) + "text/plain"(10) = 124
+	CgiCache cache(124 * 2);
+
+	cache.Set("/a", CreateParsedData(std::string(100, 'a')), 10, now);
+	cache.Set("/b", CreateParsedData(std::string(100, 'b')), 10, now);
+	// 1. 上限ちょうどまでは入る
+	ret |= HandleResult(cache.GetSize(), static_cast<std::size_t>(124 * 2));
+
+	// 2-4. /aを使ったので/bが一番古い -> /cを入れると/bが消える
+	cache.Get("/a", now);
+	cache.Set("/c", CreateParsedData(std::string(100, 'c')), 10, now);
+	ret |= HandleResult(cache.Get("/a", now).IsOk(), true);
+	ret |= HandleResult(cache.Get("/b", now).IsOk(), false);
+	ret |= HandleResult(cache.Get("/c", now).IsOk(), true);
+
+	// 5-6. 上限より大きいものは入れない(既存のものも消さない)
+	cache.Set("/d", CreateParsedData(std::string(1000, 'd')), 10, now);
+	ret |= HandleResult(cache.Get("/d", now).IsOk(), false);
+	ret |= HandleResult(cache.Get("/a", now).IsOk(), true);
+
+	// 7. Clear
+	cache.Clear();
+	ret |= HandleResult(cache.GetSize(), static_cast<std::size_t>(0));
+	return ret;
+}
+
+int TestGetTtl() {
+	int ret = EXIT_SUCCESS;
+
+	// 1-2. Cache-Controlがない -> locationのcgi_cache_valid
+	CgiHeaderFields no_cache_control;
+	ret |= HandleResult(CgiCache::GetTtl(no_cache_control, 0).IsOk(), false);
+	ret |= HandleResult(CgiCache::GetTtl(no_cache_control, 5).GetValue(), 5u);
+
+	// 3-4. max-ageはcgi_cache_validより優先
+	ret |= HandleResult(CgiCache::GetTtl(CreateCacheControl("max-age=60"), 5).GetValue(), 60u);
+	ret |= HandleResult(
+		CgiCache::GetTtl(CreateCacheControl("public,  max-age=30"), 0).GetValue(), 30u
+	);
+
+	// 5. s-maxageはmax-ageより優先
+	ret |= HandleResult(
+		CgiCache::GetTtl(CreateCacheControl("max-age=60, s-maxage=10"), 0).GetValue(), 10u
+	);
+
+	// 6-9. 保持しない
+	ret |= HandleResult(CgiCache::GetTtl(CreateCacheControl("no-store"), 5).IsOk(), false);
+	ret |= HandleResult(
+		CgiCache::GetTtl(CreateCacheControl("max-age=60, no-cache"), 5).IsOk(), false
+	);
+	ret |= HandleResult(CgiCache::GetTtl(CreateCacheControl("private"), 5).IsOk(), false);
+	ret |= HandleResult(CgiCache::GetTtl(CreateCacheControl("max-age=0"), 5).IsOk(), false);
+
+	// 10. max-ageが数字でない場合はcgi_cache_valid
+	ret |= HandleResult(CgiCache::GetTtl(CreateCacheControl("max-age=aa"), 5).GetValue(), 5u);
+
+	// 11. Set-Cookieがあるものは保持しない
+	CgiHeaderFields set_cookie = CreateCacheControl("max-age=60");
+	set_cookie[SET_COOKIE]     = "id=1";
+	ret |= HandleResult(CgiCache::GetTtl(set_cookie, 5).IsOk(), false);
+	return ret;
+}
+
+int main() {
+	int ret = EXIT_SUCCESS;
+
+	ret |= TestGetAndSet();
+	ret |= TestEvict();
+	ret |= TestGetTtl();
+
+	return ret;
+}
@@ -405,6 +405,139 @@ int RunTest6() {
 	return ret_code;
 }
 
+// -----------------------------------------------------------------------------
+// CgiManager classの主なテスト対象関数
+// - SetCollapseKey()
+// - AddWaiter()
+// - HandOverCgi()
+// - DeleteWaiter()
+// - PopCollapse()
+// -----------------------------------------------------------------------------
+int RunTest7() {
+	int ret_code = EXIT_SUCCESS;
+
+	const int leader_fd = 10;
+
+	// 最低限のCgiRequest準備
+	CgiRequest cgi_request;
+	cgi_request.meta_variables[REQUEST_METHOD] = "GET";
+	cgi_request.meta_variables[SCRIPT_NAME]    = PATH_DIR_CGI_BIN + "/test.sh";
+
+	// leaderのcgiを実行してkeyを登録
+	CgiManager                    cgi_manager;
+	const CgiManager::CollapseKey key(NULL, "/cgi-bin/test.sh?a=1");
+	cgi_manager.AddNewCgi(leader_fd, cgi_request);
+	cgi_manager.RunCgi(leader_fd);
+	cgi_manager.SetCollapseKey(leader_fd, key);
+
+	// 同じkeyはwaiterになり、違うkeyはwaiterにならない
+	ret_code |= Test(Result(cgi_manager.AddWaiter(key, 11, cgi_request), "AddWaiter same key")
+	); // Test18
+	ret_code |= Test(Result(
+		!cgi_manager.AddWaiter(CgiManager::CollapseKey(NULL, "/cgi-bin/test.sh"), 12, cgi_request),
+		"AddWaiter different key"
+	)); // Test19
+	ret_code |= Test(RunIsCgiExist(cgi_manager, 11, false)); // Test20
+
+	// leaderが切断されたら先頭のwaiterにcgiを引き継ぐ
+	const GetFdResult hand_over_result = cgi_manager.HandOverCgi(leader_fd);
+	ret_code |= Test(Result(
+		hand_over_result.IsOk() && hand_over_result.GetValue() == 11, "HandOverCgi"
+	)); // Test21
+	ret_code |= Test(RunIsCgiExist(cgi_manager, leader_fd, false)); // Test22
+	const GetFdResult read_fd_result = cgi_manager.GetReadFd(11);
+	if (read_fd_result.IsOk()) {
+		// pipe_fdも新しいleaderに紐づく
+		ret_code |= Test(IsSameClientFd(cgi_manager, read_fd_result.GetValue(), 11)); // Test23
+	} else {
+		ret_code |= Test(Result(false, "read pipe_fd was not handed over"));
+	}
+
+	// 切断されたwaiterは待ちリストから外れる
+	cgi_manager.AddWaiter(key, 12, cgi_request);
+	cgi_manager.AddWaiter(key, 13, cgi_request);
+	cgi_manager.DeleteWaiter(12);
+	ret_code |= Test(Result(!cgi_manager.IsWaiter(12), "DeleteWaiter")); // Test24
+
+	// cgiが終わったら残りのwaiterを取り出し、keyも解放される
+	const CgiManager::Collapse collapse = cgi_manager.PopCollapse(11);
+	ret_code |= Test(Result(
+		collapse.key == key && collapse.waiters.size() == 1 &&
+			collapse.waiters.front().client_fd == 13 && !cgi_manager.IsWaiter(13),
+		"PopCollapse"
+	)); // Test25
+	cgi_manager.DeleteCgi(11);
+	ret_code |= Test(Result(!cgi_manager.AddWaiter(key, 14, cgi_request), "AddWaiter after delete")
+	); // Test26
+
+	return ret_code;
+}
+
+// -----------------------------------------------------------------------------
+// CgiManager classの主なテスト対象関数
+// - PromoteWaiter()
+// -----------------------------------------------------------------------------
+int RunTest8() {
+	int ret_code = EXIT_SUCCESS;
+
+	const int leader_fd = 10;
+
+	// 最低限のCgiRequest準備
+	CgiRequest cgi_request;
+	cgi_request.meta_variables[REQUEST_METHOD] = "GET";
+	cgi_request.meta_variables[SCRIPT_NAME]    = PATH_DIR_CGI_BIN + "/test.sh";
+
+	// leaderのcgiに3つのwaiter
+	CgiManager                    cgi_manager;
+	const CgiManager::CollapseKey key(NULL, "/cgi-bin/test.sh?a=1");
+	cgi_manager.AddNewCgi(leader_fd, cgi_request);
+	cgi_manager.RunCgi(leader_fd);
+	cgi_manager.SetCollapseKey(leader_fd, key);
+	cgi_manager.AddWaiter(key, 11, cgi_request);
+	cgi_manager.AddWaiter(key, 12, cgi_request);
+	cgi_manager.AddWaiter(key, 13, cgi_request);
+
+	// leaderがtimeoutしたらcgiを止め、先頭のwaiterだけを新しいleaderにする
+	const CgiManager::Collapse collapse = cgi_manager.PopCollapse(leader_fd);
+	cgi_manager.DeleteCgi(leader_fd);
+	const GetFdResult promote_result = cgi_manager.PromoteWaiter(collapse);
+	ret_code |= Test(Result(
+		promote_result.IsOk() && promote_result.GetValue() == 11, "PromoteWaiter"
+	)); // Test27
+	ret_code |= Test(RunIsCgiExist(cgi_manager, 11, true));  // Test28
+	ret_code |= Test(RunIsCgiExist(cgi_manager, 12, false)); // Test29
+	ret_code |= Test(RunIsCgiExist(cgi_manager, 13, false)); // Test30
+
+	// 残りのwaiterは新しいleaderを待ち、同じkeyのrequestも新しいleaderを待つ
+	ret_code |= Test(Result(
+		!cgi_manager.IsWaiter(11) && cgi_manager.IsWaiter(12) && cgi_manager.IsWaiter(13),
+		"waiters of the new leader"
+	)); // Test31
+	ret_code |= Test(Result(cgi_manager.AddWaiter(key, 14, cgi_request), "AddWaiter to new leader")
+	); // Test32
+	const CgiManager::Collapse new_collapse = cgi_manager.PopCollapse(11);
+	ret_code |= Test(Result(
+		new_collapse.key == key && new_collapse.waiters.size() == 3 &&
+			new_collapse.waiters.front().client_fd == 12,
+		"PopCollapse of the new leader"
+	)); // Test33
+
+	// 同じkeyのcgiを既に実行し直していれば、waiterはそのcgiを待つ
+	cgi_manager.SetCollapseKey(11, key);
+	const GetFdResult wait_result = cgi_manager.PromoteWaiter(new_collapse);
+	ret_code |= Test(Result(
+		!wait_result.IsOk() && cgi_manager.IsWaiter(12) && !cgi_manager.IsCgiExist(12),
+		"PromoteWaiter while the key is running"
+	)); // Test34
+	cgi_manager.DeleteCgi(11);
+
+	// waiterがいなければ新しいleaderはいない
+	const GetFdResult empty_result = cgi_manager.PromoteWaiter(CgiManager::Collapse());
+	ret_code |= Test(Result(!empty_result.IsOk(), "PromoteWaiter without waiters")); // Test35
+
+	return ret_code;
+}
+
 } // namespace
 
 int main() {
@@ -416,6 +549,8 @@ int main() {
 	ret_code |= RunTest4();
 	ret_code |= RunTest5();
 	ret_code |= RunTest6();
+	ret_code |= RunTest7();
+	ret_code |= RunTest8();
 
 	return ret_code;
 }
@@ -73,8 +73,14 @@ int Test1() {
 	std::string client_ip     = "127.0.0.2";
 	std::string server_name   = "host";
 
-	cgi::CgiRequest cgi_request =
-		CgiParse::Parse(request, cgi_script + cgi_path_info, cgi_extension, server_port, client_ip);
+	cgi::CgiRequest cgi_request = CgiParse::Parse(
+		request,
+		cgi_script + cgi_path_info,
+		root_dir_path.length(),
+		cgi_extension,
+		server_port,
+		client_ip
+	);
 	cgi::MetaMap meta_variables = cgi_request.meta_variables;
 	try {
 		if (!request.body_message.empty()) {
@@ -122,8 +128,14 @@ int Test2() {
 	std::string client_ip     = "127.0.0.1";
 	std::string server_name   = "host";
 
-	cgi::CgiRequest cgi_request =
-		CgiParse::Parse(request, cgi_script + cgi_path_info, cgi_extension, server_port, client_ip);
+	cgi::CgiRequest cgi_request = CgiParse::Parse(
+		request,
+		cgi_script + cgi_path_info,
+		root_dir_path.length(),
+		cgi_extension,
+		server_port,
+		client_ip
+	);
 	cgi::MetaMap meta_variables = cgi_request.meta_variables;
 	try {
 		if (!request.body_message.empty()) {
@@ -153,6 +165,38 @@ int Test2() {
 	return EXIT_SUCCESS;
 }
 
+// 絶対pathのrootのテスト(rootの中の文字列はscriptやPATH_INFOの区切りに使わない)
+int RunAbsoluteRootTest(
+	const std::string &test_name,
+	const std::string &root,
+	const std::string &cgi_script,
+	const std::string &cgi_path_info
+) {
+	const RequestLine request_line = {"GET", "/", "HTTP/1.1"};
+	HttpRequestFormat request;
+	request.request_line        = request_line;
+	request.header_fields[HOST] = "host";
+
+	const cgi::CgiRequest cgi_request = CgiParse::Parse(
+		request, root + cgi_script + cgi_path_info, root.length(), ".pl", "8080", "127.0.0.1"
+	);
+	const cgi::MetaMap &meta_variables = cgi_request.meta_variables;
+	try {
+		COMPARE(meta_variables.at(cgi::SCRIPT_NAME), root + cgi_script);
+		COMPARE(meta_variables.at(cgi::PATH_INFO), cgi_path_info);
+		COMPARE(
+			meta_variables.at(cgi::PATH_TRANSLATED),
+			cgi_path_info.empty() ? std::string("") : root + cgi_path_info
+		);
+	} catch (const std::exception &e) {
+		PrintNg();
+		utils::Debug(test_name, e.what());
+		return EXIT_FAILURE;
+	}
+	PrintOk();
+	return EXIT_SUCCESS;
+}
+
 } // namespace
 
 int main() {
@@ -160,6 +204,12 @@ int main() {
 
 	ret |= Test1();
 	ret |= Test2();
+	// 3. rootが"root/cgi-bin/"を含まない
+	ret |= RunAbsoluteRootTest("Test3", "/tmp/t043/site", "/cgi-bin/print_ok.pl", "/aa/b");
+	// 4. rootの途中に"root/cgi-bin/"がある
+	ret |= RunAbsoluteRootTest("Test4", "/tmp/t043/docroot", "/cgi-bin/print_ok.pl", "/aa/b");
+	// 5. rootにcgi_extensionが含まれる
+	ret |= RunAbsoluteRootTest("Test5", "/srv/app.pl/www", "/cgi-bin/print_ok.pl", "");
 
 	return ret;
 }
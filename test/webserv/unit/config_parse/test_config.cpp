@@ -51,29 +51,65 @@ namespace config {
 namespace context {
 
 bool operator==(const LocationCon &lhs, const LocationCon &rhs) {
-	return lhs.request_uri == rhs.request_uri && lhs.alias == rhs.alias && lhs.index == rhs.index &&
+	return lhs.request_uri == rhs.request_uri && lhs.root == rhs.root && lhs.alias == rhs.alias &&
+		   lhs.index == rhs.index &&
 		   lhs.autoindex == rhs.autoindex && lhs.allowed_methods == rhs.allowed_methods &&
 		   lhs.redirect == rhs.redirect && lhs.cgi_extension == rhs.cgi_extension &&
-		   lhs.upload_directory == rhs.upload_directory;
+		   lhs.upload_directory == rhs.upload_directory &&
+		   lhs.cgi_cache_valid == rhs.cgi_cache_valid && lhs.proxy_pass == rhs.proxy_pass &&
+		   lhs.proxy_balance == rhs.proxy_balance &&
+		   lhs.client_body_timeout == rhs.client_body_timeout &&
+		   lhs.keepalive_timeout == rhs.keepalive_timeout &&
+		   lhs.send_timeout == rhs.send_timeout &&
+		   lhs.keepalive_requests == rhs.keepalive_requests;
 }
 
 bool operator!=(const LocationCon &lhs, const LocationCon &rhs) {
-	return lhs.request_uri != rhs.request_uri || lhs.alias != rhs.alias || lhs.index != rhs.index ||
+	return lhs.request_uri != rhs.request_uri || lhs.root != rhs.root || lhs.alias != rhs.alias ||
+		   lhs.index != rhs.index ||
 		   lhs.autoindex != rhs.autoindex || lhs.allowed_methods != rhs.allowed_methods ||
 		   lhs.redirect != rhs.redirect || lhs.cgi_extension != rhs.cgi_extension ||
-		   lhs.upload_directory != rhs.upload_directory;
+		   lhs.upload_directory != rhs.upload_directory ||
+		   lhs.cgi_cache_valid != rhs.cgi_cache_valid || lhs.proxy_pass != rhs.proxy_pass ||
+		   lhs.proxy_balance != rhs.proxy_balance ||
+		   lhs.client_body_timeout != rhs.client_body_timeout ||
+		   lhs.keepalive_timeout != rhs.keepalive_timeout ||
+		   lhs.send_timeout != rhs.send_timeout ||
+		   lhs.keepalive_requests != rhs.keepalive_requests;
 }
 
 bool operator==(const ServerCon &lhs, const ServerCon &rhs) {
 	return lhs.host_ports == rhs.host_ports && lhs.server_names == rhs.server_names &&
 		   lhs.location_con == rhs.location_con &&
-		   lhs.client_max_body_size == rhs.client_max_body_size && lhs.error_page == rhs.error_page;
+		   lhs.client_max_body_size == rhs.client_max_body_size && lhs.error_page == rhs.error_page &&
+		   lhs.cgi_cache_size == rhs.cgi_cache_size &&
+		   lhs.large_client_header_buffers == rhs.large_client_header_buffers &&
+		   lhs.max_header_fields == rhs.max_header_fields && lhs.root == rhs.root &&
+		   lhs.types == rhs.types && lhs.client_header_timeout == rhs.client_header_timeout &&
+		   lhs.client_body_timeout == rhs.client_body_timeout &&
+		   lhs.keepalive_timeout == rhs.keepalive_timeout &&
+		   lhs.send_timeout == rhs.send_timeout &&
+		   lhs.keepalive_requests == rhs.keepalive_requests &&
+		   lhs.client_min_rate == rhs.client_min_rate && lhs.send_min_rate == rhs.send_min_rate &&
+		   lhs.limit_conn_per_ip == rhs.limit_conn_per_ip &&
+		   lhs.shutdown_timeout == rhs.shutdown_timeout;
 }
 
 bool operator!=(const ServerCon &lhs, const ServerCon &rhs) {
 	return lhs.host_ports != rhs.host_ports || lhs.server_names != rhs.server_names ||
 		   lhs.location_con != rhs.location_con ||
-		   lhs.client_max_body_size != rhs.client_max_body_size || lhs.error_page != rhs.error_page;
+		   lhs.client_max_body_size != rhs.client_max_body_size || lhs.error_page != rhs.error_page ||
+		   lhs.cgi_cache_size != rhs.cgi_cache_size ||
+		   lhs.large_client_header_buffers != rhs.large_client_header_buffers ||
+		   lhs.max_header_fields != rhs.max_header_fields || lhs.root != rhs.root ||
+		   lhs.types != rhs.types || lhs.client_header_timeout != rhs.client_header_timeout ||
+		   lhs.client_body_timeout != rhs.client_body_timeout ||
+		   lhs.keepalive_timeout != rhs.keepalive_timeout ||
+		   lhs.send_timeout != rhs.send_timeout ||
+		   lhs.keepalive_requests != rhs.keepalive_requests ||
+		   lhs.client_min_rate != rhs.client_min_rate || lhs.send_min_rate != rhs.send_min_rate ||
+		   lhs.limit_conn_per_ip != rhs.limit_conn_per_ip ||
+		   lhs.shutdown_timeout != rhs.shutdown_timeout;
 }
 
 } // namespace context
@@ -468,6 +504,228 @@ ServerList MakeExpectedTest9() {
 	return expected_result;
 }
 
+/* Test10 CGI Cache Directives (cgi_cache_size, cgi_cache_valid) */
+ServerList MakeExpectedTest10() {
+	ServerList                                        expected_result;
+	std::list< std::pair<std::string, unsigned int> > expected_ports_1;
+	expected_ports_1.push_back(std::make_pair("0.0.0.0", 8080));
+	std::list<std::string> server_names_1;
+	server_names_1.push_back("localhost");
+	LocationList                         expected_locationlist_1;
+	std::list<std::string>               allowed_methods_1;
+	std::pair<unsigned int, std::string> redirect_1;
+	context::LocationCon                 expected_location_1_1 =
+		BuildLocationCon("/cgi-bin/", "", "", false, allowed_methods_1, redirect_1);
+	expected_location_1_1.cgi_extension   = ".pl";
+	expected_location_1_1.cgi_cache_valid = 10;
+	expected_locationlist_1.push_back(expected_location_1_1);
+	std::pair<unsigned int, std::string> error_page_1;
+	context::ServerCon                   expected_server_1 = BuildServerCon(
+        expected_ports_1, server_names_1, expected_locationlist_1, 1024 * 1024, error_page_1
+    );
+	expected_server_1.cgi_cache_size = 2048;
+	expected_result.push_back(expected_server_1);
+
+	return expected_result;
+}
+
+/* Test11 Proxy Directives (proxy_pass, proxy_balance) */
+ServerList MakeExpectedTest11() {
+	ServerList                                        expected_result;
+	std::list< std::pair<std::string, unsigned int> > expected_ports_1;
+	expected_ports_1.push_back(std::make_pair("0.0.0.0", 8080));
+	std::list<std::string> server_names_1;
+	server_names_1.push_back("localhost");
+	LocationList                         expected_locationlist_1;
+	std::list<std::string>               allowed_methods_1;
+	std::pair<unsigned int, std::string> redirect_1;
+	context::LocationCon                 expected_location_1_1 =
+		BuildLocationCon("/api/", "", "", false, allowed_methods_1, redirect_1);
+	expected_location_1_1.proxy_pass.push_back(std::make_pair("localhost", 3000));
+	expected_location_1_1.proxy_pass.push_back(std::make_pair("127.0.0.1", 3001));
+	expected_location_1_1.proxy_balance = "least_conn";
+	expected_locationlist_1.push_back(expected_location_1_1);
+	std::pair<unsigned int, std::string> error_page_1;
+	context::ServerCon                   expected_server_1 = BuildServerCon(
+        expected_ports_1, server_names_1, expected_locationlist_1, 1024 * 1024, error_page_1
+    );
+	expected_result.push_back(expected_server_1);
+
+	return expected_result;
+}
+
+/* Test12 Header Limit Directives (large_client_header_buffers, max_header_fields) */
+ServerList MakeExpectedTest12() {
+	ServerList                                        expected_result;
+	std::list< std::pair<std::string, unsigned int> > expected_ports_1;
+	expected_ports_1.push_back(std::make_pair("0.0.0.0", 8080));
+	std::list<std::string> server_names_1;
+	server_names_1.push_back("localhost");
+	LocationList                         expected_locationlist_1;
+	std::list<std::string>               allowed_methods_1;
+	std::pair<unsigned int, std::string> redirect_1;
+	context::LocationCon                 expected_location_1_1 =
+		BuildLocationCon("/", "/html/", "", false, allowed_methods_1, redirect_1);
+	expected_locationlist_1.push_back(expected_location_1_1);
+	std::pair<unsigned int, std::string> error_page_1;
+	context::ServerCon                   expected_server_1 = BuildServerCon(
+        expected_ports_1, server_names_1, expected_locationlist_1, 1024 * 1024, error_page_1
+    );
+	expected_server_1.large_client_header_buffers = std::make_pair(2, 1024);
+	expected_server_1.max_header_fields           = 10;
+	expected_result.push_back(expected_server_1);
+
+	return expected_result;
+}
+
+/* Test13 root Directive (server, location) */
+ServerList MakeExpectedTest13() {
+	ServerList                                        expected_result;
+	std::list< std::pair<std::string, unsigned int> > expected_ports_1;
+	expected_ports_1.push_back(std::make_pair("0.0.0.0", 8080));
+	std::list<std::string> server_names_1;
+	server_names_1.push_back("localhost");
+	LocationList                         expected_locationlist_1;
+	std::list<std::string>               allowed_methods_1;
+	std::pair<unsigned int, std::string> redirect_1;
+	context::LocationCon                 expected_location_1_1 =
+		BuildLocationCon("/", "/html/", "", false, allowed_methods_1, redirect_1);
+	context::LocationCon expected_location_1_2 =
+		BuildLocationCon("/static/", "", "", false, allowed_methods_1, redirect_1);
+	expected_location_1_2.root = "./static";
+	expected_locationlist_1.push_back(expected_location_1_1);
+	expected_locationlist_1.push_back(expected_location_1_2);
+	std::pair<unsigned int, std::string> error_page_1;
+	context::ServerCon                   expected_server_1 = BuildServerCon(
+        expected_ports_1, server_names_1, expected_locationlist_1, 1024 * 1024, error_page_1
+    );
+	expected_server_1.root = "/var/www";
+	expected_result.push_back(expected_server_1);
+
+	return expected_result;
+}
+
+/* Test14 types, include (serverの外のtypesはtypesの無いserverだけで使う) */
+ServerList MakeExpectedTest14() {
+	ServerList                                        expected_result;
+	std::list< std::pair<std::string, unsigned int> > expected_ports_1;
+	expected_ports_1.push_back(std::make_pair("0.0.0.0", 8080));
+	std::list< std::pair<std::string, unsigned int> > expected_ports_2;
+	expected_ports_2.push_back(std::make_pair("0.0.0.0", 8081));
+	std::list<std::string>               server_names;
+	LocationList                         expected_locationlist;
+	std::pair<unsigned int, std::string> error_page;
+	context::ServerCon                   expected_server_1 = BuildServerCon(
+        expected_ports_1, server_names, expected_locationlist, 1024 * 1024, error_page
+    );
+	expected_server_1.types["html"] = "text/html";
+	expected_server_1.types["png"]  = "image/png";
+	context::ServerCon expected_server_2 = BuildServerCon(
+		expected_ports_2, server_names, expected_locationlist, 1024 * 1024, error_page
+	);
+	expected_server_2.types["txt"]  = "text/plain";
+	expected_server_2.types["html"] = "text/html";
+	expected_server_2.types["htm"]  = "text/html";
+	expected_result.push_back(expected_server_1);
+	expected_result.push_back(expected_server_2);
+
+	return expected_result;
+}
+
+/* Test15 timeout, keepalive_requests (locationで書かなかったものは0のまま) */
+ServerList MakeExpectedTest15() {
+	ServerList                                        expected_result;
+	std::list< std::pair<std::string, unsigned int> > expected_ports_1;
+	expected_ports_1.push_back(std::make_pair("0.0.0.0", 8080));
+	std::list<std::string> server_names_1;
+	server_names_1.push_back("localhost");
+	LocationList                         expected_locationlist_1;
+	std::list<std::string>               allowed_methods_1;
+	std::pair<unsigned int, std::string> redirect_1;
+	context::LocationCon                 expected_location_1_1 =
+		BuildLocationCon("/", "/html/", "", false, allowed_methods_1, redirect_1);
+	context::LocationCon expected_location_1_2 =
+		BuildLocationCon("/upload/", "", "", false, allowed_methods_1, redirect_1);
+	expected_location_1_2.client_body_timeout = 120;
+	expected_location_1_2.send_timeout        = 90;
+	expected_location_1_2.keepalive_timeout   = 1;
+	expected_location_1_2.keepalive_requests  = 1;
+	expected_locationlist_1.push_back(expected_location_1_1);
+	expected_locationlist_1.push_back(expected_location_1_2);
+	std::pair<unsigned int, std::string> error_page_1;
+	context::ServerCon                   expected_server_1 = BuildServerCon(
+        expected_ports_1, server_names_1, expected_locationlist_1, 1024 * 1024, error_page_1
+    );
+	expected_server_1.client_header_timeout = 10;
+	expected_server_1.client_body_timeout   = 20;
+	expected_server_1.keepalive_timeout     = 5;
+	expected_server_1.send_timeout          = 30;
+	expected_server_1.keepalive_requests    = 50;
+	expected_result.push_back(expected_server_1);
+
+	return expected_result;
+}
+
+/* Test16 client_min_rate, send_min_rate, limit_conn_per_ip (書かなかったserverは0のまま) */
+ServerList MakeExpectedTest16() {
+	ServerList                                        expected_result;
+	std::list< std::pair<std::string, unsigned int> > expected_ports_1;
+	expected_ports_1.push_back(std::make_pair("0.0.0.0", 8080));
+	std::list< std::pair<std::string, unsigned int> > expected_ports_2;
+	expected_ports_2.push_back(std::make_pair("0.0.0.0", 8081));
+	std::list<std::string> server_names;
+	server_names.push_back("localhost");
+	LocationList                         expected_locationlist;
+	std::list<std::string>               allowed_methods;
+	std::pair<unsigned int, std::string> redirect;
+	expected_locationlist.push_back(
+		BuildLocationCon("/", "/html/", "", false, allowed_methods, redirect)
+	);
+	std::pair<unsigned int, std::string> error_page;
+	context::ServerCon                   expected_server_1 = BuildServerCon(
+        expected_ports_1, server_names, expected_locationlist, 1024 * 1024, error_page
+    );
+	expected_server_1.client_min_rate   = std::make_pair(1024, 10);
+	expected_server_1.send_min_rate     = std::make_pair(4096, 5);
+	expected_server_1.limit_conn_per_ip = 16;
+	expected_result.push_back(expected_server_1);
+	expected_result.push_back(BuildServerCon(
+		expected_ports_2, server_names, expected_locationlist, 1024 * 1024, error_page
+	));
+
+	return expected_result;
+}
+
+/* Test17 shutdown_timeout (serverの外に書き、前後どちらのserverにも入る) */
+ServerList MakeExpectedTest17() {
+	ServerList                                        expected_result;
+	std::list< std::pair<std::string, unsigned int> > expected_ports_1;
+	expected_ports_1.push_back(std::make_pair("0.0.0.0", 8080));
+	std::list< std::pair<std::string, unsigned int> > expected_ports_2;
+	expected_ports_2.push_back(std::make_pair("0.0.0.0", 8081));
+	std::list<std::string> server_names;
+	server_names.push_back("localhost");
+	LocationList                         expected_locationlist;
+	std::list<std::string>               allowed_methods;
+	std::pair<unsigned int, std::string> redirect;
+	expected_locationlist.push_back(
+		BuildLocationCon("/", "/html/", "", false, allowed_methods, redirect)
+	);
+	std::pair<unsigned int, std::string> error_page;
+	context::ServerCon                   expected_server_1 = BuildServerCon(
+        expected_ports_1, server_names, expected_locationlist, 1024 * 1024, error_page
+    );
+	expected_server_1.shutdown_timeout = 30;
+	expected_result.push_back(expected_server_1);
+	context::ServerCon expected_server_2 = BuildServerCon(
+		expected_ports_2, server_names, expected_locationlist, 1024 * 1024, error_page
+	);
+	expected_server_2.shutdown_timeout = 30;
+	expected_result.push_back(expected_server_2);
+
+	return expected_result;
+}
+
 /* For Server Context */
 int ServerDirectiveErrorTests() {
 	int ret_code = EXIT_SUCCESS;
@@ -664,6 +922,298 @@ int CgiExtensionDirectiveErrorTests() {
 	return ret_code;
 }
 
+int CgiCacheSizeDirectiveErrorTests() {
+	int ret_code = EXIT_SUCCESS;
+
+	PrintTest("cgi_cache_size");
+	ret_code |= RunErrorTest(
+		"cgi_cache_size/cgi_cache_size_no_param.conf", "cgi_cache_size/cgi_cache_size_no_param.conf"
+	);
+	ret_code |= RunErrorTest(
+		"cgi_cache_size/cgi_cache_size_duplicated.conf",
+		"cgi_cache_size/cgi_cache_size_duplicated.conf"
+	);
+	ret_code |= RunErrorTest(
+		"cgi_cache_size/cgi_cache_size_out_of_upper_range.conf",
+		"cgi_cache_size/cgi_cache_size_out_of_upper_range.conf"
+	);
+
+	return ret_code;
+}
+
+int LargeClientHeaderBuffersDirectiveErrorTests() {
+	int ret_code = EXIT_SUCCESS;
+
+	PrintTest("large_client_header_buffers");
+	ret_code |= RunErrorTest(
+		"large_client_header_buffers/large_client_header_buffers_no_size.conf",
+		"large_client_header_buffers/large_client_header_buffers_no_size.conf"
+	);
+	ret_code |= RunErrorTest(
+		"large_client_header_buffers/large_client_header_buffers_duplicated.conf",
+		"large_client_header_buffers/large_client_header_buffers_duplicated.conf"
+	);
+	ret_code |= RunErrorTest(
+		"large_client_header_buffers/large_client_header_buffers_zero_number.conf",
+		"large_client_header_buffers/large_client_header_buffers_zero_number.conf"
+	);
+	ret_code |= RunErrorTest(
+		"large_client_header_buffers/large_client_header_buffers_out_of_upper_range.conf",
+		"large_client_header_buffers/large_client_header_buffers_out_of_upper_range.conf"
+	);
+
+	return ret_code;
+}
+
+int MaxHeaderFieldsDirectiveErrorTests() {
+	int ret_code = EXIT_SUCCESS;
+
+	PrintTest("max_header_fields");
+	ret_code |= RunErrorTest(
+		"max_header_fields/max_header_fields_no_param.conf",
+		"max_header_fields/max_header_fields_no_param.conf"
+	);
+	ret_code |= RunErrorTest(
+		"max_header_fields/max_header_fields_duplicated.conf",
+		"max_header_fields/max_header_fields_duplicated.conf"
+	);
+	ret_code |= RunErrorTest(
+		"max_header_fields/max_header_fields_out_of_upper_range.conf",
+		"max_header_fields/max_header_fields_out_of_upper_range.conf"
+	);
+
+	return ret_code;
+}
+
+int RootDirectiveErrorTests() {
+	int ret_code = EXIT_SUCCESS;
+
+	PrintTest("root");
+	ret_code |= RunErrorTest("root/root_no_param.conf", "root/root_no_param.conf");
+	ret_code |= RunErrorTest("root/root_duplicated.conf", "root/root_duplicated.conf");
+	ret_code |= RunErrorTest(
+		"root/root_duplicated_in_location.conf", "root/root_duplicated_in_location.conf"
+	);
+
+	return ret_code;
+}
+
+int TypesDirectiveErrorTests() {
+	int ret_code = EXIT_SUCCESS;
+
+	PrintTest("types");
+	ret_code |= RunErrorTest("types/types_no_bracket.conf", "types/types_no_bracket.conf");
+	ret_code |= RunErrorTest("types/types_no_extension.conf", "types/types_no_extension.conf");
+	ret_code |= RunErrorTest("types/types_duplicated.conf", "types/types_duplicated.conf");
+	ret_code |= RunErrorTest("types/types_in_location.conf", "types/types_in_location.conf");
+
+	return ret_code;
+}
+
+int IncludeDirectiveErrorTests() {
+	int ret_code = EXIT_SUCCESS;
+
+	PrintTest("include");
+	ret_code |= RunErrorTest("include/include_no_param.conf", "include/include_no_param.conf");
+	ret_code |= RunErrorTest("include/include_not_found.conf", "include/include_not_found.conf");
+	ret_code |= RunErrorTest("include/include_self.conf", "include/include_self.conf");
+
+	return ret_code;
+}
+
+int TimeoutDirectiveErrorTests() {
+	int ret_code = EXIT_SUCCESS;
+
+	PrintTest("timeout");
+	ret_code |= RunErrorTest(
+		"client_header_timeout/client_header_timeout_no_param.conf",
+		"client_header_timeout/client_header_timeout_no_param.conf"
+	);
+	ret_code |= RunErrorTest(
+		"client_header_timeout/client_header_timeout_duplicated.conf",
+		"client_header_timeout/client_header_timeout_duplicated.conf"
+	);
+	ret_code |= RunErrorTest(
+		"client_header_timeout/client_header_timeout_in_location.conf",
+		"client_header_timeout/client_header_timeout_in_location.conf"
+	);
+	ret_code |= RunErrorTest(
+		"client_body_timeout/client_body_timeout_invalid.conf",
+		"client_body_timeout/client_body_timeout_invalid.conf"
+	);
+	ret_code |= RunErrorTest(
+		"client_body_timeout/client_body_timeout_duplicated_in_location.conf",
+		"client_body_timeout/client_body_timeout_duplicated_in_location.conf"
+	);
+	ret_code |= RunErrorTest(
+		"keepalive_timeout/keepalive_timeout_zero.conf",
+		"keepalive_timeout/keepalive_timeout_zero.conf"
+	);
+	ret_code |= RunErrorTest(
+		"keepalive_timeout/keepalive_timeout_out_of_upper_range.conf",
+		"keepalive_timeout/keepalive_timeout_out_of_upper_range.conf"
+	);
+	ret_code |= RunErrorTest(
+		"send_timeout/send_timeout_multi_params.conf", "send_timeout/send_timeout_multi_params.conf"
+	);
+
+	return ret_code;
+}
+
+int KeepaliveRequestsDirectiveErrorTests() {
+	int ret_code = EXIT_SUCCESS;
+
+	PrintTest("keepalive_requests");
+	ret_code |= RunErrorTest(
+		"keepalive_requests/keepalive_requests_invalid.conf",
+		"keepalive_requests/keepalive_requests_invalid.conf"
+	);
+	ret_code |= RunErrorTest(
+		"keepalive_requests/keepalive_requests_out_of_upper_range.conf",
+		"keepalive_requests/keepalive_requests_out_of_upper_range.conf"
+	);
+
+	return ret_code;
+}
+
+int MinRateDirectiveErrorTests() {
+	int ret_code = EXIT_SUCCESS;
+
+	PrintTest("client_min_rate, send_min_rate");
+	ret_code |= RunErrorTest(
+		"client_min_rate/client_min_rate_no_period.conf",
+		"client_min_rate/client_min_rate_no_period.conf"
+	);
+	ret_code |= RunErrorTest(
+		"client_min_rate/client_min_rate_invalid_bytes.conf",
+		"client_min_rate/client_min_rate_invalid_bytes.conf"
+	);
+	ret_code |= RunErrorTest(
+		"client_min_rate/client_min_rate_invalid_period.conf",
+		"client_min_rate/client_min_rate_invalid_period.conf"
+	);
+	ret_code |= RunErrorTest(
+		"client_min_rate/client_min_rate_duplicated.conf",
+		"client_min_rate/client_min_rate_duplicated.conf"
+	);
+	ret_code |= RunErrorTest(
+		"send_min_rate/send_min_rate_multi_params.conf",
+		"send_min_rate/send_min_rate_multi_params.conf"
+	);
+	ret_code |= RunErrorTest(
+		"send_min_rate/send_min_rate_out_of_upper_range.conf",
+		"send_min_rate/send_min_rate_out_of_upper_range.conf"
+	);
+
+	return ret_code;
+}
+
+int LimitConnPerIpDirectiveErrorTests() {
+	int ret_code = EXIT_SUCCESS;
+
+	PrintTest("limit_conn_per_ip");
+	ret_code |= RunErrorTest(
+		"limit_conn_per_ip/limit_conn_per_ip_invalid.conf",
+		"limit_conn_per_ip/limit_conn_per_ip_invalid.conf"
+	);
+	ret_code |= RunErrorTest(
+		"limit_conn_per_ip/limit_conn_per_ip_out_of_upper_range.conf",
+		"limit_conn_per_ip/limit_conn_per_ip_out_of_upper_range.conf"
+	);
+	ret_code |= RunErrorTest(
+		"limit_conn_per_ip/limit_conn_per_ip_duplicated.conf",
+		"limit_conn_per_ip/limit_conn_per_ip_duplicated.conf"
+	);
+
+	return ret_code;
+}
+
+int ShutdownTimeoutDirectiveErrorTests() {
+	int ret_code = EXIT_SUCCESS;
+
+	PrintTest("shutdown_timeout");
+	ret_code |= RunErrorTest(
+		"shutdown_timeout/shutdown_timeout_invalid.conf",
+		"shutdown_timeout/shutdown_timeout_invalid.conf"
+	);
+	ret_code |= RunErrorTest(
+		"shutdown_timeout/shutdown_timeout_duplicated.conf",
+		"shutdown_timeout/shutdown_timeout_duplicated.conf"
+	);
+	ret_code |= RunErrorTest(
+		"shutdown_timeout/shutdown_timeout_no_delimiter.conf",
+		"shutdown_timeout/shutdown_timeout_no_delimiter.conf"
+	);
+	ret_code |= RunErrorTest(
+		"shutdown_timeout/shutdown_timeout_in_server.conf",
+		"shutdown_timeout/shutdown_timeout_in_server.conf"
+	);
+
+	return ret_code;
+}
+
+int CgiCacheValidDirectiveErrorTests() {
+	int ret_code = EXIT_SUCCESS;
+
+	PrintTest("cgi_cache_valid");
+	ret_code |= RunErrorTest(
+		"cgi_cache_valid/cgi_cache_valid_no_param.conf",
+		"cgi_cache_valid/cgi_cache_valid_no_param.conf"
+	);
+	ret_code |= RunErrorTest(
+		"cgi_cache_valid/cgi_cache_valid_duplicated.conf",
+		"cgi_cache_valid/cgi_cache_valid_duplicated.conf"
+	);
+	ret_code |= RunErrorTest(
+		"cgi_cache_valid/cgi_cache_valid_invalid.conf",
+		"cgi_cache_valid/cgi_cache_valid_invalid.conf"
+	);
+
+	return ret_code;
+}
+
+int ProxyPassDirectiveErrorTests() {
+	int ret_code = EXIT_SUCCESS;
+
+	PrintTest("proxy_pass");
+	ret_code |= RunErrorTest(
+		"proxy_pass/proxy_pass_no_param.conf", "proxy_pass/proxy_pass_no_param.conf"
+	);
+	ret_code |= RunErrorTest(
+		"proxy_pass/proxy_pass_duplicated.conf", "proxy_pass/proxy_pass_duplicated.conf"
+	);
+	ret_code |= RunErrorTest(
+		"proxy_pass/proxy_pass_invalid_scheme.conf", "proxy_pass/proxy_pass_invalid_scheme.conf"
+	);
+	ret_code |= RunErrorTest(
+		"proxy_pass/proxy_pass_invalid_port.conf", "proxy_pass/proxy_pass_invalid_port.conf"
+	);
+	ret_code |= RunErrorTest(
+		"proxy_pass/proxy_pass_duplicated_upstream.conf",
+		"proxy_pass/proxy_pass_duplicated_upstream.conf"
+	);
+
+	return ret_code;
+}
+
+int ProxyBalanceDirectiveErrorTests() {
+	int ret_code = EXIT_SUCCESS;
+
+	PrintTest("proxy_balance");
+	ret_code |= RunErrorTest(
+		"proxy_balance/proxy_balance_no_param.conf", "proxy_balance/proxy_balance_no_param.conf"
+	);
+	ret_code |= RunErrorTest(
+		"proxy_balance/proxy_balance_duplicated.conf",
+		"proxy_balance/proxy_balance_duplicated.conf"
+	);
+	ret_code |= RunErrorTest(
+		"proxy_balance/proxy_balance_invalid.conf", "proxy_balance/proxy_balance_invalid.conf"
+	);
+
+	return ret_code;
+}
+
 int UploadDirectoryDirectiveErrorTests() {
 	int ret_code = EXIT_SUCCESS;
 
@@ -692,6 +1242,14 @@ int main() {
 	ret_code |= Test(Run("test7.conf", MakeExpectedTest7()), "test7.conf");
 	ret_code |= Test(Run("test8.conf", MakeExpectedTest8()), "test8.conf");
 	ret_code |= Test(Run("test9.conf", MakeExpectedTest9()), "test9.conf");
+	ret_code |= Test(Run("test10.conf", MakeExpectedTest10()), "test10.conf");
+	ret_code |= Test(Run("test11.conf", MakeExpectedTest11()), "test11.conf");
+	ret_code |= Test(Run("test12.conf", MakeExpectedTest12()), "test12.conf");
+	ret_code |= Test(Run("test13.conf", MakeExpectedTest13()), "test13.conf");
+	ret_code |= Test(Run("test14.conf", MakeExpectedTest14()), "test14.conf");
+	ret_code |= Test(Run("test15.conf", MakeExpectedTest15()), "test15.conf");
+	ret_code |= Test(Run("test16.conf", MakeExpectedTest16()), "test16.conf");
+	ret_code |= Test(Run("test17.conf", MakeExpectedTest17()), "test17.conf");
 
 	std::cout << std::endl;
 	std::cout << "Error Tests" << std::endl;
@@ -702,6 +1260,16 @@ int main() {
 	ret_code |= ServerNameDirectiveErrorTests();
 	ret_code |= ClientMaxBodySizeDirectiveErrorTests();
 	ret_code |= ErrorPageDirectiveErrorTests();
+	ret_code |= CgiCacheSizeDirectiveErrorTests();
+	ret_code |= LargeClientHeaderBuffersDirectiveErrorTests();
+	ret_code |= MaxHeaderFieldsDirectiveErrorTests();
+	ret_code |= RootDirectiveErrorTests();
+	ret_code |= TypesDirectiveErrorTests();
+	ret_code |= TimeoutDirectiveErrorTests();
+	ret_code |= KeepaliveRequestsDirectiveErrorTests();
+	ret_code |= MinRateDirectiveErrorTests();
+	ret_code |= LimitConnPerIpDirectiveErrorTests();
+	ret_code |= ShutdownTimeoutDirectiveErrorTests();
 	std::cout << std::endl;
 
 	/* Location Context Directive Tests */
@@ -713,9 +1281,13 @@ int main() {
 	ret_code |= ReturnDirectiveErrorTests();
 	ret_code |= CgiExtensionDirectiveErrorTests();
 	ret_code |= UploadDirectoryDirectiveErrorTests();
+	ret_code |= CgiCacheValidDirectiveErrorTests();
+	ret_code |= ProxyPassDirectiveErrorTests();
+	ret_code |= ProxyBalanceDirectiveErrorTests();
 	std::cout << std::endl;
 
 	/* Other Tests */
+	ret_code |= IncludeDirectiveErrorTests();
 	PrintTest("other");
 	ret_code |= RunErrorTest("empty_file.conf", "empty_file.conf");
 	ret_code |= RunErrorTest("empty_with_nl.conf", "empty_with_nl.conf");
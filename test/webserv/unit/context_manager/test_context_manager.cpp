@@ -0,0 +1,212 @@
+#include "client_info.hpp"
+#include "color.hpp"
+#include "context_manager.hpp"
+#include "virtual_server.hpp"
+#include <cstdlib>
+#include <iostream>
+#include <sstream>   // ostringstream
+#include <stdexcept> // logic_error
+#include <string>
+
+namespace {
+
+typedef server::ContextManager                ContextManager;
+typedef ContextManager::SnapshotId            SnapshotId;
+typedef ContextManager::SnapshotIdList        SnapshotIdList;
+typedef server::VirtualServer::ServerNameList ServerNameList;
+typedef server::VirtualServer::LocationList   LocationList;
+typedef server::VirtualServer::HostPortPair   HostPortPair;
+typedef server::VirtualServer::HostPortList   HostPortList;
+typedef server::VirtualServer::ErrorPage      ErrorPage;
+
+int GetTestCaseNum() {
+	static int test_case_num = 0;
+	++test_case_num;
+	return test_case_num;
+}
+
+void PrintOk() {
+	std::cout << utils::color::GREEN << GetTestCaseNum() << ".[OK]" << utils::color::RESET
+			  << std::endl;
+}
+
+void PrintNg() {
+	std::cerr << utils::color::RED << GetTestCaseNum() << ".[NG] " << utils::color::RESET
+			  << std::endl;
+}
+
+template <typename T>
+int HandleResult(const T &result, const T &expected) {
+	if (result == expected) {
+		PrintOk();
+		return EXIT_SUCCESS;
+	}
+	PrintNg();
+	std::cerr << "result  : " << result << std::endl;
+	std::cerr << "expected: " << expected << std::endl;
+	return EXIT_FAILURE;
+}
+
+// {0, 1} -> "0,1"
+std::string ToString(const SnapshotIdList &snapshot_ids) {
+	std::ostringstream oss;
+	typedef SnapshotIdList::const_iterator Itr;
+	for (Itr it = snapshot_ids.begin(); it != snapshot_ids.end(); ++it) {
+		if (it != snapshot_ids.begin()) {
+			oss << ",";
+		}
+		oss << *it;
+	}
+	return oss.str();
+}
+
+// server_nameで区別できるvirtual serverを最後に追加したsnapshotに登録する
+void AddVirtualServer(
+	ContextManager &context, const std::string &server_name, const HostPortPair &host_port
+) {
+	ServerNameList server_names;
+	server_names.push_back(server_name);
+	HostPortList host_ports;
+	host_ports.push_back(host_port);
+	const LocationList locations;
+	const ErrorPage    error_page = std::make_pair(404, "/error_page.html");
+
+	context.AddVirtualServer(
+		server::VirtualServer(server_names, locations, host_ports, 1024, error_page)
+	);
+	context.AddServerInfo(host_port);
+	context.AddMapping(host_port, &context.GetAllVirtualServer().back());
+}
+
+void AddClient(ContextManager &context, int client_fd, const HostPortPair &host_port) {
+	context.AddClientInfo(
+		server::ClientInfo(client_fd, "127.0.0.1", host_port.first, host_port.second)
+	);
+}
+
+// clientが使っているvirtual serverのserver_name
+std::string GetClientServerName(const ContextManager &context, int client_fd) {
+	return context.GetVirtualServerAddrList(client_fd).front()->GetServerNameList().front();
+}
+
+bool IsSnapshotExist(const ContextManager &context, SnapshotId snapshot_id) {
+	try {
+		context.GetAllVirtualServer(snapshot_id);
+		return true;
+	} catch (const std::logic_error &e) {
+		return false;
+	}
+}
+
+} // namespace
+
+// reloadの流れ: AddSnapshot -> virtual server追加 -> SetCurrentSnapshot -> 古いclientが切れたら削除
+int TestSnapshot() {
+	int                ret = EXIT_SUCCESS;
+	ContextManager     context;
+	const HostPortPair host_port = std::make_pair("127.0.0.1", 8080);
+
+	// 1. 最初のsnapshotだけの時は消すものがない
+	AddVirtualServer(context, "first", host_port);
+	ret |= HandleResult(ToString(context.GetUnusedSnapshots()), std::string());
+
+	// 2-4. 追加したsnapshotはSetCurrentSnapshot()するまで新しいclientに使わない
+	AddClient(context, 4, host_port);
+	const SnapshotId second = context.AddSnapshot();
+	ret |= HandleResult(second, 1u);
+	AddVirtualServer(context, "second", host_port);
+	AddClient(context, 5, host_port);
+	ret |= HandleResult(GetClientServerName(context, 5), std::string("first"));
+	ret |= HandleResult(ToString(context.GetUnusedSnapshots()), std::string());
+
+	// 5-7. 切り替えた後の新しいclientは新しいsnapshot、接続済みのclientは古いsnapshotのまま
+	context.SetCurrentSnapshot(second);
+	AddClient(context, 6, host_port);
+	ret |= HandleResult(GetClientServerName(context, 6), std::string("second"));
+	ret |= HandleResult(GetClientServerName(context, 4), std::string("first"));
+	ret |= HandleResult(ToString(context.GetUnusedSnapshots()), std::string());
+
+	// 8. 古いsnapshotを使うclientが1つでも残っている間は消さない
+	context.DeleteClientInfo(4);
+	ret |= HandleResult(ToString(context.GetUnusedSnapshots()), std::string());
+
+	// 9-10. 最後のclientが切れたら消せる
+	const SnapshotId third = context.AddSnapshot();
+	AddVirtualServer(context, "third", host_port);
+	context.SetCurrentSnapshot(third);
+	context.DeleteClientInfo(5);
+	ret |= HandleResult(ToString(context.GetUnusedSnapshots()), std::string("0"));
+	context.DeleteClientInfo(6);
+	ret |= HandleResult(ToString(context.GetUnusedSnapshots()), std::string("0,1"));
+
+	// 11-13. 削除したsnapshotは取得できない。今のsnapshotはclientがいなくても消さない
+	context.DeleteSnapshot(0);
+	context.DeleteSnapshot(second);
+	context.DeleteSnapshot(third);
+	ret |= HandleResult(IsSnapshotExist(context, 0), false);
+	ret |= HandleResult(IsSnapshotExist(context, third), true);
+	ret |= HandleResult(ToString(context.GetUnusedSnapshots()), std::string());
+	return ret;
+}
+
+// reloadに失敗した時は追加したsnapshotを消して今のsnapshotのまま続ける
+int TestSnapshotReloadFailed() {
+	int                ret = EXIT_SUCCESS;
+	ContextManager     context;
+	const HostPortPair host_port = std::make_pair("127.0.0.1", 8080);
+
+	AddVirtualServer(context, "first", host_port);
+	const SnapshotId failed = context.AddSnapshot();
+	AddVirtualServer(context, "failed", host_port);
+	context.DeleteSnapshot(failed);
+
+	// 1-3. 最後に追加したsnapshotが元に戻り、新しいclientも今のsnapshotを使う
+	ret |= HandleResult(IsSnapshotExist(context, failed), false);
+	ret |= HandleResult(
+		context.GetAllVirtualServer().front().GetServerNameList().front(), std::string("first")
+	);
+	AddClient(context, 4, host_port);
+	ret |= HandleResult(GetClientServerName(context, 4), std::string("first"));
+
+	// 4. 存在しないsnapshotには切り替えられない
+	try {
+		context.SetCurrentSnapshot(failed);
+		ret |= HandleResult(true, false);
+	} catch (const std::logic_error &e) {
+		ret |= HandleResult(true, true);
+	}
+
+	// 5. 次のreloadは消したsnapshotのidを使い直しても古いclientに影響しない
+	const SnapshotId next = context.AddSnapshot();
+	AddVirtualServer(context, "next", host_port);
+	context.SetCurrentSnapshot(next);
+	ret |= HandleResult(GetClientServerName(context, 4), std::string("first"));
+	return ret;
+}
+
+// reloadに失敗した時に消せるよう、新しく追加したServerInfoかを返す
+int TestAddServerInfo() {
+	int                ret = EXIT_SUCCESS;
+	ContextManager     context;
+	const HostPortPair host_port = std::make_pair("127.0.0.1", 8080);
+
+	// 1-2. 同じhost:portは1度だけ追加する
+	ret |= HandleResult(context.AddServerInfo(host_port), true);
+	ret |= HandleResult(context.AddServerInfo(host_port), false);
+
+	// 3-4. 消したhost:portはlistenしていない扱いになり、また追加できる
+	context.DeleteServerInfo(host_port);
+	ret |= HandleResult(context.GetListenSockFd(host_port), -1);
+	ret |= HandleResult(context.AddServerInfo(host_port), true);
+	return ret;
+}
+
+int main() {
+	int ret = EXIT_SUCCESS;
+
+	ret |= TestSnapshot();
+	ret |= TestSnapshotReloadFailed();
+	ret |= TestAddServerInfo();
+
+	return ret;
+}
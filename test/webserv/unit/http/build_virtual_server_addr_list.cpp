@@ -63,11 +63,17 @@ server {
 
 #include "http_message.hpp"
 #include "virtual_server.hpp"
-
-namespace server {
-
-typedef std::list<const VirtualServer *> VirtualServerAddrList;
-
+#include "virtual_server_addr_list.hpp"
+#include <climits> // PATH_MAX
+#include <cstdlib> // realpath
+
+// 起動時に解決するrootと同じく、repositoryのrootの絶対path
+std::string GetRootPath() {
+	char resolved_path[PATH_MAX];
+	if (realpath("../../../../root", resolved_path) == NULL) {
+		return "";
+	}
+	return resolved_path;
 }
 
 // Location構造体を作成する関数
@@ -83,6 +89,7 @@ server::Location BuildLocation(
 ) {
 	server::Location loc;
 	loc.request_uri      = request_uri;
+	loc.root             = GetRootPath();
 	loc.alias            = alias;
 	loc.index            = index;
 	loc.autoindex        = autoindex;
@@ -104,7 +111,7 @@ server::VirtualServer *BuildVirtualServer1() {
 
 	std::size_t client_max_body_size = 1024;
 
-	server::VirtualServer::ErrorPage error_page(404, "/error_pages/404.html");
+	server::VirtualServer::ErrorPage error_page(404, GetRootPath() + "/error_pages/404.html");
 
 	server::VirtualServer::LocationList locationlist;
 	// Location 1 - "/"
@@ -1,14 +1,7 @@
 #ifndef TEST_CASE_HPP_
 #define TEST_CASE_HPP_
 
-#include <list>
-
-namespace server {
-
-class VirtualServer;
-typedef std::list<const VirtualServer *> VirtualServerAddrList;
-
-} // namespace server
+#include "virtual_server_addr_list.hpp"
 
 namespace test {
 
@@ -81,10 +74,15 @@ int TestRequestTimeoutResponse();
 int TestInternalServerErrorResponse();
 
 // GetResponseFromCgi
-int TestGetResponseFromCgi1();
-int TestGetResponseFromCgi2();
-int TestGetResponseFromCgi3();
-int TestGetResponseFromCgi4();
+int TestGetResponseFromCgi1(const server::VirtualServerAddrList &server_infos);
+int TestGetResponseFromCgi2(const server::VirtualServerAddrList &server_infos);
+int TestGetResponseFromCgi3(const server::VirtualServerAddrList &server_infos);
+int TestGetResponseFromCgi4(const server::VirtualServerAddrList &server_infos);
+int TestGetResponseFromCgi5(const server::VirtualServerAddrList &server_infos);
+int TestGetResponseFromCgi6(const server::VirtualServerAddrList &server_infos);
+
+// DeleteClient
+int TestDeleteClient(const server::VirtualServerAddrList &server_infos);
 
 } // namespace test
 
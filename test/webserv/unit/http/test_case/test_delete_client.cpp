@@ -0,0 +1,79 @@
+#include "client_infos.hpp"
+#include "http.hpp"
+#include "http_message.hpp"
+#include "http_result.hpp"
+#include "test_expected_response.hpp"
+#include "test_handler.hpp"
+#include "test_request.hpp"
+#include "utils.hpp"
+#include <cstdlib>
+
+namespace test {
+namespace {
+
+template <typename T>
+int HandleDeleteClientResult(const T &result, const T &expected, int number) {
+	if (result == expected) {
+		std::cout << utils::color::GREEN << number << ".[OK]" << utils::color::RESET << std::endl;
+		return EXIT_SUCCESS;
+	}
+	std::cerr << "Error: DeleteClient" << std::endl;
+	std::cerr << utils::color::RED << number << ".[NG] " << utils::color::RESET << std::endl;
+	std::cerr << "result: [" << result << "]" << std::endl;
+	std::cerr << "expected: [" << expected << "]" << std::endl;
+	return EXIT_FAILURE;
+}
+
+http::ClientInfos CreateClientInfosWithFd(int fd, const std::string &request_buffer) {
+	http::ClientInfos client_infos = CreateClientInfos(request_buffer);
+	client_infos.fd                = fd;
+	return client_infos;
+}
+
+} // namespace
+
+// 処理に失敗したclientの途中のrequestだけが消え、他のclientはそのまま続けられる
+int TestDeleteClient(const server::VirtualServerAddrList &server_infos) {
+	int               ret_code     = EXIT_SUCCESS;
+	const std::string request      = request::GET_200_2_CONNECTION_KEEP;
+	const std::string request_line = request.substr(0, request.find(http::CRLF) + 2);
+	const std::string rest         = request.substr(request_line.size());
+
+	std::string  expected_body_message = LoadFileContent("../../../../root/html/index.html");
+	HeaderFields expected_header_fields;
+	expected_header_fields[http::CONNECTION]     = http::KEEP_ALIVE;
+	expected_header_fields[http::CONTENT_LENGTH] = utils::ToString(expected_body_message.length());
+	expected_header_fields[http::CONTENT_TYPE]   = http::TEXT_HTML;
+	expected_header_fields[http::SERVER]         = http::SERVER_VERSION;
+	const std::string expected_response          = CreateHttpResponseFormat(
+        EXPECTED_STATUS_LINE_OK, expected_header_fields, expected_body_message
+    );
+
+	http::Http http;
+	// 1-2. fd 3, 4ともrequest lineだけ届いた状態
+	http::HttpResult result = http.Run(CreateClientInfosWithFd(3, request_line), server_infos);
+	ret_code |= HandleDeleteClientResult(result.is_response_complete, false, 1);
+	result = http.Run(CreateClientInfosWithFd(4, request_line), server_infos);
+	ret_code |= HandleDeleteClientResult(result.is_response_complete, false, 2);
+
+	// 3. fd 3を捨てる。保存していないfdや2回目の削除でも投げない
+	try {
+		http.DeleteClient(3);
+		http.DeleteClient(3);
+		http.DeleteClient(100);
+		ret_code |= HandleDeleteClientResult(true, true, 3);
+	} catch (const std::exception &e) {
+		ret_code |= HandleDeleteClientResult(std::string(e.what()), std::string(), 3);
+	}
+
+	// 4. 同じ番号のfdの次の接続は前のrequest lineが残っていないので最初から読む
+	result = http.Run(CreateClientInfosWithFd(3, request), server_infos);
+	ret_code |= HandleDeleteClientResult(RemoveDateHeaderLine(result.response), expected_response, 4);
+
+	// 5. fd 4は続きを受け取ってresponseを返せる
+	result = http.Run(CreateClientInfosWithFd(4, rest), server_infos);
+	ret_code |= HandleDeleteClientResult(RemoveDateHeaderLine(result.response), expected_response, 5);
+	return ret_code;
+}
+
+} // namespace test
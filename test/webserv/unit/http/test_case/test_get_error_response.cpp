@@ -38,7 +38,7 @@ int TestRequestTimeoutResponse() {
 
 	http::Http       http;
 	http::HttpResult result = http.GetErrorResponse(client_infos.fd, http::TIMEOUT);
-	return HandleGetErrorResponseError(result.response, expected_response, 1);
+	return HandleGetErrorResponseError(RemoveDateHeaderLine(result.response), expected_response, 1);
 }
 
 int TestInternalServerErrorResponse() {
@@ -56,7 +56,7 @@ int TestInternalServerErrorResponse() {
 
 	http::Http       http;
 	http::HttpResult result = http.GetErrorResponse(client_infos.fd, http::INTERNAL_ERROR);
-	return HandleGetErrorResponseError(result.response, expected_response, 2);
+	return HandleGetErrorResponseError(RemoveDateHeaderLine(result.response), expected_response, 2);
 }
 
 } // namespace test
@@ -27,7 +27,7 @@ int HandleResult(const T &result, const T &expected, int number) {
 
 /* これらのテストではHttpStorageは未使用(Parseからの一連の流れは別のテストを作成) */
 // 正常なテスト
-int TestGetResponseFromCgi1() {
+int TestGetResponseFromCgi1(const server::VirtualServerAddrList &server_infos) {
 	const std::string &response =
 		"Content-Length: 12\r\nContent-Type: text/plain\r\n\r\nHello, world";
 	cgi::CgiResponse cgi_response(response, true);
@@ -43,12 +43,12 @@ int TestGetResponseFromCgi1() {
     );
 
 	http::Http       http;
-	http::HttpResult result = http.GetResponseFromCgi(1, cgi_response);
-	return HandleResult(result.response, expected_response, 1);
+	http::HttpResult result = http.GetResponseFromCgi(CreateClientInfos(""), server_infos, cgi_response);
+	return HandleResult(RemoveDateHeaderLine(result.response), expected_response, 1);
 }
 
 // Content-Lengthが無い場合 > ボディの長さをContent-Lengthに設定
-int TestGetResponseFromCgi2() {
+int TestGetResponseFromCgi2(const server::VirtualServerAddrList &server_infos) {
 	const std::string &response =
 		"Content-Type: text/html\r\n\r\n<!DOCTYPE "
 		"html><html><head><title>Test</title></head><body><h1>Test</h1></body></html>";
@@ -66,12 +66,12 @@ int TestGetResponseFromCgi2() {
     );
 
 	http::Http       http;
-	http::HttpResult result = http.GetResponseFromCgi(2, cgi_response);
-	return HandleResult(result.response, expected_response, 2);
+	http::HttpResult result = http.GetResponseFromCgi(CreateClientInfos(""), server_infos, cgi_response);
+	return HandleResult(RemoveDateHeaderLine(result.response), expected_response, 2);
 }
 
 // Content-Typeが無い場合 > application/octet-streamを設定
-int TestGetResponseFromCgi3() {
+int TestGetResponseFromCgi3(const server::VirtualServerAddrList &server_infos) {
 	const std::string &response = "Content-Length: 12\r\n\r\nHello, world";
 	cgi::CgiResponse   cgi_response(response, true);
 
@@ -86,12 +86,12 @@ int TestGetResponseFromCgi3() {
     );
 
 	http::Http       http;
-	http::HttpResult result = http.GetResponseFromCgi(3, cgi_response);
-	return HandleResult(result.response, expected_response, 3);
+	http::HttpResult result = http.GetResponseFromCgi(CreateClientInfos(""), server_infos, cgi_response);
+	return HandleResult(RemoveDateHeaderLine(result.response), expected_response, 3);
 }
 
 // Content-Lengthが出力より短い場合 > Content-Lengthの長さで切り捨て
-int TestGetResponseFromCgi4() {
+int TestGetResponseFromCgi4(const server::VirtualServerAddrList &server_infos) {
 	const std::string &response =
 		"Content-Length: 3\r\nContent-Type: text/plain\r\n\r\nHello, world";
 	cgi::CgiResponse cgi_response(response, true);
@@ -107,8 +107,71 @@ int TestGetResponseFromCgi4() {
     );
 
 	http::Http       http;
-	http::HttpResult result = http.GetResponseFromCgi(4, cgi_response);
-	return HandleResult(result.response, expected_response, 4);
+	http::HttpResult result = http.GetResponseFromCgi(CreateClientInfos(""), server_infos, cgi_response);
+	return HandleResult(RemoveDateHeaderLine(result.response), expected_response, 4);
+}
+
+// Location: /path の場合 > 再parseせずにそのpathのresponseを返す(local redirect)
+int TestGetResponseFromCgi5(const server::VirtualServerAddrList &server_infos) {
+	const std::string &response = "Location: /\r\n\r\n";
+	cgi::CgiResponse   cgi_response(response, true);
+
+	const std::string &expected_body_message = LoadFileContent("../../../../root/html/index.html");
+	HeaderFields       expected_header_fields;
+	expected_header_fields[http::CONNECTION]     = http::CLOSE;
+	expected_header_fields[http::CONTENT_LENGTH] = utils::ToString(expected_body_message.length());
+	expected_header_fields[http::CONTENT_TYPE]   = http::TEXT_HTML;
+	expected_header_fields[http::SERVER]         = http::SERVER_VERSION;
+	const std::string &expected_response         = CreateHttpResponseFormat(
+        EXPECTED_STATUS_LINE_OK, expected_header_fields, expected_body_message
+    );
+
+	// Host, Connectionをparse済みのsave_dataを残す(bodyが届いていないので未完了)
+	http::Http http;
+	http.Run(
+		CreateClientInfos("POST /cgi-bin/a.pl HTTP/1.1\r\nHost: host\r\nConnection: close\r\n"
+						  "Content-Type: text/plain\r\nContent-Length: 10\r\n\r\n"),
+		server_infos
+	);
+	http::HttpResult result =
+		http.GetResponseFromCgi(CreateClientInfos(""), server_infos, cgi_response);
+	int ret = EXIT_SUCCESS;
+	ret |= HandleResult(result.is_response_complete, true, 5);
+	ret |= HandleResult(RemoveDateHeaderLine(result.response), expected_response, 6);
+	return ret;
+}
+
+// 同じcgiを待っていたclientにはparse済みのresponseから作る
+int TestGetResponseFromCgi6(const server::VirtualServerAddrList &server_infos) {
+	const std::string &response =
+		"Content-Length: 12\r\nContent-Type: text/plain\r\n\r\nHello, world";
+	cgi::CgiResponse cgi_response(response, true);
+
+	const std::string &expected_body_message = "Hello, world";
+	HeaderFields       expected_header_fields;
+	expected_header_fields[http::CONNECTION]     = http::KEEP_ALIVE;
+	expected_header_fields[http::CONTENT_LENGTH] = utils::ToString(expected_body_message.length());
+	expected_header_fields[http::CONTENT_TYPE]   = http::TEXT_PLAIN;
+	expected_header_fields[http::SERVER]         = http::SERVER_VERSION;
+	const std::string &expected_response         = CreateHttpResponseFormat(
+        EXPECTED_STATUS_LINE_OK, expected_header_fields, expected_body_message
+    );
+
+	// cgi_cache_validのないlocationのresponseは共有しない
+	http::Http                    http;
+	http::Http::SharedCgiResponse shared_response;
+	http.GetResponseFromCgi(CreateClientInfos(""), server_infos, cgi_response, shared_response);
+	int ret = EXIT_SUCCESS;
+	ret |= HandleResult(shared_response.IsOk(), false, 7);
+
+	http::Http::CgiParsedData parsed;
+	parsed.header_fields[http::CONTENT_LENGTH] = "12";
+	parsed.header_fields[http::CONTENT_TYPE]   = http::TEXT_PLAIN;
+	parsed.body                                = expected_body_message;
+	http::HttpResult result =
+		http.GetSharedResponseFromCgi(CreateClientInfos(""), server_infos, parsed);
+	ret |= HandleResult(RemoveDateHeaderLine(result.response), expected_response, 8);
+	return ret;
 }
 
 } // namespace test
@@ -121,9 +121,24 @@ Result IsSameRequestBuffer(const std::string &request_buffer, const std::string
 	return request_buffer_result;
 }
 
+// dateは実行した時刻で変わるので、IMF-fixdateの長さで"GMT"で終わることだけ確かめて取り除く
+std::string RemoveDateHeaderLine(const std::string &response) {
+	const std::string prefix    = "\r\ndate: ";
+	const std::size_t date_size = 29; // "Sun, 06 Nov 1994 08:49:37 GMT"
+	const std::size_t pos       = response.find(prefix);
+	if (pos == std::string::npos) {
+		return response;
+	}
+	const std::size_t date_end = pos + prefix.size() + date_size;
+	if (date_end + 2 > response.size() || response.compare(date_end - 4, 6, " GMT\r\n") != 0) {
+		return response;
+	}
+	return response.substr(0, pos) + response.substr(date_end);
+}
+
 Result IsSameHttpResponse(const std::string &response, const std::string &expected) {
 	Result http_response_result;
-	if (response != expected) {
+	if (RemoveDateHeaderLine(response) != expected) {
 		std::ostringstream error_log;
 		error_log << "Error: Http Response\n";
 		error_log << "- Expected: [\n" << expected << "]\n";
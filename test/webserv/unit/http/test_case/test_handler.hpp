@@ -1,17 +1,10 @@
 #ifndef TEST_HANDLER_HPP_
 #define TEST_HANDLER_HPP_
 
-#include <list>
+#include "virtual_server_addr_list.hpp"
 #include <map>
 #include <string>
 
-namespace server {
-
-class VirtualServer;
-typedef std::list<const VirtualServer *> VirtualServerAddrList;
-
-} // namespace server
-
 namespace http {
 
 struct ClientInfos;
@@ -24,6 +17,7 @@ namespace test {
 typedef std::map<std::string, std::string> HeaderFields;
 
 std::string LoadFileContent(const std::string &file_path);
+std::string RemoveDateHeaderLine(const std::string &response);
 std::string CreateHttpResponseFormat(
 	const std::string  &status_line,
 	const HeaderFields &header_fields,
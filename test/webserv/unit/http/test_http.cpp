@@ -105,9 +105,15 @@ int  main(void) {
 
     // test GetResponseFromCgi
     std::cout << "\n\033[44;37m[ Test GetResponseFromCgi ]\033[m" << std::endl;
-    ret_code |= test::TestGetResponseFromCgi1();
-    ret_code |= test::TestGetResponseFromCgi2();
-    ret_code |= test::TestGetResponseFromCgi3();
-    ret_code |= test::TestGetResponseFromCgi4();
+    ret_code |= test::TestGetResponseFromCgi1(server_infos);
+    ret_code |= test::TestGetResponseFromCgi2(server_infos);
+    ret_code |= test::TestGetResponseFromCgi3(server_infos);
+    ret_code |= test::TestGetResponseFromCgi4(server_infos);
+    ret_code |= test::TestGetResponseFromCgi5(server_infos);
+    ret_code |= test::TestGetResponseFromCgi6(server_infos);
+
+    // test DeleteClient
+    std::cout << "\n\033[44;37m[ Test DeleteClient ]\033[m" << std::endl;
+    ret_code |= test::TestDeleteClient(server_infos);
     return ret_code;
 }
@@ -18,7 +18,7 @@ struct MethodArgument {
 		const std::string                &method,
 		const http::Method::AllowMethods &allow_methods,
 		const std::string                &request_body_message,
-		http::HeaderFields               &request_header_fields,
+		http::RequestHeaderFields        &request_header_fields,
 		std::string                      &response_body_message,
 		http::HeaderFields               &response_header_fields,
 		const std::string                &index_file_path  = "",
@@ -41,7 +41,7 @@ struct MethodArgument {
 	const std::string                &method;
 	const http::Method::AllowMethods &allow_methods;
 	const std::string                &request_body_message;
-	http::HeaderFields               &request_header_fields;
+	http::RequestHeaderFields        &request_header_fields;
 	std::string                      &response_body_message;
 	http::HeaderFields               &response_header_fields;
 	const std::string                &index_file_path;
@@ -132,8 +132,11 @@ int HandleResult(const T &result, const T &expected) {
 int MethodHandlerResult(const MethodArgument &srcs, const std::string &expected_body_message) {
 	int result = 0;
 	try {
-		http::Method::Handler(
+		http::StatusCode       status_code(http::OK);
+		const http::HttpStatus status = http::Method::Handler(
 			srcs.path,
+			0,
+			server::MimeTypes(),
 			srcs.method,
 			srcs.allow_methods,
 			srcs.request_body_message,
@@ -142,8 +145,15 @@ int MethodHandlerResult(const MethodArgument &srcs, const std::string &expected_
 			srcs.response_header_fields,
 			srcs.index_file_path,
 			srcs.autoindex_on,
-			srcs.upload_file_path
+			srcs.upload_file_path,
+			status_code
 		);
+		if (!status.IsOk()) {
+			srcs.response_body_message =
+				http::HttpResponse::CreateDefaultBodyMessage(http::StatusCode(status.GetStatusCode()));
+			std::cerr << utils::color::GRAY << status.GetMessage() << utils::color::RESET
+					  << std::endl;
+		}
 		result = HandleResult(srcs.response_body_message, expected_body_message);
 
 	} catch (const http::HttpException &e) {
@@ -165,10 +175,10 @@ int main(void) {
 	allow_methods.push_back(http::GET);
 	allow_methods.push_back(http::POST);
 	allow_methods.push_back(http::DELETE);
-	std::string        request;
-	http::HeaderFields request_header_fields;
-	std::string        response;
-	http::HeaderFields response_header_fields;
+	std::string               request;
+	http::RequestHeaderFields request_header_fields;
+	std::string               response;
+	http::HeaderFields        response_header_fields;
 
 	// http_method/expected
 	// LF:   exist target resourse file
@@ -130,7 +130,9 @@ Result IsSameRequestLine(const http::RequestLine &res, const http::RequestLine &
 	return request_line_result;
 }
 
-Result IsSameHeaderFields(const http::HeaderFields &res, http::HeaderFields expected) {
+Result IsSameHeaderFields(
+	const http::RequestHeaderFields &res, http::RequestHeaderFields expected
+) {
 	Result             header_fields_result;
 	std::ostringstream error_log;
 	if (expected[http::HOST].size() && expected.at(http::HOST) != res.at(http::HOST)) {
@@ -236,14 +238,16 @@ Result IsSameHttpRequestParsedData(
 	return current_buf_result;
 }
 
+void SetErrorStatusCode(http::HttpRequestParsedData &save_data, const http::HttpStatus &status) {
+	if (!status.IsOk()) {
+		save_data.request_result.status_code = http::StatusCode(status.GetStatusCode());
+	}
+}
+
 http::HttpRequestParsedData ParseHttpRequestFormat(const std::string &read_buf) {
 	http::HttpRequestParsedData save_data;
 	save_data.current_buf += read_buf;
-	try {
-		http::HttpParse::Run(save_data);
-	} catch (const http::HttpException &e) {
-		save_data.request_result.status_code = e.GetStatusCode();
-	}
+	SetErrorStatusCode(save_data, http::HttpParse::Run(save_data));
 	return save_data;
 }
 
@@ -264,11 +268,7 @@ int RunTestCases(const TestCase test_cases[], std::size_t num_test_cases) {
 
 http::HttpRequestParsedData ParseHttpRequestFormatForChunked(http::HttpRequestParsedData &save_data
 ) {
-	try {
-		http::HttpParse::Run(save_data);
-	} catch (const http::HttpException &e) {
-		save_data.request_result.status_code = e.GetStatusCode();
-	}
+	SetErrorStatusCode(save_data, http::HttpParse::Run(save_data));
 	return save_data;
 }
 
@@ -333,12 +333,12 @@ Result ParseChunkedMultipleTimes2() {
 	}
 
 	// 次のread_bufが追加される
-	save_data.current_buf += "\n5\r\nxx\r\n0\r\n\r\nGET /";
+	save_data.current_buf += "\n5\r\nxxxxxx\r\n0\r\n\r\nGET /";
 
 	// 2回目のParseのexpected
 	expected.request_result.status_code          = http::StatusCode(http::BAD_REQUEST); // 400
 	expected.request_result.request.body_message = "Wiki";
-	expected.current_buf                         = "5\r\nxx\r\n0\r\n\r\nGET /";
+	expected.current_buf                         = "5\r\nxxxxxx\r\n0\r\n\r\nGET /";
 
 	// 2回目のParse
 	const Result result2 =
@@ -346,6 +346,86 @@ Result ParseChunkedMultipleTimes2() {
 	return result2;
 }
 
+// request line/header fieldsが1byteずつ届いても途中から読み進めて同じ結果になるか
+Result ParseByteByByte() {
+	const std::string &request = "GET /index.html HTTP/1.1\r\nHost:  a \r\nConnection: "
+								 "close\r\n\r\nGET /";
+
+	http::HttpRequestParsedData expected;
+	expected.request_result.status_code = http::StatusCode(http::OK);
+	expected.request_result.request.request_line =
+		CreateRequestLine("GET", "/index.html", "HTTP/1.1");
+	expected.request_result.request.header_fields[http::HOST]       = "a";
+	expected.request_result.request.header_fields[http::CONNECTION] = http::CLOSE;
+	expected.is_request_format.is_request_line                      = true;
+	expected.is_request_format.is_header_fields                     = true;
+	expected.is_request_format.is_body_message                      = true;
+	expected.current_buf                                            = "GET /";
+
+	http::HttpRequestParsedData save_data;
+	for (std::string::const_iterator it = request.begin(); it != request.end(); ++it) {
+		save_data.current_buf += *it;
+		ParseHttpRequestFormatForChunked(save_data);
+	}
+	return IsSameHttpRequestParsedData(save_data, expected);
+}
+
+// chunked bodyが1byteずつ届いても同じ結果になるか
+Result ParseChunkedByteByByte() {
+	const std::string &request = "POST / HTTP/1.1\r\nHost: host\r\nTransfer-Encoding: "
+								 "chunked\r\nContent-Type: text/plain\r\n\r\n4;name=value\r\nWiki\r\n5\r\npedia\r\n0\r\n"
+								 "Expires: 0\r\n\r\nGET /";
+
+	http::HttpRequestParsedData expected;
+	expected.request_result.status_code          = http::StatusCode(http::OK);
+	expected.request_result.request.request_line = CreateRequestLine("POST", "/", "HTTP/1.1");
+	expected.request_result.request.header_fields[http::HOST]              = "host";
+	expected.request_result.request.header_fields[http::TRANSFER_ENCODING] = http::CHUNKED;
+	expected.request_result.request.header_fields[http::CONTENT_TYPE]      = http::TEXT_PLAIN;
+	expected.request_result.request.body_message = "Wikipedia";
+	expected.is_request_format.is_request_line   = true;
+	expected.is_request_format.is_header_fields  = true;
+	expected.is_request_format.is_body_message   = true;
+	expected.current_buf                         = "GET /";
+
+	http::HttpRequestParsedData save_data;
+	for (std::string::const_iterator it = request.begin(); it != request.end(); ++it) {
+		save_data.current_buf += *it;
+		ParseHttpRequestFormatForChunked(save_data);
+	}
+	return IsSameHttpRequestParsedData(save_data, expected);
+}
+
+// header fieldsを読んだ後にbody_size_maxを決めてからbodyを読む(Httpと同じ順)
+http::EStatusCode ParseWithBodySizeMax(const std::string &read_buf, std::size_t body_size_max) {
+	http::HttpRequestParsedData save_data;
+	save_data.current_buf = read_buf;
+	http::HttpStatus status = http::HttpParse::ParseRequestHead(save_data);
+	if (status.IsOk()) {
+		save_data.parse_state.body_size_max = body_size_max;
+		status                              = http::HttpParse::ParseRequestBody(save_data);
+	}
+	SetErrorStatusCode(save_data, status);
+	return save_data.request_result.status_code.GetEStatusCode();
+}
+
+// request line, header fieldsに上限を付けて読む(request_line_sizeはheader行の上限と共通)
+http::EStatusCode ParseWithHeaderLimits(
+	const std::string &read_buf,
+	std::size_t        line_size_max,
+	std::size_t        header_size_max,
+	std::size_t        header_count_max
+) {
+	http::HttpRequestParsedData save_data;
+	save_data.current_buf                       = read_buf;
+	save_data.parse_state.request_line_size_max = line_size_max;
+	save_data.parse_state.header_line_size_max  = line_size_max;
+	save_data.parse_state.header_size_max       = header_size_max;
+	save_data.parse_state.header_count_max      = header_count_max;
+	SetErrorStatusCode(save_data, http::HttpParse::ParseRequestHead(save_data));
+	return save_data.request_result.status_code.GetEStatusCode();
+}
+
 } // namespace
 
 int main(void) {
@@ -728,5 +808,166 @@ int main(void) {
 	// 26. Chunked Transfer-Encodingの場合で、1回目OKで未完成・2回目で400
 	ret_code |= HandleResult(ParseChunkedMultipleTimes2());
 
+	// 27. request line/header fieldsが1byteずつ届く場合
+	ret_code |= HandleResult(ParseByteByByte());
+
+	// 28.header行に':'がない場合 -> header fieldsの終わりまで読んでから400
+	http::HttpRequestParsedData test1_header_line;
+	test1_header_line.request_result.status_code        = http::StatusCode(http::BAD_REQUEST);
+	test1_header_line.is_request_format.is_request_line = true;
+	test1_header_line.current_buf                       = "abc";
+
+	// 29.header行の途中にLFが続かないCRがある場合
+	http::HttpRequestParsedData test2_header_line;
+	test2_header_line.request_result.status_code        = http::StatusCode(http::BAD_REQUEST);
+	test2_header_line.is_request_format.is_request_line = true;
+	test2_header_line.current_buf                       = "";
+
+	// 30.header fieldsが空の場合 -> Hostがないので400
+	http::HttpRequestParsedData test3_header_line;
+	test3_header_line.request_result.status_code        = http::StatusCode(http::BAD_REQUEST);
+	test3_header_line.is_request_format.is_request_line = true;
+	test3_header_line.current_buf                       = "";
+
+	static const TestCase test_case_http_request_header_line[] = {
+		TestCase("GET / HTTP/1.1\r\nHost: a\r\nnocolon\r\n\r\nabc", test1_header_line),
+		TestCase("GET / HTTP/1.1\r\nHost: a\rb\r\n\r\n", test2_header_line),
+		TestCase("GET / HTTP/1.1\r\n\r\n", test3_header_line),
+	};
+
+	ret_code |= RunTestCases(
+		test_case_http_request_header_line,
+		sizeof(test_case_http_request_header_line) / sizeof(test_case_http_request_header_line[0])
+	);
+
+	// 31.chunk-dataにCRLFが含まれる場合 -> chunk-sizeの分だけ読むのでOK
+	http::HttpRequestParsedData test15_body_message_chunked;
+	test15_body_message_chunked.request_result.status_code = http::StatusCode(http::OK);
+	test15_body_message_chunked.request_result.request.request_line =
+		CreateRequestLine("POST", "/", "HTTP/1.1");
+	test15_body_message_chunked.request_result.request.header_fields[http::HOST] = "host";
+	test15_body_message_chunked.request_result.request.header_fields[http::TRANSFER_ENCODING] =
+		http::CHUNKED;
+	test15_body_message_chunked.request_result.request.header_fields[http::CONTENT_TYPE] =
+		http::TEXT_PLAIN;
+	test15_body_message_chunked.is_request_format.is_request_line   = true;
+	test15_body_message_chunked.is_request_format.is_header_fields  = true;
+	test15_body_message_chunked.is_request_format.is_body_message   = true;
+	test15_body_message_chunked.request_result.request.body_message = "a\r\nb\r\n";
+	test15_body_message_chunked.current_buf                         = "";
+
+	// 32.chunk-extとtrailer-sectionがある場合 -> 読み捨ててOK
+	http::HttpRequestParsedData test16_body_message_chunked = test15_body_message_chunked;
+	test16_body_message_chunked.request_result.request.body_message = "Wikipedia";
+
+	// 33.chunk-extが';'から始まっていない場合
+	http::HttpRequestParsedData test17_body_message_chunked;
+	test17_body_message_chunked.request_result.status_code = http::StatusCode(http::BAD_REQUEST);
+	test17_body_message_chunked.is_request_format.is_request_line  = true;
+	test17_body_message_chunked.is_request_format.is_header_fields = true;
+	test17_body_message_chunked.current_buf                        = "5 x\r\npedia\r\n0\r\n\r\n";
+
+	// 34.trailerのfield-nameがtokenでない場合
+	http::HttpRequestParsedData test18_body_message_chunked = test17_body_message_chunked;
+	test18_body_message_chunked.current_buf = "0\r\nbad field: 1\r\n\r\n";
+
+	static const TestCase test_case_http_request_chunk_ext_and_trailer[] = {
+		TestCase(
+			"POST / HTTP/1.1\r\nHost: host\r\nTransfer-Encoding: chunked\r\nContent-Type: "
+			"text/plain\r\n\r\n"
+			"3\r\na\r\n\r\n3\r\nb\r\n\r\n0\r\n\r\n",
+			test15_body_message_chunked
+		),
+		TestCase(
+			"POST / HTTP/1.1\r\nHost: host\r\nTransfer-Encoding: chunked\r\nContent-Type: "
+			"text/plain\r\n\r\n"
+			"4 ; a=b;c=\"d e\"\r\nWiki\r\n5;x\r\npedia\r\n0\r\nExpires: 0\r\nX-Sum: 1\r\n\r\n",
+			test16_body_message_chunked
+		),
+		TestCase(
+			"POST / HTTP/1.1\r\nHost: host\r\nTransfer-Encoding: chunked\r\nContent-Type: "
+			"text/plain\r\n\r\n"
+			"4\r\nWiki\r\n5 x\r\npedia\r\n0\r\n\r\n",
+			test17_body_message_chunked
+		),
+		TestCase(
+			"POST / HTTP/1.1\r\nHost: host\r\nTransfer-Encoding: chunked\r\nContent-Type: "
+			"text/plain\r\n\r\n"
+			"4\r\nWiki\r\n0\r\nbad field: 1\r\n\r\n",
+			test18_body_message_chunked
+		),
+	};
+
+	ret_code |= RunTestCases(
+		test_case_http_request_chunk_ext_and_trailer,
+		sizeof(test_case_http_request_chunk_ext_and_trailer) /
+			sizeof(test_case_http_request_chunk_ext_and_trailer[0])
+	);
+
+	// 35. chunked bodyが1byteずつ届く場合
+	ret_code |= HandleResult(ParseChunkedByteByByte());
+
+	// 36-40. client_max_body_size
+	const std::string content_length_head =
+		"POST / HTTP/1.1\r\nHost: host\r\nContent-Type: text/plain\r\nContent-Length: ";
+	const std::string chunked_head = "POST / HTTP/1.1\r\nHost: host\r\nContent-Type: "
+									 "text/plain\r\nTransfer-Encoding: chunked\r\n\r\n";
+	// 36. 上限ちょうどはOK
+	ret_code |= HandleResult(
+		ParseWithBodySizeMax(content_length_head + "4\r\n\r\nWiki", 4), http::OK
+	);
+	// 37. Content-Lengthが上限を超えていればbodyが届く前に413
+	ret_code |= HandleResult(
+		ParseWithBodySizeMax(content_length_head + "5\r\n\r\n", 4), http::PAYLOAD_TOO_LARGE
+	);
+	// 38. chunkedの合計が上限ちょうどはOK
+	ret_code |= HandleResult(
+		ParseWithBodySizeMax(chunked_head + "2\r\nWi\r\n2\r\nki\r\n0\r\n\r\n", 4), http::OK
+	);
+	// 39. chunkedの合計が上限を超えるchunk-sizeの行だけで413
+	ret_code |= HandleResult(
+		ParseWithBodySizeMax(chunked_head + "2\r\nWi\r\n3\r\n", 4), http::PAYLOAD_TOO_LARGE
+	);
+	// 40. 1つのchunk-sizeが上限を超える
+	ret_code |= HandleResult(
+		ParseWithBodySizeMax(chunked_head + "ffff\r\n", 4), http::PAYLOAD_TOO_LARGE
+	);
+
+	// 41-47. request line, header fieldsの上限
+	// "GET /abc HTTP/1.1" = 17byte, "GET / HTTP/1.1" = 14byte, "Host: a" = 7byte
+	// 41. 上限ちょうどはOK
+	ret_code |= HandleResult(
+		ParseWithHeaderLimits("GET /abc HTTP/1.1\r\nHost: a\r\n\r\n", 17, 9, 1), http::OK
+	);
+	// 42. request lineが長い -> 414
+	ret_code |= HandleResult(
+		ParseWithHeaderLimits("GET /abcd HTTP/1.1\r\nHost: a\r\n\r\n", 17, 100, 10),
+		http::URI_TOO_LONG
+	);
+	// 43. request lineのCRLFが届く前でも上限を超えたら414
+	ret_code |= HandleResult(
+		ParseWithHeaderLimits("GET /" + std::string(20, 'a'), 17, 100, 10), http::URI_TOO_LONG
+	);
+	// 44. header行が長い -> 431
+	ret_code |= HandleResult(
+		ParseWithHeaderLimits("GET / HTTP/1.1\r\nHost: a\r\nX-A: 1234567890\r\n\r\n", 14, 100, 10),
+		http::REQUEST_HEADER_FIELDS_TOO_LARGE
+	);
+	// 45. header行のCRLFが届く前でも上限を超えたら431
+	ret_code |= HandleResult(
+		ParseWithHeaderLimits("GET / HTTP/1.1\r\nHost: " + std::string(20, 'a'), 14, 100, 10),
+		http::REQUEST_HEADER_FIELDS_TOO_LARGE
+	);
+	// 46. header fields全体が大きい -> 431
+	ret_code |= HandleResult(
+		ParseWithHeaderLimits("GET / HTTP/1.1\r\nHost: a\r\nX-A: 1\r\n\r\n", 100, 10, 10),
+		http::REQUEST_HEADER_FIELDS_TOO_LARGE
+	);
+	// 47. headerの数が多い -> 431
+	ret_code |= HandleResult(
+		ParseWithHeaderLimits("GET / HTTP/1.1\r\nHost: a\r\nX-A: 1\r\n\r\n", 100, 100, 1),
+		http::REQUEST_HEADER_FIELDS_TOO_LARGE
+	);
+
 	return ret_code;
 }
@@ -3,6 +3,7 @@
 #include "http_parse.hpp"
 #include "http_response.hpp"
 #include "http_result.hpp"
+#include <climits> // PATH_MAX
 #include <cstdlib>
 #include <fstream>
 
@@ -19,6 +20,21 @@ std::string LoadFileContent(const char *file_path) {
 	return file_content.str();
 }
 
+// dateは実行した時刻で変わるので、IMF-fixdateの長さで"GMT"で終わることだけ確かめて取り除く
+std::string RemoveDateHeaderLine(const std::string &response) {
+	const std::string prefix    = "\r\ndate: ";
+	const std::size_t date_size = 29; // "Sun, 06 Nov 1994 08:49:37 GMT"
+	const std::size_t pos       = response.find(prefix);
+	if (pos == std::string::npos) {
+		return response;
+	}
+	const std::size_t date_end = pos + prefix.size() + date_size;
+	if (date_end + 2 > response.size() || response.compare(date_end - 4, 6, " GMT\r\n") != 0) {
+		return response;
+	}
+	return response.substr(0, pos) + response.substr(date_end);
+}
+
 int GetTestCaseNum() {
 	static unsigned int test_case_num = 0;
 	++test_case_num;
@@ -41,6 +57,15 @@ int HandleResult(const T &result, const T &expected) {
 	}
 }
 
+// 起動時に解決するrootと同じく、repositoryのrootの絶対path
+std::string GetRootPath() {
+	char resolved_path[PATH_MAX];
+	if (realpath("../../../../root", resolved_path) == NULL) {
+		return "";
+	}
+	return resolved_path;
+}
+
 server::Location BuildLocation(
 	const std::string                          &request_uri,
 	const std::string                          &alias,
@@ -53,6 +78,7 @@ server::Location BuildLocation(
 ) {
 	server::Location loc;
 	loc.request_uri      = request_uri;
+	loc.root             = GetRootPath();
 	loc.alias            = alias;
 	loc.index            = index;
 	loc.autoindex        = autoindex;
@@ -85,7 +111,7 @@ server::VirtualServer *BuildVirtualServer1() {
 	server_names.push_back("host1");
 	server::VirtualServer::HostPortList host_ports;
 	host_ports.push_back(std::make_pair("localhost", 8080));
-	server::VirtualServer::ErrorPage error_page(404, "/error_pages/404.html");
+	server::VirtualServer::ErrorPage error_page(404, GetRootPath() + "/error_pages/404.html");
 
 	return new server::VirtualServer(server_names, locationlist, host_ports, 1024, error_page);
 }
@@ -109,7 +135,9 @@ server::VirtualServer *BuildVirtualServer2() {
 	server_names.push_back("host2");
 	server::VirtualServer::HostPortList host_ports;
 	host_ports.push_back(std::make_pair("localhost", 8080));
-	server::VirtualServer::ErrorPage error_page(404, "/html/error_pages/404.html");
+	server::VirtualServer::ErrorPage error_page(
+		404, GetRootPath() + "/html/error_pages/404.html"
+	);
 
 	return new server::VirtualServer(server_names, locationlist, host_ports, 1024, error_page);
 }
@@ -155,6 +183,7 @@ int main(void) {
 	const server::VirtualServerAddrList server_info = BuildVirtualServerAddrList();
 	http::HttpRequestResult             request_info;
 	http::CgiResult                     cgi_result;
+	http::ProxyResult                   proxy_result;
 
 	// 前提
 	// header_fields[HOST]がないとAborted what():  map::at
@@ -166,7 +195,7 @@ int main(void) {
 	request_info.request.request_line.version        = http::HTTP_VERSION;
 	request_info.request.header_fields[http::HOST]   = "sawa";
 	http::HttpResponseResult response1 =
-		http::HttpResponse::Run(client_infos, server_info, request_info, cgi_result);
+		http::HttpResponse::Run(client_infos, server_info, request_info, cgi_result, proxy_result);
 
 	std::string expected1_status_line =
 		LoadFileContent("../../expected_response/default_status_line/200_ok.txt");
@@ -177,13 +206,13 @@ int main(void) {
 	const std::string &expected1_response =
 		expected1_status_line + expected1_header_fields + http::CRLF + expected1_body_message;
 
-	ret_code |= HandleResult(response1.response, expected1_response);
+	ret_code |= HandleResult(RemoveDateHeaderLine(response1.response), expected1_response);
 
 	// DELETEメソッドの許可がないhost2にリクエスト
 	request_info.request.request_line.method       = http::DELETE;
 	request_info.request.header_fields[http::HOST] = "host2";
 	http::HttpResponseResult response2 =
-		http::HttpResponse::Run(client_infos, server_info, request_info, cgi_result);
+		http::HttpResponse::Run(client_infos, server_info, request_info, cgi_result, proxy_result);
 
 	std::string expected2_status_line =
 		LoadFileContent("../../expected_response/default_status_line/405_method_not_allowed.txt");
@@ -194,7 +223,7 @@ int main(void) {
 	);
 	const std::string &expected2_response =
 		expected2_status_line + expected2_header_fields + http::CRLF + expected2_body_message;
-	ret_code |= HandleResult(response2.response, expected2_response);
+	ret_code |= HandleResult(RemoveDateHeaderLine(response2.response), expected2_response);
 
 	// Redirectのテスト
 	request_info.request.request_line.method         = http::POST;
@@ -202,7 +231,7 @@ int main(void) {
 	request_info.request.request_line.version        = http::HTTP_VERSION;
 	request_info.request.header_fields[http::HOST]   = "host1";
 	http::HttpResponseResult response3 =
-		http::HttpResponse::Run(client_infos, server_info, request_info, cgi_result);
+		http::HttpResponse::Run(client_infos, server_info, request_info, cgi_result, proxy_result);
 
 	std::string expected3_status_line =
 		LoadFileContent("../../expected_response/default_status_line/301_moved_permanently.txt");
@@ -216,9 +245,9 @@ int main(void) {
 	);
 	const std::string &expected3_response =
 		expected3_status_line + expected3_header_fields + http::CRLF + expected3_body_message;
-	ret_code |= HandleResult(response3.response, expected3_response);
+	ret_code |= HandleResult(RemoveDateHeaderLine(response3.response), expected3_response);
 	expected2_status_line + expected2_header_fields + http::CRLF + expected2_body_message;
-	ret_code |= HandleResult(response2.response, expected2_response);
+	ret_code |= HandleResult(RemoveDateHeaderLine(response2.response), expected2_response);
 
 	// ContentTypeのテスト
 	const std::string &file_name = "../../../../root/upload/delete_file";
@@ -232,7 +261,7 @@ int main(void) {
 	request_info.request.request_line.version        = http::HTTP_VERSION;
 	request_info.request.header_fields[http::HOST]   = "host2";
 	http::HttpResponseResult response4 =
-		http::HttpResponse::Run(client_infos, server_info, request_info, cgi_result);
+		http::HttpResponse::Run(client_infos, server_info, request_info, cgi_result, proxy_result);
 
 	std::string expected4_status_line =
 		LoadFileContent("../../expected_response/default_status_line/200_ok.txt");
@@ -244,7 +273,7 @@ int main(void) {
 	);
 	const std::string &expected4_response =
 		expected4_status_line + expected4_header_fields + http::CRLF + expected4_body_message;
-	ret_code |= HandleResult(response4.response, expected4_response);
+	ret_code |= HandleResult(RemoveDateHeaderLine(response4.response), expected4_response);
 	std::remove(file_name.c_str());
 
 	// ErrorPageのテスト
@@ -253,7 +282,7 @@ int main(void) {
 	request_info.request.request_line.version        = http::HTTP_VERSION;
 	request_info.request.header_fields[http::HOST]   = "host2";
 	http::HttpResponseResult response5 =
-		http::HttpResponse::Run(client_infos, server_info, request_info, cgi_result);
+		http::HttpResponse::Run(client_infos, server_info, request_info, cgi_result, proxy_result);
 
 	std::string expected5_status_line =
 		LoadFileContent("../../expected_response/default_status_line/404_not_found.txt");
@@ -264,7 +293,7 @@ int main(void) {
 	);
 	const std::string &expected5_response =
 		expected5_status_line + expected5_header_fields + http::CRLF + expected5_body_message;
-	ret_code |= HandleResult(response5.response, expected5_response);
+	ret_code |= HandleResult(RemoveDateHeaderLine(response5.response), expected5_response);
 
 	DeleteAddrList(server_info);
 	return ret_code;
@@ -0,0 +1,143 @@
+#include "color.hpp"
+#include "http_message.hpp"
+#include "http_response_serializer.hpp"
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+using namespace http;
+
+// ==================== Test汎用 ==================== //
+namespace {
+
+int GetTestCaseNum() {
+	static int test_case_num = 0;
+	++test_case_num;
+	return test_case_num;
+}
+
+void PrintOk() {
+	std::cout << utils::color::GREEN << GetTestCaseNum() << ".[OK]" << utils::color::RESET
+			  << std::endl;
+}
+
+void PrintNg() {
+	std::cerr << utils::color::RED << GetTestCaseNum() << ".[NG] " << utils::color::RESET
+			  << std::endl;
+}
+
+template <typename T>
+int HandleResult(const T &result, const T &expected) {
+	if (result == expected) {
+		PrintOk();
+		return EXIT_SUCCESS;
+	}
+	PrintNg();
+	std::cerr << "result  : [" << result << "]" << std::endl;
+	std::cerr << "expected: [" << expected << "]" << std::endl;
+	return EXIT_FAILURE;
+}
+
+} // namespace
+
+// ================================================= //
+
+// RFC 9110の例と同じ時刻(Sun, 06 Nov 1994 08:49:37 GMT)
+const std::time_t EXAMPLE_TIME = 784111777;
+const std::string EXAMPLE_DATE = "date: Sun, 06 Nov 1994 08:49:37 GMT\r\n";
+
+HttpResponseFormat CreateResponse(const HeaderFields &header_fields, const std::string &body) {
+	return HttpResponseFormat(StatusLine(HTTP_VERSION, "200", "OK"), header_fields, body);
+}
+
+std::string Serialize(const HttpResponseFormat &response) {
+	std::string buffer;
+	HttpResponseSerializer::Serialize(response, EXAMPLE_TIME, buffer);
+	return buffer;
+}
+
+// dateはfield-nameの順の位置に入る
+std::string SerializeWithHeaderFields() {
+	HeaderFields header_fields;
+	header_fields[CONNECTION]     = KEEP_ALIVE;
+	header_fields[CONTENT_LENGTH] = "5";
+	header_fields[CONTENT_TYPE]   = TEXT_PLAIN;
+	header_fields[LOCATION]       = "/a";
+	header_fields[SERVER]         = SERVER_VERSION;
+	return Serialize(CreateResponse(header_fields, "hello"));
+}
+
+std::string ExpectWithHeaderFields() {
+	return "HTTP/1.1 200 OK\r\nconnection: keep-alive\r\ncontent-length: 5\r\n"
+		   "content-type: text/plain\r\n" +
+		   EXAMPLE_DATE + "location: /a\r\nserver: webserv/1.1\r\n\r\nhello";
+}
+
+// header fieldsがdateより前のものだけの場合は最後に入る
+std::string SerializeWithoutLaterFields() {
+	HeaderFields header_fields;
+	header_fields[CONNECTION] = CLOSE;
+	return Serialize(CreateResponse(header_fields, ""));
+}
+
+// 既にdateがある場合はそれを使い、重複させない
+std::string SerializeWithDate() {
+	HeaderFields header_fields;
+	header_fields[DATE]   = "Mon, 01 Jan 2024 00:00:00 GMT";
+	header_fields[SERVER] = SERVER_VERSION;
+	return Serialize(CreateResponse(header_fields, ""));
+}
+
+// 同じ秒なら同じ文字列を使い、秒が変わったら作り直す
+bool IsDateLineRefreshedPerSecond() {
+	const std::string *first  = &HttpResponseSerializer::GetDateHeaderLine(EXAMPLE_TIME);
+	const std::string  before = *first;
+	const std::string *same   = &HttpResponseSerializer::GetDateHeaderLine(EXAMPLE_TIME);
+	const std::string  next   = HttpResponseSerializer::GetDateHeaderLine(EXAMPLE_TIME + 1);
+	return first == same && before == EXAMPLE_DATE &&
+		   next == "date: Sun, 06 Nov 1994 08:49:38 GMT\r\n";
+}
+
+// 足りているbufferは確保し直さずに使い回す
+bool IsBufferReused() {
+	HeaderFields header_fields;
+	header_fields[SERVER] = SERVER_VERSION;
+	std::string buffer;
+	buffer.reserve(1024);
+	const char *data = buffer.data();
+	HttpResponseSerializer::Serialize(
+		CreateResponse(header_fields, std::string(512, 'a')), EXAMPLE_TIME, buffer
+	);
+	HttpResponseSerializer::Serialize(
+		CreateResponse(header_fields, std::string(256, 'b')), EXAMPLE_TIME, buffer
+	);
+	return buffer.data() == data && buffer[buffer.size() - 1] == 'b';
+}
+
+int main() {
+	int ret = EXIT_SUCCESS;
+
+	// 1. 順番
+	ret |= HandleResult(SerializeWithHeaderFields(), ExpectWithHeaderFields());
+
+	// 2. 最後に入る
+	ret |= HandleResult(
+		SerializeWithoutLaterFields(),
+		"HTTP/1.1 200 OK\r\nconnection: close\r\n" + EXAMPLE_DATE + "\r\n"
+	);
+
+	// 3. 既にあるdate
+	ret |= HandleResult(
+		SerializeWithDate(),
+		std::string("HTTP/1.1 200 OK\r\ndate: Mon, 01 Jan 2024 00:00:00 GMT\r\n"
+					"server: webserv/1.1\r\n\r\n")
+	);
+
+	// 4. dateのcache
+	ret |= HandleResult(IsDateLineRefreshedPerSecond(), true);
+
+	// 5. bufferの使い回し
+	ret |= HandleResult(IsBufferReused(), true);
+
+	return ret;
+}
@@ -10,6 +10,9 @@ namespace {
 
 using namespace http;
 
+// 起動時に解決されたrootの代わり(このテストではfileは読まない)
+const std::string TEST_ROOT = "/srv/webserv/root";
+
 server::Location BuildLocation(
 	const std::string                          &request_uri,
 	const std::string                          &alias,
@@ -22,6 +25,7 @@ server::Location BuildLocation(
 ) {
 	server::Location loc;
 	loc.request_uri      = request_uri;
+	loc.root             = TEST_ROOT;
 	loc.alias            = alias;
 	loc.index            = index;
 	loc.autoindex        = autoindex;
@@ -163,14 +167,10 @@ InputIt Next(InputIt it, typename std::iterator_traits<InputIt>::difference_type
 
 // ================================================= //
 
-#define ROOT_DIR "root"
-
 // root 以降を抜き出す
 std::string ExtractHttpServerInfoCheckPath(const std::string &full_path) {
-	const std::string target = ROOT_DIR;
-	size_t            pos    = full_path.find(target);
-	if (pos != std::string::npos) {
-		return full_path.substr(pos + target.length());
+	if (full_path.compare(0, TEST_ROOT.size(), TEST_ROOT) == 0) {
+		return full_path.substr(TEST_ROOT.size());
 	} else {
 		return "";
 	}
@@ -192,6 +192,7 @@ int Test1() {
 
 	try {
 		COMPARE(ExtractHttpServerInfoCheckPath(result.path), location.request_uri);
+		COMPARE(result.root_length, TEST_ROOT.size());
 		COMPARE(result.index, location.index);
 		COMPARE(result.autoindex, location.autoindex);
 		COMPARE(result.allowed_methods, location.allowed_methods);
@@ -357,11 +358,10 @@ int Test6() {
 
 	server::VirtualServerAddrList virtual_servers = BuildVirtualServerAddrList();
 
-	try {
-		HttpServerInfoCheck::Check(virtual_servers, request);
-	} catch (const std::exception &e) {
+	const CheckServerInfoResult result = HttpServerInfoCheck::Check(virtual_servers, request);
+	if (!result.status.IsOk() && result.status.GetStatusCode() == NOT_FOUND) {
 		PrintOk();
-		utils::Debug(e.what());
+		utils::Debug(result.status.GetMessage());
 		DeleteVirtualServerAddrList(virtual_servers);
 		return EXIT_SUCCESS;
 	}
@@ -382,11 +382,10 @@ int Test7() {
 
 	server::VirtualServerAddrList virtual_servers = BuildVirtualServerAddrList();
 
-	try {
-		HttpServerInfoCheck::Check(virtual_servers, request);
-	} catch (const std::exception &e) {
+	const CheckServerInfoResult result = HttpServerInfoCheck::Check(virtual_servers, request);
+	if (!result.status.IsOk() && result.status.GetStatusCode() == PAYLOAD_TOO_LARGE) {
 		PrintOk();
-		utils::Debug(e.what());
+		utils::Debug(result.status.GetMessage());
 		DeleteVirtualServerAddrList(virtual_servers);
 		return EXIT_SUCCESS;
 	}
@@ -36,6 +36,35 @@ int main(void) {
 	ret_code |= HandleResult(ok.GetStatusCode(), expected_200);
 	ret_code |= HandleResult(ok.GetReasonPhrase(), expected_ok);
 
+	// 表に追加した標準のステータスコードの場合
+	http::StatusCode unavailable(http::SERVICE_UNAVAILABLE);
+	ret_code |= HandleResult(unavailable.GetStatusCode(), std::string("503"));
+	ret_code |= HandleResult(unavailable.GetReasonPhrase(), std::string("Service Unavailable"));
+	ret_code |= HandleResult(
+		http::StatusCode(http::NETWORK_AUTHENTICATION_REQUIRED).GetReasonPhrase(),
+		std::string("Network Authentication Required")
+	);
+
+	// 作っておいたstatus line
+	ret_code |= HandleResult(
+		http::StatusCode(http::NOT_FOUND).GetStatusLine(), std::string("HTTP/1.1 404 Not Found\r\n")
+	);
+
+	// 作っておいたdefaultのbody
+	const std::string expected_body = "<html>\r\n<head><title>404 Not Found</title></head>\r\n"
+									  "<body>\r\n<center><h1>404 Not Found</h1></center>\r\n"
+									  "<hr><center>webserv/1.1</center>\r\n</body>\r\n</html>\r\n";
+	ret_code |=
+		HandleResult(http::StatusCode(http::NOT_FOUND).GetDefaultBodyMessage(), expected_body);
+
+	// 同じ表の文字列を参照する(作り直さない)
+	http::StatusCode copied(ok);
+	copied = unavailable;
+	ret_code |= HandleResult(copied.GetEStatusCode(), http::SERVICE_UNAVAILABLE);
+	ret_code |= HandleResult(
+		&http::StatusCode(http::OK).GetReasonPhrase() == &ok.GetReasonPhrase(), true
+	);
+
 	// 存在しないステータスコードの場合 コンパイルエラー
 	// http::StatusCode   no_status_code(0);
 	// ret_code |= HandleResult(no_status_code.GetEStatusCode(), 0);
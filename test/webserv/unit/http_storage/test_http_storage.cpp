@@ -2,6 +2,7 @@
 #include "utils.hpp"
 #include <cstdlib>
 #include <iostream>
+#include <string>
 
 int GetTestCaseNum() {
 	static unsigned int test_case_num = 0;
@@ -42,39 +43,44 @@ int main(void) {
 	http::HttpRequestParsedData save_data = storage.GetClientSaveData(1);
 	ret_code |= HandleResult(save_data.request_result.status_code.GetEStatusCode(), http::OK);
 
-	// ClientSaveDataを更新 -> OK
-	try {
-		save_data.request_result.status_code = http::StatusCode(http::BAD_REQUEST);
-		storage.UpdateClientSaveData(1, save_data);
-		http::HttpRequestParsedData update_data = storage.GetClientSaveData(1);
-		ret_code |= HandleResult(
-			update_data.request_result.status_code.GetEStatusCode(), http::BAD_REQUEST
-		);
-	} catch (const std::logic_error &e) {
-		ret_code |= ResultNg();
-		std::cerr << e.what() << std::endl;
-	}
+	// 取得した参照を書き換える -> コピーせずに保存データが更新される
+	http::HttpRequestParsedData &ref_data = storage.GetClientSaveData(1);
+	ref_data.current_buf += "GET / HTTP/1.1\r\n";
+	ret_code |= HandleResult(
+		storage.GetClientSaveData(1).current_buf, std::string("GET / HTTP/1.1\r\n")
+	);
 
-	// 更新するClientSaveDataが存在しない場合 -> Logic Error
-	try {
-		storage.UpdateClientSaveData(100, save_data);
-		ret_code |= ResultNg();
-	} catch (const std::logic_error &e) {
-		ret_code |= ResultOk();
-		std::cerr << e.what() << std::endl;
+	// 他のクライアントを追加・削除しても参照は有効なまま -> OK
+	for (int fd = 2; fd < 100; ++fd) {
+		storage.GetClientSaveData(fd);
+	}
+	for (int fd = 2; fd < 100; ++fd) {
+		storage.DeleteClientSaveData(fd);
 	}
+	ref_data.current_buf += "Host: localhost\r\n";
+	ret_code |= HandleResult(&storage.GetClientSaveData(1), &ref_data);
+	ret_code |= HandleResult(
+		storage.GetClientSaveData(1).current_buf,
+		std::string("GET / HTTP/1.1\r\nHost: localhost\r\n")
+	);
 
 	// ClientSaveDataを削除 -> OK
 	try {
 		storage.DeleteClientSaveData(1);
 		new_data = storage.GetClientSaveData(1);
-		// 更新したSaveData情報を削除されているかどうかを確認するため、BAD_REQUESTではなくOK
-		ret_code |= HandleResult(new_data.request_result.status_code.GetEStatusCode(), http::OK);
+		// 書き換えたSaveData情報が削除されているかどうかを確認するため、current_bufは空
+		ret_code |= HandleResult(new_data.current_buf, std::string());
 	} catch (const std::logic_error &e) {
 		ret_code |= ResultNg();
 		std::cerr << e.what() << std::endl;
 	}
 
+	// 保存しているかどうか -> 削除後は存在しない
+	storage.GetClientSaveData(2);
+	ret_code |= HandleResult(storage.IsClientSaveData(2), true);
+	storage.DeleteClientSaveData(2);
+	ret_code |= HandleResult(storage.IsClientSaveData(2), false);
+
 	// 削除するClientSaveDataが存在しない場合 -> Logic Error
 	try {
 		storage.DeleteClientSaveData(100);
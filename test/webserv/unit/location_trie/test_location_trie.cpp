@@ -0,0 +1,163 @@
+#include "color.hpp"
+#include "location_trie.hpp"
+#include "virtual_server.hpp"
+#include <cstdlib>
+#include <iostream>
+#include <sstream> // ostringstream
+#include <string>
+
+using namespace server;
+
+// ==================== Test汎用 ==================== //
+namespace {
+
+int GetTestCaseNum() {
+	static int test_case_num = 0;
+	++test_case_num;
+	return test_case_num;
+}
+
+void PrintOk() {
+	std::cout << utils::color::GREEN << GetTestCaseNum() << ".[OK]" << utils::color::RESET
+			  << std::endl;
+}
+
+void PrintNg() {
+	std::cerr << utils::color::RED << GetTestCaseNum() << ".[NG] " << utils::color::RESET
+			  << std::endl;
+}
+
+template <typename T>
+int HandleResult(const T &result, const T &expected) {
+	if (result == expected) {
+		PrintOk();
+		return EXIT_SUCCESS;
+	}
+	PrintNg();
+	std::cerr << "result  : " << result << std::endl;
+	std::cerr << "expected: " << expected << std::endl;
+	return EXIT_FAILURE;
+}
+
+} // namespace
+
+// ================================================= //
+
+typedef LocationTrie::LocationList LocationList;
+
+Location CreateLocation(const std::string &request_uri, const std::string &alias) {
+	Location location;
+	location.request_uri = request_uri;
+	location.alias       = alias;
+	return location;
+}
+
+LocationList CreateLocationList() {
+	LocationList locations;
+	locations.push_back(CreateLocation("/", "root"));
+	locations.push_back(CreateLocation("/www/", "www"));
+	locations.push_back(CreateLocation("/www/data/", "data"));
+	locations.push_back(CreateLocation("/wwx", "wwx"));
+	locations.push_back(CreateLocation("/cgi-bin/", "cgi"));
+	locations.push_back(CreateLocation("/www/", "duplicated"));
+	return locations;
+}
+
+// 一致したlocationのalias(無ければ"(none)")
+std::string FindAlias(const LocationTrie &trie, const std::string &request_target) {
+	const Location *location = trie.Find(request_target);
+	return location == NULL ? "(none)" : location->alias;
+}
+
+// 線形に探していた時と同じ最長一致
+const Location *FindByScan(const LocationList &locations, const std::string &request_target) {
+	const Location *match = NULL;
+	for (LocationList::const_iterator it = locations.begin(); it != locations.end(); ++it) {
+		if (request_target.compare(0, it->request_uri.size(), it->request_uri) == 0 &&
+			it->request_uri.size() > (match == NULL ? 0 : match->request_uri.size())) {
+			match = &*it;
+		}
+	}
+	return match;
+}
+
+// locationがたくさんある時も全てのrequest_targetで線形に探した時と同じものが返る
+bool IsSameAsScan() {
+	LocationList locations;
+	for (int i = 0; i < 2000; ++i) {
+		std::ostringstream oss;
+		oss << "/app" << (i % 50) << "/v" << i;
+		locations.push_back(CreateLocation(oss.str(), oss.str()));
+		if (i % 3 == 0) {
+			locations.push_back(CreateLocation(oss.str() + "/", oss.str() + "/"));
+		}
+	}
+	locations.push_back(CreateLocation("/", "/"));
+	LocationTrie       trie;
+	trie.Build(locations);
+
+	for (int i = 0; i < 2100; ++i) {
+		std::ostringstream oss;
+		oss << "/app" << (i % 60) << "/v" << i << (i % 2 == 0 ? "/index.html" : "0");
+		if (trie.Find(oss.str()) != FindByScan(locations, oss.str())) {
+			std::cerr << "different match: " << oss.str() << std::endl;
+			return false;
+		}
+	}
+	return true;
+}
+
+// VirtualServerはcopyしても自分のLocationを返す
+bool IsCopiedServerOwnLocation() {
+	const VirtualServer *original = new VirtualServer(
+		VirtualServer::ServerNameList(),
+		CreateLocationList(),
+		VirtualServer::HostPortList(),
+		1024,
+		VirtualServer::ErrorPage()
+	);
+	const VirtualServer copied(*original);
+	delete original;
+	const Location *location = copied.FindLocation("/www/index.html");
+	return location != NULL && location->alias == "www" &&
+		   location == &*(++copied.GetLocationList().begin());
+}
+
+int main() {
+	int ret = EXIT_SUCCESS;
+
+	LocationTrie       trie;
+	const LocationList locations = CreateLocationList();
+	trie.Build(locations);
+
+	// 1-3. 最長一致
+	ret |= HandleResult(FindAlias(trie, "/www/data/index.html"), std::string("data"));
+	ret |= HandleResult(FindAlias(trie, "/www/index.html"), std::string("www"));
+	ret |= HandleResult(FindAlias(trie, "/index.html"), std::string("root"));
+
+	// 4-5. request_uriそのもの
+	ret |= HandleResult(FindAlias(trie, "/www/data/"), std::string("data"));
+	ret |= HandleResult(FindAlias(trie, "/"), std::string("root"));
+
+	// 6-7. labelの途中で分かれる・終わる場合は手前のlocation
+	ret |= HandleResult(FindAlias(trie, "/www/dat"), std::string("www"));
+	ret |= HandleResult(FindAlias(trie, "/ww"), std::string("root"));
+
+	// 8. StartWithと同じく'/'の区切りは見ない
+	ret |= HandleResult(FindAlias(trie, "/wwx.html"), std::string("wwx"));
+
+	// 9. 同じrequest_uriは先にあるもの
+	ret |= HandleResult(FindAlias(trie, "/www/"), std::string("www"));
+
+	// 10-11. 一致しない
+	ret |= HandleResult(FindAlias(trie, "index.html"), std::string("(none)"));
+	ret |= HandleResult(FindAlias(LocationTrie(), "/"), std::string("(none)"));
+
+	// 12. 線形に探した場合と同じ
+	ret |= HandleResult(IsSameAsScan(), true);
+
+	// 13. copy
+	ret |= HandleResult(IsCopiedServerOwnLocation(), true);
+
+	return ret;
+}
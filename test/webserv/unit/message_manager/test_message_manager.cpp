@@ -9,8 +9,17 @@
 namespace {
 
 // このunit testがtimeout 3sであること前提で作られているので、
-// Server::REQUEST_TIMEOUT を直に呼ばない
-static const double REQUEST_TIMEOUT = 3.0;
+// ConnectionLimitsのdefault値を使わない
+server::ConnectionLimits CreateConnectionLimits(unsigned int timeout) {
+	server::ConnectionLimits connection_limits;
+	connection_limits.client_header_timeout = timeout;
+	connection_limits.client_body_timeout   = timeout;
+	connection_limits.keepalive_timeout     = timeout;
+	connection_limits.send_timeout          = timeout;
+	return connection_limits;
+}
+
+const server::ConnectionLimits LIMITS = CreateConnectionLimits(3);
 
 typedef server::MessageManager::TimeoutFds TimeoutFds;
 typedef std::deque<std::string>            ResponseDeque;
@@ -83,7 +92,7 @@ RunIsSameTimeoutFds(server::MessageManager &manager, const TimeoutFds &expected_
 	Result             result;
 	std::ostringstream oss;
 
-	const TimeoutFds &timeout_fds = manager.GetNewTimeoutFds(REQUEST_TIMEOUT);
+	const TimeoutFds &timeout_fds = manager.GetNewTimeoutFds();
 	if (!IsSame(timeout_fds, expected_timeout_fds)) {
 		result.is_success = false;
 		oss << "timeout_fds" << std::endl;
@@ -167,6 +176,37 @@ Result RunIsSameRequestBuf(
 	return result;
 }
 
+// managerの外に渡したbufferの比較用
+Result RunIsSameBuf(const std::string &name, const std::string &buf, const std::string &expected) {
+	Result             result;
+	std::ostringstream oss;
+
+	if (!IsSame(buf, expected)) {
+		result.is_success = false;
+		oss << name << std::endl;
+		oss << "- result  : " << buf << std::endl;
+		oss << "- expected: " << expected << std::endl;
+	}
+	result.error_log = oss.str();
+	return result;
+}
+
+// timer_phase, request_countの比較用
+template <typename T>
+Result RunIsSameValue(const std::string &name, const T &value, const T &expected) {
+	Result             result;
+	std::ostringstream oss;
+
+	if (!IsSame(value, expected)) {
+		result.is_success = false;
+		oss << name << std::endl;
+		oss << "- result  : " << value << std::endl;
+		oss << "- expected: " << expected << std::endl;
+	}
+	result.error_log = oss.str();
+	return result;
+}
+
 // -----------------------------------------------------------------------------
 // MessageManager classの主なテスト対象関数
 // - AddNewMessage()
@@ -184,11 +224,11 @@ int RunTestGetTimeoutFds() {
 	TimeoutFds             expected_timeout_fds;
 
 	// time(0), add fd: 4
-	manager.AddNewMessage(4);
+	manager.AddNewMessage(4, LIMITS);
 
 	sleep(1);
 	// time(1), add fd: 5
-	manager.AddNewMessage(5);
+	manager.AddNewMessage(5, LIMITS);
 
 	sleep(2);
 	// time(3), timeout fd: 4
@@ -205,7 +245,7 @@ int RunTestGetTimeoutFds() {
 
 	sleep(1);
 	// time(6), add fd: 6
-	manager.AddNewMessage(6);
+	manager.AddNewMessage(6, LIMITS);
 
 	sleep(1);
 	// time(7), GetNewTimeoutFds: {}
@@ -224,7 +264,7 @@ int RunTestGetTimeoutFds() {
 
 // -----------------------------------------------------------------------------
 // MessageManager classの主なテスト対象関数
-// - UpdateTime()
+// - StartTimer()
 // -----------------------------------------------------------------------------
 // add fd            : 4 5       6
 // timeout(3s)       :       4 5       6
@@ -238,18 +278,18 @@ int RunTestGetTimeoutFds() {
 // current time      : 0 1 2 3 4 5 6 7 8 9 10 11
 // GetNewTimeoutFds():                   *    *
 // -----------------------------------------------------------------------------
-int RunTestUpdateTime() {
+int RunTestStartTimer() {
 	int ret_code = EXIT_SUCCESS;
 
 	server::MessageManager manager;
 	TimeoutFds             expected_timeout_fds;
 
 	// time(0), add fd: 4
-	manager.AddNewMessage(4);
+	manager.AddNewMessage(4, LIMITS);
 
 	sleep(1);
 	// time(1), add fd: 5
-	manager.AddNewMessage(5);
+	manager.AddNewMessage(5, LIMITS);
 
 	sleep(2);
 	// time(3), timeout fd: 4
@@ -263,11 +303,11 @@ int RunTestUpdateTime() {
 
 	sleep(1);
 	// time(5), add fd: 6
-	manager.AddNewMessage(6);
+	manager.AddNewMessage(6, LIMITS);
 
 	sleep(2);
 	// time(7), update start_time, delete oldest response.
-	manager.UpdateTime(5);
+	manager.StartTimer(5, server::message::WAIT_REQUEST);
 	DeleteValue(expected_timeout_fds, 5);
 
 	sleep(1);
@@ -301,8 +341,8 @@ int RunTestDeleteMessage() {
 	TimeoutFds             expected_timeout_fds;
 
 	// time(0), add fd: 4,5
-	manager.AddNewMessage(4);
-	manager.AddNewMessage(5);
+	manager.AddNewMessage(4, LIMITS);
+	manager.AddNewMessage(5, LIMITS);
 
 	// time(0), delete fd: 5
 	manager.DeleteMessage(5);
@@ -360,7 +400,7 @@ int RunTestResponseDeque() {
 
 	static const int client_fd = 4;
 	// add fd: 4
-	manager.AddNewMessage(client_fd);
+	manager.AddNewMessage(client_fd, LIMITS);
 
 	// push_back response : {res1}
 	PushBackResponse(manager, expected_responses, client_fd, "res1");
@@ -386,7 +426,7 @@ int RunTestIsCompleteRequest() {
 
 	static const int client_fd = 4;
 	// add fd: 4
-	manager.AddNewMessage(client_fd);
+	manager.AddNewMessage(client_fd, LIMITS);
 
 	// is_complete_requestの初期値はtrue
 	ret_code |= Test(RunIsSameIsCompleteRequest(manager, true, client_fd)); // test10
@@ -401,7 +441,8 @@ int RunTestIsCompleteRequest() {
 // -----------------------------------------------------------------------------
 // MessageManager classの主なテスト対象関数
 // - AddRequestBuf()
-// - SetNewRequestBuf()
+// - TakeRequestBuf()
+// - RestoreRequestBuf()
 // - GetRequestBuf()
 // -----------------------------------------------------------------------------
 void AddRequestBuf(
@@ -414,16 +455,6 @@ void AddRequestBuf(
 	expected_request_buf += request_buf;
 }
 
-void SetNewRequestBuf(
-	server::MessageManager &manager,
-	std::string            &expected_request_buf,
-	int                     client_fd,
-	const std::string      &request_buf
-) {
-	manager.SetNewRequestBuf(client_fd, request_buf);
-	expected_request_buf = request_buf;
-}
-
 int RunTestRequestBuf() {
 	int ret_code = EXIT_SUCCESS;
 
@@ -432,7 +463,7 @@ int RunTestRequestBuf() {
 
 	static const int client_fd = 4;
 	// add fd: 4
-	manager.AddNewMessage(client_fd);
+	manager.AddNewMessage(client_fd, LIMITS);
 
 	// readしたbuffer追加
 	AddRequestBuf(manager, expected_request_buf, client_fd, "abc");
@@ -442,11 +473,176 @@ int RunTestRequestBuf() {
 	// request_buf == "abcdefg"
 	ret_code |= Test(RunIsSameRequestBuf(manager, expected_request_buf, client_fd)); // test12
 
-	// 新規でrequest_bufをセット
-	SetNewRequestBuf(manager, expected_request_buf, client_fd, "hi");
+	// httpに渡したbufferは空になる
+	std::string taken_buf = "old";
+	manager.TakeRequestBuf(client_fd, taken_buf);
+	ret_code |= Test(RunIsSameRequestBuf(manager, "", client_fd));     // test13
+	ret_code |= Test(RunIsSameBuf("taken_buf", taken_buf, "abcdefg")); // test14
+
+	// 渡している間に受信した分の前に、使われなかった分を戻す
+	manager.AddRequestBuf(client_fd, "jk");
+	std::string unused_buf = "i";
+	manager.RestoreRequestBuf(client_fd, unused_buf);
+	ret_code |= Test(RunIsSameRequestBuf(manager, "ijk", client_fd)); // test15
+	ret_code |= Test(RunIsSameBuf("unused_buf", unused_buf, ""));     // test16
+
+	return ret_code;
+}
+
+// -----------------------------------------------------------------------------
+// MessageManager classの主なテスト対象関数
+// - StartTimer()
+// - GetTimerPhase()
+// - SetConnectionLimits()
+// - CountRequest()
+// -----------------------------------------------------------------------------
+// 待っているものごとに別のtimeoutを使う
+// fd 4: READ_HEADER(client_header_timeout 3s)
+// fd 5: WAIT_REQUEST(keepalive_timeout 1s)
+// fd 6: SEND_RESPONSE(途中でsend_timeoutを1sに変更)
+// -----------------------------------------------------------------------------
+int RunTestTimerPhase() {
+	int ret_code = EXIT_SUCCESS;
 
-	// request_buf == "hi"
-	ret_code |= Test(RunIsSameRequestBuf(manager, expected_request_buf, client_fd)); // test13
+	server::MessageManager   manager;
+	TimeoutFds               expected_timeout_fds;
+	server::ConnectionLimits connection_limits = LIMITS;
+	connection_limits.keepalive_timeout        = 1;
+
+	// time(0), add fd: 4, 5, 6
+	manager.AddNewMessage(4, connection_limits);
+	manager.AddNewMessage(5, connection_limits);
+	manager.AddNewMessage(6, LIMITS);
+	manager.StartTimer(5, server::message::WAIT_REQUEST);
+	manager.StartTimer(6, server::message::SEND_RESPONSE);
+	manager.SetConnectionLimits(6, CreateConnectionLimits(1));
+
+	// 最初はheader fieldsを待つ
+	ret_code |= Test(
+		RunIsSameValue<int>("timer_phase", manager.GetTimerPhase(4), server::message::READ_HEADER)
+	); // test17
+	ret_code |= Test(
+		RunIsSameValue<int>("timer_phase", manager.GetTimerPhase(5), server::message::WAIT_REQUEST)
+	); // test18
+
+	sleep(1);
+	// time(1), GetNewTimeoutFds: {5, 6}
+	expected_timeout_fds.push_back(5);
+	expected_timeout_fds.push_back(6);
+	ret_code |= Test(RunIsSameTimeoutFds(manager, expected_timeout_fds)); // test19
+	expected_timeout_fds.clear();
+
+	sleep(2);
+	// time(3), GetNewTimeoutFds: {4}
+	expected_timeout_fds.push_back(4);
+	ret_code |= Test(RunIsSameTimeoutFds(manager, expected_timeout_fds)); // test20
+
+	// 処理し始めたrequestの数
+	const std::size_t initial_count = manager.GetRequestCount(4);
+	ret_code |= Test(RunIsSameValue<std::size_t>("request_count", initial_count, 0)); // test21
+	manager.CountRequest(4);
+	manager.CountRequest(4);
+	const std::size_t request_count = manager.GetRequestCount(4);
+	ret_code |= Test(RunIsSameValue<std::size_t>("request_count", request_count, 2)); // test22
+
+	return ret_code;
+}
+
+// -----------------------------------------------------------------------------
+// MessageManager classの主なテスト対象関数
+// - AddSentSize()
+// - GetBelowMinRateFds()
+// -----------------------------------------------------------------------------
+// min_rate(10byte/1s): fd4(READ_HEADER), fd5(READ_HEADER), fd6(WAIT_REQUEST)
+// min_rate(100byte/1s): fd7(SEND_RESPONSE)
+// -----------------------------------------------------------------------------
+int RunTestMinRate() {
+	int ret_code = EXIT_SUCCESS;
+
+	server::MessageManager   manager;
+	TimeoutFds               expected_fds;
+	server::ConnectionLimits connection_limits = LIMITS;
+	connection_limits.client_min_rate          = server::DataRate(10, 1);
+	connection_limits.send_min_rate            = server::DataRate(100, 1);
+
+	// time(0), add fd: 4, 5, 6, 7
+	manager.AddNewMessage(4, connection_limits);
+	manager.AddNewMessage(5, connection_limits);
+	manager.AddNewMessage(6, connection_limits);
+	manager.AddNewMessage(7, connection_limits);
+	manager.StartTimer(6, server::message::WAIT_REQUEST);
+	manager.StartTimer(7, server::message::SEND_RESPONSE);
+	manager.AddRequestBuf(4, "0123456789abc");
+	manager.AddRequestBuf(5, "01234");
+	manager.AddSentSize(7, 50);
+
+	sleep(1);
+	// time(1), GetBelowMinRateFds: {5, 7} (keep-aliveで待っているfd6は見ない)
+	expected_fds.push_back(5);
+	expected_fds.push_back(7);
+	ret_code |= Test(RunIsSameValue(
+		"below_min_rate_fds", manager.GetBelowMinRateFds(), expected_fds
+	)); // test23
+	expected_fds.clear();
+	manager.DeleteMessage(5);
+	manager.DeleteMessage(7);
+
+	// time(1), periodが経っていないので数え直している途中
+	ret_code |= Test(RunIsSameValue(
+		"below_min_rate_fds", manager.GetBelowMinRateFds(), expected_fds
+	)); // test24
+
+	// 次のperiodは足りない
+	manager.AddRequestBuf(4, "01234");
+	sleep(1);
+	// time(2), GetBelowMinRateFds: {4}
+	expected_fds.push_back(4);
+	ret_code |= Test(RunIsSameValue(
+		"below_min_rate_fds", manager.GetBelowMinRateFds(), expected_fds
+	)); // test25
+
+	return ret_code;
+}
+
+// -----------------------------------------------------------------------------
+// MessageManager classの主なテスト対象関数
+// - GetIdleFds()
+// - GetMessageCount()
+// -----------------------------------------------------------------------------
+int RunTestIdleFds() {
+	int ret_code = EXIT_SUCCESS;
+
+	server::MessageManager manager;
+	TimeoutFds             expected_fds;
+
+	// add fd: 4, 5, 6, 7
+	manager.AddNewMessage(4, LIMITS);
+	manager.AddNewMessage(5, LIMITS);
+	manager.AddNewMessage(6, LIMITS);
+	manager.AddNewMessage(7, LIMITS);
+	// fd4: 接続直後(READ_HEADER)はidleではない
+	// fd5: keep-aliveで次のrequestを待っている
+	// fd6: 次のrequestの途中まで届いている
+	// fd7: 送っていないresponseがある
+	manager.StartTimer(5, server::message::WAIT_REQUEST);
+	manager.StartTimer(6, server::message::WAIT_REQUEST);
+	manager.AddRequestBuf(6, "GET / HT");
+	manager.StartTimer(7, server::message::WAIT_REQUEST);
+	manager.AddNormalResponse(7, server::message::KEEP, "res");
+
+	// GetIdleFds: {5}
+	expected_fds.push_back(5);
+	ret_code |= Test(RunIsSameValue("idle_fds", manager.GetIdleFds(), expected_fds)); // test26
+	ret_code |= Test(RunIsSameValue(
+		"message_count", manager.GetMessageCount(), static_cast<std::size_t>(4)
+	)); // test27
+
+	manager.DeleteMessage(5);
+	expected_fds.clear();
+	ret_code |= Test(RunIsSameValue("idle_fds", manager.GetIdleFds(), expected_fds)); // test28
+	ret_code |= Test(RunIsSameValue(
+		"message_count", manager.GetMessageCount(), static_cast<std::size_t>(3)
+	)); // test29
 
 	return ret_code;
 }
@@ -457,11 +653,14 @@ int main() {
 	int ret_code = EXIT_SUCCESS;
 
 	ret_code |= RunTestGetTimeoutFds();
-	ret_code |= RunTestUpdateTime();
+	ret_code |= RunTestStartTimer();
 	ret_code |= RunTestDeleteMessage();
 	ret_code |= RunTestResponseDeque();
 	ret_code |= RunTestIsCompleteRequest();
 	ret_code |= RunTestRequestBuf();
+	ret_code |= RunTestTimerPhase();
+	ret_code |= RunTestMinRate();
+	ret_code |= RunTestIdleFds();
 
 	return ret_code;
 }
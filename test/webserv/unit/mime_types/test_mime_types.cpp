@@ -0,0 +1,131 @@
+#include "color.hpp"
+#include "mime_types.hpp"
+#include <cstdlib>
+#include <iostream>
+#include <sstream> // ostringstream
+#include <string>
+
+using namespace server;
+
+// ==================== Test汎用 ==================== //
+namespace {
+
+int GetTestCaseNum() {
+	static int test_case_num = 0;
+	++test_case_num;
+	return test_case_num;
+}
+
+void PrintOk() {
+	std::cout << utils::color::GREEN << GetTestCaseNum() << ".[OK]" << utils::color::RESET
+			  << std::endl;
+}
+
+void PrintNg() {
+	std::cerr << utils::color::RED << GetTestCaseNum() << ".[NG] " << utils::color::RESET
+			  << std::endl;
+}
+
+template <typename T>
+int HandleResult(const T &result, const T &expected) {
+	if (result == expected) {
+		PrintOk();
+		return EXIT_SUCCESS;
+	}
+	PrintNg();
+	std::cerr << "result  : " << result << std::endl;
+	std::cerr << "expected: " << expected << std::endl;
+	return EXIT_FAILURE;
+}
+
+} // namespace
+
+// ================================================= //
+
+const std::string OCTET_STREAM = "application/octet-stream";
+
+MimeTypes::TypeMap CreateTypeMap() {
+	MimeTypes::TypeMap types;
+	types["html"] = "text/html";
+	types["htm"]  = "text/html";
+	types["css"]  = "text/css";
+	types["png"]  = "image/png";
+	types["js"]   = "application/javascript";
+	return types;
+}
+
+std::string FindType(const MimeTypes &mime_types, const std::string &extension) {
+	const std::string *type = mime_types.Find(extension);
+	return type == NULL ? "(none)" : *type;
+}
+
+// bucketの数より多く入れても全部引ける
+bool IsAllTypeFound() {
+	MimeTypes::TypeMap types;
+	for (int i = 0; i < 1000; ++i) {
+		std::ostringstream extension;
+		extension << "ext" << i;
+		types[extension.str()] = "type/" + extension.str();
+	}
+	const MimeTypes mime_types(types);
+	if (mime_types.size() != types.size()) {
+		return false;
+	}
+	for (MimeTypes::TypeMap::const_iterator it = types.begin(); it != types.end(); ++it) {
+		if (FindType(mime_types, it->first) != it->second) {
+			std::cerr << "not found: " << it->first << std::endl;
+			return false;
+		}
+	}
+	return true;
+}
+
+// copyしたものも同じように引ける
+bool IsCopyFound() {
+	MimeTypes mime_types;
+	{
+		const MimeTypes original(CreateTypeMap());
+		mime_types = original;
+	}
+	const MimeTypes copied(mime_types);
+	return FindType(copied, "css") == "text/css" && copied.size() == 5;
+}
+
+int main() {
+	int ret = EXIT_SUCCESS;
+
+	const MimeTypes mime_types(CreateTypeMap());
+
+	// 1-4. 拡張子で引く(大文字小文字は区別しない)
+	ret |= HandleResult(FindType(mime_types, "html"), std::string("text/html"));
+	ret |= HandleResult(FindType(mime_types, "HTM"), std::string("text/html"));
+	ret |= HandleResult(FindType(mime_types, "Png"), std::string("image/png"));
+	ret |= HandleResult(FindType(mime_types, "htmlx"), std::string("(none)"));
+
+	// 5-10. pathの最後の要素の拡張子から決める
+	ret |= HandleResult(mime_types.GetContentType("/var/www/index.html"), std::string("text/html"));
+	ret |= HandleResult(
+		mime_types.GetContentType("/var/www/app.min.js"), std::string("application/javascript")
+	);
+	ret |= HandleResult(mime_types.GetContentType("/var/www/STYLE.CSS"), std::string("text/css"));
+	ret |= HandleResult(mime_types.GetContentType("/var/www/file.txt"), OCTET_STREAM);
+	ret |= HandleResult(mime_types.GetContentType("/var/www.css/file"), OCTET_STREAM);
+	ret |= HandleResult(mime_types.GetContentType("/var/www/file."), OCTET_STREAM);
+
+	// 11-12. 組み込みのtypes(types {}が無い時)
+	const MimeTypes built_in;
+	ret |= HandleResult(built_in.GetContentType("/a/b.jpg"), std::string("image/jpeg"));
+	ret |= HandleResult(built_in.GetContentType("/a/b.css"), OCTET_STREAM);
+
+	// 13. 空のtypes
+	const MimeTypes empty((MimeTypes::TypeMap()));
+	ret |= HandleResult(empty.GetContentType("/a/b.html"), OCTET_STREAM);
+
+	// 14. 沢山入れた時
+	ret |= HandleResult(IsAllTypeFound(), true);
+
+	// 15. copy
+	ret |= HandleResult(IsCopyFound(), true);
+
+	return ret;
+}
@@ -0,0 +1,293 @@
+#include "proxy.hpp"
+#include "proxy_response.hpp"
+#include "upstream.hpp"
+#include "utils.hpp"
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <string>
+
+using namespace server;
+
+// ==================== Test汎用 ==================== //
+namespace {
+
+int GetTestCaseNum() {
+	static int test_case_num = 0;
+	++test_case_num;
+	return test_case_num;
+}
+
+void PrintOk() {
+	std::cout << utils::color::GREEN << GetTestCaseNum() << ".[OK]" << utils::color::RESET
+			  << std::endl;
+}
+
+void PrintNg() {
+	std::cerr << utils::color::RED << GetTestCaseNum() << ".[NG] " << utils::color::RESET
+			  << std::endl;
+}
+
+template <typename T>
+int HandleResult(const T &result, const T &expected) {
+	if (result == expected) {
+		PrintOk();
+		return EXIT_SUCCESS;
+	}
+	PrintNg();
+	std::cerr << "result  : " << result << std::endl;
+	std::cerr << "expected: " << expected << std::endl;
+	return EXIT_FAILURE;
+}
+
+} // namespace
+
+// ================================================= //
+
+int TestContentLength() {
+	int ret = EXIT_SUCCESS;
+
+	// 1-4. headerが分割されて届いてもheaderが揃うまでは何も返さない
+	ProxyResponse response(false, true);
+	ret |= HandleResult(response.Add("HTTP/1.1 200 OK\r\nContent-Le").GetValue(), std::string());
+	ret |= HandleResult(response.IsHeaderComplete(), false);
+	ret |= HandleResult(
+		response.Add("ngth: 5\r\nConnection: close\r\nKeep-Alive: timeout=5\r\n\r\nab").GetValue(),
+		std::string("HTTP/1.1 200 OK\r\nContent-Length: 5\r\nconnection: keep-alive\r\n\r\nab")
+	);
+	ret |= HandleResult(response.IsComplete(), false);
+
+	// 5-7. bodyはそのまま流してContent-Length分で完了
+	ret |= HandleResult(response.Add("cde").GetValue(), std::string("cde"));
+	ret |= HandleResult(response.IsComplete(), true);
+	// upstreamがConnection: closeなら使い回さない
+	ret |= HandleResult(response.IsUpstreamKeep(), false);
+
+	// 8-9. clientがcloseならConnection: close
+	ProxyResponse close_response(false, false);
+	ret |= HandleResult(
+		close_response.Add("HTTP/1.1 204 No Content\r\n\r\n").GetValue(),
+		std::string("HTTP/1.1 204 No Content\r\nconnection: close\r\n\r\n")
+	);
+	ret |= HandleResult(close_response.IsUpstreamKeep(), true);
+
+	// 10-11. HEADはContent-Lengthがあってもbodyなし
+	ProxyResponse head_response(true, true);
+	head_response.Add("HTTP/1.1 200 OK\r\nContent-Length: 100\r\n\r\n");
+	ret |= HandleResult(head_response.IsComplete(), true);
+	ret |= HandleResult(head_response.IsUpstreamKeep(), true);
+
+	// 12. Content-Lengthの後ろに余計なものがあれば使い回さない
+	ProxyResponse extra_response(false, true);
+	extra_response.Add("HTTP/1.1 200 OK\r\nContent-Length: 1\r\n\r\naHTTP/1.1");
+	ret |= HandleResult(extra_response.IsUpstreamKeep(), false);
+	return ret;
+}
+
+int TestChunked() {
+	int ret = EXIT_SUCCESS;
+
+	ProxyResponse response(false, true);
+	response.Add("HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n");
+	// 1-3. chunkの区切りが途中で切れていてもそのまま流す
+	ret |= HandleResult(response.Add("3;ext=1\r\nab").GetValue(), std::string("3;ext=1\r\nab"));
+	ret |= HandleResult(response.Add("c\r\n0\r\n").GetValue(), std::string("c\r\n0\r\n"));
+	ret |= HandleResult(response.IsComplete(), false);
+
+	// 4-6. trailerの後の空行で完了
+	ret |= HandleResult(response.Add("X-A: 1\r\n").IsOk(), true);
+	ret |= HandleResult(response.Add("\r\n").GetValue(), std::string("\r\n"));
+	ret |= HandleResult(response.IsComplete(), true);
+
+	// 7. chunk-sizeが16進数でない
+	ProxyResponse invalid_response(false, true);
+	invalid_response.Add("HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n");
+	ret |= HandleResult(invalid_response.Add("zz\r\n").IsOk(), false);
+	return ret;
+}
+
+int TestUntilClose() {
+	int ret = EXIT_SUCCESS;
+
+	// 1-4. 長さがないresponseはcloseまでがbodyなのでclientもclose
+	ProxyResponse response(false, true);
+	ret |= HandleResult(
+		response.Add("HTTP/1.0 200 OK\r\n\r\nabc").GetValue(),
+		std::string("HTTP/1.0 200 OK\r\nconnection: close\r\n\r\nabc")
+	);
+	ret |= HandleResult(response.IsClientKeep(), false);
+	ret |= HandleResult(response.AddEof(), true);
+	ret |= HandleResult(response.IsComplete(), true);
+
+	// 5. Content-Lengthの途中でcloseは失敗
+	ProxyResponse length_response(false, true);
+	length_response.Add("HTTP/1.1 200 OK\r\nContent-Length: 5\r\n\r\nab");
+	ret |= HandleResult(length_response.AddEof(), false);
+
+	// 6-7. 不正なstatus-line, Content-Lengthの重複
+	ProxyResponse invalid_response(false, true);
+	ret |= HandleResult(invalid_response.Add("HTTP/2 200\r\n\r\n").IsOk(), false);
+	ProxyResponse duplicate_response(false, true);
+	ret |= HandleResult(
+		duplicate_response.Add("HTTP/1.1 200 OK\r\nContent-Length: 1\r\nContent-Length: 2\r\n\r\n")
+			.IsOk(),
+		false
+	);
+	return ret;
+}
+
+int TestInterimResponse() {
+	int ret = EXIT_SUCCESS;
+
+	// 1-3. 1xxは読み捨てて最終responseのheaderだけを送る
+	ProxyResponse response(false, true);
+	ret |= HandleResult(response.Add("HTTP/1.1 100 Continue\r\n\r\n").GetValue(), std::string());
+	ret |= HandleResult(response.IsHeaderComplete(), false);
+	ret |= HandleResult(
+		response.Add("HTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\nab").GetValue(),
+		std::string("HTTP/1.1 200 OK\r\nContent-Length: 2\r\nconnection: keep-alive\r\n\r\nab")
+	);
+
+	// 4-5. 1xxと最終responseが1回で届いても、複数の1xxが続いても同じ
+	ProxyResponse multi_response(false, true);
+	ret |= HandleResult(
+		multi_response
+			.Add("HTTP/1.1 100 Continue\r\n\r\nHTTP/1.1 103 Early Hints\r\nLink: </a>\r\n\r\n"
+				 "HTTP/1.1 204 No Content\r\n\r\n")
+			.GetValue(),
+		std::string("HTTP/1.1 204 No Content\r\nconnection: keep-alive\r\n\r\n")
+	);
+	ret |= HandleResult(multi_response.IsComplete(), true);
+
+	// 6-7. 1xxの後の最終responseが分割されて届く
+	ProxyResponse split_response(false, true);
+	ret |= HandleResult(
+		split_response.Add("HTTP/1.1 100 Continue\r\n\r\nHTTP/1.1 200 OK\r\nContent-").GetValue(),
+		std::string()
+	);
+	ret |= HandleResult(
+		split_response.Add("Length: 0\r\n\r\n").GetValue(),
+		std::string("HTTP/1.1 200 OK\r\nContent-Length: 0\r\nconnection: keep-alive\r\n\r\n")
+	);
+
+	// 8. 101は最終responseとして扱う
+	ProxyResponse switching_response(false, true);
+	switching_response.Add("HTTP/1.1 101 Switching Protocols\r\n\r\n");
+	ret |= HandleResult(switching_response.IsComplete(), true);
+	return ret;
+}
+
+int TestConnectionOptions() {
+	int ret = EXIT_SUCCESS;
+
+	// 1-2. Connectionに書かれたheaderは送らない(bodyの区切りに使うheaderは残す)
+	ProxyResponse response(false, true);
+	ret |= HandleResult(
+		response
+			.Add("HTTP/1.1 200 OK\r\nConnection: X-Hop, close\r\nX-Hop: 1\r\nX-End: 2\r\n"
+				 "Content-Length: 0\r\n\r\n")
+			.GetValue(),
+		std::string(
+			"HTTP/1.1 200 OK\r\nX-End: 2\r\nContent-Length: 0\r\nconnection: keep-alive\r\n\r\n"
+		)
+	);
+	ret |= HandleResult(response.IsUpstreamKeep(), false);
+	return ret;
+}
+
+int TestUpstream() {
+	int               ret = EXIT_SUCCESS;
+	Upstream          upstream;
+	const std::time_t now = 100;
+
+	// 1-3. 最後に戻した接続から使う
+	ret |= HandleResult(upstream.PopIdleFd().IsOk(), false);
+	upstream.AddIdleFd(4);
+	upstream.AddIdleFd(5);
+	ret |= HandleResult(upstream.PopIdleFd().GetValue(), 5);
+	upstream.DeleteIdleFd(4);
+	ret |= HandleResult(upstream.GetIdleFds().empty(), true);
+
+	// 4. IDLE_FD_MAXを超えたら保持しない
+	for (std::size_t i = 0; i < Upstream::IDLE_FD_MAX; ++i) {
+		upstream.AddIdleFd(static_cast<int>(i));
+	}
+	ret |= HandleResult(upstream.AddIdleFd(100), false);
+
+	// 5-6. 処理中の接続数
+	upstream.IncrementActiveCount();
+	upstream.IncrementActiveCount();
+	upstream.DecrementActiveCount();
+	ret |= HandleResult(upstream.GetActiveCount(), 1u);
+	upstream.DecrementActiveCount();
+	upstream.DecrementActiveCount();
+	ret |= HandleResult(upstream.GetActiveCount(), 0u);
+
+	// 7-9. 失敗したらFAIL_TIMEOUTの間はdown
+	upstream.MarkFailed(now);
+	ret |= HandleResult(upstream.IsDown(now + Upstream::FAIL_TIMEOUT - 1), true);
+	ret |= HandleResult(upstream.IsDown(now + Upstream::FAIL_TIMEOUT), false);
+	upstream.MarkFailed(now);
+	upstream.MarkSucceeded();
+	ret |= HandleResult(upstream.IsDown(now), false);
+	return ret;
+}
+
+http::ProxyResult CreateProxyResult(bool is_idempotent) {
+	http::ProxyResult proxy_result;
+	proxy_result.is_proxy      = true;
+	proxy_result.upstreams.push_back(Proxy::IpPortPair("127.0.0.1", 8080));
+	proxy_result.request       = "POST / HTTP/1.1\r\nContent-Length: 2\r\n\r\nab";
+	proxy_result.is_idempotent = is_idempotent;
+	return proxy_result;
+}
+
+int TestRetry() {
+	int                     ret = EXIT_SUCCESS;
+	const Proxy::IpPortPair ip_port("127.0.0.1", 8080);
+
+	// 1-2. connectに失敗した時はどのmethodでも送り直す
+	Proxy post_proxy(CreateProxyResult(false), true);
+	post_proxy.SetUpstream(ip_port, 5, false);
+	ret |= HandleResult(post_proxy.IsRetryable(), true);
+	Proxy get_proxy(CreateProxyResult(true), true);
+	get_proxy.SetUpstream(ip_port, 5, false);
+	ret |= HandleResult(get_proxy.IsRetryable(), true);
+
+	// 3-4. 新しく張った接続が送信後に切れた時は送り直さない
+	post_proxy.SetConnected();
+	post_proxy.ReplaceNewRequest("");
+	ret |= HandleResult(post_proxy.IsRetryable(), false);
+	get_proxy.SetConnected();
+	get_proxy.ReplaceNewRequest("");
+	ret |= HandleResult(get_proxy.IsRetryable(), false);
+
+	// 5-6. poolの接続がまだ1byteも書いていないうちに切れた時はどのmethodでも送り直す
+	post_proxy.ResetUpstream(true);
+	post_proxy.SetUpstream(ip_port, 6, true);
+	ret |= HandleResult(post_proxy.IsRetryable(), true);
+	get_proxy.ResetUpstream(true);
+	get_proxy.SetUpstream(ip_port, 6, true);
+	ret |= HandleResult(get_proxy.IsRetryable(), true);
+
+	// 7-8. poolの接続がrequestを書いた後に切れた時は冪等なmethodだけ送り直す
+	post_proxy.ReplaceNewRequest("ab");
+	ret |= HandleResult(post_proxy.IsRetryable(), false);
+	get_proxy.ReplaceNewRequest("");
+	ret |= HandleResult(get_proxy.IsRetryable(), true);
+	return ret;
+}
+
+int main() {
+	int ret = EXIT_SUCCESS;
+
+	ret |= TestContentLength();
+	ret |= TestChunked();
+	ret |= TestUntilClose();
+	ret |= TestInterimResponse();
+	ret |= TestConnectionOptions();
+	ret |= TestUpstream();
+	ret |= TestRetry();
+
+	return ret;
+}
@@ -0,0 +1,177 @@
+#include "color.hpp"
+#include "request_header_fields.hpp"
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+using namespace http;
+
+// ==================== Test汎用 ==================== //
+namespace {
+
+int GetTestCaseNum() {
+	static int test_case_num = 0;
+	++test_case_num;
+	return test_case_num;
+}
+
+void PrintOk() {
+	std::cout << utils::color::GREEN << GetTestCaseNum() << ".[OK]" << utils::color::RESET
+			  << std::endl;
+}
+
+void PrintNg() {
+	std::cerr << utils::color::RED << GetTestCaseNum() << ".[NG] " << utils::color::RESET
+			  << std::endl;
+}
+
+template <typename T>
+int HandleResult(const T &result, const T &expected) {
+	if (result == expected) {
+		PrintOk();
+		return EXIT_SUCCESS;
+	}
+	PrintNg();
+	std::cerr << "result  : " << result << std::endl;
+	std::cerr << "expected: " << expected << std::endl;
+	return EXIT_FAILURE;
+}
+
+} // namespace
+
+// ================================================= //
+
+const char *const KNOWN_NAMES[HEADER_ID_SIZE] = {
+	"host",
+	"user-agent",
+	"accept",
+	"accept-encoding",
+	"connection",
+	"content-type",
+	"content-length",
+	"transfer-encoding",
+	"location",
+	"authorization",
+	"cache-control",
+	"expect",
+	"x-forwarded-for"
+};
+
+// 全ての既知のheaderがHeaderFieldIdの順にidになる
+bool IsAllKnownNameResolved() {
+	for (std::size_t i = 0; i < HEADER_ID_SIZE; ++i) {
+		if (RequestHeaderFields::GetId(KNOWN_NAMES[i]) != static_cast<HeaderFieldId>(i)) {
+			std::cerr << "not resolved: " << KNOWN_NAMES[i] << std::endl;
+			return false;
+		}
+	}
+	return true;
+}
+
+bool IsUnknown(const std::string &name) {
+	return RequestHeaderFields::GetId(name) == HEADER_UNKNOWN;
+}
+
+// 既知のheaderとそれ以外を混ぜて入れ、届いた順で取り出せる
+bool IsInsertionOrderKept() {
+	RequestHeaderFields header_fields;
+	header_fields.insert(std::make_pair("x-custom", "1"));
+	header_fields.insert(std::make_pair("host", "localhost"));
+	header_fields.insert(std::make_pair("content-length", "3"));
+	RequestHeaderFields::const_iterator it = header_fields.begin();
+	return header_fields.size() == 3 && (it++)->first == "x-custom" && (it++)->first == "host" &&
+		   (it++)->first == "content-length" && it == header_fields.end();
+}
+
+// 既にあるfieldはstd::map::insertと同じく上書きしない
+bool IsDuplicateInsertIgnored(const std::string &name) {
+	RequestHeaderFields header_fields;
+	const bool is_first  = header_fields.insert(std::make_pair(name, "first")).second;
+	const bool is_second = header_fields.insert(std::make_pair(name, "second")).second;
+	return is_first && !is_second && header_fields.size() == 1 &&
+		   header_fields.at(name) == "first";
+}
+
+std::string FindValue(const RequestHeaderFields &header_fields, const std::string &name) {
+	const RequestHeaderFields::const_iterator it = header_fields.find(name);
+	return it == header_fields.end() ? "(none)" : it->second;
+}
+
+// 前のfieldを消しても後ろの既知のheaderのslotがずれない
+bool IsSlotKeptAfterErase() {
+	RequestHeaderFields header_fields;
+	header_fields["x-custom"]          = "1";
+	header_fields["host"]              = "localhost";
+	header_fields["transfer-encoding"] = "chunked";
+	header_fields.erase("x-custom");
+	header_fields.erase("host");
+	return header_fields.size() == 1 && FindValue(header_fields, "host") == "(none)" &&
+		   FindValue(header_fields, "transfer-encoding") == "chunked";
+}
+
+bool IsAtThrowOnMissing() {
+	RequestHeaderFields header_fields;
+	try {
+		header_fields.at("host");
+	} catch (const std::out_of_range &) {
+		return true;
+	}
+	return false;
+}
+
+// 順番が違っても同じfieldを持っていれば等しい
+bool IsEqualRegardlessOfOrder() {
+	RequestHeaderFields lhs;
+	lhs["host"]     = "a";
+	lhs["x-custom"] = "b";
+	RequestHeaderFields rhs;
+	rhs["x-custom"] = "b";
+	rhs["host"]     = "a";
+	RequestHeaderFields other = rhs;
+	other["host"]             = "c";
+	return lhs == rhs && lhs != other;
+}
+
+// clear()の後はslotも空になっている
+bool IsClearResetSlots() {
+	RequestHeaderFields header_fields;
+	header_fields["connection"] = "close";
+	header_fields.clear();
+	return header_fields.empty() && header_fields.count("connection") == 0;
+}
+
+int main() {
+	int ret = EXIT_SUCCESS;
+
+	// 1. 既知のheaderのid
+	ret |= HandleResult(IsAllKnownNameResolved(), true);
+
+	// 2-6. 既知ではないもの(大文字, 同じhashになりうる別の名前, 空)はunknown
+	ret |= HandleResult(IsUnknown("Host"), true);
+	ret |= HandleResult(IsUnknown("hosts"), true);
+	ret |= HandleResult(IsUnknown("x-custom"), true);
+	ret |= HandleResult(IsUnknown("hpst"), true);
+	ret |= HandleResult(IsUnknown(""), true);
+
+	// 7. 届いた順を保つ
+	ret |= HandleResult(IsInsertionOrderKept(), true);
+
+	// 8-9. 重複したinsert(既知, 未知)
+	ret |= HandleResult(IsDuplicateInsertIgnored("content-length"), true);
+	ret |= HandleResult(IsDuplicateInsertIgnored("x-custom"), true);
+
+	// 10. erase
+	ret |= HandleResult(IsSlotKeptAfterErase(), true);
+
+	// 11. at
+	ret |= HandleResult(IsAtThrowOnMissing(), true);
+
+	// 12. 比較
+	ret |= HandleResult(IsEqualRegardlessOfOrder(), true);
+
+	// 13. clear
+	ret |= HandleResult(IsClearResetSlots(), true);
+
+	return ret;
+}
@@ -0,0 +1,219 @@
+#include "color.hpp"
+#include "scan.hpp"
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+using namespace utils::scan;
+
+// ==================== Test汎用 ==================== //
+namespace {
+
+int GetTestCaseNum() {
+	static int test_case_num = 0;
+	++test_case_num;
+	return test_case_num;
+}
+
+void PrintOk() {
+	std::cout << utils::color::GREEN << GetTestCaseNum() << ".[OK]" << utils::color::RESET
+			  << std::endl;
+}
+
+void PrintNg() {
+	std::cerr << utils::color::RED << GetTestCaseNum() << ".[NG] " << utils::color::RESET
+			  << std::endl;
+}
+
+template <typename T>
+int HandleResult(const T &result, const T &expected) {
+	if (result == expected) {
+		PrintOk();
+		return EXIT_SUCCESS;
+	}
+	PrintNg();
+	std::cerr << "result  : " << result << std::endl;
+	std::cerr << "expected: " << expected << std::endl;
+	return EXIT_FAILURE;
+}
+
+} // namespace
+
+// ================================================= //
+
+// blockの境界(16, 32byte)の前後を含むように長さを変えて試す
+const std::size_t MAX_LENGTH = 100;
+
+// 比較用の素朴な実装
+bool IsTokenCharForTest(char c) {
+	static const std::string symbols = "!#$%&'*+-.^_`|~";
+	return (c >= '0' && c <= '9') || (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') ||
+		   symbols.find(c) != std::string::npos;
+}
+
+bool IsPrintForTest(const std::string &str) {
+	for (std::size_t i = 0; i < str.size(); ++i) {
+		const unsigned char c = static_cast<unsigned char>(str[i]);
+		if (c < 0x20 || c > 0x7e) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool IsUpperAlphaForTest(const std::string &str) {
+	for (std::size_t i = 0; i < str.size(); ++i) {
+		if (str[i] < 'A' || str[i] > 'Z') {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool IsTokenForTest(const std::string &str) {
+	for (std::size_t i = 0; i < str.size(); ++i) {
+		if (!IsTokenCharForTest(str[i])) {
+			return false;
+		}
+	}
+	return true;
+}
+
+std::string ToLowerForTest(const std::string &str) {
+	std::string lower = str;
+	for (std::size_t i = 0; i < lower.size(); ++i) {
+		if (lower[i] >= 'A' && lower[i] <= 'Z') {
+			lower[i] = static_cast<char>(lower[i] - 'A' + 'a');
+		}
+	}
+	return lower;
+}
+
+// 長さlengthの"aaa..."のoffsetの位置にtargetを置く
+std::string CreateStr(std::size_t length, std::size_t offset, const std::string &target) {
+	std::string str(length, 'a');
+	if (offset + target.size() <= length) {
+		str.replace(offset, target.size(), target);
+	}
+	return str;
+}
+
+// 全ての長さ・位置で区切り文字の探索がstd::string::findと一致するか
+bool IsFindSameAsStd(const std::string &target) {
+	for (std::size_t length = 0; length <= MAX_LENGTH; ++length) {
+		for (std::size_t offset = 0; offset <= length; ++offset) {
+			const std::string str = CreateStr(length, offset, target);
+			for (std::size_t pos = 0; pos <= length; pos += 7) {
+				std::size_t result = std::string::npos;
+				if (target == "\r\n") {
+					result = FindCrlf(str, pos);
+				} else if (target == "\r\n\r\n") {
+					result = FindCrlfCrlf(str, pos);
+				} else {
+					result = FindByte(str, target[0], pos);
+				}
+				if (result != str.find(target, pos)) {
+					std::cerr << "length: " << length << ", offset: " << offset
+							  << ", pos: " << pos << std::endl;
+					return false;
+				}
+			}
+		}
+	}
+	return true;
+}
+
+bool IsFindEitherSameAsStd() {
+	for (std::size_t length = 0; length <= MAX_LENGTH; ++length) {
+		for (std::size_t offset = 0; offset <= length; ++offset) {
+			const std::string str = CreateStr(length, offset, ":");
+			if (FindEitherByte(str, '\r', ':') != str.find_first_of("\r:") ||
+				FindEitherByte(str, ':', '\r') != str.find_first_of("\r:")) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+// 全ての長さ・位置で1byteだけ変えた文字列の判定が比較用の実装と一致するか
+bool IsValidateSameAsTest(char replaced, const std::string &base_chars) {
+	for (std::size_t length = 0; length <= MAX_LENGTH; ++length) {
+		for (std::size_t offset = 0; offset <= length; ++offset) {
+			std::string str;
+			for (std::size_t i = 0; i < length; ++i) {
+				str += base_chars[i % base_chars.size()];
+			}
+			if (offset < length) {
+				str[offset] = replaced;
+			}
+			if (IsPrint(str) != IsPrintForTest(str) ||
+				IsUpperAlpha(str) != IsUpperAlphaForTest(str) ||
+				IsToken(str) != IsTokenForTest(str)) {
+				std::cerr << "length: " << length << ", offset: " << offset << std::endl;
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+bool IsToLowerSameAsTest() {
+	std::string all_chars;
+	for (int c = 0; c < 256; ++c) {
+		all_chars += static_cast<char>(c);
+	}
+	for (std::size_t offset = 0; offset < MAX_LENGTH; ++offset) {
+		std::string str = all_chars.substr(offset);
+		ToLower(str);
+		if (str != ToLowerForTest(all_chars.substr(offset))) {
+			return false;
+		}
+	}
+	return true;
+}
+
+int RunTestCases(Isa isa) {
+	int ret = EXIT_SUCCESS;
+
+	SelectIsa(isa);
+	if (GetSelectedIsa() != isa) {
+		std::cout << GetIsaName(isa) << " is not supported on this CPU" << std::endl;
+		return ret;
+	}
+	std::cout << "--- " << GetIsaName(isa) << " ---" << std::endl;
+
+	// 1-4. 区切り文字の探索
+	ret |= HandleResult(IsFindSameAsStd("\r"), true);
+	ret |= HandleResult(IsFindSameAsStd("\r\n"), true);
+	ret |= HandleResult(IsFindSameAsStd("\r\n\r\n"), true);
+	ret |= HandleResult(IsFindEitherSameAsStd(), true);
+
+	// 5-6. "\r\r\n"や"\r\n\r\r\n"のように途中まで一致するもの
+	ret |= HandleResult(FindCrlf("a\r\r\n"), static_cast<std::size_t>(2));
+	ret |= HandleResult(
+		FindCrlfCrlf(std::string(30, 'a') + "\r\n\r\r\n\r\n"), static_cast<std::size_t>(33)
+	);
+
+	// 7-12. 文字種のチェック(制御文字, DEL, 0x80以上, 記号, 小文字, 大文字)
+	ret |= HandleResult(IsValidateSameAsTest('\t', "ABCZ"), true);
+	ret |= HandleResult(IsValidateSameAsTest('\x7f', "AZaz09-"), true);
+	ret |= HandleResult(IsValidateSameAsTest('\x80', "AZaz09-"), true);
+	ret |= HandleResult(IsValidateSameAsTest('(', "!#$%&'*+-.^_`|~"), true);
+	ret |= HandleResult(IsValidateSameAsTest('a', "ABCDEFGHIJKLMNOPQRSTUVWXYZ"), true);
+	ret |= HandleResult(IsValidateSameAsTest('@', "content-length"), true);
+
+	// 13. 小文字への変換
+	ret |= HandleResult(IsToLowerSameAsTest(), true);
+	return ret;
+}
+
+int main() {
+	int ret = EXIT_SUCCESS;
+
+	ret |= RunTestCases(ISA_SCALAR);
+	ret |= RunTestCases(ISA_SSE2);
+	ret |= RunTestCases(ISA_AVX2);
+
+	return ret;
+}
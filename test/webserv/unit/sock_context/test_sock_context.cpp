@@ -111,6 +111,38 @@ int TestThrow(TestFunc test_func, const server::SockContext &context, int client
 	}
 }
 
+Result RunGetConnectionCount(
+	const server::SockContext &context, const std::string &ip, std::size_t expected_count
+) {
+	Result             result;
+	std::ostringstream oss;
+
+	const std::size_t count = context.GetConnectionCount(ip);
+	if (count != expected_count) {
+		result.is_success = false;
+		oss << "connection_count(" << ip << ")" << std::endl;
+		oss << "- result  : " << count << std::endl;
+		oss << "- expected: " << expected_count << std::endl;
+	}
+	result.error_log = oss.str();
+	return result;
+}
+
+template <typename T>
+Result RunIsSameValue(const std::string &name, const T &value, const T &expected) {
+	Result             result;
+	std::ostringstream oss;
+
+	if (value != expected) {
+		result.is_success = false;
+		oss << name << std::endl;
+		oss << "- result  : " << value << std::endl;
+		oss << "- expected: " << expected << std::endl;
+	}
+	result.error_log = oss.str();
+	return result;
+}
+
 // -----------------------------------------------------------------------------
 // test用にcontextとexpectedに同じserver_fd,server_infoを追加する
 void AddServerInfoForTest(
@@ -228,6 +260,34 @@ int RunTestSockContext() {
 	// 2度同じClientInfo1を削除してみる(期待: 何も起きない)
 	context.DeleteClientInfo(client_fd1);
 
+	// IPごとの接続数
+	// - ClientInfoMap = {{7: ClientInfo2}, {10: ClientInfo3}}
+	server::ClientInfo client_info3(10, "127.0.0.2", host_port1.first, host_port1.second);
+	const int          client_fd3 = 10;
+	AddClientInfoForTest(context, expected_client_info, client_fd3, client_info3);
+	ret_code |= Test(RunGetConnectionCount(context, "127.0.0.2", 2));
+	ret_code |= Test(RunGetConnectionCount(context, "127.0.0.1", 0));
+
+	// 削除したclientは数えない(同じclientを2度削除しても1回だけ減る)
+	DeleteClientInfoForTest(context, expected_client_info, client_fd2);
+	context.DeleteClientInfo(client_fd2);
+	ret_code |= Test(RunGetConnectionCount(context, "127.0.0.2", 1));
+
+	// listenしているhost:port (fdをセットしたものだけ)
+	context.SetSockFd(host_port1, 4);
+	ret_code |= Test(RunIsSameValue("sock_fd", context.GetSockFd(host_port1), 4));
+	ret_code |= Test(RunIsSameValue("sock_fd", context.GetSockFd(host_port2), -1));
+	ret_code |= Test(RunIsSameValue<std::size_t>(
+		"listen_host_ports", context.GetListenHostPorts().size(), 1
+	));
+
+	// reloadで使わなくなったhost:portを削除 (fdはcloseしない)
+	context.DeleteServerInfo(host_port1);
+	ret_code |= Test(RunIsSameValue("sock_fd", context.GetSockFd(host_port1), -1));
+	ret_code |= Test(RunIsSameValue<std::size_t>(
+		"listen_host_ports", context.GetListenHostPorts().size(), 0
+	));
+
 	return ret_code;
 }
 
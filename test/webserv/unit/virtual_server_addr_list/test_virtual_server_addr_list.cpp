@@ -0,0 +1,160 @@
+#include "color.hpp"
+#include "virtual_server.hpp"
+#include "virtual_server_addr_list.hpp"
+#include <cstdlib>
+#include <iostream>
+#include <sstream> // ostringstream
+#include <string>
+#include <vector>
+
+using namespace server;
+
+// ==================== Test汎用 ==================== //
+namespace {
+
+int GetTestCaseNum() {
+	static int test_case_num = 0;
+	++test_case_num;
+	return test_case_num;
+}
+
+void PrintOk() {
+	std::cout << utils::color::GREEN << GetTestCaseNum() << ".[OK]" << utils::color::RESET
+			  << std::endl;
+}
+
+void PrintNg() {
+	std::cerr << utils::color::RED << GetTestCaseNum() << ".[NG] " << utils::color::RESET
+			  << std::endl;
+}
+
+template <typename T>
+int HandleResult(const T &result, const T &expected) {
+	if (result == expected) {
+		PrintOk();
+		return EXIT_SUCCESS;
+	}
+	PrintNg();
+	std::cerr << "result  : " << result << std::endl;
+	std::cerr << "expected: " << expected << std::endl;
+	return EXIT_FAILURE;
+}
+
+} // namespace
+
+// ================================================= //
+
+// 1つ目のserver_nameをtestで見分ける名前として使う
+VirtualServer CreateVirtualServer(const std::string &names) {
+	VirtualServer::ServerNameList server_names;
+	std::istringstream            iss(names);
+	std::string                   name;
+	while (iss >> name) {
+		server_names.push_back(name);
+	}
+	return VirtualServer(
+		server_names,
+		VirtualServer::LocationList(),
+		VirtualServer::HostPortList(),
+		1024,
+		VirtualServer::ErrorPage()
+	);
+}
+
+std::string FindName(const VirtualServerAddrList &virtual_servers, const std::string &host) {
+	const VirtualServer *virtual_server = virtual_servers.FindVirtualServer(host);
+	if (virtual_server == NULL) {
+		return "(none)";
+	}
+	return virtual_server->GetServerNameList().front();
+}
+
+// server_nameがたくさんあってhash tableを広げても全て引ける
+bool IsAllNameFound() {
+	std::vector<VirtualServer> servers;
+	for (int i = 0; i < 300; ++i) {
+		std::ostringstream oss;
+		oss << "host" << i << ".example.com alias" << i;
+		servers.push_back(CreateVirtualServer(oss.str()));
+	}
+	VirtualServerAddrList virtual_servers;
+	for (std::size_t i = 0; i < servers.size(); ++i) {
+		virtual_servers.push_back(&servers[i]);
+	}
+	for (std::size_t i = 0; i < servers.size(); ++i) {
+		std::ostringstream oss;
+		oss << "alias" << i;
+		if (virtual_servers.FindVirtualServer(oss.str()) != &servers[i]) {
+			std::cerr << "not found: " << oss.str() << std::endl;
+			return false;
+		}
+	}
+	return virtual_servers.size() == servers.size();
+}
+
+int main() {
+	int ret = EXIT_SUCCESS;
+
+	const VirtualServer default_server = CreateVirtualServer("default localhost");
+	const VirtualServer host1          = CreateVirtualServer("host1 www.Host1.com");
+	const VirtualServer wildcard       = CreateVirtualServer("*.example.com");
+	const VirtualServer sub_wildcard   = CreateVirtualServer("*.api.example.com");
+	const VirtualServer exact          = CreateVirtualServer("www.example.com");
+	const VirtualServer duplicated     = CreateVirtualServer("dup host1 *.example.com");
+
+	VirtualServerAddrList virtual_servers;
+	virtual_servers.push_back(&default_server);
+	virtual_servers.push_back(&host1);
+	virtual_servers.push_back(&wildcard);
+	virtual_servers.push_back(&sub_wildcard);
+	virtual_servers.push_back(&exact);
+	virtual_servers.push_back(&duplicated);
+
+	// 1-4. 完全一致(大文字, port, 末尾の'.'は無視する)
+	ret |= HandleResult(FindName(virtual_servers, "host1"), std::string("host1"));
+	ret |= HandleResult(FindName(virtual_servers, "WWW.HOST1.COM"), std::string("host1"));
+	ret |= HandleResult(FindName(virtual_servers, "localhost:8080"), std::string("default"));
+	ret |= HandleResult(FindName(virtual_servers, "host1.:8080"), std::string("host1"));
+
+	// 5-8. wildcardは一番長く一致したもの。完全一致の方を優先する
+	ret |= HandleResult(FindName(virtual_servers, "a.example.com"), std::string("*.example.com"));
+	ret |=
+		HandleResult(FindName(virtual_servers, "a.b.example.com"), std::string("*.example.com"));
+	ret |= HandleResult(
+		FindName(virtual_servers, "v1.api.example.com"), std::string("*.api.example.com")
+	);
+	ret |= HandleResult(
+		FindName(virtual_servers, "www.example.com"), std::string("www.example.com")
+	);
+
+	// 9-11. *.example.comはexample.comそのものや別のdomainには一致しないのでdefault server
+	ret |= HandleResult(FindName(virtual_servers, "example.com"), std::string("default"));
+	ret |= HandleResult(FindName(virtual_servers, "aexample.com"), std::string("default"));
+	ret |= HandleResult(FindName(virtual_servers, "unknown"), std::string("default"));
+
+	// 12. 同じserver_nameは先に追加したserver
+	ret |= HandleResult(FindName(virtual_servers, "dup"), std::string("dup"));
+
+	// 13. default server
+	ret |= HandleResult(virtual_servers.GetDefaultServer() == &default_server, true);
+
+	// 14. 空の場合
+	ret |= HandleResult(FindName(VirtualServerAddrList(), "host1"), std::string("(none)"));
+
+	// 15. copyしても同じように引ける
+	const VirtualServerAddrList copied = virtual_servers;
+	ret |= HandleResult(FindName(copied, "x.api.example.com"), std::string("*.api.example.com"));
+
+	// 16-17. Host headerの正規化
+	ret |= HandleResult(
+		VirtualServerAddrList::NormalizeHostName("[::1]:8080"), std::string("[::1]")
+	);
+	ret |= HandleResult(
+		VirtualServerAddrList::NormalizeHostName("Example.COM."), std::string("example.com")
+	);
+
+	// 18. たくさんのserver_name
+	ret |= HandleResult(IsAllNameFound(), true);
+
+	return ret;
+}